@@ -0,0 +1,272 @@
+#include "SGBenchmark.h"
+#include "SGAssetPack.h"
+#include "SGAssetPackWriter.h"
+
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <string>
+
+#ifndef _WIN32
+#include <sys/resource.h>
+#endif
+
+namespace
+{
+	const unsigned int TEXTURE_SIZE = 512;
+	const unsigned int TEXTURE_MIP_LEVELS = 10;
+	const unsigned int R8G8B8A8_UNORM = 28;
+	const unsigned int VERTEX_STRIDE = 32;
+	const unsigned int NR_OF_VERTICES = 65536;
+	const unsigned int NR_OF_INDICES = 196608;
+
+	struct LooseAsset
+	{
+		std::string path;
+		bool texture;
+	};
+
+	long GetPageFaults()
+	{
+#ifdef _WIN32
+		return 0;
+#else
+		rusage usage;
+		getrusage(RUSAGE_SELF, &usage);
+		return usage.ru_minflt + usage.ru_majflt;
+#endif
+	}
+
+	// Reads every byte the way the device reads initial data when a resource is created
+	uint64_t Consume(const void* data, size_t size)
+	{
+		const unsigned char* bytes = static_cast<const unsigned char*>(data);
+		uint64_t sum = 0;
+		size_t i = 0;
+
+		for (; i + 8 <= size; i += 8)
+		{
+			uint64_t value;
+			std::memcpy(&value, bytes + i, 8);
+			sum += value;
+		}
+
+		for (; i < size; ++i)
+			sum += bytes[i];
+
+		return sum;
+	}
+
+	void FillPattern(std::vector<unsigned char>& data, unsigned int seed)
+	{
+		for (size_t i = 0; i < data.size(); ++i)
+			data[i] = static_cast<unsigned char>(i * 131 + seed);
+	}
+
+	bool WriteFile(const std::string& path, const std::vector<unsigned char>& data)
+	{
+		FILE* file = std::fopen(path.c_str(), "wb");
+
+		if (file == nullptr)
+			return false;
+
+		bool written = std::fwrite(data.data(), 1, data.size(), file) == data.size();
+		return std::fclose(file) == 0 && written;
+	}
+
+	/** Reads a loose asset into a heap buffer of its own and hands out pointers into it, what callers had to do before packs */
+	uint64_t LoadLoose(const LooseAsset& asset)
+	{
+		std::vector<unsigned char> buffer;
+		FILE* file = std::fopen(asset.path.c_str(), "rb");
+
+		if (file == nullptr)
+			return 0;
+
+		std::fseek(file, 0, SEEK_END);
+		buffer.resize(static_cast<size_t>(std::ftell(file)));
+		std::fseek(file, 0, SEEK_SET);
+		size_t read = std::fread(buffer.data(), 1, buffer.size(), file);
+		std::fclose(file);
+
+		if (read != buffer.size())
+			return 0;
+
+		if (!asset.texture)
+			return Consume(buffer.data(), NR_OF_VERTICES * VERTEX_STRIDE) + Consume(buffer.data() + NR_OF_VERTICES * VERTEX_STRIDE, NR_OF_INDICES * 4);
+
+		uint64_t sum = 0;
+		size_t offset = 0;
+
+		for (unsigned int mip = 0; mip < TEXTURE_MIP_LEVELS; ++mip)
+		{
+			size_t mipSize = static_cast<size_t>(TEXTURE_SIZE >> mip) * (TEXTURE_SIZE >> mip) * 4;
+			sum += Consume(buffer.data() + offset, mipSize);
+			offset += mipSize;
+		}
+
+		return sum;
+	}
+
+	uint64_t LoadPacked(const SG::SGAssetPack& pack, const std::vector<SG::SGGuid>& names)
+	{
+		uint64_t sum = 0;
+
+		for (auto& name : names)
+		{
+			SG::SGPackedTexture texture;
+			SG::SGPackedMesh mesh;
+
+			if (pack.GetTexture(name, texture) == SG::SGResult::OK)
+			{
+				for (size_t i = 0; i < texture.data.size(); ++i)
+					sum += Consume(texture.data[i], static_cast<size_t>(texture.slicePitches[i]));
+			}
+			else if (pack.GetMesh(name, mesh) == SG::SGResult::OK)
+			{
+				sum += Consume(mesh.vertices, mesh.vertexDataSize) + Consume(mesh.indices, mesh.indexDataSize);
+			}
+		}
+
+		return sum;
+	}
+}
+
+int main(int argc, char** argv)
+{
+	size_t nrOfAssets = SG::GetArgument(argc, argv, 1, 64);
+	std::string directory = argc > 2 ? argv[2] : ".";
+	std::string packPath = directory + "/BenchmarkAssetPack.sgpack";
+
+	// Half textures with full mip chains and half indexed meshes, written both as loose files and as one pack
+	std::vector<std::vector<unsigned char>> contents(nrOfAssets);
+	std::vector<LooseAsset> looseAssets;
+	std::vector<SG::SGGuid> names;
+	SG::SGAssetPackWriter writer;
+	size_t totalSize = 0;
+
+	for (size_t i = 0; i < nrOfAssets; ++i)
+	{
+		std::string name = "Asset" + std::to_string(i);
+		bool texture = i % 2 == 0;
+		std::vector<unsigned char>& content = contents[i];
+
+		if (texture)
+		{
+			SG::SGPackedTexture packed = {};
+			packed.format = R8G8B8A8_UNORM;
+			packed.width = TEXTURE_SIZE;
+			packed.height = TEXTURE_SIZE;
+			packed.depth = 1;
+			packed.arraySize = 1;
+			packed.mipLevels = TEXTURE_MIP_LEVELS;
+			size_t size = 0;
+
+			for (unsigned int mip = 0; mip < TEXTURE_MIP_LEVELS; ++mip)
+				size += static_cast<size_t>(TEXTURE_SIZE >> mip) * (TEXTURE_SIZE >> mip) * 4;
+
+			content.resize(size);
+			FillPattern(content, static_cast<unsigned int>(i));
+			size_t offset = 0;
+
+			for (unsigned int mip = 0; mip < TEXTURE_MIP_LEVELS; ++mip)
+			{
+				unsigned int width = TEXTURE_SIZE >> mip;
+				packed.data.push_back(content.data() + offset);
+				packed.rowPitches.push_back(width * 4);
+				packed.slicePitches.push_back(width * width * 4);
+				offset += static_cast<size_t>(width) * width * 4;
+			}
+
+			writer.AddTexture(name, packed);
+		}
+		else
+		{
+			content.resize(NR_OF_VERTICES * VERTEX_STRIDE + NR_OF_INDICES * 4);
+			FillPattern(content, static_cast<unsigned int>(i));
+			SG::SGPackedMesh packed = { content.data(), NR_OF_VERTICES * VERTEX_STRIDE, VERTEX_STRIDE, NR_OF_VERTICES,
+				content.data() + NR_OF_VERTICES * VERTEX_STRIDE, NR_OF_INDICES * 4, 4, NR_OF_INDICES };
+			writer.AddMesh(name, packed);
+		}
+
+		looseAssets.push_back({ directory + "/BenchmarkAssetPack" + std::to_string(i) + ".bin", texture });
+		names.push_back(SG::SGGuid(name));
+		totalSize += content.size();
+
+		if (!WriteFile(looseAssets.back().path, content))
+		{
+			std::printf("Could not write %s\n", looseAssets.back().path.c_str());
+			return 1;
+		}
+	}
+
+	if (writer.Write(packPath) != SG::SGResult::OK)
+	{
+		std::printf("Could not write %s\n", packPath.c_str());
+		return 1;
+	}
+
+	contents.clear();
+	double megabytes = static_cast<double>(totalSize) / (1024.0 * 1024.0);
+	uint64_t expectedSum = 0;
+	bool sumsMatch = true;
+
+	std::printf("Loading %zu assets, %.1f MB, from the page cache\n", nrOfAssets, megabytes);
+	std::printf("%-16s %10s %10s %14s\n", "loader", "ms", "MB/s", "page faults");
+
+	// Every loader has to see the same bytes
+	auto report = [&](const char* loader, const std::function<uint64_t()>& load)
+	{
+		long faults = 0;
+		double milliseconds = SG::MeasureMilliseconds(5, [&]()
+		{
+			long before = GetPageFaults();
+			uint64_t sum = load();
+			faults = GetPageFaults() - before;
+
+			if (expectedSum == 0)
+				expectedSum = sum;
+
+			sumsMatch = sumsMatch && sum == expectedSum;
+		});
+
+		std::printf("%-16s %10.2f %10.1f %14ld\n", loader, milliseconds, megabytes * 1000.0 / milliseconds, faults);
+	};
+
+	report("fread", [&]()
+	{
+		uint64_t sum = 0;
+
+		for (auto& asset : looseAssets)
+			sum += LoadLoose(asset);
+
+		return sum;
+	});
+
+	report("pack", [&]()
+	{
+		SG::SGAssetPack pack;
+		pack.Open(packPath);
+		return LoadPacked(pack, names);
+	});
+
+	report("pack prefetched", [&]()
+	{
+		SG::SGAssetPack pack;
+		pack.Open(packPath);
+		pack.Prefetch(names);
+		return LoadPacked(pack, names);
+	});
+
+	for (auto& asset : looseAssets)
+		std::remove(asset.path.c_str());
+
+	std::remove(packPath.c_str());
+	if (!sumsMatch)
+	{
+		std::printf("The pack did not return the data of the loose files\n");
+		return 1;
+	}
+
+	return 0;
+}
@@ -0,0 +1,128 @@
+#include "SGBenchmark.h"
+#include "SGBlockCompressor.h"
+
+#include <cmath>
+#include <random>
+#include <thread>
+
+namespace
+{
+	/** Compares the channels the format stores with the source, returns 0 if the image could not be decoded */
+	double GetPSNR(const SG::SGMipImage& image, const SG::SGCompressedImage& compressed)
+	{
+		SG::SGMipImage decoded;
+
+		if (SG::DecompressImage(compressed, decoded) != SG::SGResult::OK)
+			return 0.0;
+
+		int nrOfChannels = compressed.format == SG::SGBlockFormat::BC1 ? 3 : (compressed.format == SG::SGBlockFormat::BC5 ? 2 : 4);
+		double squaredError = 0.0;
+		size_t nrOfValues = 0;
+
+		for (size_t i = 0; i < image.texels.size(); i += 4)
+		{
+			for (int c = 0; c < nrOfChannels; ++c)
+			{
+				double difference = static_cast<double>(image.texels[i + c]) - decoded.texels[i + c];
+				squaredError += difference * difference;
+				++nrOfValues;
+			}
+		}
+
+		double meanSquaredError = squaredError / nrOfValues;
+		return meanSquaredError > 0.0 ? 10.0 * std::log10(255.0 * 255.0 / meanSquaredError) : 99.0;
+	}
+
+	/** Smooth gradients and waves with hard edged shapes, closer to baked content than plain noise. Noise with a deviation of
+	noiseDeviation is added on top, which the formats can only keep a little of, so it holds down the PSNR of every format */
+	SG::SGMipImage CreateImage(unsigned int size, bool opaque, float noiseDeviation)
+	{
+		std::mt19937 generator(48);
+		std::normal_distribution<float> noise(0.0f, 1.0f);
+		SG::SGMipImage image;
+		image.width = size;
+		image.height = size;
+		image.texels.resize(static_cast<size_t>(size) * size * 4);
+
+		for (unsigned int y = 0; y < size; ++y)
+		{
+			for (unsigned int x = 0; x < size; ++x)
+			{
+				float u = static_cast<float>(x) / size;
+				float v = static_cast<float>(y) / size;
+				bool shape = (x / 96 + y / 64) % 5 == 0;
+				float values[4] =
+				{
+					255.0f * u,
+					127.5f + 127.5f * std::sin(v * 40.0f + u * 7.0f),
+					shape ? 230.0f : 60.0f + 80.0f * v,
+					opaque ? 255.0f : 127.5f + 127.5f * std::cos(u * 23.0f) * std::sin(v * 17.0f)
+				};
+
+				for (int c = 0; c < 4; ++c)
+				{
+					float value = c < 3 || !opaque ? values[c] + noiseDeviation * noise(generator) : values[c];
+					image.texels[(static_cast<size_t>(y) * size + x) * 4 + c] = static_cast<unsigned char>(std::min(255.0f, std::max(0.0f, value)));
+				}
+			}
+		}
+
+		return image;
+	}
+}
+
+int main(int argc, char** argv)
+{
+	unsigned int size = static_cast<unsigned int>(SG::GetArgument(argc, argv, 1, 1024));
+	size_t nrOfThreads = SG::GetArgument(argc, argv, 2, std::max(1u, std::thread::hardware_concurrency()));
+
+	SG::SGThreadPool threadPool(static_cast<int>(nrOfThreads > 1 ? nrOfThreads - 1 : 1));
+	const float noiseDeviation = 4.0f;
+	SG::SGMipImage opaqueImage = CreateImage(size, true, noiseDeviation);
+	SG::SGMipImage image = CreateImage(size, false, noiseDeviation);
+	SG::SGMipImage cleanOpaqueImage = CreateImage(size, true, 0.0f);
+	SG::SGMipImage cleanImage = CreateImage(size, false, 0.0f);
+	SG::SGCompressedImage compressed;
+	double megabytes = static_cast<double>(image.texels.size()) / (1024.0 * 1024.0);
+
+	// Noise of deviation s has a PSNR of 20 * log10(255 / s) against the clean image, the noisy column ends up close to it
+	std::printf("Compressing a %ux%u RGBA8 image, %zu threads, MB/s counts source bytes\n", size, size, nrOfThreads);
+	std::printf("The noisy image has noise with a deviation of %.0f, %.1f dB on its own, the clean image measures the compression alone\n", noiseDeviation,
+		20.0 * std::log10(255.0 / noiseDeviation));
+	std::printf("%-6s %-8s %12s %14s %10s %10s\n", "format", "quality", "MB/s/core", "MB/s threads", "noisy dB", "clean dB");
+
+	const std::pair<SG::SGBlockFormat, const char*> formats[] =
+	{
+		{ SG::SGBlockFormat::BC1, "BC1" }, { SG::SGBlockFormat::BC3, "BC3" }, { SG::SGBlockFormat::BC5, "BC5" }, { SG::SGBlockFormat::BC7, "BC7" }
+	};
+	const std::pair<SG::SGCompressionQuality, const char*> qualities[] =
+	{
+		{ SG::SGCompressionQuality::FAST, "fast" }, { SG::SGCompressionQuality::NORMAL, "normal" }, { SG::SGCompressionQuality::HIGH, "high" }
+	};
+
+	for (auto& format : formats)
+	{
+		// BC1 turns texels with little alpha transparent, so it is measured on colour alone
+		const SG::SGMipImage& source = format.first == SG::SGBlockFormat::BC1 ? opaqueImage : image;
+		const SG::SGMipImage& cleanSource = format.first == SG::SGBlockFormat::BC1 ? cleanOpaqueImage : cleanImage;
+
+		for (auto& quality : qualities)
+		{
+			SG::SGCompressionSettings settings;
+			settings.format = format.first;
+			settings.quality = quality.first;
+
+			double singleThreaded = SG::MeasureMilliseconds(3, [&]() { SG::CompressImage(source, settings, compressed, nullptr); });
+			double threaded = nrOfThreads > 1 ?
+				SG::MeasureMilliseconds(3, [&]() { SG::CompressImage(source, settings, compressed, &threadPool); }) : singleThreaded;
+
+			double noisyPSNR = GetPSNR(source, compressed);
+			SG::CompressImage(cleanSource, settings, compressed, &threadPool);
+
+			std::printf("%-6s %-8s %12.1f %14.1f %10.2f %10.2f\n", format.second, quality.second, megabytes * 1000.0 / singleThreaded,
+				megabytes * 1000.0 / threaded, noisyPSNR, GetPSNR(cleanSource, compressed));
+		}
+	}
+
+	return 0;
+}
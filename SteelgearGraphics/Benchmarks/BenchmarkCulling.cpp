@@ -0,0 +1,131 @@
+#include "SGBenchmark.h"
+#include "SGCulling.h"
+
+#include <cmath>
+#include <random>
+#include <thread>
+
+namespace
+{
+	// Plain per entity test with the same rules as CullEntities, one entity at a time
+	void CullScalar(const SG::SGEntityBounds& bounds, const std::vector<SG::SGFrustum>& frustums,
+		const std::vector<SG::SGGraphicalEntityID>& entities, std::vector<SG::SGGraphicalEntityID>& visibleEntities)
+	{
+		for (auto entity : entities)
+		{
+			for (auto& frustum : frustums)
+			{
+				bool inside = true;
+
+				for (auto& plane : frustum.planes)
+				{
+					float distance = plane.x * bounds.centerX[entity] + plane.y * bounds.centerY[entity] +
+						plane.z * bounds.centerZ[entity] + plane.w;
+					float boxReach = std::fabs(plane.x) * bounds.extentX[entity] + std::fabs(plane.y) * bounds.extentY[entity] +
+						std::fabs(plane.z) * bounds.extentZ[entity];
+
+					inside = inside && distance + bounds.radius[entity] >= 0.0f && distance + boxReach >= 0.0f;
+				}
+
+				if (inside)
+				{
+					visibleEntities.push_back(entity);
+					break;
+				}
+			}
+		}
+	}
+
+	// Row major perspective projection used as v * M, looking down +z from the origin rotated around y by yaw
+	SG::SGFrustum CreateCameraFrustum(float yaw)
+	{
+		const float nearZ = 0.1f;
+		const float farZ = 500.0f;
+		const float scale = 1.0f / std::tan(0.5f * 1.2f);
+		float sine = std::sin(yaw);
+		float cosine = std::cos(yaw);
+		float range = farZ / (farZ - nearZ);
+
+		// The view matrix is the inverse of the rotation, multiplied with the projection
+		float viewProjection[16] =
+		{
+			cosine * scale / 1.78f, 0.0f, sine * range, sine,
+			0.0f, scale, 0.0f, 0.0f,
+			-sine * scale / 1.78f, 0.0f, cosine * range, cosine,
+			0.0f, 0.0f, -nearZ * range, 0.0f
+		};
+
+		return SG::CreateFrustumFromMatrix(viewProjection);
+	}
+}
+
+int main(int argc, char** argv)
+{
+	size_t nrOfEntities = SG::GetArgument(argc, argv, 1, 1000000);
+	size_t nrOfThreads = SG::GetArgument(argc, argv, 2, std::max(1u, std::thread::hardware_concurrency()));
+
+	// Half of the entities are spheres and half are boxes, spread over a square around the camera
+	std::mt19937 generator(28);
+	std::uniform_real_distribution<float> position(-400.0f, 400.0f);
+	std::uniform_real_distribution<float> size(0.5f, 8.0f);
+	SG::SGEntityBounds bounds;
+	std::vector<SG::SGGraphicalEntityID> entities;
+
+	for (size_t i = 0; i < nrOfEntities; ++i)
+	{
+		SG::SGGraphicalEntityID entity = static_cast<SG::SGGraphicalEntityID>(i);
+		bounds.AddEntity();
+		entities.push_back(entity);
+
+		float center[3] = { position(generator), position(generator) * 0.1f, position(generator) };
+
+		if (i % 2 == 0)
+		{
+			bounds.SetSphere(entity, center[0], center[1], center[2], size(generator));
+		}
+		else
+		{
+			float extents[3] = { size(generator), size(generator), size(generator) };
+			bounds.SetBox(entity, center, extents);
+		}
+	}
+
+	std::vector<SG::SGFrustum> oneFrustum = { CreateCameraFrustum(0.3f) };
+	std::vector<SG::SGFrustum> fourFrustums = { CreateCameraFrustum(0.3f), CreateCameraFrustum(1.9f),
+		CreateCameraFrustum(3.4f), CreateCameraFrustum(5.0f) };
+	SG::SGThreadPool threadPool(static_cast<int>(nrOfThreads > 1 ? nrOfThreads - 1 : 1));
+	std::vector<SG::SGGraphicalEntityID> visibleEntities;
+	visibleEntities.reserve(nrOfEntities);
+
+	std::printf("Culling %zu spheres and boxes, %zu threads\n", nrOfEntities, nrOfThreads);
+	std::printf("%-10s %-8s %12s %14s %10s\n", "frustums", "path", "ms/frame", "Mentities/s", "visible");
+
+	for (auto* frustums : { &oneFrustum, &fourFrustums })
+	{
+		auto report = [&](const char* path, double milliseconds)
+		{
+			std::printf("%-10zu %-8s %12.3f %14.1f %10zu\n", frustums->size(), path, milliseconds,
+				nrOfEntities / milliseconds / 1000.0, visibleEntities.size());
+		};
+
+		report("scalar", SG::MeasureMilliseconds(10, [&]()
+		{
+			visibleEntities.clear();
+			CullScalar(bounds, *frustums, entities, visibleEntities);
+		}));
+
+		report("sse", SG::MeasureMilliseconds(10, [&]()
+		{
+			visibleEntities.clear();
+			SG::CullEntities(bounds, *frustums, entities, visibleEntities, nullptr);
+		}));
+
+		report("threads", SG::MeasureMilliseconds(10, [&]()
+		{
+			visibleEntities.clear();
+			SG::CullEntities(bounds, *frustums, entities, visibleEntities, nrOfThreads > 1 ? &threadPool : nullptr);
+		}));
+	}
+
+	return 0;
+}
@@ -0,0 +1,237 @@
+#include "SGBenchmark.h"
+#include "SGJobBalancer.h"
+#include "SGThreadPool.h"
+
+#include <algorithm>
+#include <chrono>
+#include <string>
+#include <thread>
+
+namespace
+{
+	const size_t MINIMUM_ENTITIES_PER_CHUNK = 512;
+	const size_t SEGMENTS_PER_CONTEXT = 4;
+
+	struct Job
+	{
+		SG::SGGuid guid;
+		size_t nrOfEntities;
+		double timePerEntity; // Microseconds spent recording one entity
+	};
+
+	struct Chunk
+	{
+		size_t job;
+		size_t entityStart;
+		size_t entityEnd;
+		double recordedTime;
+	};
+
+	volatile unsigned int workResult = 0;
+	double iterationsPerMicrosecond = 0.0;
+
+	void DoWork(size_t iterations)
+	{
+		unsigned int value = workResult;
+
+		for (size_t i = 0; i < iterations; ++i)
+			value = value * 1664525u + 1013904223u;
+
+		workResult = value;
+	}
+
+	// Work is counted in iterations rather than waited for, so threads sharing a core take longer as they would when recording
+	void CalibrateWork()
+	{
+		const size_t iterations = 50000000;
+		auto start = std::chrono::steady_clock::now();
+		DoWork(iterations);
+		iterationsPerMicrosecond = iterations / std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+	}
+
+	double GetCost(const Job& job, const Chunk& chunk)
+	{
+		return job.timePerEntity * (chunk.entityEnd - chunk.entityStart);
+	}
+
+	// Stands in for recording the draw calls of a chunk
+	void RecordChunk(const Job& job, Chunk& chunk)
+	{
+		auto start = std::chrono::steady_clock::now();
+		DoWork(static_cast<size_t>(iterationsPerMicrosecond * GetCost(job, chunk)));
+		chunk.recordedTime = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+	}
+
+	// Splits jobs the way the engine does, into at most maxChunksPerJob chunks of at least MINIMUM_ENTITIES_PER_CHUNK entities
+	void CreateChunks(const std::vector<Job>& jobs, size_t maxChunksPerJob, std::vector<Chunk>& chunks)
+	{
+		chunks.clear();
+
+		for (size_t i = 0; i < jobs.size(); ++i)
+		{
+			size_t nrOfChunks = std::max<size_t>(1, std::min(jobs[i].nrOfEntities / MINIMUM_ENTITIES_PER_CHUNK, maxChunksPerJob));
+			size_t entitiesPerChunk = (jobs[i].nrOfEntities + nrOfChunks - 1) / nrOfChunks;
+
+			for (size_t start = 0; start < jobs[i].nrOfEntities; start += entitiesPerChunk)
+				chunks.push_back({ i, start, std::min(start + entitiesPerChunk, jobs[i].nrOfEntities), 0.0 });
+		}
+	}
+
+	/** The scheme the balancer replaced, each context records one contiguous range with about the same number of entities.
+	Returns the critical path in milliseconds, the cost of the context with the most work when every context has a core of its own.
+	It does not depend on the cores of the machine running the benchmark, unlike the measured frame time */
+	double RecordEqualEntities(const std::vector<Job>& jobs, std::vector<Chunk>& chunks, SG::SGThreadPool& threadPool, size_t nrOfContexts)
+	{
+		CreateChunks(jobs, nrOfContexts, chunks);
+		nrOfContexts = std::min(nrOfContexts, chunks.size());
+
+		size_t totalCost = 0;
+		for (auto& chunk : chunks)
+			totalCost += chunk.entityEnd - chunk.entityStart;
+
+		std::vector<size_t> rangeStarts(nrOfContexts + 1, chunks.size());
+		rangeStarts[0] = 0;
+		size_t accumulatedCost = 0;
+		size_t currentContext = 1;
+
+		for (size_t i = 0; i < chunks.size() && currentContext < nrOfContexts; ++i)
+		{
+			accumulatedCost += chunks[i].entityEnd - chunks[i].entityStart;
+
+			while (currentContext < nrOfContexts && accumulatedCost * nrOfContexts >= totalCost * currentContext)
+				rangeStarts[currentContext++] = i + 1;
+		}
+
+		// One task per context, the same way ExecuteJobs hands them to the thread pool
+		SG::RunTasks(&threadPool, nrOfContexts, 1, [&](size_t context, size_t)
+		{
+			for (size_t i = rangeStarts[context]; i < rangeStarts[context + 1]; ++i)
+				RecordChunk(jobs[chunks[i].job], chunks[i]);
+		});
+
+		double criticalPath = 0.0;
+
+		for (size_t context = 0; context < nrOfContexts; ++context)
+		{
+			double contextCost = 0.0;
+
+			for (size_t i = rangeStarts[context]; i < rangeStarts[context + 1]; ++i)
+				contextCost += GetCost(jobs[chunks[i].job], chunks[i]);
+
+			criticalPath = std::max(criticalPath, contextCost);
+		}
+
+		return criticalPath / 1000.0;
+	}
+
+	double RecordBalanced(const std::vector<Job>& jobs, std::vector<Chunk>& chunks, SG::SGThreadPool& threadPool, size_t nrOfContexts,
+		SG::SGJobBalancer& balancer)
+	{
+		size_t nrOfSegments = nrOfContexts * SEGMENTS_PER_CONTEXT;
+		std::vector<double> predictedTimes;
+		CreateChunks(jobs, nrOfSegments, chunks);
+
+		for (auto& chunk : chunks)
+			predictedTimes.push_back(balancer.PredictTime(jobs[chunk.job].guid, chunk.entityEnd - chunk.entityStart));
+
+		balancer.CreateSegments(predictedTimes, nrOfSegments);
+		const std::vector<SG::SGChunkSegment>& segments = balancer.GetSegments();
+		nrOfContexts = std::min(nrOfContexts, segments.size());
+
+		SG::RunTasks(&threadPool, nrOfContexts, 1, [&](size_t, size_t)
+		{
+			size_t next = 0;
+
+			while (balancer.TakeSegment(next))
+			{
+				for (size_t i = segments[next].chunkStart; i < segments[next].chunkEnd; ++i)
+					RecordChunk(jobs[chunks[i].job], chunks[i]);
+			}
+		});
+
+		for (auto& chunk : chunks)
+			balancer.AddRecordedTime(jobs[chunk.job].guid, chunk.entityEnd - chunk.entityStart, chunk.recordedTime);
+
+		// Segments go longest predicted first to the context that is free the earliest
+		std::vector<size_t> order(segments.size());
+
+		for (size_t i = 0; i < order.size(); ++i)
+			order[i] = i;
+
+		std::stable_sort(order.begin(), order.end(), [&](size_t first, size_t second)
+		{
+			return segments[first].predictedTime > segments[second].predictedTime;
+		});
+
+		std::vector<double> contextCosts(nrOfContexts, 0.0);
+
+		for (size_t segment : order)
+		{
+			double& freeFirst = *std::min_element(contextCosts.begin(), contextCosts.end());
+
+			for (size_t i = segments[segment].chunkStart; i < segments[segment].chunkEnd; ++i)
+				freeFirst += GetCost(jobs[chunks[i].job], chunks[i]);
+		}
+
+		return contextCosts.empty() ? 0.0 : *std::max_element(contextCosts.begin(), contextCosts.end()) / 1000.0;
+	}
+}
+
+int main(int argc, char** argv)
+{
+	size_t nrOfJobs = SG::GetArgument(argc, argv, 1, 48);
+	size_t heavyEvery = SG::GetArgument(argc, argv, 2, 8);
+	size_t nrOfContexts = SG::GetArgument(argc, argv, 3, std::max(1u, std::thread::hardware_concurrency()));
+	const size_t entitiesPerJob = 2048;
+	const double lightTimePerEntity = 0.1;
+	const double heavyTimePerEntity = 2.0;
+
+	// Every heavyEvery-th job costs twenty times as much per entity, like a job with many bindings next to simple ones
+	std::vector<Job> jobs;
+	double totalTime = 0.0;
+
+	for (size_t i = 0; i < nrOfJobs; ++i)
+	{
+		bool heavy = heavyEvery != 0 && i % heavyEvery == 0;
+		jobs.push_back({ SG::SGGuid("BenchmarkJob" + std::to_string(i)), entitiesPerJob, heavy ? heavyTimePerEntity : lightTimePerEntity });
+		totalTime += jobs.back().timePerEntity * entitiesPerJob / 1000.0;
+	}
+
+	CalibrateWork();
+	SG::SGThreadPool threadPool(static_cast<int>(nrOfContexts > 1 ? nrOfContexts - 1 : 1));
+	SG::SGJobBalancer balancer;
+	std::vector<Chunk> chunks;
+
+	std::printf("Recording %zu jobs of %zu entities, every %zu. job is %.0fx heavier, %zu contexts\n", nrOfJobs, entitiesPerJob, heavyEvery,
+		heavyTimePerEntity / lightTimePerEntity, nrOfContexts);
+	std::printf("%-16s %12s %16s\n", "scheme", "ms/frame", "critical path ms");
+	std::printf("%-16s %12s %16.3f\n", "ideal", "", totalTime / nrOfContexts);
+	double criticalPath = 0.0;
+
+	auto report = [&](const char* scheme, double milliseconds)
+	{
+		std::printf("%-16s %12.3f %16.3f\n", scheme, milliseconds, criticalPath);
+	};
+
+	report("equal entities", SG::MeasureMilliseconds(20, [&]()
+	{
+		criticalPath = RecordEqualEntities(jobs, chunks, threadPool, nrOfContexts);
+	}));
+
+	// Without history every job is predicted to cost the same per entity, the first frames teach the balancer
+	report("first frame", SG::MeasureMilliseconds(1, [&]()
+	{
+		SG::SGJobBalancer firstFrame;
+		criticalPath = RecordBalanced(jobs, chunks, threadPool, nrOfContexts, firstFrame);
+	}));
+
+	for (int frame = 0; frame < 10; ++frame)
+		RecordBalanced(jobs, chunks, threadPool, nrOfContexts, balancer);
+
+	report("balanced", SG::MeasureMilliseconds(20, [&]()
+	{
+		criticalPath = RecordBalanced(jobs, chunks, threadPool, nrOfContexts, balancer);
+	}));
+
+	return 0;
+}
@@ -0,0 +1,82 @@
+#include "SGBenchmark.h"
+#include "SGLODSelection.h"
+
+#include <random>
+
+int main(int argc, char** argv)
+{
+	size_t nrOfEntities = SG::GetArgument(argc, argv, 1, 1000000);
+
+	// Spheres spread over a square around the camera, like the culling benchmark
+	std::mt19937 generator(30);
+	std::uniform_real_distribution<float> position(-400.0f, 400.0f);
+	std::uniform_real_distribution<float> size(0.5f, 8.0f);
+	SG::SGEntityBounds bounds;
+	std::vector<SG::SGGraphicalEntityID> entities;
+
+	for (size_t i = 0; i < nrOfEntities; ++i)
+	{
+		SG::SGGraphicalEntityID entity = static_cast<SG::SGGraphicalEntityID>(i);
+		bounds.AddEntity();
+		bounds.SetSphere(entity, position(generator), position(generator) * 0.1f, position(generator), size(generator));
+		entities.push_back(entity);
+	}
+
+	SG::SGLODThresholds thresholds;
+	thresholds.screenSizes = { 0.2f, 0.05f, 0.01f, 0.0f };
+	SG::SGLODCamera camera;
+	camera.projectionScale = 1.5f;
+	std::vector<float> sizes(nrOfEntities);
+	std::vector<unsigned int> levels(nrOfEntities, static_cast<unsigned int>(thresholds.screenSizes.size()));
+	size_t nrOfChanged = 0;
+
+	// The camera moves forward every frame so some entities cross a threshold, like in a walkthrough
+	auto moveCamera = [&]()
+	{
+		camera.position[2] += 0.5f;
+	};
+
+	auto selectLevels = [&]()
+	{
+		nrOfChanged = 0;
+
+		for (size_t i = 0; i < nrOfEntities; ++i)
+		{
+			unsigned int level = SG::SelectLODLevel(thresholds, levels[i], sizes[i]);
+			nrOfChanged += level != levels[i] ? 1 : 0;
+			levels[i] = level;
+		}
+	};
+
+	std::printf("Selecting LOD levels of %zu entities with %zu levels\n", nrOfEntities, thresholds.screenSizes.size());
+	std::printf("%-16s %12s %14s %10s\n", "step", "ms/frame", "Mentities/s", "changed");
+
+	auto report = [&](const char* step, double milliseconds)
+	{
+		std::printf("%-16s %12.3f %14.1f %10zu\n", step, milliseconds, nrOfEntities / milliseconds / 1000.0, nrOfChanged);
+	};
+
+	// One entity at a time only uses the scalar remainder
+	report("sizes scalar", SG::MeasureMilliseconds(10, [&]()
+	{
+		moveCamera();
+
+		for (size_t i = 0; i < nrOfEntities; ++i)
+			SG::ComputeScreenSizes(bounds, camera, &entities[i], 1, &sizes[i]);
+	}));
+
+	report("sizes sse", SG::MeasureMilliseconds(10, [&]()
+	{
+		moveCamera();
+		SG::ComputeScreenSizes(bounds, camera, entities.data(), nrOfEntities, sizes.data());
+	}));
+
+	report("sizes and select", SG::MeasureMilliseconds(10, [&]()
+	{
+		moveCamera();
+		SG::ComputeScreenSizes(bounds, camera, entities.data(), nrOfEntities, sizes.data());
+		selectLevels();
+	}));
+
+	return 0;
+}
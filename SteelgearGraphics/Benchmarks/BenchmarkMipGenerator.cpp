@@ -0,0 +1,116 @@
+#include "SGBenchmark.h"
+#include "SGMipGenerator.h"
+
+#include <random>
+#include <thread>
+
+namespace
+{
+	// Plain 2x2 box filter on the bytes, the chain a caller without a generator would make for linear 2D textures
+	void GenerateBoxMipsScalar(const SG::SGMipImage& source, std::vector<SG::SGMipImage>& mips)
+	{
+		mips.resize(1);
+		mips[0] = source;
+
+		while (mips.back().width > 1 || mips.back().height > 1)
+		{
+			const SG::SGMipImage& previous = mips.back();
+			SG::SGMipImage mip;
+			mip.width = std::max(1u, previous.width / 2);
+			mip.height = std::max(1u, previous.height / 2);
+			mip.texels.resize(static_cast<size_t>(mip.width) * mip.height * 4);
+
+			for (unsigned int y = 0; y < mip.height; ++y)
+			{
+				unsigned int y0 = std::min(y * 2, previous.height - 1);
+				unsigned int y1 = std::min(y * 2 + 1, previous.height - 1);
+
+				for (unsigned int x = 0; x < mip.width; ++x)
+				{
+					unsigned int x0 = std::min(x * 2, previous.width - 1);
+					unsigned int x1 = std::min(x * 2 + 1, previous.width - 1);
+
+					for (unsigned int c = 0; c < 4; ++c)
+					{
+						unsigned int sum = previous.texels[(y0 * previous.width + x0) * 4 + c] + previous.texels[(y0 * previous.width + x1) * 4 + c] +
+							previous.texels[(y1 * previous.width + x0) * 4 + c] + previous.texels[(y1 * previous.width + x1) * 4 + c];
+						mip.texels[(y * mip.width + x) * 4 + c] = static_cast<unsigned char>((sum + 2) / 4);
+					}
+				}
+			}
+
+			mips.push_back(std::move(mip));
+		}
+	}
+
+	SG::SGMipImage CreateImage(unsigned int width, unsigned int height, unsigned int depth)
+	{
+		std::mt19937 generator(47);
+		std::uniform_int_distribution<int> noise(0, 255);
+		SG::SGMipImage image;
+		image.width = width;
+		image.height = height;
+		image.depth = depth;
+		image.texels.resize(static_cast<size_t>(width) * height * depth * 4);
+
+		for (auto& texel : image.texels)
+			texel = static_cast<unsigned char>(noise(generator));
+
+		return image;
+	}
+}
+
+int main(int argc, char** argv)
+{
+	unsigned int size = static_cast<unsigned int>(SG::GetArgument(argc, argv, 1, 2048));
+	unsigned int volumeSize = static_cast<unsigned int>(SG::GetArgument(argc, argv, 2, 128));
+	size_t nrOfThreads = SG::GetArgument(argc, argv, 3, std::max(1u, std::thread::hardware_concurrency()));
+
+	SG::SGThreadPool threadPool(static_cast<int>(nrOfThreads > 1 ? nrOfThreads - 1 : 1));
+	std::vector<SG::SGThreadPool*> pools = { nullptr };
+	if (nrOfThreads > 1)
+		pools.push_back(&threadPool);
+
+	SG::SGMipImage image = CreateImage(size, size, 1);
+	SG::SGMipImage volume = CreateImage(volumeSize, volumeSize, volumeSize);
+	std::vector<SG::SGMipImage> mips;
+
+	std::printf("Full mip chains of a %ux%u texture and a %u^3 volume, %zu threads\n", size, size, volumeSize, nrOfThreads);
+	std::printf("%-8s %-8s %-5s %-6s %-8s %12s %12s\n", "image", "filter", "srgb", "alpha", "threads", "ms", "Mtexels/s");
+
+	auto report = [](const char* name, const char* filter, bool srgb, bool alpha, size_t threads, const SG::SGMipImage& source, double milliseconds)
+	{
+		double texels = static_cast<double>(source.width) * source.height * source.depth;
+		std::printf("%-8s %-8s %-5s %-6s %-8zu %12.3f %12.1f\n", name, filter, srgb ? "yes" : "no", alpha ? "yes" : "no", threads,
+			milliseconds, texels / milliseconds / 1000.0);
+	};
+
+	report("2D", "scalar", false, false, 1, image, SG::MeasureMilliseconds(5, [&]() { GenerateBoxMipsScalar(image, mips); }));
+
+	const std::pair<SG::SGMipFilter, const char*> filters[] =
+	{
+		{ SG::SGMipFilter::BOX, "box" }, { SG::SGMipFilter::KAISER, "kaiser" }, { SG::SGMipFilter::LANCZOS, "lanczos" }
+	};
+
+	for (const SG::SGMipImage* source : { &image, &volume })
+	{
+		for (auto& filter : filters)
+		{
+			for (int variant = 0; variant < 3; ++variant)
+			{
+				SG::SGMipSettings settings;
+				settings.filter = filter.first;
+				settings.srgb = variant >= 1;
+				settings.alphaReference = variant == 2 ? 0.5f : -1.0f;
+
+				for (SG::SGThreadPool* pool : pools)
+				{
+					double milliseconds = SG::MeasureMilliseconds(5, [&]() { SG::GenerateMips(*source, settings, mips, pool); });
+					report(source == &image ? "2D" : "3D", filter.second, settings.srgb, variant == 2, pool ? nrOfThreads : 1, *source, milliseconds);
+				}
+			}
+		}
+	}
+
+	return 0;
+}
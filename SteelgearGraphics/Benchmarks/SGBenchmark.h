@@ -0,0 +1,35 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+// Every benchmark is an executable of its own that prints its results, the sizes can be given on the command line
+namespace SG
+{
+	/** Calls function once to warm up and then repetitions times, returns the median time of a call in milliseconds */
+	template<class Function>
+	double MeasureMilliseconds(unsigned int repetitions, const Function& function)
+	{
+		std::vector<double> times;
+		function();
+
+		for (unsigned int i = 0; i < repetitions; ++i)
+		{
+			auto start = std::chrono::steady_clock::now();
+			function();
+			times.push_back(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+		}
+
+		std::sort(times.begin(), times.end());
+		return times[times.size() / 2];
+	}
+
+	// Returns the argument at index as a number, or defaultValue if it was not given
+	inline size_t GetArgument(int argc, char** argv, int index, size_t defaultValue)
+	{
+		return index < argc ? static_cast<size_t>(std::strtoull(argv[index], nullptr, 10)) : defaultValue;
+	}
+}
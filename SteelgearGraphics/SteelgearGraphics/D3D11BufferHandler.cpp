@@ -1,42 +1,51 @@
 #include "D3D11BufferHandler.h"
+#include "D3D11Capture.h"
 
 SG::SGResult SG::D3D11BufferHandler::BindBufferToEntity(const SGGraphicalEntityID & entity, const SGGuid & bufferGuid, const SGGuid & bindGuid)
 {
+	SGCaptureScope capture(SGCaptureCall::BIND_BUFFER_TO_ENTITY, entity, bufferGuid, bindGuid);
 	return SG::SGGraphicsHandler::BindElementToEntity(entity, bufferGuid, bindGuid, buffers);
 }
 
 SG::SGResult SG::D3D11BufferHandler::BindBufferToGroup(const SGGuid & group, const SGGuid & bufferGuid, const SGGuid & bindGuid)
 {
+	SGCaptureScope capture(SGCaptureCall::BIND_BUFFER_TO_GROUP, group, bufferGuid, bindGuid);
 	return SG::SGGraphicsHandler::BindElementToGroup(group, bufferGuid, bindGuid, buffers);
 }
 
 SG::SGResult SG::D3D11BufferHandler::BindOffsetToEntity(const SGGraphicalEntityID & entity, const SGGuid & offsetGuid, const SGGuid & bindGuid)
 {
+	SGCaptureScope capture(SGCaptureCall::BIND_OFFSET_TO_ENTITY, entity, offsetGuid, bindGuid);
 	return SG::SGGraphicsHandler::BindElementToEntity(entity, offsetGuid, bindGuid, bufferOffsets);
 }
 
 SG::SGResult SG::D3D11BufferHandler::BindOffsetToGroup(const SGGuid & group, const SGGuid & offsetGuid, const SGGuid & bindGuid)
 {
+	SGCaptureScope capture(SGCaptureCall::BIND_OFFSET_TO_GROUP, group, offsetGuid, bindGuid);
 	return SG::SGGraphicsHandler::BindElementToGroup(group, offsetGuid, bindGuid, bufferOffsets);
 }
 
 SG::SGResult SG::D3D11BufferHandler::BindStrideToEntity(const SGGraphicalEntityID & entity, const SGGuid & strideGuid, const SGGuid & bindGuid)
 {
+	SGCaptureScope capture(SGCaptureCall::BIND_STRIDE_TO_ENTITY, entity, strideGuid, bindGuid);
 	return SG::SGGraphicsHandler::BindElementToEntity(entity, strideGuid, bindGuid, bufferStrides);
 }
 
 SG::SGResult SG::D3D11BufferHandler::BindStrideToGroup(const SGGuid & group, const SGGuid & strideGuid, const SGGuid & bindGuid)
 {
+	SGCaptureScope capture(SGCaptureCall::BIND_STRIDE_TO_GROUP, group, strideGuid, bindGuid);
 	return SG::SGGraphicsHandler::BindElementToGroup(group, strideGuid, bindGuid, bufferStrides);
 }
 
 SG::SGResult SG::D3D11BufferHandler::BindViewToEntity(const SGGraphicalEntityID & entity, const SGGuid & viewGuid, const SGGuid & bindGuid)
 {
+	SGCaptureScope capture(SGCaptureCall::BIND_BUFFER_VIEW_TO_ENTITY, entity, viewGuid, bindGuid);
 	return SG::SGGraphicsHandler::BindElementToEntity(entity, viewGuid, bindGuid, views);
 }
 
 SG::SGResult SG::D3D11BufferHandler::BindViewToGroup(const SGGuid & group, const SGGuid & viewGuid, const SGGuid & bindGuid)
 {
+	SGCaptureScope capture(SGCaptureCall::BIND_BUFFER_VIEW_TO_GROUP, group, viewGuid, bindGuid);
 	return SG::SGGraphicsHandler::BindElementToGroup(group, viewGuid, bindGuid, views);
 }
 
@@ -44,6 +53,7 @@ void SG::D3D11BufferHandler::UpdateBuffer(const SGGuid & guid, const UpdateStrat
 {
 	D3D11BufferData& temp = buffers.GetElement(guid);
 	auto& ToUpdate = temp.updatedData.GetToUpdate();
+	SGCaptureScope capture(SGCaptureCall::UPDATE_BUFFER, guid, updateStrategy, SGCaptureBytes{ data, ToUpdate.size }, subresource);
 	memcpy(ToUpdate.data, data, ToUpdate.size);
 	ToUpdate.strategy = updateStrategy;
 	ToUpdate.subresource = subresource;
@@ -56,6 +66,8 @@ void SG::D3D11BufferHandler::UpdateBuffer(const SGGuid & guid, const UpdateStrat
 
 void SG::D3D11BufferHandler::FinishFrame()
 {
+	SGTraceScope scope("D3D11BufferHandler::FinishFrame");
+
 	// No need to lock since this function is called only by the render engine during certain conditions
 	SGGraphicsHandler::FinishFrame();
 
@@ -73,13 +85,17 @@ void SG::D3D11BufferHandler::FinishFrame()
 
 void SG::D3D11BufferHandler::SwapFrame()
 {
+	SGTraceScope scope("D3D11BufferHandler::SwapFrame");
+
 	// No need to lock since this function is called only by the render engine during certain conditions
 	SGGraphicsHandler::SwapFrame();
 
-	buffers.UpdateActive();
-	views.UpdateActive();
-	bufferOffsets.UpdateActive();
-	bufferStrides.UpdateActive();
+	changedViews.clear();
+	size_t nrOfOperations = buffers.UpdateActive();
+	nrOfOperations += views.UpdateActive(&changedViews);
+	nrOfOperations += bufferOffsets.UpdateActive();
+	nrOfOperations += bufferStrides.UpdateActive();
+	SGProfiler::Count(SGCounter::FRAME_MAP_OPERATIONS, nrOfOperations);
 
 	for (auto& guid : updatedTotalBuffer)
 		buffers[guid].updatedData.SwitchActiveBuffer();
@@ -93,6 +109,8 @@ void SG::D3D11BufferHandler::UpdateBufferGPU(D3D11BufferData & toUpdate, ID3D11D
 	ZeroMemory(&mappedResource, sizeof(D3D11_MAPPED_SUBRESOURCE));
 	UpdateData& uData = toUpdate.updatedData.GetActive();
 	D3D11_MAP mapStrategy = (uData.strategy == UpdateStrategy::DISCARD ? D3D11_MAP_WRITE_DISCARD : D3D11_MAP_WRITE_NO_OVERWRITE);
+	SGProfiler::Count(SGCounter::MAPS);
+	SGProfiler::Count(SGCounter::BYTES_UPLOADED, uData.size);
 	context->Map(toUpdate.buffer, uData.subresource, mapStrategy, 0, &mappedResource);
 	memcpy(mappedResource.pData, uData.data, uData.size);
 	context->Unmap(toUpdate.buffer, uData.subresource);
@@ -129,39 +147,39 @@ ID3D11Buffer * SG::D3D11BufferHandler::GetBuffer(const SGGuid & guid, ID3D11Devi
 	return bData.buffer;
 }
 
-ID3D11ShaderResourceView * SG::D3D11BufferHandler::GetSRV(const SGGuid & guid)
+ID3D11ShaderResourceView * SG::D3D11BufferHandler::GetSRV(const SGGuid & guid, ID3D11Resource ** resource)
 {
-	void* toReturn = SG::D3D11GraphicsHandler::GetGlobalResourceView(guid, ResourceViewType::SRV, views, "buffer");
+	void* toReturn = SG::D3D11GraphicsHandler::GetGlobalResourceView(guid, ResourceViewType::SRV, views, "buffer", resource);
 	return static_cast<ID3D11ShaderResourceView *>(toReturn);
 }
 
-ID3D11ShaderResourceView * SG::D3D11BufferHandler::GetSRV(const SGGuid & guid, const SGGuid & groupGuid)
+ID3D11ShaderResourceView * SG::D3D11BufferHandler::GetSRV(const SGGuid & guid, const SGGuid & groupGuid, ID3D11Resource ** resource)
 {
-	void* toReturn = SG::D3D11GraphicsHandler::GetGroupResourceView(guid, groupGuid, ResourceViewType::SRV, views, "buffer");
+	void* toReturn = SG::D3D11GraphicsHandler::GetGroupResourceView(guid, groupGuid, ResourceViewType::SRV, views, "buffer", resource);
 	return static_cast<ID3D11ShaderResourceView*>(toReturn);
 }
 
-ID3D11ShaderResourceView * SG::D3D11BufferHandler::GetSRV(const SGGuid & guid, const SGGraphicalEntityID & entity)
+ID3D11ShaderResourceView * SG::D3D11BufferHandler::GetSRV(const SGGuid & guid, const SGGraphicalEntityID & entity, ID3D11Resource ** resource)
 {
-	void* toReturn = SG::D3D11GraphicsHandler::GetEntityResourceView(guid, entity, ResourceViewType::SRV, views, "buffer");
+	void* toReturn = SG::D3D11GraphicsHandler::GetEntityResourceView(guid, entity, ResourceViewType::SRV, views, "buffer", resource);
 	return static_cast<ID3D11ShaderResourceView*>(toReturn);
 }
 
-ID3D11UnorderedAccessView * SG::D3D11BufferHandler::GetUAV(const SGGuid & guid)
+ID3D11UnorderedAccessView * SG::D3D11BufferHandler::GetUAV(const SGGuid & guid, ID3D11Resource ** resource)
 {
-	void* toReturn = SG::D3D11GraphicsHandler::GetGlobalResourceView(guid, ResourceViewType::UAV, views, "buffer");
+	void* toReturn = SG::D3D11GraphicsHandler::GetGlobalResourceView(guid, ResourceViewType::UAV, views, "buffer", resource);
 	return static_cast<ID3D11UnorderedAccessView*>(toReturn);
 }
 
-ID3D11UnorderedAccessView * SG::D3D11BufferHandler::GetUAV(const SGGuid & guid, const SGGuid & groupGuid)
+ID3D11UnorderedAccessView * SG::D3D11BufferHandler::GetUAV(const SGGuid & guid, const SGGuid & groupGuid, ID3D11Resource ** resource)
 {
-	void* toReturn = SG::D3D11GraphicsHandler::GetGroupResourceView(guid, groupGuid, ResourceViewType::UAV, views, "buffer");
+	void* toReturn = SG::D3D11GraphicsHandler::GetGroupResourceView(guid, groupGuid, ResourceViewType::UAV, views, "buffer", resource);
 	return static_cast<ID3D11UnorderedAccessView*>(toReturn);
 }
 
-ID3D11UnorderedAccessView * SG::D3D11BufferHandler::GetUAV(const SGGuid & guid, const SGGraphicalEntityID & entity)
+ID3D11UnorderedAccessView * SG::D3D11BufferHandler::GetUAV(const SGGuid & guid, const SGGraphicalEntityID & entity, ID3D11Resource ** resource)
 {
-	void* toReturn = SG::D3D11GraphicsHandler::GetEntityResourceView(guid, entity, ResourceViewType::UAV, views, "buffer");
+	void* toReturn = SG::D3D11GraphicsHandler::GetEntityResourceView(guid, entity, ResourceViewType::UAV, views, "buffer", resource);
 	return static_cast<ID3D11UnorderedAccessView*>(toReturn);
 }
 
@@ -279,14 +297,16 @@ UINT SG::D3D11BufferHandler::GetVBElementSize(const SGGuid & guid, const SGGraph
 	}
 }
 
-SG::D3D11BufferHandler::D3D11BufferHandler(ID3D11Device * device)
+SG::D3D11BufferHandler::D3D11BufferHandler(ID3D11Device * device, SGLoadQueue* loadQueue)
 {
 	this->device = device;
+	this->loadQueue = loadQueue;
 }
 
 SG::SGResult SG::D3D11BufferHandler::CreateVertexBuffer(const SGGuid & guid, UINT size, UINT nrOfVertices,
 	bool dynamic, bool streamOut, const void* const data)
 {
+	SGCaptureScope capture(SGCaptureCall::CREATE_VERTEX_BUFFER, guid, size, nrOfVertices, dynamic, streamOut, SGCaptureBytes{ data, size });
 	D3D11_BUFFER_DESC desc;
 	ZeroMemory(&desc, sizeof(desc));
 	desc.ByteWidth = size;
@@ -336,8 +356,20 @@ SG::SGResult SG::D3D11BufferHandler::CreateVertexBuffer(const SGGuid & guid, UIN
 	return SGResult::OK;
 }
 
+SG::SGResult SG::D3D11BufferHandler::CreateVertexBufferAsync(const SGGuid & guid, UINT size, UINT nrOfVertices,
+	bool dynamic, bool streamOut, const void* const data, const SGLoadCallback & onComplete)
+{
+	loadQueue->Enqueue(guid, size, [=]()
+	{
+		return CreateVertexBuffer(guid, size, nrOfVertices, dynamic, streamOut, data);
+	}, onComplete);
+
+	return SGResult::OK;
+}
+
 SG::SGResult SG::D3D11BufferHandler::CreateIndexBuffer(const SGGuid & guid, UINT size, UINT nrOfIndices, bool dynamic, const void* const data)
 {
+	SGCaptureScope capture(SGCaptureCall::CREATE_INDEX_BUFFER, guid, size, nrOfIndices, dynamic, SGCaptureBytes{ data, size });
 	D3D11_BUFFER_DESC desc;
 	ZeroMemory(&desc, sizeof(desc));
 	desc.ByteWidth = size;
@@ -374,6 +406,7 @@ SG::SGResult SG::D3D11BufferHandler::CreateIndexBuffer(const SGGuid & guid, UINT
 
 SG::SGResult SG::D3D11BufferHandler::CreateConstantBuffer(const SGGuid & guid, UINT size, bool dynamic, bool cpuUpdate, const void* const data)
 {
+	SGCaptureScope capture(SGCaptureCall::CREATE_CONSTANT_BUFFER, guid, size, dynamic, cpuUpdate, SGCaptureBytes{ data, size });
 	D3D11_BUFFER_DESC desc;
 	ZeroMemory(&desc, sizeof(desc));
 	desc.ByteWidth = size;
@@ -414,33 +447,39 @@ SG::SGResult SG::D3D11BufferHandler::CreateConstantBuffer(const SGGuid & guid, U
 
 void SG::D3D11BufferHandler::RemoveBuffer(const SGGuid& guid)
 {
+	SGCaptureScope capture(SGCaptureCall::REMOVE_BUFFER, guid);
 	buffers.RemoveElement(guid);
 }
 
 SG::SGResult SG::D3D11BufferHandler::CreateBufferOffset(const SGGuid & guid, UINT value)
 {
+	SGCaptureScope capture(SGCaptureCall::CREATE_BUFFER_OFFSET, guid, value);
 	bufferOffsets.AddElement(guid, std::move(value));
 	return SGResult::OK;
 }
 
 void SG::D3D11BufferHandler::RemoveBufferOffset(const SGGuid& guid)
 {
+	SGCaptureScope capture(SGCaptureCall::REMOVE_BUFFER_OFFSET, guid);
 	bufferOffsets.RemoveElement(guid);
 }
 
 SG::SGResult SG::D3D11BufferHandler::CreateBufferStride(const SGGuid & guid, UINT value)
 {
+	SGCaptureScope capture(SGCaptureCall::CREATE_BUFFER_STRIDE, guid, value);
 	bufferStrides.AddElement(guid, std::move(value));
 	return SGResult::OK;
 }
 
 void SG::D3D11BufferHandler::RemoveBufferStride(const SGGuid& guid)
 {
+	SGCaptureScope capture(SGCaptureCall::REMOVE_BUFFER_STRIDE, guid);
 	bufferStrides.RemoveElement(guid);
 }
 
 SG::SGResult SG::D3D11BufferHandler::CreateSRV(const SGGuid & guid, const SGGuid & bufferGuid, DXGI_FORMAT format, UINT elementOffset, UINT elementWidth)
 {
+	SGCaptureScope capture(SGCaptureCall::CREATE_BUFFER_SRV, guid, bufferGuid, format, elementOffset, elementWidth);
 	if constexpr (DEBUG_VERSION)
 	{
 		if (!buffers.Exists(bufferGuid))
@@ -460,6 +499,7 @@ SG::SGResult SG::D3D11BufferHandler::CreateSRV(const SGGuid & guid, const SGGuid
 		return SGResult::FAIL;
 
 	toStore.resourceGuid = bufferGuid;
+	toStore.resource = buffer;
 	toStore.type = SG::ResourceViewType::SRV;
 	views.AddElement(guid, std::move(toStore));
 
@@ -468,6 +508,7 @@ SG::SGResult SG::D3D11BufferHandler::CreateSRV(const SGGuid & guid, const SGGuid
 
 SG::SGResult SG::D3D11BufferHandler::CreateUAV(const SGGuid & guid, const SGGuid & bufferGuid, DXGI_FORMAT format, UINT firstElement, UINT numberOfElements, bool counter, bool append, bool raw)
 {
+	SGCaptureScope capture(SGCaptureCall::CREATE_BUFFER_UAV, guid, bufferGuid, format, firstElement, numberOfElements, counter, append, raw);
 	if constexpr (DEBUG_VERSION)
 	{
 		if (!buffers.Exists(bufferGuid))
@@ -488,6 +529,7 @@ SG::SGResult SG::D3D11BufferHandler::CreateUAV(const SGGuid & guid, const SGGuid
 		return SGResult::FAIL;
 
 	toStore.resourceGuid = bufferGuid;
+	toStore.resource = buffer;
 	toStore.type = SG::ResourceViewType::UAV;
 	views.AddElement(guid, std::move(toStore));
 
@@ -496,5 +538,6 @@ SG::SGResult SG::D3D11BufferHandler::CreateUAV(const SGGuid & guid, const SGGuid
 
 void SG::D3D11BufferHandler::RemoveView(const SGGuid& guid)
 {
+	SGCaptureScope capture(SGCaptureCall::REMOVE_BUFFER_VIEW, guid);
 	views.RemoveElement(guid);
 }
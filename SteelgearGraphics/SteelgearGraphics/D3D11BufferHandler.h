@@ -11,10 +11,15 @@ namespace SG
 	{
 	public:
 
-		D3D11BufferHandler(ID3D11Device* device);
+		D3D11BufferHandler(ID3D11Device* device, SGLoadQueue* loadQueue);
 		~D3D11BufferHandler() = default;
 
 		SGResult CreateVertexBuffer(const SGGuid& guid, UINT size, UINT nrOfVertices, bool dynamic, bool streamOut, const void* const data);
+		/**
+			Created on a loader thread, data has to stay valid until onComplete is called
+		*/
+		SGResult CreateVertexBufferAsync(const SGGuid& guid, UINT size, UINT nrOfVertices, bool dynamic, bool streamOut, const void* const data,
+			const SGLoadCallback& onComplete = nullptr);
 		SGResult CreateIndexBuffer(const SGGuid& guid, UINT size, UINT nrOfIndices, bool dynamic, const void* const data);
 		SGResult CreateConstantBuffer(const SGGuid& guid, UINT size, bool dynamic, bool cpuUpdate, const void * const data);
 		SGResult CreateStructuredBuffer(const SGGuid& guid, UINT count, UINT structSize, bool cpuWritable, bool gpuWritable, void* data);
@@ -57,9 +62,11 @@ namespace SG
 	private:
 
 		friend class D3D11RenderEngine;
+		friend class D3D11Readback;
 
 		FrameMap<SGGuid, D3D11BufferData> buffers;
 		FrameMap<SGGuid, D3D11ResourceViewData> views;
+		std::vector<SGGuid> changedViews; // Added or removed by the last swap
 		FrameMap<SGGuid, UINT> bufferOffsets;
 		FrameMap<SGGuid, UINT> bufferStrides;
 
@@ -68,6 +75,7 @@ namespace SG
 		std::vector<SGGuid> updatedTotalBuffer;
 
 		ID3D11Device* device;
+		SGLoadQueue* loadQueue;
 
 		void FinishFrame() override;
 		void SwapFrame() override;
@@ -78,13 +86,13 @@ namespace SG
 		ID3D11Buffer* GetBuffer(const SGGuid& guid, ID3D11DeviceContext* context, const SGGuid& groupGuid);
 		ID3D11Buffer* GetBuffer(const SGGuid& guid, ID3D11DeviceContext* context, const SGGraphicalEntityID& entity);
 
-		ID3D11ShaderResourceView* GetSRV(const SGGuid& guid);
-		ID3D11ShaderResourceView* GetSRV(const SGGuid& guid, const SGGuid& groupGuid);
-		ID3D11ShaderResourceView* GetSRV(const SGGuid& guid, const SGGraphicalEntityID& entity);
+		ID3D11ShaderResourceView* GetSRV(const SGGuid& guid, ID3D11Resource** resource = nullptr);
+		ID3D11ShaderResourceView* GetSRV(const SGGuid& guid, const SGGuid& groupGuid, ID3D11Resource** resource = nullptr);
+		ID3D11ShaderResourceView* GetSRV(const SGGuid& guid, const SGGraphicalEntityID& entity, ID3D11Resource** resource = nullptr);
 
-		ID3D11UnorderedAccessView* GetUAV(const SGGuid& guid);
-		ID3D11UnorderedAccessView* GetUAV(const SGGuid& guid, const SGGuid& groupGuid);
-		ID3D11UnorderedAccessView* GetUAV(const SGGuid& guid, const SGGraphicalEntityID& entity);
+		ID3D11UnorderedAccessView* GetUAV(const SGGuid& guid, ID3D11Resource** resource = nullptr);
+		ID3D11UnorderedAccessView* GetUAV(const SGGuid& guid, const SGGuid& groupGuid, ID3D11Resource** resource = nullptr);
+		ID3D11UnorderedAccessView* GetUAV(const SGGuid& guid, const SGGraphicalEntityID& entity, ID3D11Resource** resource = nullptr);
 
 		UINT GetOffset(const SGGuid& guid);
 		UINT GetOffset(const SGGuid& guid, const SGGuid& groupGuid);
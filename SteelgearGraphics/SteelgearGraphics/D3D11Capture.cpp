@@ -0,0 +1,420 @@
+#include "D3D11Capture.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iterator>
+
+void SG::CaptureWrite(SGCaptureStream & stream, const DXGI_SAMPLE_DESC & sampleDesc)
+{
+	stream.Write(&sampleDesc, sizeof(sampleDesc));
+}
+
+void SG::CaptureRead(SGCaptureStream & stream, DXGI_SAMPLE_DESC & sampleDesc)
+{
+	stream.Read(&sampleDesc, sizeof(sampleDesc));
+}
+
+void SG::CaptureWrite(SGCaptureStream & stream, const D3D11_BOX & box)
+{
+	stream.Write(&box, sizeof(box));
+}
+
+void SG::CaptureRead(SGCaptureStream & stream, D3D11_BOX & box)
+{
+	stream.Read(&box, sizeof(box));
+}
+
+void SG::CaptureWrite(SGCaptureStream & stream, const SGCaptureTextureData & textureData)
+{
+	const SGTextureData& settings = textureData.settings;
+	CaptureWriteAll(stream, settings.mipLevels, settings.format, settings.gpuWritable, settings.cpuWritable, settings.cpuReadable,
+		settings.textureBindings, settings.generateMips, settings.resourceClamp, settings.rowPitches);
+
+	// Same layout as the texture handler expects, one subresource per mip level of every array slice
+	std::vector<SGCaptureBytes> subresources;
+
+	for (size_t i = 0; i < settings.data.size(); ++i)
+	{
+		SGSubresourcePitch pitch = GetSubresourcePitch(settings.format, textureData.width, textureData.height, textureData.depth,
+			settings.mipLevels, static_cast<UINT>(i));
+		size_t rowPitch = i < settings.rowPitches.size() ? settings.rowPitches[i] : pitch.rowPitch;
+		subresources.push_back({ settings.data[i], rowPitch * pitch.nrOfRows * pitch.depth });
+	}
+
+	CaptureWrite(stream, subresources);
+}
+
+void SG::CaptureRead(SGCaptureStream & stream, SGTextureData & textureData)
+{
+	CaptureReadAll(stream, textureData.mipLevels, textureData.format, textureData.gpuWritable, textureData.cpuWritable, textureData.cpuReadable,
+		textureData.textureBindings, textureData.generateMips, textureData.resourceClamp, textureData.rowPitches, textureData.data);
+}
+
+void SG::CaptureWrite(SGCaptureStream & stream, const SGInputElement & element)
+{
+	CaptureWriteAll(stream, element.semanticName, element.semanticIndex, element.format, element.inputSlot, element.alignedByteOffset,
+		element.instancedData, element.instanceDataStepRate);
+}
+
+void SG::CaptureRead(SGCaptureStream & stream, SGInputElement & element)
+{
+	CaptureReadAll(stream, element.semanticName, element.semanticIndex, element.format, element.inputSlot, element.alignedByteOffset,
+		element.instancedData, element.instanceDataStepRate);
+}
+
+void SG::CaptureWrite(SGCaptureStream & stream, const RenderTargetBlending & blending)
+{
+	stream.Write(&blending, sizeof(blending));
+}
+
+void SG::CaptureRead(SGCaptureStream & stream, RenderTargetBlending & blending)
+{
+	stream.Read(&blending, sizeof(blending));
+}
+
+void SG::CaptureWrite(SGCaptureStream & stream, const SGStateBlock & block)
+{
+	CaptureWriteAll(stream, block.rasterizerState, block.blendState, block.depthStencilState, block.blendData, block.depthStencilData,
+		block.topology, block.inputLayout, block.vertexShader, block.hullShader, block.domainShader, block.geometryShader, block.pixelShader);
+}
+
+void SG::CaptureRead(SGCaptureStream & stream, SGStateBlock & block)
+{
+	CaptureReadAll(stream, block.rasterizerState, block.blendState, block.depthStencilState, block.blendData, block.depthStencilData,
+		block.topology, block.inputLayout, block.vertexShader, block.hullShader, block.domainShader, block.geometryShader, block.pixelShader);
+}
+
+void SG::CaptureWrite(SGCaptureStream & stream, const PipelineComponent & component)
+{
+	CaptureWriteAll(stream, component.source, component.resourceGuid);
+}
+
+void SG::CaptureRead(SGCaptureStream & stream, PipelineComponent & component)
+{
+	CaptureReadAll(stream, component.source, component.resourceGuid);
+}
+
+void SG::CaptureWrite(SGCaptureStream & stream, const ConstantBuffer & constantBuffer)
+{
+	CaptureWrite(stream, constantBuffer.component);
+}
+
+void SG::CaptureRead(SGCaptureStream & stream, ConstantBuffer & constantBuffer)
+{
+	CaptureRead(stream, constantBuffer.component);
+}
+
+void SG::CaptureWrite(SGCaptureStream & stream, const ResourceView & view)
+{
+	CaptureWriteAll(stream, view.type, view.component);
+}
+
+void SG::CaptureRead(SGCaptureStream & stream, ResourceView & view)
+{
+	CaptureReadAll(stream, view.type, view.component);
+}
+
+void SG::CaptureWrite(SGCaptureStream & stream, const RenderShader & shader)
+{
+	CaptureWriteAll(stream, shader.shader, shader.constantBuffers, shader.shaderResourceViews, shader.samplers);
+}
+
+void SG::CaptureRead(SGCaptureStream & stream, RenderShader & shader)
+{
+	CaptureReadAll(stream, shader.shader, shader.constantBuffers, shader.shaderResourceViews, shader.samplers);
+}
+
+void SG::CaptureWrite(SGCaptureStream & stream, const SGVertexBuffer & vertexBuffer)
+{
+	CaptureWriteAll(stream, vertexBuffer.buffer, vertexBuffer.stride, vertexBuffer.offset);
+}
+
+void SG::CaptureRead(SGCaptureStream & stream, SGVertexBuffer & vertexBuffer)
+{
+	CaptureReadAll(stream, vertexBuffer.buffer, vertexBuffer.stride, vertexBuffer.offset);
+}
+
+void SG::CaptureWrite(SGCaptureStream & stream, const SGIndexBuffer & indexBuffer)
+{
+	CaptureWriteAll(stream, indexBuffer.buffer, indexBuffer.offset, indexBuffer.format);
+}
+
+void SG::CaptureRead(SGCaptureStream & stream, SGIndexBuffer & indexBuffer)
+{
+	CaptureReadAll(stream, indexBuffer.buffer, indexBuffer.offset, indexBuffer.format);
+}
+
+void SG::CaptureWrite(SGCaptureStream & stream, const SGRenderJob & job)
+{
+	CaptureWriteAll(stream, job.association, job.topology, job.inputAssembly, job.vertexBuffers, job.indexBuffer,
+		job.vertexShader, job.hullShader, job.domainShader, job.geometryShader, job.pixelShader,
+		job.rtvs, job.uavs, job.viewports, job.dsv, job.rasterizerState, job.blendState, job.stateBlock, job.drawCall);
+}
+
+void SG::CaptureRead(SGCaptureStream & stream, SGRenderJob & job)
+{
+	CaptureReadAll(stream, job.association, job.topology, job.inputAssembly, job.vertexBuffers, job.indexBuffer,
+		job.vertexShader, job.hullShader, job.domainShader, job.geometryShader, job.pixelShader,
+		job.rtvs, job.uavs, job.viewports, job.dsv, job.rasterizerState, job.blendState, job.stateBlock, job.drawCall);
+}
+
+void SG::CaptureWrite(SGCaptureStream & stream, const SGComputeJob & job)
+{
+	CaptureWriteAll(stream, job.association, job.shader, job.dispatchCall, job.constantBuffers, job.shaderResourceViews,
+		job.unorderedAccessViews, job.samplers);
+}
+
+void SG::CaptureRead(SGCaptureStream & stream, SGComputeJob & job)
+{
+	CaptureReadAll(stream, job.association, job.shader, job.dispatchCall, job.constantBuffers, job.shaderResourceViews,
+		job.unorderedAccessViews, job.samplers);
+}
+
+void SG::CaptureWrite(SGCaptureStream & stream, const SGClearRenderTargetJob & job)
+{
+	CaptureWriteAll(stream, job.toClear, job.color[0], job.color[1], job.color[2], job.color[3]);
+}
+
+void SG::CaptureRead(SGCaptureStream & stream, SGClearRenderTargetJob & job)
+{
+	CaptureReadAll(stream, job.toClear, job.color[0], job.color[1], job.color[2], job.color[3]);
+}
+
+void SG::CaptureWrite(SGCaptureStream & stream, const SGClearDepthStencilJob & job)
+{
+	CaptureWriteAll(stream, job.toClear, job.clearDepth, job.clearStencil, job.depthClearValue, job.stencilClearValue);
+}
+
+void SG::CaptureRead(SGCaptureStream & stream, SGClearDepthStencilJob & job)
+{
+	CaptureReadAll(stream, job.toClear, job.clearDepth, job.clearStencil, job.depthClearValue, job.stencilClearValue);
+}
+
+void SG::CaptureWrite(SGCaptureStream & stream, const SGTransientTexture & texture)
+{
+	CaptureWriteAll(stream, texture.guid, texture.format, texture.width, texture.height, texture.views);
+}
+
+void SG::CaptureRead(SGCaptureStream & stream, SGTransientTexture & texture)
+{
+	CaptureReadAll(stream, texture.guid, texture.format, texture.width, texture.height, texture.views);
+}
+
+void SG::CaptureWrite(SGCaptureStream & stream, const SGPipeline & pipeline)
+{
+	CaptureWriteAll(stream, pipeline.jobs, pipeline.transientTextures, pipeline.outputs);
+}
+
+void SG::CaptureRead(SGCaptureStream & stream, SGPipeline & pipeline)
+{
+	CaptureReadAll(stream, pipeline.jobs, pipeline.transientTextures, pipeline.outputs);
+}
+
+void SG::CaptureWrite(SGCaptureStream & stream, const SGLODLevel & level)
+{
+	CaptureWriteAll(stream, level.vertexBuffer, level.indexBuffer, level.drawCall, level.levelGroup, level.screenSizeThreshold);
+}
+
+void SG::CaptureRead(SGCaptureStream & stream, SGLODLevel & level)
+{
+	CaptureReadAll(stream, level.vertexBuffer, level.indexBuffer, level.drawCall, level.levelGroup, level.screenSizeThreshold);
+}
+
+void SG::CaptureWrite(SGCaptureStream & stream, const SGLODSet & lodSet)
+{
+	CaptureWriteAll(stream, lodSet.association, lodSet.vertexBufferBindGuid, lodSet.indexBufferBindGuid, lodSet.drawCallBindGuid,
+		lodSet.levels, lodSet.hysteresis);
+}
+
+void SG::CaptureRead(SGCaptureStream & stream, SGLODSet & lodSet)
+{
+	CaptureReadAll(stream, lodSet.association, lodSet.vertexBufferBindGuid, lodSet.indexBufferBindGuid, lodSet.drawCallBindGuid,
+		lodSet.levels, lodSet.hysteresis);
+}
+
+SG::D3D11CaptureReplayer::D3D11CaptureReplayer(D3D11RenderEngine * engine)
+{
+	this->engine = engine;
+}
+
+SG::SGResult SG::D3D11CaptureReplayer::Load(const std::string & path)
+{
+	std::ifstream file(path, std::ios::binary);
+
+	if (!file.is_open())
+		return SGResult::FAIL;
+
+	capture.bytes.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+	capture.position = 0;
+	capture.readGuids.clear();
+
+	const char magic[8] = { 'S', 'G', 'C', 'A', 'P', 'T', 'U', 'R' };
+	unsigned int version[2];
+
+	if (capture.bytes.size() < sizeof(magic) + sizeof(version) || !std::equal(magic, magic + sizeof(magic), capture.bytes.begin()))
+		return SGResult::FAIL;
+
+	capture.position = sizeof(magic);
+	capture.Read(version, sizeof(version));
+
+	if (version[0] != 2)
+		return SGResult::FAIL;
+
+	return SGResult::OK;
+}
+
+bool SG::D3D11CaptureReplayer::ReplayFrame()
+{
+	// Records are a header of the call and the payload size, followed by the payload padded to the block alignment
+	while (capture.position < capture.bytes.size())
+	{
+		unsigned int header[2];
+		unsigned long long size;
+		capture.Read(header, sizeof(header));
+		capture.Read(&size, sizeof(size));
+		size_t payloadStart = capture.position;
+		SGCaptureCall call = static_cast<SGCaptureCall>(header[0]);
+
+		ReplayCall(call);
+		capture.position = payloadStart + SGCaptureStream::Aligned(static_cast<size_t>(size));
+
+		if (call == SGCaptureCall::RENDER)
+			return true;
+	}
+
+	return false;
+}
+
+void SG::D3D11CaptureReplayer::ReplayAll()
+{
+	while (ReplayFrame())
+	{
+	}
+}
+
+void SG::D3D11CaptureReplayer::ReplayCall(SGCaptureCall call)
+{
+	D3D11BufferHandler* buffers = engine->BufferHandler();
+	D3D11SamplerHandler* samplers = engine->SamplerHandler();
+	D3D11ShaderManager* shaders = engine->ShaderManager();
+	D3D11StateHandler* states = engine->StateHandler();
+	D3D11TextureHandler* textures = engine->TextureHandler();
+	D3D11PipelineManager* pipelines = engine->PipelineManager();
+	D3D11DrawCallHandler* drawCalls = engine->DrawCallHandler();
+	SGOcclusionCuller* occlusionCuller = engine->OcclusionCuller();
+
+	switch (call)
+	{
+	case SGCaptureCall::DECLARE_GUID:
+	{
+		unsigned long long id;
+		std::string identifier;
+		CaptureReadAll(capture, id, identifier);
+		capture.readGuids[static_cast<size_t>(id)] = SGGuid(identifier);
+		break;
+	}
+	case SGCaptureCall::CREATE_ENTITY: Replay(engine, &SGRenderEngine::CreateEntity); break;
+	case SGCaptureCall::SET_ENTITY_TO_GROUP: Replay(engine, &SGRenderEngine::SetEntityToGroup); break;
+	case SGCaptureCall::SET_ENTITY_BOUNDING_SPHERE: Replay(engine, &SGRenderEngine::SetEntityBoundingSphere); break;
+	case SGCaptureCall::SET_ENTITY_BOUNDING_BOX: Replay(engine, &SGRenderEngine::SetEntityBoundingBox); break;
+	case SGCaptureCall::SET_LOD_CAMERA: Replay(engine, &SGRenderEngine::SetLODCamera); break;
+	case SGCaptureCall::SET_ENTITY_LOD_SET: Replay(engine, &SGRenderEngine::SetEntityLODSet); break;
+	case SGCaptureCall::RENDER: Replay(engine, &SGRenderEngine::Render); break;
+	case SGCaptureCall::ADD_OCCLUDER: Replay(occlusionCuller, &SGOcclusionCuller::AddOccluder); break;
+	case SGCaptureCall::REMOVE_OCCLUDER: Replay(occlusionCuller, &SGOcclusionCuller::RemoveOccluder); break;
+	case SGCaptureCall::SET_OCCLUDER_TRANSFORM: Replay(occlusionCuller, &SGOcclusionCuller::SetOccluderTransform); break;
+	case SGCaptureCall::SET_VIEW_PROJECTION: Replay(occlusionCuller, &SGOcclusionCuller::SetViewProjection); break;
+	case SGCaptureCall::CREATE_LOD_SET: Replay(engine, &D3D11RenderEngine::CreateLODSet); break;
+	case SGCaptureCall::CREATE_VERTEX_BUFFER: Replay(buffers, &D3D11BufferHandler::CreateVertexBuffer); break;
+	case SGCaptureCall::CREATE_INDEX_BUFFER: Replay(buffers, &D3D11BufferHandler::CreateIndexBuffer); break;
+	case SGCaptureCall::CREATE_CONSTANT_BUFFER: Replay(buffers, &D3D11BufferHandler::CreateConstantBuffer); break;
+	case SGCaptureCall::REMOVE_BUFFER: Replay(buffers, &D3D11BufferHandler::RemoveBuffer); break;
+	case SGCaptureCall::CREATE_BUFFER_OFFSET: Replay(buffers, &D3D11BufferHandler::CreateBufferOffset); break;
+	case SGCaptureCall::REMOVE_BUFFER_OFFSET: Replay(buffers, &D3D11BufferHandler::RemoveBufferOffset); break;
+	case SGCaptureCall::CREATE_BUFFER_STRIDE: Replay(buffers, &D3D11BufferHandler::CreateBufferStride); break;
+	case SGCaptureCall::REMOVE_BUFFER_STRIDE: Replay(buffers, &D3D11BufferHandler::RemoveBufferStride); break;
+	case SGCaptureCall::CREATE_BUFFER_SRV: Replay(buffers, &D3D11BufferHandler::CreateSRV); break;
+	case SGCaptureCall::CREATE_BUFFER_UAV: Replay(buffers, &D3D11BufferHandler::CreateUAV); break;
+	case SGCaptureCall::REMOVE_BUFFER_VIEW: Replay(buffers, &D3D11BufferHandler::RemoveView); break;
+	case SGCaptureCall::BIND_BUFFER_TO_ENTITY: Replay(buffers, &D3D11BufferHandler::BindBufferToEntity); break;
+	case SGCaptureCall::BIND_BUFFER_TO_GROUP: Replay(buffers, &D3D11BufferHandler::BindBufferToGroup); break;
+	case SGCaptureCall::BIND_OFFSET_TO_ENTITY: Replay(buffers, &D3D11BufferHandler::BindOffsetToEntity); break;
+	case SGCaptureCall::BIND_OFFSET_TO_GROUP: Replay(buffers, &D3D11BufferHandler::BindOffsetToGroup); break;
+	case SGCaptureCall::BIND_STRIDE_TO_ENTITY: Replay(buffers, &D3D11BufferHandler::BindStrideToEntity); break;
+	case SGCaptureCall::BIND_STRIDE_TO_GROUP: Replay(buffers, &D3D11BufferHandler::BindStrideToGroup); break;
+	case SGCaptureCall::BIND_BUFFER_VIEW_TO_ENTITY: Replay(buffers, &D3D11BufferHandler::BindViewToEntity); break;
+	case SGCaptureCall::BIND_BUFFER_VIEW_TO_GROUP: Replay(buffers, &D3D11BufferHandler::BindViewToGroup); break;
+	case SGCaptureCall::UPDATE_BUFFER: Replay(buffers, &D3D11BufferHandler::UpdateBuffer); break;
+	case SGCaptureCall::CREATE_SAMPLER: Replay(samplers, &D3D11SamplerHandler::CreateSampler); break;
+	case SGCaptureCall::REMOVE_SAMPLER: Replay(samplers, &D3D11SamplerHandler::RemoveSampler); break;
+	case SGCaptureCall::BIND_SAMPLER_TO_ENTITY: Replay(samplers, &D3D11SamplerHandler::BindSamplerToEntity); break;
+	case SGCaptureCall::BIND_SAMPLER_TO_GROUP: Replay(samplers, &D3D11SamplerHandler::BindSamplerToGroup); break;
+	case SGCaptureCall::CREATE_INPUT_LAYOUT: Replay(shaders, &D3D11ShaderManager::CreateInputLayout); break;
+	case SGCaptureCall::REMOVE_INPUT_LAYOUT: Replay(shaders, &D3D11ShaderManager::RemoveInputLayout); break;
+	case SGCaptureCall::CREATE_VERTEX_SHADER: Replay(shaders, &D3D11ShaderManager::CreateVertexShader); break;
+	case SGCaptureCall::CREATE_HULL_SHADER: Replay(shaders, &D3D11ShaderManager::CreateHullShader); break;
+	case SGCaptureCall::CREATE_DOMAIN_SHADER: Replay(shaders, &D3D11ShaderManager::CreateDomainShader); break;
+	case SGCaptureCall::CREATE_GEOMETRY_SHADER: Replay(shaders, &D3D11ShaderManager::CreateGeometryShader); break;
+	case SGCaptureCall::CREATE_PIXEL_SHADER: Replay(shaders, &D3D11ShaderManager::CreatePixelShader); break;
+	case SGCaptureCall::CREATE_COMPUTE_SHADER: Replay(shaders, &D3D11ShaderManager::CreateComputeShader); break;
+	case SGCaptureCall::REMOVE_SHADER: Replay(shaders, &D3D11ShaderManager::RemoveShader); break;
+	case SGCaptureCall::CREATE_RASTERIZER_STATE: Replay(states, &D3D11StateHandler::CreateRasterizerState); break;
+	case SGCaptureCall::CREATE_DEPTH_STENCIL_STATE: Replay(states, &D3D11StateHandler::CreateDepthStencilState); break;
+	case SGCaptureCall::CREATE_BLEND_STATE: Replay(states, &D3D11StateHandler::CreateBlendState); break;
+	case SGCaptureCall::REMOVE_STATE: Replay(states, &D3D11StateHandler::RemoveState); break;
+	case SGCaptureCall::CREATE_VIEWPORT: Replay(states, &D3D11StateHandler::CreateViewport); break;
+	case SGCaptureCall::REMOVE_VIEWPORT: Replay(states, &D3D11StateHandler::RemoveViewport); break;
+	case SGCaptureCall::CREATE_DEPTH_STENCIL_DATA: Replay(states, &D3D11StateHandler::CreateDepthStencilData); break;
+	case SGCaptureCall::CREATE_BLEND_DATA: Replay(states, &D3D11StateHandler::CreateBlendData); break;
+	case SGCaptureCall::REMOVE_STATE_DATA: Replay(states, &D3D11StateHandler::RemoveStateData); break;
+	case SGCaptureCall::CREATE_STATE_BLOCK: Replay(states, &D3D11StateHandler::CreateStateBlock); break;
+	case SGCaptureCall::REMOVE_STATE_BLOCK: Replay(states, &D3D11StateHandler::RemoveStateBlock); break;
+	case SGCaptureCall::BIND_STATE_TO_ENTITY: Replay(states, &D3D11StateHandler::BindStateToEntity); break;
+	case SGCaptureCall::BIND_STATE_TO_GROUP: Replay(states, &D3D11StateHandler::BindStateToGroup); break;
+	case SGCaptureCall::BIND_STATE_BLOCK_TO_ENTITY: Replay(states, &D3D11StateHandler::BindStateBlockToEntity); break;
+	case SGCaptureCall::BIND_STATE_BLOCK_TO_GROUP: Replay(states, &D3D11StateHandler::BindStateBlockToGroup); break;
+	case SGCaptureCall::BIND_VIEWPORT_TO_ENTITY: Replay(states, &D3D11StateHandler::BindViewportToEntity); break;
+	case SGCaptureCall::BIND_VIEWPORT_TO_GROUP: Replay(states, &D3D11StateHandler::BindViewportToGroup); break;
+	case SGCaptureCall::CREATE_TEXTURE_2D: Replay(textures, &D3D11TextureHandler::CreateTexture2D); break;
+	case SGCaptureCall::REMOVE_TEXTURE: Replay(textures, &D3D11TextureHandler::RemoveTexture); break;
+	case SGCaptureCall::CREATE_TEXTURE_SRV: Replay(textures, &D3D11TextureHandler::CreateSRV); break;
+	case SGCaptureCall::CREATE_TEXTURE_SRV_ARRAY: Replay(textures, &D3D11TextureHandler::CreateSRVTextureArray); break;
+	case SGCaptureCall::CREATE_TEXTURE_UAV: Replay(textures, &D3D11TextureHandler::CreateUAV); break;
+	case SGCaptureCall::CREATE_TEXTURE_UAV_ARRAY: Replay(textures, &D3D11TextureHandler::CreateUAVTextureArray); break;
+	case SGCaptureCall::CREATE_RTV: Replay(textures, &D3D11TextureHandler::CreateRTV); break;
+	case SGCaptureCall::CREATE_RTV_ARRAY: Replay(textures, &D3D11TextureHandler::CreateRTVTextureArray); break;
+	case SGCaptureCall::CREATE_DSV: Replay(textures, &D3D11TextureHandler::CreateDSV); break;
+	case SGCaptureCall::CREATE_DSV_ARRAY: Replay(textures, &D3D11TextureHandler::CreateDSVTextureArray); break;
+	case SGCaptureCall::REMOVE_TEXTURE_VIEW: Replay(textures, &D3D11TextureHandler::RemoveView); break;
+	case SGCaptureCall::BIND_TEXTURE_VIEW_TO_ENTITY: Replay(textures, &D3D11TextureHandler::BindViewToEntity); break;
+	case SGCaptureCall::BIND_TEXTURE_VIEW_TO_GROUP: Replay(textures, &D3D11TextureHandler::BindViewToGroup); break;
+	case SGCaptureCall::CREATE_RENDER_JOB: Replay(pipelines, &D3D11PipelineManager::CreateRenderJob); break;
+	case SGCaptureCall::REMOVE_RENDER_JOB: Replay(pipelines, &D3D11PipelineManager::RemoveRenderJob); break;
+	case SGCaptureCall::CREATE_COMPUTE_JOB: Replay(pipelines, &D3D11PipelineManager::CreateComputeJob); break;
+	case SGCaptureCall::REMOVE_COMPUTE_JOB: Replay(pipelines, &D3D11PipelineManager::RemoveComputeJob); break;
+	case SGCaptureCall::CREATE_CLEAR_RENDER_TARGET_JOB: Replay(pipelines, &D3D11PipelineManager::CreateClearRenderTargetJob); break;
+	case SGCaptureCall::REMOVE_CLEAR_RENDER_TARGET_JOB: Replay(pipelines, &D3D11PipelineManager::RemoveClearRenderTargetJob); break;
+	case SGCaptureCall::CREATE_CLEAR_DEPTH_STENCIL_JOB: Replay(pipelines, &D3D11PipelineManager::CreateClearDepthStencilJob); break;
+	case SGCaptureCall::REMOVE_CLEAR_DEPTH_STENCIL_JOB: Replay(pipelines, &D3D11PipelineManager::RemoveClearDepthStencilJob); break;
+	case SGCaptureCall::CREATE_PIPELINE: Replay(pipelines, &D3D11PipelineManager::CreatePipeline); break;
+	case SGCaptureCall::REMOVE_PIPELINE: Replay(pipelines, &D3D11PipelineManager::RemovePipeline); break;
+	case SGCaptureCall::CREATE_DRAW_CALL: Replay(drawCalls, &D3D11DrawCallHandler::CreateDrawCall); break;
+	case SGCaptureCall::CREATE_DRAW_INDEXED_CALL: Replay(drawCalls, &D3D11DrawCallHandler::CreateDrawIndexedCall); break;
+	case SGCaptureCall::CREATE_DRAW_INSTANCED_CALL: Replay(drawCalls, &D3D11DrawCallHandler::CreateDrawInstancedCall); break;
+	case SGCaptureCall::CREATE_DRAW_INDEXED_INSTANCED_CALL: Replay(drawCalls, &D3D11DrawCallHandler::CreateDrawIndexedInstancedCall); break;
+	case SGCaptureCall::REMOVE_DRAW_CALL: Replay(drawCalls, &D3D11DrawCallHandler::RemoveDrawCall); break;
+	case SGCaptureCall::CREATE_DISPATCH_CALL: Replay(drawCalls, &D3D11DrawCallHandler::CreateDispatchCall); break;
+	case SGCaptureCall::CREATE_DISPATCH_INDIRECT_CALL: Replay(drawCalls, &D3D11DrawCallHandler::CreateDispatchIndirectCall); break;
+	case SGCaptureCall::REMOVE_DISPATCH_CALL: Replay(drawCalls, &D3D11DrawCallHandler::RemoveDispatchCall); break;
+	case SGCaptureCall::BIND_DRAW_CALL_TO_ENTITY: Replay(drawCalls, &D3D11DrawCallHandler::BindDrawCallToEntity); break;
+	case SGCaptureCall::BIND_DRAW_CALL_TO_GROUP: Replay(drawCalls, &D3D11DrawCallHandler::BindDrawCallToGroup); break;
+	case SGCaptureCall::BIND_DISPATCH_CALL_TO_ENTITY: Replay(drawCalls, &D3D11DrawCallHandler::BindDispatchCallToEntity); break;
+	case SGCaptureCall::BIND_DISPATCH_CALL_TO_GROUP: Replay(drawCalls, &D3D11DrawCallHandler::BindDispatchCallToGroup); break;
+	case SGCaptureCall::CREATE_TEXTURE_1D: Replay(textures, &D3D11TextureHandler::CreateTexture1D); break;
+	case SGCaptureCall::CREATE_TEXTURE_3D: Replay(textures, &D3D11TextureHandler::CreateTexture3D); break;
+	case SGCaptureCall::UPDATE_TEXTURE: Replay(textures, &D3D11TextureHandler::UpdateTexture); break;
+	case SGCaptureCall::CREATE_PLACEHOLDER_VIEW: Replay(textures, &D3D11TextureHandler::CreatePlaceholderView); break;
+	default:
+		throw std::runtime_error("Error replaying capture, unknown call");
+	}
+}
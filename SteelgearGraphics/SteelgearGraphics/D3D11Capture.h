@@ -0,0 +1,94 @@
+#pragma once
+
+#include <string>
+#include <tuple>
+#include <type_traits>
+
+#include "SGCapture.h"
+#include "D3D11RenderEngine.h"
+
+namespace SG
+{
+	// Written like an SGTextureData including the initial data, which needs the size of the texture to be known
+	struct SGCaptureTextureData
+	{
+		const SGTextureData& settings;
+		UINT width;
+		UINT height;
+		UINT arraySize;
+		UINT depth = 1;
+	};
+
+	void CaptureWrite(SGCaptureStream& stream, const DXGI_SAMPLE_DESC& sampleDesc);
+	void CaptureRead(SGCaptureStream& stream, DXGI_SAMPLE_DESC& sampleDesc);
+	void CaptureWrite(SGCaptureStream& stream, const D3D11_BOX& box);
+	void CaptureRead(SGCaptureStream& stream, D3D11_BOX& box);
+	void CaptureWrite(SGCaptureStream& stream, const SGCaptureTextureData& textureData);
+	void CaptureRead(SGCaptureStream& stream, SGTextureData& textureData);
+	void CaptureWrite(SGCaptureStream& stream, const SGInputElement& element);
+	void CaptureRead(SGCaptureStream& stream, SGInputElement& element);
+	void CaptureWrite(SGCaptureStream& stream, const RenderTargetBlending& blending);
+	void CaptureRead(SGCaptureStream& stream, RenderTargetBlending& blending);
+	void CaptureWrite(SGCaptureStream& stream, const SGStateBlock& block);
+	void CaptureRead(SGCaptureStream& stream, SGStateBlock& block);
+	void CaptureWrite(SGCaptureStream& stream, const PipelineComponent& component);
+	void CaptureRead(SGCaptureStream& stream, PipelineComponent& component);
+	void CaptureWrite(SGCaptureStream& stream, const ConstantBuffer& constantBuffer);
+	void CaptureRead(SGCaptureStream& stream, ConstantBuffer& constantBuffer);
+	void CaptureWrite(SGCaptureStream& stream, const ResourceView& view);
+	void CaptureRead(SGCaptureStream& stream, ResourceView& view);
+	void CaptureWrite(SGCaptureStream& stream, const RenderShader& shader);
+	void CaptureRead(SGCaptureStream& stream, RenderShader& shader);
+	void CaptureWrite(SGCaptureStream& stream, const SGVertexBuffer& vertexBuffer);
+	void CaptureRead(SGCaptureStream& stream, SGVertexBuffer& vertexBuffer);
+	void CaptureWrite(SGCaptureStream& stream, const SGIndexBuffer& indexBuffer);
+	void CaptureRead(SGCaptureStream& stream, SGIndexBuffer& indexBuffer);
+	void CaptureWrite(SGCaptureStream& stream, const SGRenderJob& job);
+	void CaptureRead(SGCaptureStream& stream, SGRenderJob& job);
+	void CaptureWrite(SGCaptureStream& stream, const SGComputeJob& job);
+	void CaptureRead(SGCaptureStream& stream, SGComputeJob& job);
+	void CaptureWrite(SGCaptureStream& stream, const SGClearRenderTargetJob& job);
+	void CaptureRead(SGCaptureStream& stream, SGClearRenderTargetJob& job);
+	void CaptureWrite(SGCaptureStream& stream, const SGClearDepthStencilJob& job);
+	void CaptureRead(SGCaptureStream& stream, SGClearDepthStencilJob& job);
+	void CaptureWrite(SGCaptureStream& stream, const SGTransientTexture& texture);
+	void CaptureRead(SGCaptureStream& stream, SGTransientTexture& texture);
+	void CaptureWrite(SGCaptureStream& stream, const SGPipeline& pipeline);
+	void CaptureRead(SGCaptureStream& stream, SGPipeline& pipeline);
+	void CaptureWrite(SGCaptureStream& stream, const SGLODLevel& level);
+	void CaptureRead(SGCaptureStream& stream, SGLODLevel& level);
+	void CaptureWrite(SGCaptureStream& stream, const SGLODSet& lodSet);
+	void CaptureRead(SGCaptureStream& stream, SGLODSet& lodSet);
+
+	/** Replays a capture against a render engine that was created for it and has not been used yet, entities are
+	recreated in the captured order so they get the same ids. The whole capture is loaded before it is replayed,
+	so replaying only costs the calls themselves */
+	class D3D11CaptureReplayer
+	{
+	public:
+		D3D11CaptureReplayer(D3D11RenderEngine* engine);
+		~D3D11CaptureReplayer() = default;
+
+		SGResult Load(const std::string& path);
+		bool ReplayFrame(); // Replays the calls up to and including the next Render, false once the capture is exhausted
+		void ReplayAll();
+
+	private:
+		D3D11RenderEngine* engine;
+		SGCaptureStream capture;
+
+		void ReplayCall(SGCaptureCall call);
+
+		template<typename Object, typename Handler, typename Result, typename... Parameters>
+		void Replay(Object* object, Result(Handler::*method)(Parameters...));
+	};
+
+	template<typename Object, typename Handler, typename Result, typename... Parameters>
+	inline void D3D11CaptureReplayer::Replay(Object* object, Result(Handler::*method)(Parameters...))
+	{
+		// Captured in parameter order, pointers are read as pointers into the capture
+		std::tuple<std::decay_t<Parameters>...> arguments;
+		std::apply([this](auto&... toRead) { CaptureReadAll(capture, toRead...); }, arguments);
+		std::apply([object, method](auto&... toPass) { (object->*method)(toPass...); }, arguments);
+	}
+}
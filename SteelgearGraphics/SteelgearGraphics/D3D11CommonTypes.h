@@ -8,6 +8,7 @@
 
 #include "SGGuid.h"
 #include "D3D11ResourceViewData.h"
+#include "D3D11FormatInfo.h"
 
 namespace SG
 {
@@ -113,8 +114,4 @@ namespace SG
 			comObject = nullptr;
 		}
 	}
-
-	//https://stackoverflow.com/questions/40339138/convert-dxgi-format-to-a-bpp
-	int GetFormatElementSize(DXGI_FORMAT format);
-
 }
\ No newline at end of file
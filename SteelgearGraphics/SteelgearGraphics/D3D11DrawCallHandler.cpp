@@ -1,4 +1,5 @@
 #include "D3D11DrawCallHandler.h"
+#include "D3D11Capture.h"
 
 SG::D3D11DrawCallHandler::D3D11DrawCallHandler(ID3D11Device * device)
 {
@@ -7,6 +8,7 @@ SG::D3D11DrawCallHandler::D3D11DrawCallHandler(ID3D11Device * device)
 
 SG::SGResult SG::D3D11DrawCallHandler::CreateDrawCall(const SGGuid & guid, UINT vertexCount, UINT startVertexLocation)
 {
+	SGCaptureScope capture(SGCaptureCall::CREATE_DRAW_CALL, guid, vertexCount, startVertexLocation);
 	DrawCall toStore;
 	toStore.type = DrawType::DRAW;
 	toStore.data.draw.vertexCount = vertexCount;
@@ -18,6 +20,7 @@ SG::SGResult SG::D3D11DrawCallHandler::CreateDrawCall(const SGGuid & guid, UINT
 
 SG::SGResult SG::D3D11DrawCallHandler::CreateDrawIndexedCall(const SGGuid & guid, UINT indexCount, UINT startIndexLocation, INT baseVertexLocation)
 {
+	SGCaptureScope capture(SGCaptureCall::CREATE_DRAW_INDEXED_CALL, guid, indexCount, startIndexLocation, baseVertexLocation);
 	DrawCall toStore;
 	toStore.type = DrawType::DRAW_INDEXED;
 	toStore.data.drawIndexed.indexCount = indexCount;
@@ -30,6 +33,7 @@ SG::SGResult SG::D3D11DrawCallHandler::CreateDrawIndexedCall(const SGGuid & guid
 
 SG::SGResult SG::D3D11DrawCallHandler::CreateDrawInstancedCall(const SGGuid & guid, UINT vertexCountPerInstance, UINT instanceCount, UINT startVertexLocation, UINT startInstanceLocation)
 {
+	SGCaptureScope capture(SGCaptureCall::CREATE_DRAW_INSTANCED_CALL, guid, vertexCountPerInstance, instanceCount, startVertexLocation, startInstanceLocation);
 	DrawCall toStore;
 	toStore.type = DrawType::DRAW_INSTANCED;
 	toStore.data.drawInstanced.vertexCountPerInstance = vertexCountPerInstance;
@@ -43,6 +47,7 @@ SG::SGResult SG::D3D11DrawCallHandler::CreateDrawInstancedCall(const SGGuid & gu
 
 SG::SGResult SG::D3D11DrawCallHandler::CreateDrawIndexedInstancedCall(const SGGuid & guid, UINT indexCountPerInstance, UINT instanceCount, UINT startIndexLocation, INT baseVertexLocation, UINT startInstanceLocation)
 {
+	SGCaptureScope capture(SGCaptureCall::CREATE_DRAW_INDEXED_INSTANCED_CALL, guid, indexCountPerInstance, instanceCount, startIndexLocation, baseVertexLocation, startInstanceLocation);
 	DrawCall toStore;
 	toStore.type = DrawType::DRAW_INDEXED_INSTANCED;
 	toStore.data.drawIndexedInstanced.indexCountPerInstance = indexCountPerInstance;
@@ -57,11 +62,13 @@ SG::SGResult SG::D3D11DrawCallHandler::CreateDrawIndexedInstancedCall(const SGGu
 
 void SG::D3D11DrawCallHandler::RemoveDrawCall(const SGGuid& guid)
 {
+	SGCaptureScope capture(SGCaptureCall::REMOVE_DRAW_CALL, guid);
 	drawCalls.RemoveElement(guid);
 }
 
 SG::SGResult SG::D3D11DrawCallHandler::CreateDispatchCall(const SGGuid & guid, UINT threadGroupCountX, UINT threadGroupCountY, UINT threadGroupCountZ)
 {
+	SGCaptureScope capture(SGCaptureCall::CREATE_DISPATCH_CALL, guid, threadGroupCountX, threadGroupCountY, threadGroupCountZ);
 	DispatchCall toStore;
 	toStore.indirect = false;
 	toStore.data.dispatch.threadGroupCountX = threadGroupCountX;
@@ -74,6 +81,7 @@ SG::SGResult SG::D3D11DrawCallHandler::CreateDispatchCall(const SGGuid & guid, U
 
 SG::SGResult SG::D3D11DrawCallHandler::CreateDispatchIndirectCall(const SGGuid & guid, const SGGuid & bufferGuid, UINT alignedByteOffsetForArgs)
 {
+	SGCaptureScope capture(SGCaptureCall::CREATE_DISPATCH_INDIRECT_CALL, guid, bufferGuid, alignedByteOffsetForArgs);
 	DispatchCall toStore;
 	toStore.indirect = true;
 	toStore.data.dispatchIndirect.bufferForArgs = bufferGuid;
@@ -85,31 +93,38 @@ SG::SGResult SG::D3D11DrawCallHandler::CreateDispatchIndirectCall(const SGGuid &
 
 void SG::D3D11DrawCallHandler::RemoveDispatchCall(const SGGuid& guid)
 {
+	SGCaptureScope capture(SGCaptureCall::REMOVE_DISPATCH_CALL, guid);
 	dispatchCalls.RemoveElement(guid);
 }
 
 SG::SGResult SG::D3D11DrawCallHandler::BindDrawCallToEntity(const SGGraphicalEntityID & entity, const SGGuid & callGuid, const SGGuid & bindGuid)
 {
+	SGCaptureScope capture(SGCaptureCall::BIND_DRAW_CALL_TO_ENTITY, entity, callGuid, bindGuid);
 	return SG::SGGraphicsHandler::BindElementToEntity(entity, callGuid, bindGuid, drawCalls);
 }
 
 SG::SGResult SG::D3D11DrawCallHandler::BindDrawCallToGroup(const SGGuid & group, const SGGuid & callGuid, const SGGuid & bindGuid)
 {
+	SGCaptureScope capture(SGCaptureCall::BIND_DRAW_CALL_TO_GROUP, group, callGuid, bindGuid);
 	return SG::SGGraphicsHandler::BindElementToGroup(group, callGuid, bindGuid, drawCalls);
 }
 
 SG::SGResult SG::D3D11DrawCallHandler::BindDispatchCallToEntity(const SGGraphicalEntityID & entity, const SGGuid & callGuid, const SGGuid & bindGuid)
 {
+	SGCaptureScope capture(SGCaptureCall::BIND_DISPATCH_CALL_TO_ENTITY, entity, callGuid, bindGuid);
 	return SG::SGGraphicsHandler::BindElementToEntity(entity, callGuid, bindGuid, dispatchCalls);
 }
 
 SG::SGResult SG::D3D11DrawCallHandler::BindDispatchCallToGroup(const SGGuid & group, const SGGuid & callGuid, const SGGuid & bindGuid)
 {
+	SGCaptureScope capture(SGCaptureCall::BIND_DISPATCH_CALL_TO_GROUP, group, callGuid, bindGuid);
 	return SG::SGGraphicsHandler::BindElementToGroup(group, callGuid, bindGuid, dispatchCalls);
 }
 
 void SG::D3D11DrawCallHandler::FinishFrame()
 {
+	SGTraceScope scope("D3D11DrawCallHandler::FinishFrame");
+
 	SG::SGGraphicsHandler::FinishFrame();
 
 	drawCalls.FinishFrame();
@@ -118,10 +133,13 @@ void SG::D3D11DrawCallHandler::FinishFrame()
 
 void SG::D3D11DrawCallHandler::SwapFrame()
 {
+	SGTraceScope scope("D3D11DrawCallHandler::SwapFrame");
+
 	SG::SGGraphicsHandler::SwapFrame();
 
-	drawCalls.UpdateActive();
-	dispatchCalls.UpdateActive();
+	size_t nrOfOperations = drawCalls.UpdateActive();
+	nrOfOperations += dispatchCalls.UpdateActive();
+	SGProfiler::Count(SGCounter::FRAME_MAP_OPERATIONS, nrOfOperations);
 }
 
 SG::D3D11DrawCallHandler::DrawCall SG::D3D11DrawCallHandler::GetDrawCall(const SGGuid & guid)
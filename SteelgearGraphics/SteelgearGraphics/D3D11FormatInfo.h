@@ -0,0 +1,192 @@
+#pragma once
+
+#include <cstddef>
+#include <initializer_list>
+
+#include <dxgiformat.h>
+
+namespace SG
+{
+	enum class FormatPlanes
+	{
+		SINGLE,
+		CHROMA_HALF_HEIGHT, // A luma plane followed by an interleaved chroma plane of half the height, like NV12
+		CHROMA_FULL_HEIGHT // A luma plane followed by an interleaved chroma plane of the same height, like NV11
+	};
+
+	/** Data is stored in blocks of blockWidth x blockHeight texels, a format where bytesPerBlock is 0 can not be given initial data */
+	struct SGFormatInfo
+	{
+		unsigned int blockWidth = 1;
+		unsigned int blockHeight = 1;
+		unsigned int bytesPerBlock = 0;
+		FormatPlanes planes = FormatPlanes::SINGLE;
+	};
+
+	struct SGFormatTable
+	{
+		static constexpr unsigned int SIZE = DXGI_FORMAT_V408 + 1;
+		SGFormatInfo infos[SIZE] = {};
+	};
+
+	constexpr SGFormatTable MakeFormatTable()
+	{
+		SGFormatTable table;
+
+		auto set = [&table](DXGI_FORMAT format, unsigned int blockWidth, unsigned int blockHeight, unsigned int bytesPerBlock,
+			FormatPlanes planes = FormatPlanes::SINGLE)
+		{
+			table.infos[format] = SGFormatInfo{ blockWidth, blockHeight, bytesPerBlock, planes };
+		};
+
+		for (DXGI_FORMAT format : { DXGI_FORMAT_R32G32B32A32_TYPELESS, DXGI_FORMAT_R32G32B32A32_FLOAT, DXGI_FORMAT_R32G32B32A32_UINT,
+			DXGI_FORMAT_R32G32B32A32_SINT })
+			set(format, 1, 1, 16);
+
+		for (DXGI_FORMAT format : { DXGI_FORMAT_R32G32B32_TYPELESS, DXGI_FORMAT_R32G32B32_FLOAT, DXGI_FORMAT_R32G32B32_UINT,
+			DXGI_FORMAT_R32G32B32_SINT })
+			set(format, 1, 1, 12);
+
+		for (DXGI_FORMAT format : { DXGI_FORMAT_R16G16B16A16_TYPELESS, DXGI_FORMAT_R16G16B16A16_FLOAT, DXGI_FORMAT_R16G16B16A16_UNORM,
+			DXGI_FORMAT_R16G16B16A16_UINT, DXGI_FORMAT_R16G16B16A16_SNORM, DXGI_FORMAT_R16G16B16A16_SINT, DXGI_FORMAT_R32G32_TYPELESS,
+			DXGI_FORMAT_R32G32_FLOAT, DXGI_FORMAT_R32G32_UINT, DXGI_FORMAT_R32G32_SINT, DXGI_FORMAT_R32G8X24_TYPELESS,
+			DXGI_FORMAT_D32_FLOAT_S8X24_UINT, DXGI_FORMAT_R32_FLOAT_X8X24_TYPELESS, DXGI_FORMAT_X32_TYPELESS_G8X24_UINT, DXGI_FORMAT_Y416 })
+			set(format, 1, 1, 8);
+
+		for (DXGI_FORMAT format : { DXGI_FORMAT_R10G10B10A2_TYPELESS, DXGI_FORMAT_R10G10B10A2_UNORM, DXGI_FORMAT_R10G10B10A2_UINT,
+			DXGI_FORMAT_R11G11B10_FLOAT, DXGI_FORMAT_R8G8B8A8_TYPELESS, DXGI_FORMAT_R8G8B8A8_UNORM, DXGI_FORMAT_R8G8B8A8_UNORM_SRGB,
+			DXGI_FORMAT_R8G8B8A8_UINT, DXGI_FORMAT_R8G8B8A8_SNORM, DXGI_FORMAT_R8G8B8A8_SINT, DXGI_FORMAT_R16G16_TYPELESS,
+			DXGI_FORMAT_R16G16_FLOAT, DXGI_FORMAT_R16G16_UNORM, DXGI_FORMAT_R16G16_UINT, DXGI_FORMAT_R16G16_SNORM, DXGI_FORMAT_R16G16_SINT,
+			DXGI_FORMAT_R32_TYPELESS, DXGI_FORMAT_D32_FLOAT, DXGI_FORMAT_R32_FLOAT, DXGI_FORMAT_R32_UINT, DXGI_FORMAT_R32_SINT,
+			DXGI_FORMAT_R24G8_TYPELESS, DXGI_FORMAT_D24_UNORM_S8_UINT, DXGI_FORMAT_R24_UNORM_X8_TYPELESS, DXGI_FORMAT_X24_TYPELESS_G8_UINT,
+			DXGI_FORMAT_R9G9B9E5_SHAREDEXP, DXGI_FORMAT_B8G8R8A8_UNORM, DXGI_FORMAT_B8G8R8X8_UNORM, DXGI_FORMAT_R10G10B10_XR_BIAS_A2_UNORM,
+			DXGI_FORMAT_B8G8R8A8_TYPELESS, DXGI_FORMAT_B8G8R8A8_UNORM_SRGB, DXGI_FORMAT_B8G8R8X8_TYPELESS, DXGI_FORMAT_B8G8R8X8_UNORM_SRGB,
+			DXGI_FORMAT_AYUV, DXGI_FORMAT_Y410 })
+			set(format, 1, 1, 4);
+
+		for (DXGI_FORMAT format : { DXGI_FORMAT_R8G8_TYPELESS, DXGI_FORMAT_R8G8_UNORM, DXGI_FORMAT_R8G8_UINT, DXGI_FORMAT_R8G8_SNORM,
+			DXGI_FORMAT_R8G8_SINT, DXGI_FORMAT_R16_TYPELESS, DXGI_FORMAT_R16_FLOAT, DXGI_FORMAT_D16_UNORM, DXGI_FORMAT_R16_UNORM,
+			DXGI_FORMAT_R16_UINT, DXGI_FORMAT_R16_SNORM, DXGI_FORMAT_R16_SINT, DXGI_FORMAT_B5G6R5_UNORM, DXGI_FORMAT_B5G5R5A1_UNORM,
+			DXGI_FORMAT_A8P8, DXGI_FORMAT_B4G4R4A4_UNORM })
+			set(format, 1, 1, 2);
+
+		for (DXGI_FORMAT format : { DXGI_FORMAT_R8_TYPELESS, DXGI_FORMAT_R8_UNORM, DXGI_FORMAT_R8_UINT, DXGI_FORMAT_R8_SNORM,
+			DXGI_FORMAT_R8_SINT, DXGI_FORMAT_A8_UNORM, DXGI_FORMAT_AI44, DXGI_FORMAT_IA44, DXGI_FORMAT_P8 })
+			set(format, 1, 1, 1);
+
+		set(DXGI_FORMAT_R1_UNORM, 8, 1, 1);
+
+		// Two texels share their chroma, so a row is stored in pairs
+		for (DXGI_FORMAT format : { DXGI_FORMAT_R8G8_B8G8_UNORM, DXGI_FORMAT_G8R8_G8B8_UNORM, DXGI_FORMAT_YUY2 })
+			set(format, 2, 1, 4);
+
+		for (DXGI_FORMAT format : { DXGI_FORMAT_Y210, DXGI_FORMAT_Y216 })
+			set(format, 2, 1, 8);
+
+		// The pitch of a planar format is the pitch of its luma plane, the chroma plane only adds rows
+		for (DXGI_FORMAT format : { DXGI_FORMAT_NV12, DXGI_FORMAT_420_OPAQUE })
+			set(format, 2, 1, 2, FormatPlanes::CHROMA_HALF_HEIGHT);
+
+		for (DXGI_FORMAT format : { DXGI_FORMAT_P010, DXGI_FORMAT_P016 })
+			set(format, 2, 1, 4, FormatPlanes::CHROMA_HALF_HEIGHT);
+
+		set(DXGI_FORMAT_NV11, 4, 1, 4, FormatPlanes::CHROMA_FULL_HEIGHT);
+		set(DXGI_FORMAT_P208, 2, 1, 2, FormatPlanes::CHROMA_FULL_HEIGHT);
+
+		for (DXGI_FORMAT format : { DXGI_FORMAT_BC1_TYPELESS, DXGI_FORMAT_BC1_UNORM, DXGI_FORMAT_BC1_UNORM_SRGB, DXGI_FORMAT_BC4_TYPELESS,
+			DXGI_FORMAT_BC4_UNORM, DXGI_FORMAT_BC4_SNORM })
+			set(format, 4, 4, 8);
+
+		for (DXGI_FORMAT format : { DXGI_FORMAT_BC2_TYPELESS, DXGI_FORMAT_BC2_UNORM, DXGI_FORMAT_BC2_UNORM_SRGB, DXGI_FORMAT_BC3_TYPELESS,
+			DXGI_FORMAT_BC3_UNORM, DXGI_FORMAT_BC3_UNORM_SRGB, DXGI_FORMAT_BC5_TYPELESS, DXGI_FORMAT_BC5_UNORM, DXGI_FORMAT_BC5_SNORM,
+			DXGI_FORMAT_BC6H_TYPELESS, DXGI_FORMAT_BC6H_UF16, DXGI_FORMAT_BC6H_SF16, DXGI_FORMAT_BC7_TYPELESS, DXGI_FORMAT_BC7_UNORM,
+			DXGI_FORMAT_BC7_UNORM_SRGB })
+			set(format, 4, 4, 16);
+
+		return table;
+	}
+
+	constexpr SGFormatTable FORMAT_TABLE = MakeFormatTable();
+
+	constexpr SGFormatInfo GetFormatInfo(DXGI_FORMAT format)
+	{
+		return static_cast<unsigned int>(format) < SGFormatTable::SIZE ? FORMAT_TABLE.infos[format] : SGFormatInfo();
+	}
+
+	constexpr bool IsBlockCompressed(DXGI_FORMAT format)
+	{
+		return GetFormatInfo(format).blockHeight > 1;
+	}
+
+	constexpr bool IsPlanar(DXGI_FORMAT format)
+	{
+		return GetFormatInfo(format).planes != FormatPlanes::SINGLE;
+	}
+
+	/** Size of a mip level along one axis */
+	constexpr unsigned int GetMipDimension(unsigned int size, unsigned int mip)
+	{
+		return mip < 32 && (size >> mip) > 1 ? size >> mip : 1;
+	}
+
+	/** Bytes in a row of blocks, for a block compressed format a row is four texels high */
+	constexpr size_t GetRowPitch(DXGI_FORMAT format, unsigned int width)
+	{
+		SGFormatInfo info = GetFormatInfo(format);
+		return static_cast<size_t>((width + info.blockWidth - 1) / info.blockWidth) * info.bytesPerBlock;
+	}
+
+	/** Rows of blocks in a slice, including the rows of the chroma plane of a planar format */
+	constexpr unsigned int GetNrOfRows(DXGI_FORMAT format, unsigned int height)
+	{
+		SGFormatInfo info = GetFormatInfo(format);
+
+		switch (info.planes)
+		{
+		case FormatPlanes::CHROMA_HALF_HEIGHT:
+			return height + (height + 1) / 2;
+		case FormatPlanes::CHROMA_FULL_HEIGHT:
+			return height * 2;
+		default:
+			return (height + info.blockHeight - 1) / info.blockHeight;
+		}
+	}
+
+	constexpr size_t GetSlicePitch(DXGI_FORMAT format, unsigned int width, unsigned int height)
+	{
+		return GetRowPitch(format, width) * GetNrOfRows(format, height);
+	}
+
+	struct SGSubresourcePitch
+	{
+		size_t rowPitch = 0;
+		size_t slicePitch = 0;
+		unsigned int nrOfRows = 0;
+		unsigned int depth = 1;
+	};
+
+	/** Tightly packed pitches of a subresource, which are numbered mip by mip within each array slice */
+	constexpr SGSubresourcePitch GetSubresourcePitch(DXGI_FORMAT format, unsigned int width, unsigned int height, unsigned int depth,
+		unsigned int mipLevels, unsigned int subresource)
+	{
+		unsigned int mip = mipLevels != 0 ? subresource % mipLevels : 0;
+		SGSubresourcePitch pitch;
+		pitch.rowPitch = GetRowPitch(format, GetMipDimension(width, mip));
+		pitch.nrOfRows = GetNrOfRows(format, GetMipDimension(height, mip));
+		pitch.slicePitch = pitch.rowPitch * pitch.nrOfRows;
+		pitch.depth = GetMipDimension(depth, mip);
+
+		return pitch;
+	}
+
+	// Spot checks when compiling so a mistake in the table breaks every build, Tests/TestFormatInfo.cpp walks whole textures
+	static_assert(GetRowPitch(DXGI_FORMAT_R8G8B8A8_UNORM, 13) == 52 && GetNrOfRows(DXGI_FORMAT_R8G8B8A8_UNORM, 7) == 7, "Wrong linear pitch");
+	static_assert(GetRowPitch(DXGI_FORMAT_BC1_UNORM, 13) == 32 && GetNrOfRows(DXGI_FORMAT_BC1_UNORM, 13) == 4, "Wrong BC1 pitch");
+	static_assert(GetSlicePitch(DXGI_FORMAT_BC7_UNORM, 1, 1) == 16 && GetSlicePitch(DXGI_FORMAT_BC4_SNORM, 2, 2) == 8, "Wrong BC mip tail pitch");
+	static_assert(GetSubresourcePitch(DXGI_FORMAT_BC3_UNORM, 256, 64, 1, 9, 9 + 6).slicePitch == 16, "Wrong BC subresource pitch");
+	static_assert(GetSubresourcePitch(DXGI_FORMAT_R16_FLOAT, 64, 32, 16, 7, 2).depth == 4, "Wrong volume mip depth");
+	static_assert(GetRowPitch(DXGI_FORMAT_R1_UNORM, 9) == 2 && GetRowPitch(DXGI_FORMAT_YUY2, 5) == 12, "Wrong packed pitch");
+	static_assert(GetSlicePitch(DXGI_FORMAT_NV12, 5, 5) == 6 * 8 && GetSlicePitch(DXGI_FORMAT_NV11, 5, 3) == 8 * 6, "Wrong planar pitch");
+	static_assert(GetFormatInfo(DXGI_FORMAT_UNKNOWN).bytesPerBlock == 0 && GetFormatInfo(DXGI_FORMAT_FORCE_UINT).bytesPerBlock == 0,
+		"Unknown formats have no size");
+}
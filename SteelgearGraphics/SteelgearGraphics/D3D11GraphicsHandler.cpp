@@ -2,7 +2,7 @@
 
 void* SG::D3D11GraphicsHandler::GetGlobalResourceView(const SGGuid& guid, const ResourceViewType& resourceViewType,
 												FrameMap<SGGuid, D3D11ResourceViewData>& views, 
-												const std::string& associatedResourceName)
+												const std::string& associatedResourceName, ID3D11Resource** resource)
 {
 	(void)associatedResourceName; // Ugly solution for now. Since resourcename is only used in debug mode the parameter is unused in release builds.
 	if constexpr (DEBUG_VERSION)
@@ -18,14 +18,19 @@ void* SG::D3D11GraphicsHandler::GetGlobalResourceView(const SGGuid& guid, const
 									 + " Associated resource was: " + associatedResourceName);
 	}
 
-	return views[guid].view.srv;
+	D3D11ResourceViewData& data = views[guid];
+
+	if (resource != nullptr)
+		*resource = data.resource;
+
+	return data.view.srv;
 	// Since all are pointers it does not actually matter what pointer is returned here as long
 	// as it actually points to the correct type of view and is received as the correct type
 }
 
 void* SG::D3D11GraphicsHandler::GetGroupResourceView(const SGGuid& guid, const SGGuid& groupGuid, const ResourceViewType& resourceViewType,
 													 FrameMap<SGGuid, D3D11ResourceViewData>& views, 
-													 const std::string& associatedResourceName)
+													 const std::string& associatedResourceName, ID3D11Resource** resource)
 {
 	(void)associatedResourceName; // Ugly solution for now. Since resourcename is only used in debug mode the parameter is unused in release builds.
 	if constexpr (DEBUG_VERSION)
@@ -50,12 +55,17 @@ void* SG::D3D11GraphicsHandler::GetGroupResourceView(const SGGuid& guid, const S
 				+ " Associated resource was : " + associatedResourceName);
 	}
 
-	return views[groupData[groupGuid][guid].GetActive()].view.srv;
+	D3D11ResourceViewData& data = views[groupData[groupGuid][guid].GetActive()];
+
+	if (resource != nullptr)
+		*resource = data.resource;
+
+	return data.view.srv;
 	// Since all are pointers it does not actually matter what pointer is returned here as long
 	// as it actually points to the correct type of view and is received as the correct type
 }
 
-void* SG::D3D11GraphicsHandler::GetEntityResourceView(const SGGuid& guid, const SGGraphicalEntityID& entity, const ResourceViewType& resourceViewType, FrameMap<SGGuid, D3D11ResourceViewData>& views, const std::string& associatedResourceName)
+void* SG::D3D11GraphicsHandler::GetEntityResourceView(const SGGuid& guid, const SGGraphicalEntityID& entity, const ResourceViewType& resourceViewType, FrameMap<SGGuid, D3D11ResourceViewData>& views, const std::string& associatedResourceName, ID3D11Resource** resource)
 {
 	(void)associatedResourceName; // Ugly solution for now. Since resourcename is only used in debug mode the parameter is unused in release builds.
 	if constexpr (DEBUG_VERSION)
@@ -80,7 +90,12 @@ void* SG::D3D11GraphicsHandler::GetEntityResourceView(const SGGuid& guid, const
 				+ " Associated resource was : " + associatedResourceName);
 	}
 
-	return views[entityData[entity][guid].GetActive()].view.srv;
+	D3D11ResourceViewData& data = views[entityData[entity][guid].GetActive()];
+
+	if (resource != nullptr)
+		*resource = data.resource;
+
+	return data.view.srv;
 	// Since all are pointers it does not actually matter what pointer is returned here as long
 	// as it actually points to the correct type of view and is received as the correct type
 }
@@ -16,14 +16,15 @@ namespace SG
 
 	protected:
 
+		// resource is set to the resource of the view if it is not nullptr
 		void* GetGlobalResourceView(const SGGuid& guid, const ResourceViewType& resourceViewType,
-			FrameMap<SGGuid, D3D11ResourceViewData>& views, const std::string& associatedResourceName);
+			FrameMap<SGGuid, D3D11ResourceViewData>& views, const std::string& associatedResourceName, ID3D11Resource** resource);
 
 		void* GetGroupResourceView(const SGGuid& guid, const SGGuid& groupGuid, const ResourceViewType& resourceViewType,
-			FrameMap<SGGuid, D3D11ResourceViewData>& views, const std::string& associatedResourceName);
+			FrameMap<SGGuid, D3D11ResourceViewData>& views, const std::string& associatedResourceName, ID3D11Resource** resource);
 
 		void* GetEntityResourceView(const SGGuid& guid, const SGGraphicalEntityID& entity, const ResourceViewType& resourceViewType,
-			FrameMap<SGGuid, D3D11ResourceViewData>& views, const std::string& associatedResourceName);
+			FrameMap<SGGuid, D3D11ResourceViewData>& views, const std::string& associatedResourceName, ID3D11Resource** resource);
 
 	private:
 		std::string TranslateViewToString(const ResourceViewType& resourceViewType);
@@ -21,3 +21,14 @@ SG::D3D11InputLayoutData& SG::D3D11InputLayoutData::operator=(D3D11InputLayoutDa
 
     return *this;
 }
+
+SG::D3D11InputLayoutData SG::D3D11InputLayoutData::Share() const
+{
+    D3D11InputLayoutData toReturn;
+    toReturn.inputLayout = inputLayout;
+
+    if (inputLayout != nullptr)
+        inputLayout->AddRef();
+
+    return toReturn;
+}
@@ -13,5 +13,7 @@ namespace SG
 
 		D3D11InputLayoutData(D3D11InputLayoutData&& other);
 		D3D11InputLayoutData& operator=(D3D11InputLayoutData&& other);
+
+		D3D11InputLayoutData Share() const; // Another owner of the same input layout
 	};
 }
\ No newline at end of file
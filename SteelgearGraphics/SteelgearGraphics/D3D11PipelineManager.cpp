@@ -1,4 +1,5 @@
 #include "D3D11PipelineManager.h"
+#include "D3D11Capture.h"
 
 SG::D3D11PipelineManager::D3D11PipelineManager(ID3D11Device * device)
 {
@@ -7,61 +8,75 @@ SG::D3D11PipelineManager::D3D11PipelineManager(ID3D11Device * device)
 
 SG::SGResult SG::D3D11PipelineManager::CreateRenderJob(const SGGuid & guid, const SGRenderJob & job)
 {
-	renderJobs.AddElement(guid, job);
+	SGCaptureScope capture(SGCaptureCall::CREATE_RENDER_JOB, guid, job);
+	SGRenderJob shapedJob = job;
+	shapedJob.shape = GetRenderJobShape(job); // Once here instead of every time the job is drawn
+	renderJobs.AddElement(guid, shapedJob);
 	return SGResult::OK;
 }
 
 void SG::D3D11PipelineManager::RemoveRenderJob(const SGGuid& guid)
 {
+	SGCaptureScope capture(SGCaptureCall::REMOVE_RENDER_JOB, guid);
 	renderJobs.RemoveElement(guid);
 }
 
 SG::SGResult SG::D3D11PipelineManager::CreateComputeJob(const SGGuid & guid, const SGComputeJob & job)
 {
+	SGCaptureScope capture(SGCaptureCall::CREATE_COMPUTE_JOB, guid, job);
 	computeJobs.AddElement(guid, job);
 	return SGResult::OK;
 }
 
 void SG::D3D11PipelineManager::RemoveComputeJob(const SGGuid& guid)
 {
+	SGCaptureScope capture(SGCaptureCall::REMOVE_COMPUTE_JOB, guid);
 	computeJobs.RemoveElement(guid);
 }
 
 SG::SGResult SG::D3D11PipelineManager::CreateClearRenderTargetJob(const SGGuid & guid, const SGClearRenderTargetJob & job)
 {
+	SGCaptureScope capture(SGCaptureCall::CREATE_CLEAR_RENDER_TARGET_JOB, guid, job);
 	clearRenderTargetJobs.AddElement(guid, job);
 	return SGResult::OK;
 }
 
 void SG::D3D11PipelineManager::RemoveClearRenderTargetJob(const SGGuid& guid)
 {
+	SGCaptureScope capture(SGCaptureCall::REMOVE_CLEAR_RENDER_TARGET_JOB, guid);
 	clearRenderTargetJobs.RemoveElement(guid);
 }
 
 SG::SGResult SG::D3D11PipelineManager::CreateClearDepthStencilJob(const SGGuid & guid, const SGClearDepthStencilJob & job)
 {
+	SGCaptureScope capture(SGCaptureCall::CREATE_CLEAR_DEPTH_STENCIL_JOB, guid, job);
 	clearDepthStencilJobs.AddElement(guid, job);
 	return SGResult::OK;
 }
 
 void SG::D3D11PipelineManager::RemoveClearDepthStencilJob(const SGGuid& guid)
 {
+	SGCaptureScope capture(SGCaptureCall::REMOVE_CLEAR_DEPTH_STENCIL_JOB, guid);
 	clearDepthStencilJobs.RemoveElement(guid);
 }
 
 SG::SGResult SG::D3D11PipelineManager::CreatePipeline(const SGGuid & guid, const SGPipeline & pipeline)
 {
+	SGCaptureScope capture(SGCaptureCall::CREATE_PIPELINE, guid, pipeline);
 	pipelines.AddElement(guid, pipeline);
 	return SGResult::OK;
 }
 
 void SG::D3D11PipelineManager::RemovePipeline(const SGGuid& guid)
 {
+	SGCaptureScope capture(SGCaptureCall::REMOVE_PIPELINE, guid);
 	pipelines.RemoveElement(guid);
 }
 
 void SG::D3D11PipelineManager::FinishFrame()
 {
+	SGTraceScope scope("D3D11PipelineManager::FinishFrame");
+
 	renderJobs.FinishFrame();
 	computeJobs.FinishFrame();
 	clearRenderTargetJobs.FinishFrame();
@@ -71,11 +86,15 @@ void SG::D3D11PipelineManager::FinishFrame()
 
 void SG::D3D11PipelineManager::SwapFrame()
 {
-	renderJobs.UpdateActive();
-	computeJobs.UpdateActive();
-	clearRenderTargetJobs.UpdateActive();
-	clearDepthStencilJobs.UpdateActive();
-	pipelines.UpdateActive();
+	SGTraceScope scope("D3D11PipelineManager::SwapFrame");
+
+	changedGuids.clear();
+	size_t nrOfOperations = renderJobs.UpdateActive(&changedGuids);
+	nrOfOperations += computeJobs.UpdateActive(&changedGuids);
+	nrOfOperations += clearRenderTargetJobs.UpdateActive(&changedGuids);
+	nrOfOperations += clearDepthStencilJobs.UpdateActive(&changedGuids);
+	nrOfOperations += pipelines.UpdateActive(&changedGuids);
+	SGProfiler::Count(SGCounter::FRAME_MAP_OPERATIONS, nrOfOperations);
 }
 
 SG::SGRenderJob SG::D3D11PipelineManager::GetRenderJob(const SGGuid & guid)
@@ -89,6 +108,72 @@ SG::SGRenderJob SG::D3D11PipelineManager::GetRenderJob(const SGGuid & guid)
 	return renderJobs[guid];
 }
 
+unsigned int SG::D3D11PipelineManager::GetRenderJobShape(const SGRenderJob & job)
+{
+	unsigned int shape = 0;
+	bool perDraw = false;
+	auto checkComponent = [&perDraw](const PipelineComponent& component)
+	{
+		perDraw |= component.source != Association::GLOBAL && component.resourceGuid != SGGuid();
+	};
+
+	const RenderShader* shaders[] = { &job.vertexShader, &job.hullShader, &job.domainShader, &job.geometryShader, &job.pixelShader };
+
+	for (unsigned int i = 0; i < 5; ++i)
+	{
+		const RenderShader& shader = *shaders[i];
+
+		if (shader.constantBuffers.size() || shader.shaderResourceViews.size() || shader.samplers.size())
+			shape |= VERTEX_STAGE << i;
+
+		for (auto& constantBuffer : shader.constantBuffers)
+			checkComponent(constantBuffer.component);
+
+		for (auto& srv : shader.shaderResourceViews)
+			checkComponent(srv.component);
+
+		for (auto& sampler : shader.samplers)
+			checkComponent(sampler);
+	}
+
+	for (auto& vertexBuffer : job.vertexBuffers)
+	{
+		checkComponent(vertexBuffer.buffer);
+		checkComponent(vertexBuffer.stride);
+		checkComponent(vertexBuffer.offset);
+	}
+
+	checkComponent(job.indexBuffer.buffer);
+	checkComponent(job.indexBuffer.offset);
+
+	for (auto& rtv : job.rtvs)
+		checkComponent(rtv.component);
+
+	for (auto& uav : job.uavs)
+		checkComponent(uav.component);
+
+	for (auto& viewport : job.viewports)
+		checkComponent(viewport);
+
+	checkComponent(job.dsv.component);
+	checkComponent(job.rasterizerState);
+	checkComponent(job.blendState);
+	checkComponent(job.stateBlock);
+
+	return perDraw ? shape | PER_DRAW_BINDINGS : shape;
+}
+
+SG::Association SG::D3D11PipelineManager::GetRenderJobAssociation(const SGGuid & guid)
+{
+	if constexpr (DEBUG_VERSION)
+	{
+		if (!renderJobs.HasElement(guid))
+			throw std::runtime_error("Error fetching render job, guid does not exist");
+	}
+
+	return renderJobs[guid].association;
+}
+
 SG::SGComputeJob SG::D3D11PipelineManager::GetComputeJob(const SGGuid & guid)
 {
 	if constexpr (DEBUG_VERSION)
@@ -13,7 +13,6 @@ namespace SG
 {
 	struct ConstantBuffer
 	{
-		bool clearAtEnd = false;
 		PipelineComponent component;
 	};
 
@@ -25,7 +24,6 @@ namespace SG
 			TEXTURE
 		} type;
 
-		bool clearAtEnd = false;
 		PipelineComponent component;
 	};
 
@@ -39,7 +37,6 @@ namespace SG
 
 	struct SGVertexBuffer
 	{
-		bool clearAtEnd = false;
 		PipelineComponent buffer;
 		PipelineComponent stride;
 		PipelineComponent offset;
@@ -53,7 +50,6 @@ namespace SG
 
 	struct SGIndexBuffer
 	{
-		bool clearAtEnd = false;
 		PipelineComponent buffer;
 		PipelineComponent offset;
 		IndexBufferFormat format = IndexBufferFormat::IB_32_BIT;
@@ -122,7 +118,9 @@ namespace SG
 		ResourceView dsv;
 		PipelineComponent rasterizerState;
 		PipelineComponent blendState;
+		PipelineComponent stateBlock; // Replaces the topology, input layout, shaders and states of the job when set
 		PipelineComponent drawCall;
+		unsigned int shape = 0; // Set by CreateRenderJob, picks the draw loop of the job
 	};
 
 	struct SGComputeJob
@@ -160,9 +158,22 @@ namespace SG
 		COPY_RESOURCE
 	};
 
+	// Only alive while the jobs of the pipeline that use it run. Backed by a pooled texture that is shared with other transient
+	// textures of the same description whose lifetimes do not overlap, so the content does not survive between frames
+	struct SGTransientTexture
+	{
+		SGGuid guid;
+		DXGI_FORMAT format = DXGI_FORMAT_R8G8B8A8_UNORM; // Has to be typed since the views use the format of the texture
+		UINT width;
+		UINT height;
+		std::vector<std::pair<SGGuid, ResourceViewType>> views; // Views of the whole texture, used by jobs as global views
+	};
+
 	struct SGPipeline
 	{
 		std::vector<std::pair<PipelineJobType, SGGuid>> jobs;
+		std::vector<SGTransientTexture> transientTextures;
+		std::vector<SGGuid> outputs; // Textures and buffers the pipeline produces, jobs not contributing to them are culled. Nothing is culled if empty
 	};
 
 	class D3D11PipelineManager
@@ -190,11 +201,21 @@ namespace SG
 
 		friend class D3D11RenderEngine;
 
+		// A render job shape is the stages that have resources bound and if any binding changes between draws
+		static constexpr unsigned int VERTEX_STAGE = 1;
+		static constexpr unsigned int HULL_STAGE = 2;
+		static constexpr unsigned int DOMAIN_STAGE = 4;
+		static constexpr unsigned int GEOMETRY_STAGE = 8;
+		static constexpr unsigned int PIXEL_STAGE = 16;
+		static constexpr unsigned int PER_DRAW_BINDINGS = 32;
+		static constexpr size_t NR_OF_SHAPES = 64;
+
 		FrameMap<SGGuid, SGRenderJob> renderJobs;
 		FrameMap<SGGuid, SGComputeJob> computeJobs;
 		FrameMap<SGGuid, SGClearRenderTargetJob> clearRenderTargetJobs;
 		FrameMap<SGGuid, SGClearDepthStencilJob> clearDepthStencilJobs;
 		FrameMap<SGGuid, SGPipeline> pipelines;
+		std::vector<SGGuid> changedGuids; // Jobs and pipelines added or removed by the last swap
 
 		ID3D11Device* device;
 
@@ -202,6 +223,8 @@ namespace SG
 		void SwapFrame();
 
 		SGRenderJob GetRenderJob(const SGGuid& guid);
+		unsigned int GetRenderJobShape(const SGRenderJob& job);
+		Association GetRenderJobAssociation(const SGGuid& guid);
 		SGComputeJob GetComputeJob(const SGGuid& guid);
 		SGClearRenderTargetJob GetClearRenderTargetJob(const SGGuid& guid);
 		SGClearDepthStencilJob GetClearDepthStencilJob(const SGGuid& guid);
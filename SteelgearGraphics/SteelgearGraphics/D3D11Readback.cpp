@@ -0,0 +1,294 @@
+#include "D3D11Readback.h"
+#include "D3D11FormatInfo.h"
+
+SG::D3D11Readback::D3D11Readback(ID3D11Device * device, D3D11BufferHandler * bufferHandler, D3D11TextureHandler * textureHandler, size_t nrOfSlots)
+	: device(device), bufferHandler(bufferHandler), textureHandler(textureHandler), slots(nrOfSlots), ring(this, nrOfSlots)
+{
+}
+
+SG::D3D11Readback::~D3D11Readback()
+{
+	for (auto& slot : slots)
+	{
+		ReleaseCOM(slot.staging);
+		ReleaseCOM(slot.fence);
+	}
+}
+
+SG::SGReadbackID SG::D3D11Readback::ReadbackBuffer(const SGGuid & bufferGuid, const SGReadbackCallback & callback, size_t offset, size_t size)
+{
+	SGReadbackSource source;
+	source.guid = bufferGuid;
+	source.offset = offset;
+	source.size = size;
+
+	return ring.Request(source, callback);
+}
+
+SG::SGReadbackID SG::D3D11Readback::ReadbackTexture(const SGGuid & textureGuid, const SGReadbackCallback & callback, UINT subresource,
+	const std::optional<D3D11_BOX>& box)
+{
+	SGReadbackSource source;
+	source.guid = textureGuid;
+	source.texture = true;
+	source.subresource = subresource;
+	source.wholeSubresource = !box.has_value();
+
+	if (box.has_value())
+	{
+		source.left = box->left;
+		source.top = box->top;
+		source.front = box->front;
+		source.right = box->right;
+		source.bottom = box->bottom;
+		source.back = box->back;
+	}
+
+	return ring.Request(source, callback);
+}
+
+SG::SGReadbackStatus SG::D3D11Readback::GetStatus(SGReadbackID id)
+{
+	return ring.GetStatus(id);
+}
+
+bool SG::D3D11Readback::TakeData(SGReadbackID id, std::vector<unsigned char>& data, SGReadbackData & layout)
+{
+	return ring.TakeData(id, data, layout);
+}
+
+void SG::D3D11Readback::Update(ID3D11DeviceContext * context)
+{
+	SGTraceScope scope("D3D11Readback::Update");
+
+	this->context = context;
+	ring.Update();
+}
+
+bool SG::D3D11Readback::CopyToSlot(size_t slot, const SGReadbackSource & source)
+{
+	Slot& toCopyTo = slots[slot];
+
+	if (!(source.texture ? CopyTexture(toCopyTo, source) : CopyBuffer(toCopyTo, source)))
+		return false;
+
+	context->End(toCopyTo.fence);
+	return true;
+}
+
+bool SG::D3D11Readback::IsSlotReady(size_t slot)
+{
+	// Without the flag the query would flush the context every time it is polled
+	return context->GetData(slots[slot].fence, nullptr, 0, D3D11_ASYNC_GETDATA_DONOTFLUSH) == S_OK;
+}
+
+bool SG::D3D11Readback::MapSlot(size_t slot, SGReadbackData & data)
+{
+	Slot& toMap = slots[slot];
+	D3D11_MAPPED_SUBRESOURCE mapped;
+
+	if (FAILED(context->Map(toMap.staging, 0, D3D11_MAP_READ, 0, &mapped)))
+		return false;
+
+	SGProfiler::Count(SGCounter::MAPS);
+
+	data = toMap.layout;
+	data.bytes = static_cast<const unsigned char*>(mapped.pData);
+	data.rowPitch = toMap.type == StagingType::BUFFER ? data.rowSize : mapped.RowPitch;
+	data.depthPitch = toMap.type == StagingType::TEXTURE_3D ? mapped.DepthPitch : data.rowPitch * data.nrOfRows;
+
+	return true;
+}
+
+void SG::D3D11Readback::UnmapSlot(size_t slot)
+{
+	context->Unmap(slots[slot].staging, 0);
+}
+
+bool SG::D3D11Readback::CopyBuffer(Slot & slot, const SGReadbackSource & source)
+{
+	if (!bufferHandler->buffers.HasElement(source.guid))
+		return false;
+
+	ID3D11Buffer* buffer = bufferHandler->buffers[source.guid].buffer;
+	D3D11_BUFFER_DESC desc;
+	buffer->GetDesc(&desc);
+
+	size_t size = source.size;
+
+	if (size == 0)
+		size = source.offset < desc.ByteWidth ? desc.ByteWidth - source.offset : 0;
+
+	if (size == 0 || source.offset + size > desc.ByteWidth)
+		return false;
+
+	if (!PrepareSlot(slot, StagingType::BUFFER, DXGI_FORMAT_UNKNOWN, static_cast<UINT>(size), 1, 1))
+		return false;
+
+	D3D11_BOX box = { static_cast<UINT>(source.offset), 0, 0, static_cast<UINT>(source.offset + size), 1, 1 };
+	context->CopySubresourceRegion(slot.staging, 0, 0, 0, 0, buffer, 0, &box);
+
+	slot.layout.rowSize = size;
+	slot.layout.nrOfRows = 1;
+	slot.layout.depth = 1;
+
+	return true;
+}
+
+bool SG::D3D11Readback::CopyTexture(Slot & slot, const SGReadbackSource & source)
+{
+	if (!textureHandler->textures.HasElement(source.guid))
+		return false;
+
+	D3D11TextureData& textureData = textureHandler->textures[source.guid];
+	D3D11TextureHandler::SubresourceInfo info;
+
+	if (!textureHandler->GetSubresourceInfo(textureData, source.subresource, info) || info.sampleCount != 1 || IsPlanar(info.format))
+		return false;
+
+	DXGI_FORMAT format = info.format;
+	SGFormatInfo formatInfo = GetFormatInfo(format);
+	D3D11_BOX box = { 0, 0, 0, info.width, info.height, info.depth };
+
+	if (!source.wholeSubresource)
+	{
+		// Depth stencil textures can only be copied whole
+		if ((info.bindFlags & D3D11_BIND_DEPTH_STENCIL) || source.left >= source.right || source.top >= source.bottom ||
+			source.front >= source.back || source.right > info.width || source.bottom > info.height || source.back > info.depth)
+			return false;
+
+		// Block compressed regions start on a block and end on one or at the edge of the mip
+		if (IsBlockCompressed(format) && (source.left % formatInfo.blockWidth != 0 || source.top % formatInfo.blockHeight != 0 ||
+			(source.right % formatInfo.blockWidth != 0 && source.right != info.width) ||
+			(source.bottom % formatInfo.blockHeight != 0 && source.bottom != info.height)))
+			return false;
+
+		box = { source.left, source.top, source.front, source.right, source.bottom, source.back };
+	}
+
+	UINT width = box.right - box.left;
+	UINT height = box.bottom - box.top;
+	UINT depth = box.back - box.front;
+	StagingType type = StagingType::TEXTURE_2D;
+
+	if (textureData.type == TextureType::TEXTURE_1D || textureData.type == TextureType::TEXTURE_ARRAY_1D)
+		type = StagingType::TEXTURE_1D;
+	else if (textureData.type == TextureType::TEXTURE_3D)
+		type = StagingType::TEXTURE_3D;
+
+	// Block compressed textures are made of whole blocks even where the mip ends inside one
+	UINT stagingWidth = (width + formatInfo.blockWidth - 1) / formatInfo.blockWidth * formatInfo.blockWidth;
+	UINT stagingHeight = (height + formatInfo.blockHeight - 1) / formatInfo.blockHeight * formatInfo.blockHeight;
+
+	if (!PrepareSlot(slot, type, format, stagingWidth, stagingHeight, depth))
+		return false;
+
+	context->CopySubresourceRegion(slot.staging, 0, 0, 0, 0, textureHandler->GetResource(textureData), source.subresource,
+		source.wholeSubresource ? nullptr : &box);
+
+	slot.layout.rowSize = GetRowPitch(format, width);
+	slot.layout.nrOfRows = GetNrOfRows(format, height);
+	slot.layout.depth = depth;
+
+	return true;
+}
+
+bool SG::D3D11Readback::PrepareSlot(Slot & slot, StagingType type, DXGI_FORMAT format, UINT width, UINT height, UINT depth)
+{
+	if (slot.fence == nullptr)
+	{
+		D3D11_QUERY_DESC desc = { D3D11_QUERY_EVENT, 0 };
+
+		if (FAILED(device->CreateQuery(&desc, &slot.fence)))
+			return false;
+	}
+
+	// A staging buffer can be larger than the range read into it
+	bool fits = slot.staging != nullptr && slot.type == type && slot.format == format && slot.height == height && slot.depth == depth &&
+		(type == StagingType::BUFFER ? slot.width >= width : slot.width == width);
+
+	if (fits)
+		return true;
+
+	ReleaseCOM(slot.staging);
+	slot.type = StagingType::NONE;
+	HRESULT hr = E_FAIL;
+
+	switch (type)
+	{
+	case StagingType::BUFFER:
+	{
+		D3D11_BUFFER_DESC desc = {};
+		desc.ByteWidth = width;
+		desc.Usage = D3D11_USAGE_STAGING;
+		desc.CPUAccessFlags = D3D11_CPU_ACCESS_READ;
+
+		ID3D11Buffer* buffer = nullptr;
+		hr = device->CreateBuffer(&desc, nullptr, &buffer);
+		slot.staging = buffer;
+		break;
+	}
+	case StagingType::TEXTURE_1D:
+	{
+		D3D11_TEXTURE1D_DESC desc = {};
+		desc.Width = width;
+		desc.MipLevels = 1;
+		desc.ArraySize = 1;
+		desc.Format = format;
+		desc.Usage = D3D11_USAGE_STAGING;
+		desc.CPUAccessFlags = D3D11_CPU_ACCESS_READ;
+
+		ID3D11Texture1D* texture = nullptr;
+		hr = device->CreateTexture1D(&desc, nullptr, &texture);
+		slot.staging = texture;
+		break;
+	}
+	case StagingType::TEXTURE_3D:
+	{
+		D3D11_TEXTURE3D_DESC desc = {};
+		desc.Width = width;
+		desc.Height = height;
+		desc.Depth = depth;
+		desc.MipLevels = 1;
+		desc.Format = format;
+		desc.Usage = D3D11_USAGE_STAGING;
+		desc.CPUAccessFlags = D3D11_CPU_ACCESS_READ;
+
+		ID3D11Texture3D* texture = nullptr;
+		hr = device->CreateTexture3D(&desc, nullptr, &texture);
+		slot.staging = texture;
+		break;
+	}
+	default:
+	{
+		D3D11_TEXTURE2D_DESC desc = {};
+		desc.Width = width;
+		desc.Height = height;
+		desc.MipLevels = 1;
+		desc.ArraySize = 1;
+		desc.Format = format;
+		desc.SampleDesc.Count = 1;
+		desc.Usage = D3D11_USAGE_STAGING;
+		desc.CPUAccessFlags = D3D11_CPU_ACCESS_READ;
+
+		ID3D11Texture2D* texture = nullptr;
+		hr = device->CreateTexture2D(&desc, nullptr, &texture);
+		slot.staging = texture;
+		break;
+	}
+	}
+
+	if (FAILED(hr))
+	{
+		ReleaseCOM(slot.staging);
+		return false;
+	}
+
+	slot.type = type;
+	slot.format = format;
+	slot.width = width;
+	slot.height = height;
+	slot.depth = depth;
+
+	return true;
+}
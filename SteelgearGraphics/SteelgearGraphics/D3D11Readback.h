@@ -0,0 +1,73 @@
+#pragma once
+
+#include <optional>
+#include <vector>
+
+#include <d3d11_4.h>
+
+#include "SGReadbackRing.h"
+#include "D3D11BufferHandler.h"
+#include "D3D11TextureHandler.h"
+
+namespace SG
+{
+	/** Reads buffers and textures of the handlers back to the CPU through a ring of staging resources, see SGReadbackRing.
+	A slot keeps its staging resource between readbacks and only recreates it when a readback does not fit in it,
+	so reading the same region every frame allocates nothing after the first frames */
+	class D3D11Readback : public SGReadbackDevice
+	{
+	public:
+		D3D11Readback(ID3D11Device* device, D3D11BufferHandler* bufferHandler, D3D11TextureHandler* textureHandler, size_t nrOfSlots);
+		~D3D11Readback();
+
+		SGReadbackID ReadbackBuffer(const SGGuid& bufferGuid, const SGReadbackCallback& callback = nullptr, size_t offset = 0, size_t size = 0);
+		/** Multisampled textures can not be read back, depth stencil textures only as whole subresources */
+		SGReadbackID ReadbackTexture(const SGGuid& textureGuid, const SGReadbackCallback& callback = nullptr, UINT subresource = 0,
+			const std::optional<D3D11_BOX>& box = std::nullopt);
+
+		SGReadbackStatus GetStatus(SGReadbackID id);
+		bool TakeData(SGReadbackID id, std::vector<unsigned char>& data, SGReadbackData& layout);
+
+	private:
+		friend class D3D11RenderEngine;
+
+		enum class StagingType
+		{
+			NONE,
+			BUFFER,
+			TEXTURE_1D,
+			TEXTURE_2D,
+			TEXTURE_3D
+		};
+
+		struct Slot
+		{
+			ID3D11Resource* staging = nullptr;
+			ID3D11Query* fence = nullptr;
+			StagingType type = StagingType::NONE;
+			DXGI_FORMAT format = DXGI_FORMAT_UNKNOWN;
+			UINT width = 0; // Bytes for a buffer
+			UINT height = 0;
+			UINT depth = 0;
+			SGReadbackData layout; // Pitches and bytes are set when mapped
+		};
+
+		ID3D11Device* device;
+		ID3D11DeviceContext* context = nullptr;
+		D3D11BufferHandler* bufferHandler;
+		D3D11TextureHandler* textureHandler;
+		std::vector<Slot> slots;
+		SGReadbackRing ring;
+
+		void Update(ID3D11DeviceContext* context); // Once per frame on the render thread, after the work of the frame is submitted
+
+		bool CopyToSlot(size_t slot, const SGReadbackSource& source) override;
+		bool IsSlotReady(size_t slot) override;
+		bool MapSlot(size_t slot, SGReadbackData& data) override;
+		void UnmapSlot(size_t slot) override;
+
+		bool CopyBuffer(Slot& slot, const SGReadbackSource& source);
+		bool CopyTexture(Slot& slot, const SGReadbackSource& source);
+		bool PrepareSlot(Slot& slot, StagingType type, DXGI_FORMAT format, UINT width, UINT height, UINT depth);
+	};
+}
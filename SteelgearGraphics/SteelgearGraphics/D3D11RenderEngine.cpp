@@ -1,21 +1,36 @@
 #include "D3D11RenderEngine.h"
+#include "D3D11Capture.h"
 #include "D3D11CommonTypes.h"
+#include "SGStateDiff.h"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
 
 SG::D3D11RenderEngine::D3D11RenderEngine(const SGRenderSettings & settings) : SGRenderEngine(settings)
 {
 	this->CreateDeviceAndContext(settings);
-	bufferHandler = new D3D11BufferHandler(device);
+	bufferHandler = new D3D11BufferHandler(device, &loadQueue);
 	samplerHandler = new D3D11SamplerHandler(device);
-	shaderManager = new D3D11ShaderManager(device);
+	shaderManager = new D3D11ShaderManager(device, &loadQueue);
 	this->stateHandler = new D3D11StateHandler(device);
-	this->textureHandler = new D3D11TextureHandler(device);
+	this->textureHandler = new D3D11TextureHandler(device, &loadQueue, settings.textureUpdateBudgetPerFrame);
 	this->pipelineManager = new D3D11PipelineManager(device);
 	this->drawCallHandler = new D3D11DrawCallHandler(device);
-	this->CreateSwapChain(settings);
+	this->textureStreamer = new D3D11TextureStreamer(textureHandler, &loadQueue, settings.textureStreamingBudget);
+	this->readback = new D3D11Readback(device, bufferHandler, textureHandler, settings.readbackSlots);
+	this->streamingViewportHeight = static_cast<float>(settings.backBufferSettings.height);
+	this->specializedDrawLoops = settings.specializedDrawLoops;
+
+	if (settings.headless)
+		this->CreateHeadlessBackBuffers(settings);
+	else
+		this->CreateSwapChain(settings);
 }
 
 SG::D3D11RenderEngine::~D3D11RenderEngine()
 {
+	loadQueue.Stop();
 	engineActive = false;
 	while (renderthreadActive)
 	{
@@ -29,6 +44,8 @@ SG::D3D11RenderEngine::~D3D11RenderEngine()
 	for (auto& context : defferedContexts)
 		ReleaseCOM(context);
 
+	delete readback;
+	delete textureStreamer;
 	delete bufferHandler;
 	delete samplerHandler;
 	delete shaderManager;
@@ -36,6 +53,10 @@ SG::D3D11RenderEngine::~D3D11RenderEngine()
 	delete textureHandler;
 	delete pipelineManager;
 	delete drawCallHandler;
+
+	for (auto& textures : transientPool)
+		for (auto& texture : textures)
+			ReleaseCOM(texture);
 }
 
 SG::D3D11BufferHandler * SG::D3D11RenderEngine::BufferHandler()
@@ -73,6 +94,76 @@ SG::D3D11DrawCallHandler * SG::D3D11RenderEngine::DrawCallHandler()
 	return drawCallHandler;
 }
 
+SG::D3D11TextureStreamer * SG::D3D11RenderEngine::TextureStreamer()
+{
+	return textureStreamer;
+}
+
+SG::D3D11Readback * SG::D3D11RenderEngine::Readback()
+{
+	return readback;
+}
+
+SG::SGTransientPlan SG::D3D11RenderEngine::GetTransientPlan(const SGGuid & pipelineGuid)
+{
+	transientMutex.lock();
+	auto plan = transientPlans.find(pipelineGuid);
+	SGTransientPlan toReturn = plan != transientPlans.end() ? plan->second : SGTransientPlan();
+	transientMutex.unlock();
+
+	return toReturn;
+}
+
+SG::SGResult SG::D3D11RenderEngine::CreateLODSet(const SGGuid & guid, const SGLODSet & lodSet)
+{
+	SGCaptureScope capture(SGCaptureCall::CREATE_LOD_SET, guid, lodSet);
+	if (lodSet.levels.size() == 0 || lodSet.association == Association::GLOBAL)
+		return SGResult::FAIL;
+
+	SGLODThresholds thresholds;
+	thresholds.hysteresis = lodSet.hysteresis;
+
+	for (size_t i = 0; i < lodSet.levels.size(); ++i)
+	{
+		const SGLODLevel& level = lodSet.levels[i];
+
+		if (i > 0 && level.screenSizeThreshold > lodSet.levels[i - 1].screenSizeThreshold)
+			return SGResult::FAIL;
+
+		thresholds.screenSizes.push_back(level.screenSizeThreshold);
+	}
+
+	if (lodSet.association == Association::GROUP)
+	{
+		SGGuid noGuid;
+
+		for (auto& level : lodSet.levels)
+		{
+			if (level.levelGroup == noGuid)
+				return SGResult::FAIL;
+
+			SGResult result = SGResult::OK;
+
+			if (level.vertexBuffer != noGuid && result == SGResult::OK)
+				result = bufferHandler->BindBufferToGroup(level.levelGroup, level.vertexBuffer, lodSet.vertexBufferBindGuid);
+			if (level.indexBuffer != noGuid && result == SGResult::OK)
+				result = bufferHandler->BindBufferToGroup(level.levelGroup, level.indexBuffer, lodSet.indexBufferBindGuid);
+			if (level.drawCall != noGuid && result == SGResult::OK)
+				result = drawCallHandler->BindDrawCallToGroup(level.levelGroup, level.drawCall, lodSet.drawCallBindGuid);
+
+			if (result != SGResult::OK)
+				return result;
+		}
+	}
+
+	lodMutex.lock();
+	lodLevelBindings[guid] = lodSet;
+	lodMutex.unlock();
+
+	RegisterLODSet(guid, thresholds, lodSet.association == Association::GROUP);
+	return SGResult::OK;
+}
+
 void SG::D3D11RenderEngine::CreateDeviceAndContext(const SGRenderSettings & settings)
 {
 	UINT flags = 0;
@@ -83,7 +174,11 @@ void SG::D3D11RenderEngine::CreateDeviceAndContext(const SGRenderSettings & sett
 	//if (settings.nrOfContexts <= 1)
 	//	flags |= D3D11_CREATE_DEVICE_SINGLETHREADED;
 
-	if (FAILED(D3D11CreateDevice(settings.adapter, D3D_DRIVER_TYPE_HARDWARE, NULL, flags, NULL, 0, D3D11_SDK_VERSION, &device, NULL, &immediateContext)))
+	// The null driver can not be combined with an adapter
+	IDXGIAdapter* adapter = settings.headless ? nullptr : settings.adapter;
+	D3D_DRIVER_TYPE driverType = settings.headless ? D3D_DRIVER_TYPE_NULL : D3D_DRIVER_TYPE_HARDWARE;
+
+	if (FAILED(D3D11CreateDevice(adapter, driverType, NULL, flags, NULL, 0, D3D11_SDK_VERSION, &device, NULL, &immediateContext)))
 		throw std::runtime_error("Error creating device and immediate context");
 
 	for (int i = 0; i < (settings.nrOfContexts >= 1 ? settings.nrOfContexts : 1); ++i)
@@ -93,6 +188,117 @@ void SG::D3D11RenderEngine::CreateDeviceAndContext(const SGRenderSettings & sett
 			throw std::runtime_error("Error creating deffered context");
 
 		defferedContexts.push_back(defferedContext);
+		contextStates.push_back(ContextShadowState{});
+	}
+}
+
+SG::ContextShadowState & SG::D3D11RenderEngine::GetContextState(ID3D11DeviceContext * context)
+{
+	for (size_t i = 0; i < defferedContexts.size(); ++i)
+		if (defferedContexts[i] == context)
+			return contextStates[i];
+
+	throw std::runtime_error("Error, no shadow state exists for context");
+}
+
+size_t SG::D3D11RenderEngine::GetResourceID(ID3D11Resource * resource)
+{
+	// Views hand out the resource they were created with, so buffers and views of them get the same ID
+	return reinterpret_cast<size_t>(resource);
+}
+
+void SG::D3D11RenderEngine::UnbindHazards(ContextShadowState & state, ID3D11DeviceContext * context)
+{
+	bool outputMergerChanged = false;
+	SGProfiler::Count(SGCounter::HAZARD_UNBINDS, state.hazards.size());
+
+	for (auto& hazard : state.hazards)
+	{
+		switch (hazard.type)
+		{
+		case SGBindType::VERTEX_BUFFER:
+		{
+			ID3D11Buffer* buffer = nullptr;
+			UINT zero = 0;
+			context->IASetVertexBuffers(hazard.slot, 1, &buffer, &zero, &zero);
+			state.render.vertexBuffers[hazard.slot] = { nullptr, 0, 0 };
+			break;
+		}
+		case SGBindType::INDEX_BUFFER:
+			context->IASetIndexBuffer(nullptr, state.render.indexBuffer.format, 0);
+			state.render.indexBuffer.buffer = nullptr;
+			state.render.indexBuffer.offset = 0;
+			break;
+		case SGBindType::SHADER_RESOURCE:
+			UnbindShaderResource(state, hazard, context);
+			break;
+		case SGBindType::RENDER_TARGET:
+			state.render.rtvs[hazard.slot] = nullptr;
+			outputMergerChanged = true;
+			break;
+		case SGBindType::DEPTH_STENCIL:
+			state.render.dsv = nullptr;
+			outputMergerChanged = true;
+			break;
+		case SGBindType::UNORDERED_ACCESS:
+			if (hazard.stage == SGBindStage::COMPUTE_SHADER)
+			{
+				ID3D11UnorderedAccessView* uav = nullptr;
+				context->CSSetUnorderedAccessViews(hazard.slot, 1, &uav, nullptr);
+				state.compute.unorderedAccessViews[hazard.slot] = nullptr;
+			}
+			else
+			{
+				state.render.uavs[hazard.slot] = nullptr;
+				outputMergerChanged = true;
+			}
+			break;
+		}
+	}
+
+	// The shadow already has the conflicting outputs removed, setting it again unbinds all of them with one call
+	if (outputMergerChanged)
+	{
+		RenderPipelineState& render = state.render;
+		context->OMSetRenderTargetsAndUnorderedAccessViews(render.nrOfRTVs, render.rtvs, render.dsv,
+			render.nrOfRTVs, 8 - render.nrOfRTVs, render.uavs + render.nrOfRTVs, nullptr);
+	}
+
+	state.hazards.clear();
+}
+
+void SG::D3D11RenderEngine::UnbindShaderResource(ContextShadowState & state, const SGBindPoint & bindPoint, ID3D11DeviceContext * context)
+{
+	ID3D11ShaderResourceView* srv = nullptr;
+
+	switch (bindPoint.stage)
+	{
+	case SGBindStage::VERTEX_SHADER:
+		context->VSSetShaderResources(bindPoint.slot, 1, &srv);
+		state.render.vertexShader.shaderResourceViews[bindPoint.slot] = nullptr;
+		break;
+	case SGBindStage::HULL_SHADER:
+		context->HSSetShaderResources(bindPoint.slot, 1, &srv);
+		state.render.hullShader.shaderResourceViews[bindPoint.slot] = nullptr;
+		break;
+	case SGBindStage::DOMAIN_SHADER:
+		context->DSSetShaderResources(bindPoint.slot, 1, &srv);
+		state.render.domainShader.shaderResourceViews[bindPoint.slot] = nullptr;
+		break;
+	case SGBindStage::GEOMETRY_SHADER:
+		context->GSSetShaderResources(bindPoint.slot, 1, &srv);
+		state.render.geometryShader.shaderResourceViews[bindPoint.slot] = nullptr;
+		break;
+	case SGBindStage::PIXEL_SHADER:
+		context->PSSetShaderResources(bindPoint.slot, 1, &srv);
+		state.render.pixelShader.shaderResourceViews[bindPoint.slot] = nullptr;
+		break;
+	case SGBindStage::COMPUTE_SHADER:
+		context->CSSetShaderResources(bindPoint.slot, 1, &srv);
+		state.compute.shaderResourceViews[bindPoint.slot] = nullptr;
+		break;
+	default:
+		break;
 	}
 }
 
@@ -148,8 +354,48 @@ void SG::D3D11RenderEngine::CreateSwapChain(const SGRenderSettings & settings)
 	}
 }
 
+void SG::D3D11RenderEngine::CreateHeadlessBackBuffers(const SGRenderSettings & settings)
+{
+	// Plain textures under the same guids, so that pipelines written for the swap chain work unchanged
+	D3D11_TEXTURE2D_DESC desc;
+	desc.Width = settings.backBufferSettings.width;
+	desc.Height = settings.backBufferSettings.height;
+	desc.MipLevels = 1;
+	desc.ArraySize = 1;
+	desc.Format = settings.backBufferSettings.format;
+	desc.SampleDesc.Count = settings.backBufferSettings.multiSampleCount;
+	desc.SampleDesc.Quality = settings.backBufferSettings.multiSampleQuality;
+	desc.Usage = D3D11_USAGE_DEFAULT;
+	desc.BindFlags = D3D11_BIND_RENDER_TARGET | D3D11_BIND_SHADER_RESOURCE;
+	desc.CPUAccessFlags = 0;
+	desc.MiscFlags = 0;
+
+	for (int i = 0; i < settings.backBufferSettings.nrOfBackBuffers - 1; ++i)
+	{
+		ID3D11Texture2D* texture;
+		if (FAILED(device->CreateTexture2D(&desc, nullptr, &texture)))
+			throw std::runtime_error("Error creating headless back buffer");
+
+		textureHandler->AddTexture2D(SGGuid(std::string("SG_BACKBUFFER_") + std::to_string(i)), texture);
+	}
+}
+
+void SG::D3D11RenderEngine::Present()
+{
+	SGTraceScope scope("Present");
+
+	// After the work of the frame, so readbacks requested during it see its results
+	readback->Update(immediateContext);
+
+	if (swapChain != nullptr)
+		swapChain->Present(0, 0);
+}
+
 void SG::D3D11RenderEngine::FinishFrame()
 {
+	SGTraceScope scope("D3D11RenderEngine::FinishFrame");
+
+	textureStreamer->FinishFrame();
 	bufferHandler->FinishFrame();
 	samplerHandler->FinishFrame();
 	shaderManager->FinishFrame();
@@ -161,6 +407,8 @@ void SG::D3D11RenderEngine::FinishFrame()
 
 void SG::D3D11RenderEngine::SwapFrame()
 {
+	SGTraceScope scope("D3D11RenderEngine::SwapFrame");
+
 	bufferHandler->SwapFrame();
 	samplerHandler->SwapFrame();
 	shaderManager->SwapFrame();
@@ -168,81 +416,648 @@ void SG::D3D11RenderEngine::SwapFrame()
 	textureHandler->SwapFrame();
 	pipelineManager->SwapFrame();
 	drawCallHandler->SwapFrame();
+
+	std::vector<SGGuid> changedGuids = pipelineManager->changedGuids;
+	changedGuids.insert(changedGuids.end(), textureHandler->changedViews.begin(), textureHandler->changedViews.end());
+	changedGuids.insert(changedGuids.end(), bufferHandler->changedViews.begin(), bufferHandler->changedViews.end());
+	InvalidateCompiledPipelines(changedGuids);
 }
 
 void SG::D3D11RenderEngine::ExecuteJobs(const std::vector<SGGraphicsJob>& jobs)
 {
-	unsigned int nrOfContexts = static_cast<unsigned int>(jobs.size() < defferedContexts.size() ? jobs.size() : defferedContexts.size());
-	unsigned int jobsPerContext = static_cast<unsigned int>(jobs.size() / nrOfContexts);
-	size_t threadsToUse = (jobs.size() < nrOfContexts ? jobs.size() - 1 : nrOfContexts - 1);
-	std::vector<SG::FunctionStatus> statuses(threadsToUse);
+	SGTraceScope scope("D3D11RenderEngine::ExecuteJobs");
 
+	// More segments than contexts lets a thread that finishes early pick up the work of a slower one
+	const size_t segmentsPerContext = 4;
+	const size_t nrOfSegments = defferedContexts.size() * segmentsPerContext;
 
-	for (int i = 0; i < static_cast<int>(threadsToUse); ++i)
+	// On the immediate context before any command list is executed, so every job of the frame sees the updates
+	textureHandler->UploadUpdates(immediateContext);
+	CreateJobChunks(jobs, nrOfSegments);
+	PredictChunkTimes();
+	jobBalancer.CreateSegments(predictedChunkTimes, nrOfSegments);
+	segmentCommandLists.assign(jobBalancer.GetSegments().size(), nullptr);
+
+	size_t nrOfContexts = segmentCommandLists.size() < defferedContexts.size() ? segmentCommandLists.size() : defferedContexts.size();
+
+	if (nrOfContexts == 0)
 	{
-		auto temp = std::bind(&D3D11RenderEngine::HandlePipelineJobs, this, jobs, i * jobsPerContext, (i + 1) * jobsPerContext, defferedContexts[i]);
+		Present();
+		return;
+	}
+
+	size_t threadsToUse = nrOfContexts - 1;
+	std::vector<std::atomic<SG::FunctionStatus>> statuses(threadsToUse);
+
+	for (size_t i = 0; i < threadsToUse; ++i)
+	{
+		auto temp = std::bind(&D3D11RenderEngine::RecordChunkSegments, this, std::cref(jobs), defferedContexts[i]);
 		threadPool->EnqueFunction(&statuses[i], temp);
 	}
 
-	HandlePipelineJobs(jobs, nrOfContexts - 1, static_cast<int>(jobs.size()), defferedContexts[threadsToUse]);
+	RecordChunkSegments(jobs, defferedContexts[threadsToUse]);
+	std::chrono::steady_clock::time_point waitStart;
+
+	if constexpr (PROFILING_VERSION)
+		waitStart = std::chrono::steady_clock::now();
 
 	for (size_t i = 0; i < threadsToUse; ++i)
 	{
-		while (statuses[i] != FunctionStatus::FINISHED)
+		// Acquire, so the command lists recorded by the worker are visible once it is seen finished
+		while (statuses[i].load(std::memory_order_acquire) != FunctionStatus::FINISHED)
 		{
 			// Spinwait
 		}
+	}
+
+	if constexpr (PROFILING_VERSION)
+		profiler.CurrentFrame().workerWaitTime = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - waitStart).count();
 
-		ID3D11CommandList* cmdList;
-		
-		if(FAILED(defferedContexts[i]->FinishCommandList(false, &cmdList)))
+	// Segments are recorded in whatever order the threads pick them up, but always executed in chunk order
+	for (auto& commandList : segmentCommandLists)
+	{
+		if (commandList == nullptr)
 			throw std::runtime_error("Error finishing command list");
 
-		immediateContext->ExecuteCommandList(cmdList, false);
-		ReleaseCOM(cmdList);
+		immediateContext->ExecuteCommandList(commandList, false);
+		ReleaseCOM(commandList);
+	}
+
+	UpdateJobTimes();
+
+	if constexpr (PROFILING_VERSION)
+	{
+		SGFrameProfile& frame = profiler.CurrentFrame();
+
+		for (auto& chunk : jobChunks)
+		{
+			frame.recordingTime += chunk.recordedTime;
+			frame.AddPipelineTime(jobs[chunk.graphicsJob].pipelineGuid.GetID(), chunk.recordedTime);
+			frame.AddJobTime(chunk.pipelineJob.second.GetID(), chunk.recordedTime);
+		}
+	}
+
+	Present();
+}
+
+void SG::D3D11RenderEngine::ApplyLODLevel(const SGGraphicalEntityID & entity, const SGGuid & lodSetGuid, unsigned int level)
+{
+	// Copied out under the lock, the binds below take the locks of the handlers
+	lodMutex.lock();
+	auto found = lodLevelBindings.find(lodSetGuid);
+
+	if (found == lodLevelBindings.end() || level >= found->second.levels.size())
+	{
+		lodMutex.unlock();
+		return;
+	}
+
+	const SGLODSet& lodSet = found->second;
+	SGLODLevel lodLevel = lodSet.levels[level];
+	Association association = lodSet.association;
+	SGGuid vertexBufferBindGuid = lodSet.vertexBufferBindGuid;
+	SGGuid indexBufferBindGuid = lodSet.indexBufferBindGuid;
+	SGGuid drawCallBindGuid = lodSet.drawCallBindGuid;
+	lodMutex.unlock();
+
+	if (association == Association::GROUP)
+	{
+		ChangeEntityGroup(entity, lodLevel.levelGroup);
+		return;
+	}
+
+	SGGuid noGuid;
+
+	if (lodLevel.vertexBuffer != noGuid)
+		bufferHandler->BindBufferToEntity(entity, lodLevel.vertexBuffer, vertexBufferBindGuid);
+	if (lodLevel.indexBuffer != noGuid)
+		bufferHandler->BindBufferToEntity(entity, lodLevel.indexBuffer, indexBufferBindGuid);
+	if (lodLevel.drawCall != noGuid)
+		drawCallHandler->BindDrawCallToEntity(entity, lodLevel.drawCall, drawCallBindGuid);
+}
+
+void SG::D3D11RenderEngine::RequestTextureMips(const SGGraphicsJob & job)
+{
+	const std::vector<SGGraphicalEntityID>& entities = job.entitiesToRender;
+	screenSizeBuffer.resize(entities.size());
+
+	lodMutex.lock();
+	ComputeScreenSizes(entityBounds, lodCamera, entities.data(), entities.size(), screenSizeBuffer.data());
+	lodMutex.unlock();
+
+	SGGuid viewGuid;
+	entityMutex.lock();
+
+	for (size_t i = 0; i < entities.size(); ++i)
+	{
+		const SGGuid& groupGuid = graphicalEntities[entities[i]].groupGuid;
+
+		// Views that are not streamed are ignored by the streamer
+		for (auto& bindGuid : job.streamedTextureBinds)
+			if (textureHandler->GetBoundView(bindGuid, entities[i], groupGuid, viewGuid))
+				textureStreamer->RequestScreenSize(viewGuid, screenSizeBuffer[i], streamingViewportHeight);
+	}
+
+	entityMutex.unlock();
+}
+
+const std::vector<std::pair<SG::PipelineJobType, SG::SGGuid>>& SG::D3D11RenderEngine::GetCompiledPipeline(const SGGuid & pipelineGuid)
+{
+	auto found = compiledPipelines.find(pipelineGuid);
+
+	if (found != compiledPipelines.end())
+		return found->second.jobs;
+
+	SGPipeline pipeline = pipelineManager->GetPipeline(pipelineGuid);
+	CompiledPipeline compiled;
+	std::vector<SGRenderGraphNode> nodes;
+	std::vector<size_t> outputs;
+
+	compiled.dependencies.push_back(pipelineGuid);
+
+	for (auto& texture : pipeline.transientTextures)
+	{
+		for (auto& view : texture.views)
+		{
+			transientViewTextures[view.first] = texture.guid;
+			compiled.transientViews.push_back(view.first);
+		}
+	}
+
+	for (auto& job : pipeline.jobs)
+	{
+		compiled.dependencies.push_back(job.second);
+		nodes.push_back(CreateRenderGraphNode(job, compiled.dependencies));
 	}
 
-	ID3D11CommandList* cmdList;
+	for (auto& output : pipeline.outputs)
+		outputs.push_back(output.GetID());
 
-	if (FAILED(defferedContexts[threadsToUse]->FinishCommandList(false, &cmdList)))
-		throw std::runtime_error("Error finishing command list");
+	SGCompiledRenderGraph graph = CompileRenderGraph(nodes, outputs);
+	CreateTransientTextures(pipelineGuid, pipeline, nodes, graph);
 
-	immediateContext->ExecuteCommandList(cmdList, false);
-	ReleaseCOM(cmdList);
+	for (size_t node : graph.order)
+		compiled.jobs.push_back(pipeline.jobs[node]);
 
-	swapChain->Present(0, 0);
+	return compiledPipelines.emplace(pipelineGuid, std::move(compiled)).first->second.jobs;
 }
 
-void SG::D3D11RenderEngine::HandlePipelineJobs(const std::vector<SGGraphicsJob>& jobs, int startPos, int endPos, ID3D11DeviceContext * context)
+void SG::D3D11RenderEngine::InvalidateCompiledPipelines(const std::vector<SGGuid>& changedGuids)
 {
-	for (int i = startPos; i < endPos; ++i)
+	if (changedGuids.empty())
+		return;
+
+	std::unordered_set<SGGuid> changed(changedGuids.begin(), changedGuids.end());
+	bool invalidated = true;
+
+	// Other pipelines may have resolved the transient views of an invalidated one, so those count as changed as well
+	while (invalidated)
 	{
-		SGPipeline pipeline = pipelineManager->GetPipeline(jobs[i].pipelineGuid);
+		invalidated = false;
 
-		for (auto& job : pipeline.jobs)
+		for (auto compiled = compiledPipelines.begin(); compiled != compiledPipelines.end();)
 		{
-			switch (job.first)
+			const std::vector<SGGuid>& dependencies = compiled->second.dependencies;
+
+			if (std::none_of(dependencies.begin(), dependencies.end(), [&](const SGGuid& guid) { return changed.count(guid) != 0; }))
 			{
-			case PipelineJobType::RENDER:
-				HandleRenderJob(pipelineManager->GetRenderJob(job.second), jobs[i].entitiesToRender, context);
+				++compiled;
+				continue;
+			}
+
+			for (auto& view : compiled->second.transientViews)
+			{
+				transientViewTextures.erase(view);
+				changed.insert(view);
+			}
+
+			compiled = compiledPipelines.erase(compiled);
+			invalidated = true;
+		}
+	}
+}
+
+SG::SGRenderGraphNode SG::D3D11RenderEngine::CreateRenderGraphNode(const std::pair<PipelineJobType, SGGuid>& job, std::vector<SGGuid>& dependencies)
+{
+	SGRenderGraphNode node;
+
+	switch (job.first)
+	{
+	case PipelineJobType::RENDER:
+	{
+		SGRenderJob renderJob = pipelineManager->GetRenderJob(job.second);
+
+		for (auto& vertexBuffer : renderJob.vertexBuffers)
+			AddComponentRead(vertexBuffer.buffer, node);
+
+		AddComponentRead(renderJob.indexBuffer.buffer, node);
+
+		for (const RenderShader* shader : { &renderJob.vertexShader, &renderJob.hullShader, &renderJob.domainShader,
+			&renderJob.geometryShader, &renderJob.pixelShader })
+		{
+			for (auto& constantBuffer : shader->constantBuffers)
+				AddComponentRead(constantBuffer.component, node);
+
+			for (auto& srv : shader->shaderResourceViews)
+				AddViewAccess(srv, true, false, node, dependencies);
+		}
+
+		for (auto& rtv : renderJob.rtvs)
+			AddViewAccess(rtv, false, true, node, dependencies);
+
+		for (auto& uav : renderJob.uavs)
+			AddViewAccess(uav, true, true, node, dependencies);
+
+		AddViewAccess(renderJob.dsv, true, true, node, dependencies);
+		break;
+	}
+	case PipelineJobType::COMPUTE:
+	{
+		SGComputeJob computeJob = pipelineManager->GetComputeJob(job.second);
+
+		for (auto& constantBuffer : computeJob.constantBuffers)
+			AddComponentRead(constantBuffer.component, node);
+
+		for (auto& srv : computeJob.shaderResourceViews)
+			AddViewAccess(srv, true, false, node, dependencies);
+
+		for (auto& uav : computeJob.unorderedAccessViews)
+			AddViewAccess(uav, true, true, node, dependencies);
+
+		break;
+	}
+	case PipelineJobType::CLEAR_RENDER_TARGET:
+	case PipelineJobType::CLEAR_DEPTH_STENCIL:
+	{
+		ResourceView view;
+		view.type = ResourceView::ResourceType::TEXTURE;
+		view.component = { Association::GLOBAL, job.first == PipelineJobType::CLEAR_RENDER_TARGET ?
+			pipelineManager->GetClearRenderTargetJob(job.second).toClear : pipelineManager->GetClearDepthStencilJob(job.second).toClear };
+		AddViewAccess(view, false, true, node, dependencies);
+		break;
+	}
+	default:
+		node.barrier = true;
+		break;
+	}
+
+	return node;
+}
+
+void SG::D3D11RenderEngine::AddComponentRead(const PipelineComponent & component, SGRenderGraphNode & node)
+{
+	if (component.resourceGuid == SGGuid())
+		return;
+
+	if (component.source == Association::GLOBAL)
+		node.reads.push_back(component.resourceGuid.GetID());
+	else
+		node.readsUnknown = true;
+}
+
+void SG::D3D11RenderEngine::AddViewAccess(const ResourceView & view, bool read, bool write, SGRenderGraphNode & node,
+	std::vector<SGGuid>& dependencies)
+{
+	if (view.component.resourceGuid == SGGuid())
+		return;
+
+	// Views bound to groups or entities are resolved when recording, so the order does not depend on them
+	if (view.component.source == Association::GLOBAL)
+		dependencies.push_back(view.component.resourceGuid);
+
+	auto transientTexture = transientViewTextures.find(view.component.resourceGuid);
+
+	if (view.component.source == Association::GLOBAL && transientTexture != transientViewTextures.end())
+	{
+		if (read)
+			node.reads.push_back(transientTexture->second.GetID());
+
+		if (write)
+			node.writes.push_back(transientTexture->second.GetID());
+
+		return;
+	}
+
+	FrameMap<SGGuid, D3D11ResourceViewData>& views = view.type == ResourceView::ResourceType::TEXTURE ? textureHandler->views : bufferHandler->views;
+
+	// Views bound to groups or entities can point to different resources for every entity
+	if (view.component.source != Association::GLOBAL || !views.HasElement(view.component.resourceGuid))
+	{
+		node.readsUnknown |= read;
+		node.barrier |= write;
+		return;
+	}
+
+	size_t resource = views[view.component.resourceGuid].resourceGuid.GetID();
+
+	if (read)
+		node.reads.push_back(resource);
+
+	if (write)
+		node.writes.push_back(resource);
+}
+
+void SG::D3D11RenderEngine::CreateTransientTextures(const SGGuid & pipelineGuid, const SGPipeline & pipeline,
+	const std::vector<SGRenderGraphNode>& nodes, const SGCompiledRenderGraph & graph)
+{
+	const size_t none = static_cast<size_t>(-1);
+	std::unordered_map<size_t, size_t> textureIndices;
+	std::vector<SGTransientResource> resources;
+
+	for (size_t i = 0; i < pipeline.transientTextures.size(); ++i)
+	{
+		const SGTransientTexture& texture = pipeline.transientTextures[i];
+		textureIndices[texture.guid.GetID()] = i;
+		resources.push_back({ GetTransientDescriptorKey(texture),
+			GetSlicePitch(texture.format, texture.width, texture.height), none, none });
+	}
+
+	// Lifetimes are measured in positions of the compiled order, since that is the order the jobs are executed in
+	for (size_t position = 0; position < graph.order.size(); ++position)
+	{
+		const SGRenderGraphNode& node = nodes[graph.order[position]];
+
+		for (const std::vector<size_t>* accesses : { &node.reads, &node.writes })
+		{
+			for (size_t resource : *accesses)
+			{
+				auto index = textureIndices.find(resource);
+
+				if (index == textureIndices.end())
+					continue;
+
+				SGTransientResource& transient = resources[index->second];
+				transient.firstUse = transient.firstUse == none || position < transient.firstUse ? position : transient.firstUse;
+				transient.lastUse = transient.lastUse == none || position > transient.lastUse ? position : transient.lastUse;
+			}
+		}
+	}
+
+	// Textures that no remaining job uses never get any memory
+	std::vector<size_t> usedTextures;
+	std::vector<SGTransientResource> usedResources;
+
+	for (size_t i = 0; i < resources.size(); ++i)
+	{
+		if (resources[i].firstUse == none)
+			continue;
+
+		usedTextures.push_back(i);
+		usedResources.push_back(resources[i]);
+	}
+
+	SGTransientPlan plan = PlanTransientResources(usedResources);
+
+	// Pipelines run one after the other and transient content does not outlive its pipeline,
+	// so every pipeline can start from the front of the pool
+	std::vector<ID3D11Texture2D*> backings;
+	std::vector<size_t> nrUsedPerKey(transientDescriptors.size(), 0);
+
+	for (size_t key : plan.allocationKeys)
+		backings.push_back(GetTransientBacking(key, nrUsedPerKey[key]++));
+
+	std::unordered_map<SGGuid, D3D11ResourceViewData>& views = textureHandler->views.Elements();
+
+	for (size_t i = 0; i < usedTextures.size(); ++i)
+	{
+		const SGTransientTexture& texture = pipeline.transientTextures[usedTextures[i]];
+		ID3D11Texture2D* backing = backings[plan.assignments[i]];
+
+		for (auto& view : texture.views)
+		{
+			D3D11ResourceViewData toStore;
+			toStore.type = view.second;
+			toStore.view.srv = nullptr;
+			toStore.resourceGuid = texture.guid;
+			toStore.resource = backing;
+
+			HRESULT result = E_FAIL;
+
+			switch (view.second)
+			{
+			case ResourceViewType::SRV:
+				result = device->CreateShaderResourceView(backing, nullptr, &toStore.view.srv);
 				break;
-			case PipelineJobType::COMPUTE:
-				HandleComputeJob(pipelineManager->GetComputeJob(job.second), jobs[i].entitiesToRender, context);
+			case ResourceViewType::UAV:
+				result = device->CreateUnorderedAccessView(backing, nullptr, &toStore.view.uav);
 				break;
-			case PipelineJobType::CLEAR_RENDER_TARGET:
-				HandleClearRenderTargetJob(pipelineManager->GetClearRenderTargetJob(job.second), context);
+			case ResourceViewType::RTV:
+				result = device->CreateRenderTargetView(backing, nullptr, &toStore.view.rtv);
+				break;
+			case ResourceViewType::DSV:
+				result = device->CreateDepthStencilView(backing, nullptr, &toStore.view.dsv);
 				break;
-			case PipelineJobType::CLEAR_DEPTH_STENCIL:
-				HandleClearDepthStencilJob(pipelineManager->GetClearDepthStencilJob(job.second), context);
 			}
+
+			if (FAILED(result))
+				throw std::runtime_error("Error creating view of transient texture");
+
+			// Erased first since the move assignment of the view data does not release the view it replaces
+			views.erase(view.first);
+			views.emplace(view.first, std::move(toStore));
+		}
+	}
+
+	transientMutex.lock();
+	transientPlans[pipelineGuid] = plan;
+	transientMutex.unlock();
+}
+
+size_t SG::D3D11RenderEngine::GetTransientDescriptorKey(const SGTransientTexture & texture)
+{
+	D3D11_TEXTURE2D_DESC desc;
+	desc.Width = texture.width;
+	desc.Height = texture.height;
+	desc.MipLevels = 1;
+	desc.ArraySize = 1;
+	desc.Format = texture.format;
+	desc.SampleDesc.Count = 1;
+	desc.SampleDesc.Quality = 0;
+	desc.Usage = D3D11_USAGE_DEFAULT;
+	desc.BindFlags = 0;
+	desc.CPUAccessFlags = 0;
+	desc.MiscFlags = 0;
+
+	for (auto& view : texture.views)
+	{
+		switch (view.second)
+		{
+		case ResourceViewType::SRV:
+			desc.BindFlags |= D3D11_BIND_SHADER_RESOURCE;
+			break;
+		case ResourceViewType::UAV:
+			desc.BindFlags |= D3D11_BIND_UNORDERED_ACCESS;
+			break;
+		case ResourceViewType::RTV:
+			desc.BindFlags |= D3D11_BIND_RENDER_TARGET;
+			break;
+		case ResourceViewType::DSV:
+			desc.BindFlags |= D3D11_BIND_DEPTH_STENCIL;
+			break;
+		}
+	}
+
+	for (size_t i = 0; i < transientDescriptors.size(); ++i)
+	{
+		const D3D11_TEXTURE2D_DESC& stored = transientDescriptors[i];
+
+		if (stored.Width == desc.Width && stored.Height == desc.Height && stored.Format == desc.Format && stored.BindFlags == desc.BindFlags)
+			return i;
+	}
+
+	transientDescriptors.push_back(desc);
+	transientPool.push_back(std::vector<ID3D11Texture2D*>());
+	return transientDescriptors.size() - 1;
+}
+
+ID3D11Texture2D * SG::D3D11RenderEngine::GetTransientBacking(size_t descriptorKey, size_t poolIndex)
+{
+	std::vector<ID3D11Texture2D*>& pool = transientPool[descriptorKey];
+
+	while (pool.size() <= poolIndex)
+	{
+		ID3D11Texture2D* texture;
+
+		if (FAILED(device->CreateTexture2D(&transientDescriptors[descriptorKey], nullptr, &texture)))
+			throw std::runtime_error("Error creating transient texture");
+
+		pool.push_back(texture);
+	}
+
+	return pool[poolIndex];
+}
+
+void SG::D3D11RenderEngine::CreateJobChunks(const std::vector<SGGraphicsJob>& jobs, size_t maxChunksPerJob)
+{
+	jobChunks.clear();
+
+	for (size_t i = 0; i < jobs.size(); ++i)
+	{
+		const std::vector<std::pair<PipelineJobType, SGGuid>>& pipelineJobs = GetCompiledPipeline(jobs[i].pipelineGuid);
+		const std::vector<SGGraphicalEntityID>& entities = jobs[i].entitiesToRender;
+
+		for (auto& job : pipelineJobs)
+		{
+			size_t nrOfChunks = 1;
+			Association association = Association::GLOBAL;
+
+			// Only render jobs that draw per entity or group can be split, everything else is recorded as a whole
+			if (job.first == PipelineJobType::RENDER && entities.size() >= 2 * minimumEntitiesPerChunk)
+			{
+				association = pipelineManager->GetRenderJobAssociation(job.second);
+
+				if (association != Association::GLOBAL)
+				{
+					nrOfChunks = entities.size() / minimumEntitiesPerChunk;
+					nrOfChunks = nrOfChunks < maxChunksPerJob ? nrOfChunks : maxChunksPerJob;
+				}
+			}
+
+			if (nrOfChunks <= 1)
+			{
+				jobChunks.push_back({ i, job, 0, entities.size(), 0.0 });
+				continue;
+			}
+
+			size_t entitiesPerChunk = (entities.size() + nrOfChunks - 1) / nrOfChunks;
+			size_t chunkStart = 0;
+
+			while (chunkStart < entities.size())
+			{
+				size_t chunkEnd = chunkStart + entitiesPerChunk < entities.size() ? chunkStart + entitiesPerChunk : entities.size();
+
+				// A group is drawn instanced with a single draw call so it can not be split between two chunks
+				if (association == Association::GROUP)
+					chunkEnd = GetGroupEnd(entities, chunkEnd - 1, entities.size());
+
+				jobChunks.push_back({ i, job, chunkStart, chunkEnd, 0.0 });
+				chunkStart = chunkEnd;
+			}
+		}
+	}
+}
+
+size_t SG::D3D11RenderEngine::GetGroupEnd(const std::vector<SGGraphicalEntityID>& entities, size_t position, size_t endPos)
+{
+	entityMutex.lock();
+	SG::SGGuid groupGuid = graphicalEntities[entities[position]].groupGuid;
+	size_t groupEnd = position + 1;
+
+	while (groupEnd < endPos && graphicalEntities[entities[groupEnd]].groupGuid == groupGuid)
+		++groupEnd;
+
+	entityMutex.unlock();
+
+	return groupEnd;
+}
+
+void SG::D3D11RenderEngine::PredictChunkTimes()
+{
+	predictedChunkTimes.clear();
+
+	for (auto& chunk : jobChunks)
+		predictedChunkTimes.push_back(jobBalancer.PredictTime(chunk.pipelineJob.second, chunk.entityEnd - chunk.entityStart));
+}
+
+void SG::D3D11RenderEngine::RecordChunkSegments(const std::vector<SGGraphicsJob>& jobs, ID3D11DeviceContext * context)
+{
+	SGTraceScope scope("D3D11RenderEngine::RecordChunkSegments");
+
+	size_t next = 0;
+
+	while (jobBalancer.TakeSegment(next))
+	{
+		const SGChunkSegment& segment = jobBalancer.GetSegments()[next];
+		HandlePipelineJobs(jobs, segment.chunkStart, segment.chunkEnd, context);
+
+		if (FAILED(context->FinishCommandList(false, &segmentCommandLists[next])))
+			segmentCommandLists[next] = nullptr; // Exceptions can not leave the thread pool, the render thread throws instead
+
+		// Finishing the command list resets the deffered context to its default state
+		GetContextState(context) = ContextShadowState{};
+	}
+}
+
+void SG::D3D11RenderEngine::UpdateJobTimes()
+{
+	for (auto& chunk : jobChunks)
+		jobBalancer.AddRecordedTime(chunk.pipelineJob.second, chunk.entityEnd - chunk.entityStart, chunk.recordedTime);
+}
+
+void SG::D3D11RenderEngine::HandlePipelineJobs(const std::vector<SGGraphicsJob>& jobs, size_t startPos, size_t endPos, ID3D11DeviceContext * context)
+{
+	SGTraceScope scope("D3D11RenderEngine::HandlePipelineJobs");
+
+	for (size_t i = startPos; i < endPos; ++i)
+	{
+		PipelineJobChunk& chunk = jobChunks[i];
+		auto recordStart = std::chrono::steady_clock::now();
+		const std::vector<SGGraphicalEntityID>& entities = jobs[chunk.graphicsJob].entitiesToRender;
+
+		switch (chunk.pipelineJob.first)
+		{
+		case PipelineJobType::RENDER:
+			HandleRenderJob(pipelineManager->GetRenderJob(chunk.pipelineJob.second), entities, chunk.entityStart, chunk.entityEnd, context);
+			break;
+		case PipelineJobType::COMPUTE:
+			HandleComputeJob(pipelineManager->GetComputeJob(chunk.pipelineJob.second), entities, context);
+			break;
+		case PipelineJobType::CLEAR_RENDER_TARGET:
+			HandleClearRenderTargetJob(pipelineManager->GetClearRenderTargetJob(chunk.pipelineJob.second), context);
+			break;
+		case PipelineJobType::CLEAR_DEPTH_STENCIL:
+			HandleClearDepthStencilJob(pipelineManager->GetClearDepthStencilJob(chunk.pipelineJob.second), context);
 		}
 
+		chunk.recordedTime = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - recordStart).count();
 	}
 }
 
-void SG::D3D11RenderEngine::HandleRenderJob(const SGRenderJob & job, const std::vector<SGGraphicalEntityID>& entities, ID3D11DeviceContext * context)
+void SG::D3D11RenderEngine::HandleRenderJob(const SGRenderJob & job, const std::vector<SGGraphicalEntityID>& entities,
+	size_t entityStart, size_t entityEnd, ID3D11DeviceContext * context)
 {
-	SetShaders(job, context);
+	SetShaders(job, GetContextState(context), context);
+	size_t shape = specializedDrawLoops ? job.shape : NR_OF_SHAPES - 1; // The last shape sets every stage before every draw
 
 	if (job.association == Association::GLOBAL)
 	{
@@ -250,14 +1065,26 @@ void SG::D3D11RenderEngine::HandleRenderJob(const SGRenderJob & job, const std::
 	}
 	else if (job.association == Association::GROUP)
 	{
-		HandleGroupRenderJob(job, entities, context);
+		static const std::array<DrawLoop, NR_OF_SHAPES> groupLoops = CreateGroupDrawLoops(std::make_index_sequence<NR_OF_SHAPES>());
+		(this->*groupLoops[shape])(job, entities, entityStart, entityEnd, context);
 	}
 	else if (job.association == Association::ENTITY)
 	{
-		HandleEntityRenderJob(job, entities, context);
+		static const std::array<DrawLoop, NR_OF_SHAPES> entityLoops = CreateEntityDrawLoops(std::make_index_sequence<NR_OF_SHAPES>());
+		(this->*entityLoops[shape])(job, entities, entityStart, entityEnd, context);
 	}
+}
+
+template<size_t ...Shapes>
+std::array<SG::D3D11RenderEngine::DrawLoop, sizeof...(Shapes)> SG::D3D11RenderEngine::CreateGroupDrawLoops(std::index_sequence<Shapes...>)
+{
+	return { &D3D11RenderEngine::HandleGroupRenderJob<Shapes>... };
+}
 
-	ClearNecessaryResources(job, context);
+template<size_t ...Shapes>
+std::array<SG::D3D11RenderEngine::DrawLoop, sizeof...(Shapes)> SG::D3D11RenderEngine::CreateEntityDrawLoops(std::index_sequence<Shapes...>)
+{
+	return { &D3D11RenderEngine::HandleEntityRenderJob<Shapes>... };
 }
 
 D3D11_PRIMITIVE_TOPOLOGY SG::D3D11RenderEngine::TranslateTopology(const SGTopology & topology)
@@ -341,450 +1168,249 @@ D3D11_PRIMITIVE_TOPOLOGY SG::D3D11RenderEngine::TranslateTopology(const SGTopolo
 		return D3D11_PRIMITIVE_TOPOLOGY_32_CONTROL_POINT_PATCHLIST;
 
 	default:
-		return D3D11_PRIMITIVE_TOPOLOGY_UNDEFINED;
-	}
-}
-
-void SG::D3D11RenderEngine::SetShaders(const SGRenderJob & job, ID3D11DeviceContext * context)
-{
-	context->IASetPrimitiveTopology(TranslateTopology(job.topology));
-	shaderManager->SetInputLayout(job.inputAssembly, context);
-	shaderManager->SetVertexShader(job.vertexShader.shader, context);
-	
-	if (job.hullShader.shader != SG::SGGuid())
-		shaderManager->SetHullShader(job.hullShader.shader, context);
-
-	if (job.domainShader.shader != SG::SGGuid())
-		shaderManager->SetDomainShader(job.domainShader.shader, context);
-
-	if (job.geometryShader.shader != SG::SGGuid())
-		shaderManager->SetGeometryShader(job.geometryShader.shader, context);
-	
-	if (job.pixelShader.shader != SG::SGGuid())
-		shaderManager->SetPixelShader(job.pixelShader.shader, context);
-}
-
-void SG::D3D11RenderEngine::HandleGlobalRenderJob(const SGRenderJob & job, ID3D11DeviceContext * context)
-{
-	RenderPipelineState currentState{};
-	SGGraphicalEntityID dummy; // Ugly workaround
-	SetVertexBuffers(job, currentState.vertexBuffers, dummy, context);
-	SetIndexBuffer(job, currentState.indexBuffer, dummy, context);
-	SetConstantBuffers(job, currentState, dummy, context);
-	SetShaderResourceViews(job, currentState, dummy, context);
-	SetSamplerStates(job, currentState, dummy, context);
-	SetViewports(job, currentState.viewports, dummy, context);
-	SetStates(job, currentState, dummy, context);
-	SetOMViews(job, currentState, dummy, context);
-	ExecuteDrawCall(job, dummy, context);
-}
-
-void SG::D3D11RenderEngine::HandleGroupRenderJob(const SGRenderJob & job, const std::vector<SGGraphicalEntityID>& entities, ID3D11DeviceContext * context)
-{
-	entityMutex.lock();
-	SG::SGGuid currentGroupGuid = graphicalEntities[entities[0]].groupGuid;
-	entityMutex.unlock();
-	unsigned int nrInGroup = 1;
-	RenderPipelineState currentState{};
-
-	for (auto it = entities.begin() + 1; it != entities.end(); ++it)
-	{
-		entityMutex.lock();
-
-		while (it != entities.end() && graphicalEntities[*it].groupGuid == currentGroupGuid)
-		{
-			++nrInGroup;
-			++it;
-		}
-
-		entityMutex.unlock();
-
-		SG::SGGraphicalEntityID entity = *(it - 1);
-
-		SetVertexBuffers(job, currentState.vertexBuffers, entity, context);
-		SetIndexBuffer(job, currentState.indexBuffer, entity, context);
-		SetConstantBuffers(job, currentState, entity, context);
-		SetShaderResourceViews(job, currentState, entity, context);
-		SetSamplerStates(job, currentState, entity, context);
-		SetViewports(job, currentState.viewports, entity, context);
-		SetStates(job, currentState, entity, context);
-		SetOMViews(job, currentState, entity, context);
-		ExecuteDrawCall(job, entity, nrInGroup, context);
-
-		if (it != entities.end())
-		{
-			nrInGroup = 1;
-			currentGroupGuid = graphicalEntities[entity].groupGuid;
-		}
-		else
-		{
-			break; // We cannot iterate past end
-		}
-	}
-}
-
-void SG::D3D11RenderEngine::HandleEntityRenderJob(const SGRenderJob & job, const std::vector<SGGraphicalEntityID>& entities, ID3D11DeviceContext * context)
-{
-	RenderPipelineState currentState{};
-
-	for (auto& entity : entities)
-	{
-		SetVertexBuffers(job, currentState.vertexBuffers, entity, context);
-		SetIndexBuffer(job, currentState.indexBuffer, entity, context);
-		SetConstantBuffers(job, currentState, entity, context);
-		SetShaderResourceViews(job, currentState, entity, context);
-		SetSamplerStates(job, currentState, entity, context);
-		SetViewports(job, currentState.viewports, entity, context);
-		SetStates(job, currentState, entity, context);
-		SetOMViews(job, currentState, entity, context);
-		ExecuteDrawCall(job, entity, context);
-	}
-}
-
-void SG::D3D11RenderEngine::HandleComputeJob(const SGComputeJob & job, const std::vector<SGGraphicalEntityID>& entities, ID3D11DeviceContext * context)
-{
-	(void)entities;
-	shaderManager->SetComputeShader(job.shader, context);
-
-	if (job.association == Association::GLOBAL)
-	{
-		HandleGlobalComputeJob(job, context);
-	}
-	else if (job.association == Association::GROUP)
-	{
-		//HandleGroupComputeJob(job, entities, context);
-	}
-	else if (job.association == Association::ENTITY)
-	{
-		//HandleEntityComputeJob(job, entities, context);
+		return D3D11_PRIMITIVE_TOPOLOGY_UNDEFINED;
 	}
-
-	ClearNecessaryResources(job, context); 
 }
 
-void SG::D3D11RenderEngine::HandleGlobalComputeJob(const SGComputeJob & job, ID3D11DeviceContext * context)
+void SG::D3D11RenderEngine::SetShaders(const SGRenderJob & job, ContextShadowState& state, ID3D11DeviceContext * context)
 {
-	ComputePipelineState currentState{};
-	SGGraphicalEntityID dummy; // Ugly workaround
-	SetConstantBuffersForShader(job.constantBuffers, currentState.constantBuffers, dummy, context, 
-		&ID3D11DeviceContext::CSSetConstantBuffers);
-	SetShaderResourceViewsForShader(job.shaderResourceViews, currentState.shaderResourceViews, dummy, context,
-		&ID3D11DeviceContext::CSSetShaderResources);
-	SetSamplerStatesForShader(job.samplers, currentState.samplers,
-		dummy, context, &ID3D11DeviceContext::CSSetSamplers);
-	
-	const int maximumUAVs = 8;
-	ID3D11UnorderedAccessView* uavs[maximumUAVs] = {};
-	UINT nrOfUAVS = 0;
-
-	for (auto& uav : job.unorderedAccessViews)
-		uavs[nrOfUAVS++] = GetUAV(uav, dummy);
-
-	context->CSSetUnorderedAccessViews(0, nrOfUAVS, uavs, nullptr);
-
-	SG::D3D11DrawCallHandler::DispatchCall dispatchCall = GetDispatchCall(job.dispatchCall, dummy);
-	if (dispatchCall.indirect)
-		context->DispatchIndirect(bufferHandler->GetBuffer(dispatchCall.data.dispatchIndirect.bufferForArgs, context), dispatchCall.data.dispatchIndirect.alignedByteOffsetForArgs);
-	else
-		context->Dispatch(dispatchCall.data.dispatch.threadGroupCountX, dispatchCall.data.dispatch.threadGroupCountY, dispatchCall.data.dispatch.threadGroupCountZ);
-}
+	// Shaders and topology are part of the state block, which is applied per draw
+	if (job.stateBlock.resourceGuid != SGGuid())
+		return;
 
-void SG::D3D11RenderEngine::ClearNecessaryResources(const SGRenderJob& job, ID3D11DeviceContext* context)
-{
-	ClearVertexBuffers(job.vertexBuffers, context);
+	state.render.stateBlock = 0;
+	D3D11_PRIMITIVE_TOPOLOGY topology = TranslateTopology(job.topology);
 
-	if (job.indexBuffer.clearAtEnd)
+	if (state.topology != topology)
 	{
-		DXGI_FORMAT format = job.indexBuffer.format == IndexBufferFormat::IB_32_BIT ? DXGI_FORMAT_R32_UINT : DXGI_FORMAT_R16_UINT;
-		context->IASetIndexBuffer(nullptr, format, 0);
+		SGProfiler::Count(SGCounter::INPUT_ASSEMBLER_CHANGES);
+		context->IASetPrimitiveTopology(topology);
+		state.topology = topology;
 	}
 
-	ClearConstantBuffers(job, context);
-	ClearShaderResourceViews(job, context);
-	ClearOMViews(job, context);
+	shaderManager->SetInputLayout(job.inputAssembly, state.inputLayout, context);
+	shaderManager->SetVertexShader(job.vertexShader.shader, state.vertexShader, context);
+	shaderManager->SetHullShader(job.hullShader.shader, state.hullShader, context);
+	shaderManager->SetDomainShader(job.domainShader.shader, state.domainShader, context);
+	shaderManager->SetGeometryShader(job.geometryShader.shader, state.geometryShader, context);
+	shaderManager->SetPixelShader(job.pixelShader.shader, state.pixelShader, context);
 }
 
-void SG::D3D11RenderEngine::ClearNecessaryResources(const SGComputeJob& job, ID3D11DeviceContext* context)
+void SG::D3D11RenderEngine::HandleGlobalRenderJob(const SGRenderJob & job, ID3D11DeviceContext * context)
 {
-	ClearConstantBuffersForShader(job.constantBuffers, context, &ID3D11DeviceContext::CSSetConstantBuffers);
-	ClearShaderResourceViewsForShader(job.shaderResourceViews, context, &ID3D11DeviceContext::CSSetShaderResources);
-
-	ID3D11UnorderedAccessView* uavArr[8] = {};
-	for (unsigned int i = 0; i < job.unorderedAccessViews.size(); ++i)
-	{
-		if (job.unorderedAccessViews[i].clearAtEnd)
-		{
-			int nrToClear = 1;
-
-			while (i + nrToClear < job.unorderedAccessViews.size() && job.unorderedAccessViews[i + nrToClear].clearAtEnd)
-			{
-				++nrToClear;
-			}
-
-			context->CSSetUnorderedAccessViews(i, nrToClear, uavArr, nullptr);
-			i += nrToClear - 1;
-		}
-	}
+	RenderPipelineState& currentState = GetContextState(context).render;
+	SGGraphicalEntityID dummy; // Ugly workaround
+	SetDrawBindings<VERTEX_STAGE | HULL_STAGE | DOMAIN_STAGE | GEOMETRY_STAGE | PIXEL_STAGE>(job, currentState, dummy, context);
+	ExecuteDrawCall(job, dummy, context);
 }
 
-void SG::D3D11RenderEngine::ClearVertexBuffers(const std::vector<SGVertexBuffer>& vertexBuffers, ID3D11DeviceContext* context)
+template<unsigned int Shape>
+void SG::D3D11RenderEngine::HandleGroupRenderJob(const SGRenderJob & job, const std::vector<SGGraphicalEntityID>& entities,
+	size_t entityStart, size_t entityEnd, ID3D11DeviceContext * context)
 {
-	const UINT arrSize = D3D11_IA_VERTEX_INPUT_RESOURCE_SLOT_COUNT;
-	ID3D11Buffer* bufferArr[arrSize] = {};
-	UINT strideArr[arrSize] = {};
-	UINT offsetArr[arrSize] = {};
+	RenderPipelineState& currentState = GetContextState(context).render;
+	size_t groupStart = entityStart;
 
-	for (unsigned int i = 0; i < vertexBuffers.size(); ++i)
+	if constexpr ((Shape & PER_DRAW_BINDINGS) == 0)
 	{
-		if (vertexBuffers[i].clearAtEnd)
-		{
-			int startPos = i;
-			int nrToClear = 1;
-
-			while (i + nrToClear < vertexBuffers.size() && vertexBuffers[i + nrToClear].clearAtEnd)
-			{
-				++nrToClear;
-			}
-
-			context->IASetVertexBuffers(startPos, nrToClear, bufferArr, strideArr, offsetArr);
-			i += nrToClear - 1;
-		}
+		if (entityStart < entityEnd)
+			SetDrawBindings<Shape>(job, currentState, entities[entityStart], context);
 	}
-}
-
-void SG::D3D11RenderEngine::ClearConstantBuffers(const SGRenderJob& job, ID3D11DeviceContext* context)
-{
-	ClearConstantBuffersForShader(job.vertexShader.constantBuffers, context, &ID3D11DeviceContext::VSSetConstantBuffers);
-	ClearConstantBuffersForShader(job.hullShader.constantBuffers, context, &ID3D11DeviceContext::HSSetConstantBuffers);
-	ClearConstantBuffersForShader(job.domainShader.constantBuffers, context, &ID3D11DeviceContext::DSSetConstantBuffers);
-	ClearConstantBuffersForShader(job.geometryShader.constantBuffers, context, &ID3D11DeviceContext::GSSetConstantBuffers);
-	ClearConstantBuffersForShader(job.pixelShader.constantBuffers, context, &ID3D11DeviceContext::PSSetConstantBuffers);
-}
-
-void SG::D3D11RenderEngine::ClearConstantBuffersForShader(const std::vector<ConstantBuffer>& constantBuffers, ID3D11DeviceContext* context, void(_stdcall ID3D11DeviceContext::* func)(UINT, UINT, ID3D11Buffer* const*))
-{
-	const UINT arrSize = D3D11_COMMONSHADER_CONSTANT_BUFFER_API_SLOT_COUNT;
-	ID3D11Buffer* bufferArr[arrSize] = {};
 
-	for (unsigned int i = 0; i < constantBuffers.size(); ++i)
+	while (groupStart < entityEnd)
 	{
-		if (constantBuffers[i].clearAtEnd)
-		{
-			int nrToClear = 1;
+		size_t groupEnd = GetGroupEnd(entities, groupStart, entityEnd);
+		unsigned int nrInGroup = static_cast<unsigned int>(groupEnd - groupStart);
+		SG::SGGraphicalEntityID entity = entities[groupEnd - 1];
 
-			while (i + nrToClear < constantBuffers.size() && constantBuffers[i + nrToClear].clearAtEnd)
-			{
-				++nrToClear;
-			}
+		if constexpr ((Shape & PER_DRAW_BINDINGS) != 0)
+			SetDrawBindings<Shape>(job, currentState, entity, context);
 
-			(context->*func)(i, nrToClear, bufferArr);
-			i += nrToClear - 1;
-		}
+		ExecuteDrawCall(job, entity, nrInGroup, context);
+
+		groupStart = groupEnd;
 	}
 }
 
-void SG::D3D11RenderEngine::ClearShaderResourceViews(const SGRenderJob& job, ID3D11DeviceContext* context)
+template<unsigned int Shape>
+void SG::D3D11RenderEngine::HandleEntityRenderJob(const SGRenderJob & job, const std::vector<SGGraphicalEntityID>& entities,
+	size_t entityStart, size_t entityEnd, ID3D11DeviceContext * context)
 {
-	ClearShaderResourceViewsForShader(job.vertexShader.shaderResourceViews, context, &ID3D11DeviceContext::VSSetShaderResources);
-	ClearShaderResourceViewsForShader(job.hullShader.shaderResourceViews, context, &ID3D11DeviceContext::HSSetShaderResources);
-	ClearShaderResourceViewsForShader(job.domainShader.shaderResourceViews, context, &ID3D11DeviceContext::DSSetShaderResources);
-	ClearShaderResourceViewsForShader(job.geometryShader.shaderResourceViews, context, &ID3D11DeviceContext::GSSetShaderResources);
-	ClearShaderResourceViewsForShader(job.pixelShader.shaderResourceViews, context, &ID3D11DeviceContext::PSSetShaderResources);
-}
+	RenderPipelineState& currentState = GetContextState(context).render;
 
-void SG::D3D11RenderEngine::ClearShaderResourceViewsForShader(const std::vector<ResourceView>& srvs, ID3D11DeviceContext* context, void(_stdcall ID3D11DeviceContext::* func)(UINT, UINT, ID3D11ShaderResourceView* const*))
-{
-	const UINT arrSize = D3D11_COMMONSHADER_INPUT_RESOURCE_SLOT_COUNT;
-	ID3D11ShaderResourceView* srvArr[arrSize] = {};
+	// Everything is global, so only the draw calls are left in the loop
+	if constexpr ((Shape & PER_DRAW_BINDINGS) == 0)
+	{
+		if (entityStart < entityEnd)
+			SetDrawBindings<Shape>(job, currentState, entities[entityStart], context);
+	}
 
-	for (unsigned int i = 0; i < srvs.size(); ++i)
+	for (size_t i = entityStart; i < entityEnd; ++i)
 	{
-		if (srvs[i].clearAtEnd)
-		{
-			int nrToClear = 1;
+		const SGGraphicalEntityID& entity = entities[i];
 
-			while (i + nrToClear < srvs.size() && srvs[i + nrToClear].clearAtEnd)
-			{
-				++nrToClear;
-			}
+		if constexpr ((Shape & PER_DRAW_BINDINGS) != 0)
+			SetDrawBindings<Shape>(job, currentState, entity, context);
 
-			(context->*func)(i, nrToClear, srvArr);
-			i += nrToClear - 1;
-		}
+		ExecuteDrawCall(job, entity, context);
 	}
 }
 
-void SG::D3D11RenderEngine::ClearOMViews(const SGRenderJob& job, ID3D11DeviceContext* context)
+template<unsigned int Shape>
+void SG::D3D11RenderEngine::SetDrawBindings(const SGRenderJob & job, RenderPipelineState & currentState,
+	const SGGraphicalEntityID & entity, ID3D11DeviceContext * context)
 {
-	const int maximumRTVsAndUAVs = 8;
-	ID3D11RenderTargetView* rtvs[maximumRTVsAndUAVs] = {};
-	ID3D11UnorderedAccessView* uavs[maximumRTVsAndUAVs] = {};
-	ID3D11DepthStencilView* dsv = nullptr;
-	int rtvsToClear[maximumRTVsAndUAVs];
-	int nrOfRTVsToClear = 0;
-	int uavsToClear[maximumRTVsAndUAVs];
-	int nrOfUAVsToClear = 0;
-	UINT nrOfRTVs = static_cast<UINT>(job.rtvs.size());
-	UINT nrOfUAVs = static_cast<UINT>(job.uavs.size());
-
-	for (unsigned int i = 0; i < job.rtvs.size(); ++i)
-		if (job.rtvs[i].clearAtEnd)
-			rtvsToClear[nrOfRTVsToClear++] = i;
-
-	for (unsigned int i = 0; i < job.uavs.size(); ++i)
-		if (job.uavs[i].clearAtEnd)
-			uavsToClear[nrOfUAVsToClear++] = i;
+	SetOMViews(job, currentState, entity, context);
+	SetVertexBuffers(job, currentState.vertexBuffers, entity, context);
+	SetIndexBuffer(job, currentState.indexBuffer, entity, context);
 
-	if (job.dsv.clearAtEnd || nrOfRTVsToClear != 0 || nrOfUAVsToClear != 0)
-	{
-		context->OMGetRenderTargetsAndUnorderedAccessViews(nrOfRTVs, rtvs, job.dsv.clearAtEnd ? &dsv : nullptr, nrOfRTVs, nrOfUAVs, uavs);
-
-		for (int i = 0; i < nrOfRTVsToClear; ++i)
-		{
-			rtvs[rtvsToClear[i]]->Release();
-			rtvs[rtvsToClear[i]] = nullptr;
-		}
+	if constexpr ((Shape & VERTEX_STAGE) != 0)
+		SetShaderStageResources<&ID3D11DeviceContext::VSSetConstantBuffers, &ID3D11DeviceContext::VSSetShaderResources,
+			&ID3D11DeviceContext::VSSetSamplers>(job.vertexShader, currentState.vertexShader, SGBindStage::VERTEX_SHADER, entity, context);
 
-		for (int i = 0; i < nrOfUAVsToClear; ++i)
-		{
-			uavs[uavsToClear[i]]->Release();
-			uavs[uavsToClear[i]] = nullptr;
-		}
+	if constexpr ((Shape & HULL_STAGE) != 0)
+		SetShaderStageResources<&ID3D11DeviceContext::HSSetConstantBuffers, &ID3D11DeviceContext::HSSetShaderResources,
+			&ID3D11DeviceContext::HSSetSamplers>(job.hullShader, currentState.hullShader, SGBindStage::HULL_SHADER, entity, context);
 
-		if (job.dsv.clearAtEnd)
-		{
-			dsv->Release();
-			dsv = nullptr;
-		}
+	if constexpr ((Shape & DOMAIN_STAGE) != 0)
+		SetShaderStageResources<&ID3D11DeviceContext::DSSetConstantBuffers, &ID3D11DeviceContext::DSSetShaderResources,
+			&ID3D11DeviceContext::DSSetSamplers>(job.domainShader, currentState.domainShader, SGBindStage::DOMAIN_SHADER, entity, context);
 
-		context->OMSetRenderTargetsAndUnorderedAccessViews(nrOfRTVs, rtvs, dsv, nrOfRTVs, nrOfUAVs, uavs, nullptr);
+	if constexpr ((Shape & GEOMETRY_STAGE) != 0)
+		SetShaderStageResources<&ID3D11DeviceContext::GSSetConstantBuffers, &ID3D11DeviceContext::GSSetShaderResources,
+			&ID3D11DeviceContext::GSSetSamplers>(job.geometryShader, currentState.geometryShader, SGBindStage::GEOMETRY_SHADER, entity, context);
 
-		for (int i = 0; i < nrOfRTVsToClear; ++i)
-			if(rtvs[rtvsToClear[i]] != nullptr)
-				rtvs[rtvsToClear[i]]->Release();
+	if constexpr ((Shape & PIXEL_STAGE) != 0)
+		SetShaderStageResources<&ID3D11DeviceContext::PSSetConstantBuffers, &ID3D11DeviceContext::PSSetShaderResources,
+			&ID3D11DeviceContext::PSSetSamplers>(job.pixelShader, currentState.pixelShader, SGBindStage::PIXEL_SHADER, entity, context);
 
-		for (int i = 0; i < nrOfUAVsToClear; ++i)
-			if(uavs[uavsToClear[i]] != nullptr)
-				uavs[uavsToClear[i]]->Release();
-	
-		//No need to release dsv, only fetched if cleared and then it is already released at this point
-	}
+	SetViewports(job, currentState, entity, context);
+	SetStates(job, currentState, entity, context);
 }
 
-void SG::D3D11RenderEngine::SetConstantBuffers(const SGRenderJob & job, RenderPipelineState& previousFrame, const SGGraphicalEntityID & entity,
-	ID3D11DeviceContext * context)
+template<SG::D3D11RenderEngine::SetBuffersFunc SetBuffers, SG::D3D11RenderEngine::SetSRVsFunc SetSRVs, SG::D3D11RenderEngine::SetSamplersFunc SetSamplers>
+void SG::D3D11RenderEngine::SetShaderStageResources(const RenderShader & shader, RenderShaderState & currentState, SGBindStage stage,
+	const SGGraphicalEntityID & entity, ID3D11DeviceContext * context)
 {
-	if(job.vertexShader.constantBuffers.size())
-		SetConstantBuffersForShader(job.vertexShader.constantBuffers, previousFrame.vertexShader.constantBuffers,
-			entity, context, &ID3D11DeviceContext::VSSetConstantBuffers);
-
-	if(job.hullShader.constantBuffers.size())
-		SetConstantBuffersForShader(job.hullShader.constantBuffers, previousFrame.hullShader.constantBuffers,
-			entity, context, &ID3D11DeviceContext::HSSetConstantBuffers);
+	if (shader.constantBuffers.size())
+		SetConstantBuffersForShader<SetBuffers>(shader.constantBuffers, currentState.constantBuffers, entity, context);
 
-	if(job.domainShader.constantBuffers.size())
-		SetConstantBuffersForShader(job.domainShader.constantBuffers, previousFrame.domainShader.constantBuffers,
-			entity, context, &ID3D11DeviceContext::DSSetConstantBuffers);
+	if (shader.shaderResourceViews.size())
+		SetShaderResourceViewsForShader<SetSRVs>(shader.shaderResourceViews, currentState.shaderResourceViews, stage, entity, context);
 
-	if(job.geometryShader.constantBuffers.size())
-		SetConstantBuffersForShader(job.geometryShader.constantBuffers, previousFrame.geometryShader.constantBuffers,
-			entity, context, &ID3D11DeviceContext::GSSetConstantBuffers);
-
-	if(job.pixelShader.constantBuffers.size())
-		SetConstantBuffersForShader(job.pixelShader.constantBuffers, previousFrame.pixelShader.constantBuffers,
-			entity, context, &ID3D11DeviceContext::PSSetConstantBuffers);
+	if (shader.samplers.size())
+		SetSamplerStatesForShader<SetSamplers>(shader.samplers, currentState.samplers, entity, context);
 }
 
-void SG::D3D11RenderEngine::SetShaderResourceViews(const SGRenderJob & job, RenderPipelineState& previousFrame, const SGGraphicalEntityID & entity,
-	ID3D11DeviceContext * context)
+void SG::D3D11RenderEngine::HandleComputeJob(const SGComputeJob & job, const std::vector<SGGraphicalEntityID>& entities, ID3D11DeviceContext * context)
 {
-	if(job.vertexShader.shaderResourceViews.size())
-		SetShaderResourceViewsForShader(job.vertexShader.shaderResourceViews, previousFrame.vertexShader.shaderResourceViews,
-			entity, context, &ID3D11DeviceContext::VSSetShaderResources);
-
-	if(job.hullShader.shaderResourceViews.size())
-		SetShaderResourceViewsForShader(job.hullShader.shaderResourceViews, previousFrame.hullShader.shaderResourceViews,
-			entity, context, &ID3D11DeviceContext::HSSetShaderResources);
-
-	if(job.domainShader.shaderResourceViews.size())
-		SetShaderResourceViewsForShader(job.domainShader.shaderResourceViews, previousFrame.domainShader.shaderResourceViews,
-			entity, context, &ID3D11DeviceContext::DSSetShaderResources);
+	(void)entities;
+	shaderManager->SetComputeShader(job.shader, GetContextState(context).computeShader, context);
 
-	if(job.geometryShader.shaderResourceViews.size())
-		SetShaderResourceViewsForShader(job.geometryShader.shaderResourceViews, previousFrame.geometryShader.shaderResourceViews,
-			entity, context, &ID3D11DeviceContext::GSSetShaderResources);
-	
-	if(job.pixelShader.shaderResourceViews.size())
-		SetShaderResourceViewsForShader(job.pixelShader.shaderResourceViews, previousFrame.pixelShader.shaderResourceViews,
-			entity, context, &ID3D11DeviceContext::PSSetShaderResources);
+	if (job.association == Association::GLOBAL)
+	{
+		HandleGlobalComputeJob(job, context);
+	}
+	else if (job.association == Association::GROUP)
+	{
+		//HandleGroupComputeJob(job, entities, context);
+	}
+	else if (job.association == Association::ENTITY)
+	{
+		//HandleEntityComputeJob(job, entities, context);
+	}
 }
 
-void SG::D3D11RenderEngine::SetSamplerStates(const SGRenderJob & job, RenderPipelineState& previousFrame, const SGGraphicalEntityID & entity,
-	ID3D11DeviceContext * context)
+void SG::D3D11RenderEngine::HandleGlobalComputeJob(const SGComputeJob & job, ID3D11DeviceContext * context)
 {
-	if(job.vertexShader.samplers.size())
-		SetSamplerStatesForShader(job.vertexShader.samplers, previousFrame.vertexShader.samplers,
-			entity, context, &ID3D11DeviceContext::VSSetSamplers);
+	ContextShadowState& state = GetContextState(context);
+	ComputePipelineState& currentState = state.compute;
+	SGGraphicalEntityID dummy; // Ugly workaround
+	SetConstantBuffersForShader<&ID3D11DeviceContext::CSSetConstantBuffers>(job.constantBuffers, currentState.constantBuffers, dummy, context);
+	SetSamplerStatesForShader<&ID3D11DeviceContext::CSSetSamplers>(job.samplers, currentState.samplers, dummy, context);
+	
+	const int maximumUAVs = 8;
+	ID3D11UnorderedAccessView* uavs[maximumUAVs] = {};
+	ID3D11Resource* uavResources[maximumUAVs] = {};
+	UINT nrOfUAVS = 0;
 
-	if(job.hullShader.samplers.size())
-		SetSamplerStatesForShader(job.hullShader.samplers, previousFrame.hullShader.samplers,
-			entity, context, &ID3D11DeviceContext::HSSetSamplers);
+	for (auto& uav : job.unorderedAccessViews)
+	{
+		uavs[nrOfUAVS] = GetUAV(uav, dummy, &uavResources[nrOfUAVS]);
+		++nrOfUAVS;
+	}
+
+	UINT first;
+	UINT last;
 
-	if(job.domainShader.samplers.size())
-		SetSamplerStatesForShader(job.domainShader.samplers, previousFrame.domainShader.samplers,
-			entity, context, &ID3D11DeviceContext::DSSetSamplers);
+	// Every slot is compared, so slots past the views of this job are unbound if an earlier job left something there
+	if (FindChangedRange(currentState.unorderedAccessViews, uavs, maximumUAVs, first, last))
+	{
+		for (UINT i = first; i <= last; ++i)
+			state.tracker.Bind({ SGBindStage::COMPUTE_SHADER, SGBindType::UNORDERED_ACCESS, i }, GetResourceID(uavResources[i]), state.hazards);
+
+		UnbindHazards(state, context);
+		SGProfiler::Count(SGCounter::OUTPUT_MERGER_CHANGES);
+		context->CSSetUnorderedAccessViews(first, last - first + 1, uavs + first, nullptr);
+		std::copy(uavs + first, uavs + last + 1, currentState.unorderedAccessViews + first);
+	}
 
-	if(job.geometryShader.samplers.size())
-		SetSamplerStatesForShader(job.geometryShader.samplers, previousFrame.geometryShader.samplers,
-			entity, context, &ID3D11DeviceContext::GSSetSamplers);
+	// Outputs first, so that a resource moving from output to input does not need an extra unbind
+	SetShaderResourceViewsForShader<&ID3D11DeviceContext::CSSetShaderResources>(job.shaderResourceViews, currentState.shaderResourceViews,
+		SGBindStage::COMPUTE_SHADER, dummy, context);
 
-	if(job.pixelShader.samplers.size())
-		SetSamplerStatesForShader(job.pixelShader.samplers, previousFrame.pixelShader.samplers,
-			entity, context, &ID3D11DeviceContext::PSSetSamplers);
+	SGProfiler::Count(SGCounter::DISPATCHES);
+	SG::D3D11DrawCallHandler::DispatchCall dispatchCall = GetDispatchCall(job.dispatchCall, dummy);
+	if (dispatchCall.indirect)
+		context->DispatchIndirect(bufferHandler->GetBuffer(dispatchCall.data.dispatchIndirect.bufferForArgs, context), dispatchCall.data.dispatchIndirect.alignedByteOffsetForArgs);
+	else
+		context->Dispatch(dispatchCall.data.dispatch.threadGroupCountX, dispatchCall.data.dispatch.threadGroupCountY, dispatchCall.data.dispatch.threadGroupCountZ);
 }
 
 void SG::D3D11RenderEngine::SetVertexBuffers(const SGRenderJob & job, VertexBufferState currentState[], const SGGraphicalEntityID & entity, ID3D11DeviceContext * context)
 {
 	const UINT arrSize = D3D11_IA_VERTEX_INPUT_RESOURCE_SLOT_COUNT;
-	ID3D11Buffer* bufferArr[arrSize] = {};
-	UINT strideArr[arrSize] = {};
-	UINT offsetArr[arrSize] = {};
+	VertexBufferState wanted[arrSize];
+	ID3D11Buffer* bufferArr[arrSize];
+	UINT strideArr[arrSize];
+	UINT offsetArr[arrSize];
 	UINT counter = 0;
 	for (auto& vBuffer : job.vertexBuffers)
 	{
-		bufferArr[counter] = GetBuffer(vBuffer.buffer, entity, context);
+		wanted[counter].buffer = GetBuffer(vBuffer.buffer, entity, context);
+		wanted[counter].offset = 0;
 
 		if (vBuffer.offset.resourceGuid != SGGuid())
-			offsetArr[counter] = GetOffset(vBuffer.offset, entity);
+			wanted[counter].offset = GetOffset(vBuffer.offset, entity);
 
 		if (vBuffer.stride.resourceGuid != SGGuid())
-			strideArr[counter] = GetStride(vBuffer.stride, entity);
+			wanted[counter].stride = GetStride(vBuffer.stride, entity);
 		else
-			strideArr[counter] = GetStrideFromVB(vBuffer.buffer, entity);
+			wanted[counter].stride = GetStrideFromVB(vBuffer.buffer, entity);
 
 		++counter;
 	}
 
-	UINT startOfNewData = static_cast<UINT>(-1);
-	for (UINT i = 0; i < counter && startOfNewData == static_cast<UINT>(-1); ++i)
-	{
-		auto& prevData = currentState[i];
-		if (bufferArr[i] != prevData.buffer || offsetArr[i] != prevData.offset || strideArr[i] != prevData.stride)
-			startOfNewData = i;
-	}
+	UINT first;
+	UINT last;
 
-	if (startOfNewData != static_cast<UINT>(-1))
-	{
-		context->IASetVertexBuffers(startOfNewData, counter - startOfNewData,
-			bufferArr + startOfNewData, strideArr + startOfNewData, offsetArr + startOfNewData);
+	if (!FindChangedRange(currentState, wanted, counter, first, last))
+		return;
 
-		for (unsigned int i = startOfNewData; i < counter; ++i)
-		{
-			currentState[i].buffer = bufferArr[i];
-			currentState[i].offset = offsetArr[i];
-			currentState[i].stride = strideArr[i];
-		}
+	ContextShadowState& state = GetContextState(context);
+
+	for (UINT i = first; i <= last; ++i)
+	{
+		state.tracker.Bind({ SGBindStage::INPUT_ASSEMBLER, SGBindType::VERTEX_BUFFER, i }, GetResourceID(wanted[i].buffer), state.hazards);
+		bufferArr[i] = wanted[i].buffer;
+		strideArr[i] = wanted[i].stride;
+		offsetArr[i] = wanted[i].offset;
+		currentState[i] = wanted[i];
 	}
+
+	UnbindHazards(state, context);
+	SGProfiler::Count(SGCounter::INPUT_ASSEMBLER_CHANGES);
+	context->IASetVertexBuffers(first, last - first + 1, bufferArr + first, strideArr + first, offsetArr + first);
 }
 
 void SG::D3D11RenderEngine::SetIndexBuffer(const SGRenderJob & job, IndexBufferState& currentState, const SGGraphicalEntityID & entity, ID3D11DeviceContext * context)
@@ -799,11 +1425,16 @@ void SG::D3D11RenderEngine::SetIndexBuffer(const SGRenderJob & job, IndexBufferS
 
 	DXGI_FORMAT format = job.indexBuffer.format == IndexBufferFormat::IB_32_BIT ? DXGI_FORMAT_R32_UINT : DXGI_FORMAT_R16_UINT;
 
-	if (currentState.buffer != buffer || currentState.offset != offset)
+	if (currentState.buffer != buffer || currentState.offset != offset || currentState.format != format)
 	{
+		ContextShadowState& state = GetContextState(context);
+		state.tracker.Bind({ SGBindStage::INPUT_ASSEMBLER, SGBindType::INDEX_BUFFER }, GetResourceID(buffer), state.hazards);
+		UnbindHazards(state, context);
+		SGProfiler::Count(SGCounter::INPUT_ASSEMBLER_CHANGES);
 		context->IASetIndexBuffer(buffer, format, offset);
 		currentState.buffer = buffer;
 		currentState.offset = offset;
+		currentState.format = format;
 	}
 }
 
@@ -813,50 +1444,77 @@ void SG::D3D11RenderEngine::SetOMViews(const SGRenderJob & job, RenderPipelineSt
 	const int maximumRTVsAndUAVs = 8;
 	ID3D11RenderTargetView* rtvs[maximumRTVsAndUAVs] = {};
 	ID3D11UnorderedAccessView* uavs[maximumRTVsAndUAVs] = {};
+	ID3D11Resource* rtvResources[maximumRTVsAndUAVs] = {};
+	ID3D11Resource* uavResources[maximumRTVsAndUAVs] = {};
 	UINT nrOfRTVs = 0;
 	UINT nrOfUAVS = 0;
 	ID3D11DepthStencilView* dsv = nullptr;
+	ID3D11Resource* dsvResource = nullptr;
 
 	for (auto& rtv : job.rtvs)
-		rtvs[nrOfRTVs++] = GetRTV(rtv, entity);
+	{
+		rtvs[nrOfRTVs] = GetRTV(rtv, entity, &rtvResources[nrOfRTVs]);
+		++nrOfRTVs;
+	}
 
 	if(job.dsv.component.resourceGuid != SGGuid())
-		dsv = GetDSV(job.dsv, entity);
+		dsv = GetDSV(job.dsv, entity, &dsvResource);
 
+	// Unordered access views share the output slots with the render targets and start after them
 	for (auto& uav : job.uavs)
-		uavs[nrOfUAVS++] = GetUAV(uav, entity);
+	{
+		uavs[nrOfRTVs + nrOfUAVS] = GetUAV(uav, entity, &uavResources[nrOfRTVs + nrOfUAVS]);
+		++nrOfUAVS;
+	}
 
-	UINT startOfNewRTVData = static_cast<UINT>(-1);
-	for (unsigned int i = 0; i < nrOfRTVs; ++i)
+	UINT first;
+	UINT last;
+	bool rtvsChanged = nrOfRTVs != currentState.nrOfRTVs || dsv != currentState.dsv ||
+		FindChangedRange(currentState.rtvs, rtvs, nrOfRTVs, first, last);
+	// Every slot after the render targets is compared, so fewer views than the previous job unbinds the rest
+	bool uavsChanged = FindChangedRange(currentState.uavs + nrOfRTVs, uavs + nrOfRTVs, maximumRTVsAndUAVs - nrOfRTVs, first, last);
+
+	if (!rtvsChanged && !uavsChanged)
+		return;
+
+	ContextShadowState& state = GetContextState(context);
+
+	if (rtvsChanged)
 	{
-		if (currentState.rtvs[i] != rtvs[i])
-		{
-			startOfNewRTVData = (startOfNewRTVData == static_cast<UINT>(-1)) ? i : startOfNewRTVData;
-			currentState.rtvs[i] = rtvs[i];
-		}
+		for (UINT i = 0; i < maximumRTVsAndUAVs; ++i)
+			if (rtvs[i] != currentState.rtvs[i])
+				state.tracker.Bind({ SGBindStage::OUTPUT_MERGER, SGBindType::RENDER_TARGET, i }, GetResourceID(rtvResources[i]), state.hazards);
+
+		if (dsv != currentState.dsv)
+			state.tracker.Bind({ SGBindStage::OUTPUT_MERGER, SGBindType::DEPTH_STENCIL }, GetResourceID(dsvResource), state.hazards);
 	}
 
-	UINT startOfNewUAVData = static_cast<UINT>(-1);
-	for (unsigned int i = 0; i < nrOfUAVS; ++i)
+	if (uavsChanged)
 	{
-		if (currentState.uavs[i] != uavs[i])
-		{
-			startOfNewUAVData = (startOfNewUAVData == static_cast<UINT>(-1)) ? i : startOfNewUAVData;
-			currentState.uavs[i] = uavs[i];
-		}
+		for (UINT i = nrOfRTVs; i < maximumRTVsAndUAVs; ++i)
+			if (uavs[i] != currentState.uavs[i])
+				state.tracker.Bind({ SGBindStage::OUTPUT_MERGER, SGBindType::UNORDERED_ACCESS, i }, GetResourceID(uavResources[i]), state.hazards);
 	}
-	
-	if (startOfNewRTVData != static_cast<UINT>(-1) || startOfNewUAVData != static_cast<UINT>(-1) || dsv != currentState.dsv)
+
+	UnbindHazards(state, context);
+
+	// Render targets are always set as a whole, the views themselves only if they changed
+	SGProfiler::Count(SGCounter::OUTPUT_MERGER_CHANGES);
+	context->OMSetRenderTargetsAndUnorderedAccessViews(rtvsChanged ? nrOfRTVs : D3D11_KEEP_RENDER_TARGETS_AND_DEPTH_STENCIL,
+		rtvs, dsv, nrOfRTVs, uavsChanged ? maximumRTVsAndUAVs - nrOfRTVs : D3D11_KEEP_UNORDERED_ACCESS_VIEWS, uavs + nrOfRTVs, nullptr);
+
+	if (rtvsChanged)
 	{
-		startOfNewRTVData = (startOfNewRTVData == static_cast<UINT>(-1)) ? 0 : startOfNewRTVData;
-		startOfNewUAVData = (startOfNewUAVData == static_cast<UINT>(-1)) ? 0 : startOfNewUAVData;
-		context->OMSetRenderTargetsAndUnorderedAccessViews(nrOfRTVs - startOfNewRTVData, rtvs + startOfNewRTVData, dsv,
-			nrOfRTVs, nrOfUAVS - startOfNewUAVData, uavs + startOfNewUAVData, nullptr);
+		std::copy(rtvs, rtvs + maximumRTVsAndUAVs, currentState.rtvs);
+		currentState.nrOfRTVs = nrOfRTVs;
 		currentState.dsv = dsv;
 	}
+
+	if (uavsChanged)
+		std::copy(uavs, uavs + maximumRTVsAndUAVs, currentState.uavs);
 }
 
-void SG::D3D11RenderEngine::SetViewports(const SGRenderJob & job, D3D11_VIEWPORT currentState[],
+void SG::D3D11RenderEngine::SetViewports(const SGRenderJob & job, RenderPipelineState& currentState,
 	const SGGraphicalEntityID & entity, ID3D11DeviceContext * context)
 {
 	D3D11_VIEWPORT viewports[D3D11_VIEWPORT_AND_SCISSORRECT_OBJECT_COUNT_PER_PIPELINE];
@@ -865,37 +1523,128 @@ void SG::D3D11RenderEngine::SetViewports(const SGRenderJob & job, D3D11_VIEWPORT
 	for (auto& vp : job.viewports)
 		viewports[nrOfViewports++] = GetViewport(vp, entity);
 
-	UINT startOfNewViewPortData = static_cast<UINT>(-1);
-	for (unsigned int i = 0; i < nrOfViewports; ++i)
+	UINT first;
+	UINT last;
+
+	// Setting viewports always replaces all of them, so only the check can be limited to what changed
+	if (nrOfViewports != currentState.nrOfViewports || FindChangedRange(currentState.viewports, viewports, nrOfViewports, first, last))
 	{
-		if (currentState[i] != viewports[i])
-		{
-			startOfNewViewPortData = (startOfNewViewPortData == static_cast<UINT>(-1)) ? i : startOfNewViewPortData;
-			currentState[i] = viewports[i];
-		}
+		SGProfiler::Count(SGCounter::RASTERIZER_CHANGES);
+		context->RSSetViewports(nrOfViewports, viewports);
+		std::copy(viewports, viewports + nrOfViewports, currentState.viewports);
+		currentState.nrOfViewports = nrOfViewports;
 	}
-
-	if(startOfNewViewPortData != static_cast<UINT>(-1))
-		context->RSSetViewports(nrOfViewports - startOfNewViewPortData, viewports + startOfNewViewPortData);
 }
 
 void SG::D3D11RenderEngine::SetStates(const SGRenderJob & job, RenderPipelineState& currentState,
 	const SGGraphicalEntityID & entity, ID3D11DeviceContext * context)
 {
+	if (job.stateBlock.resourceGuid != SGGuid())
+	{
+		const D3D11StateBlockData& block = GetStateBlock(job.stateBlock, entity);
+
+		if (currentState.stateBlock != block.id)
+			ApplyStateBlock(block, GetContextState(context), context);
+
+		return;
+	}
+
 	ID3D11RasterizerState* rs = GetRasterizerState(job.rasterizerState, entity);
+	const FLOAT defaultBlendFactor[4] = { 1.0f, 1.0f, 1.0f, 1.0f };
+	currentState.stateBlock = 0;
+
+	if (currentState.rasterizerState != rs)
+	{
+		SGProfiler::Count(SGCounter::RASTERIZER_CHANGES);
+		context->RSSetState(rs);
+		currentState.rasterizerState = rs;
+	}
+	else
+	{
+		SGProfiler::Count(SGCounter::STATE_SETS_AVOIDED);
+	}
+
+	// Without a state block there is no blend or depth stencil data, so the defaults are used
+	SetBlendState(GetBlendState(job.blendState, entity), defaultBlendFactor, 0xffffffff, currentState, context);
+	SetDepthStencilState(nullptr, 0, currentState, context);
+}
+
+void SG::D3D11RenderEngine::ApplyStateBlock(const D3D11StateBlockData & block, ContextShadowState & state, ID3D11DeviceContext * context)
+{
+	RenderPipelineState& currentState = state.render;
+
+	if (state.topology != block.topology)
+	{
+		SGProfiler::Count(SGCounter::INPUT_ASSEMBLER_CHANGES);
+		context->IASetPrimitiveTopology(block.topology);
+		state.topology = block.topology;
+	}
+
+	shaderManager->SetInputLayout(block.inputLayout, state.inputLayout, context);
+	shaderManager->SetVertexShader(block.vertexShader, state.vertexShader, context);
+	shaderManager->SetHullShader(block.hullShader, state.hullShader, context);
+	shaderManager->SetDomainShader(block.domainShader, state.domainShader, context);
+	shaderManager->SetGeometryShader(block.geometryShader, state.geometryShader, context);
+	shaderManager->SetPixelShader(block.pixelShader, state.pixelShader, context);
+
+	ID3D11RasterizerState* rs = block.rasterizerState != SGGuid() ? stateHandler->GetRazterizerState(block.rasterizerState) : nullptr;
 
 	if (currentState.rasterizerState != rs)
 	{
-		context->RSSetState(GetRasterizerState(job.rasterizerState, entity));
+		SGProfiler::Count(SGCounter::RASTERIZER_CHANGES);
+		context->RSSetState(rs);
 		currentState.rasterizerState = rs;
 	}
+	else
+	{
+		SGProfiler::Count(SGCounter::STATE_SETS_AVOIDED);
+	}
+
+	SetBlendState(block.blendState != SGGuid() ? stateHandler->GetBlendState(block.blendState) : nullptr,
+		block.blendFactor, block.sampleMask, currentState, context);
+	SetDepthStencilState(block.depthStencilState != SGGuid() ? stateHandler->GetDepthStencilState(block.depthStencilState) : nullptr,
+		block.stencilRef, currentState, context);
+
+	currentState.stateBlock = block.id;
+}
+
+void SG::D3D11RenderEngine::SetBlendState(ID3D11BlendState * blendState, const FLOAT blendFactor[4], UINT sampleMask,
+	RenderPipelineState & currentState, ID3D11DeviceContext * context)
+{
+	if (currentState.blendState != blendState || currentState.sampleMask != sampleMask ||
+		!std::equal(blendFactor, blendFactor + 4, currentState.blendFactor))
+	{
+		SGProfiler::Count(SGCounter::BLEND_DEPTH_STENCIL_CHANGES);
+		context->OMSetBlendState(blendState, blendFactor, sampleMask);
+		currentState.blendState = blendState;
+		std::copy(blendFactor, blendFactor + 4, currentState.blendFactor);
+		currentState.sampleMask = sampleMask;
+	}
+	else
+	{
+		SGProfiler::Count(SGCounter::STATE_SETS_AVOIDED);
+	}
+}
 
-	//blendstate
-	//depthstencilstate
+void SG::D3D11RenderEngine::SetDepthStencilState(ID3D11DepthStencilState * depthStencilState, UINT stencilRef,
+	RenderPipelineState & currentState, ID3D11DeviceContext * context)
+{
+	if (currentState.depthStencilState != depthStencilState || currentState.stencilRef != stencilRef)
+	{
+		SGProfiler::Count(SGCounter::BLEND_DEPTH_STENCIL_CHANGES);
+		context->OMSetDepthStencilState(depthStencilState, stencilRef);
+		currentState.depthStencilState = depthStencilState;
+		currentState.stencilRef = stencilRef;
+	}
+	else
+	{
+		SGProfiler::Count(SGCounter::STATE_SETS_AVOIDED);
+	}
 }
 
 void SG::D3D11RenderEngine::ExecuteDrawCall(const SGRenderJob & job, const SGGraphicalEntityID& entity, unsigned int nrInGroup, ID3D11DeviceContext * context)
 {
+	SGProfiler::Count(SGCounter::DRAWS);
 	SG::D3D11DrawCallHandler::DrawCall drawCall = GetDrawCall(job.drawCall, entity);
 
 	switch (drawCall.type)
@@ -926,6 +1675,7 @@ void SG::D3D11RenderEngine::ExecuteDrawCall(const SGRenderJob & job, const SGGra
 
 void SG::D3D11RenderEngine::ExecuteDrawCall(const SGRenderJob & job, const SGGraphicalEntityID & entity, ID3D11DeviceContext * context)
 {
+	SGProfiler::Count(SGCounter::DRAWS);
 	SG::D3D11DrawCallHandler::DrawCall drawCall = GetDrawCall(job.drawCall, entity);
 
 	switch (drawCall.type)
@@ -951,76 +1701,82 @@ void SG::D3D11RenderEngine::ExecuteDrawCall(const SGRenderJob & job, const SGGra
 
 }
 
+template<SG::D3D11RenderEngine::SetBuffersFunc SetBuffers>
 void SG::D3D11RenderEngine::SetConstantBuffersForShader(const std::vector<ConstantBuffer>& buffers, ID3D11Buffer** currentState, 
-	const SGGraphicalEntityID & entity, ID3D11DeviceContext * context,
-	void(_stdcall ID3D11DeviceContext::*func)(UINT, UINT, ID3D11Buffer * const *))
+	const SGGraphicalEntityID & entity, ID3D11DeviceContext * context)
 {
 	const UINT arrSize = D3D11_COMMONSHADER_CONSTANT_BUFFER_API_SLOT_COUNT;
-	ID3D11Buffer* bufferArr[arrSize] = {};
+	ID3D11Buffer* bufferArr[arrSize];
 	UINT counter = 0;
 	for (auto& cBuffer : buffers)
 		bufferArr[counter++] = GetBuffer(cBuffer.component, entity, context);
 
-	UINT startOfNewConstantBufferData = static_cast<UINT>(-1);
-	for (unsigned int i = 0; i < counter; ++i)
+	UINT first;
+	UINT last;
+
+	if (FindChangedRange(currentState, bufferArr, counter, first, last))
 	{
-		if (currentState[i] != bufferArr[i])
-		{
-			startOfNewConstantBufferData = (startOfNewConstantBufferData == static_cast<UINT>(-1)) ? i : startOfNewConstantBufferData;
-			currentState[i] = bufferArr[i];
-		}
+		SGProfiler::Count(SGCounter::CONSTANT_BUFFER_CHANGES);
+		(context->*SetBuffers)(first, last - first + 1, bufferArr + first);
+		std::copy(bufferArr + first, bufferArr + last + 1, currentState + first);
 	}
-
-	if(startOfNewConstantBufferData != static_cast<UINT>(-1))
-		(context->*func)(startOfNewConstantBufferData, arrSize - startOfNewConstantBufferData, bufferArr + startOfNewConstantBufferData);
 }
 
+template<SG::D3D11RenderEngine::SetSRVsFunc SetSRVs>
 void SG::D3D11RenderEngine::SetShaderResourceViewsForShader(const std::vector<ResourceView>& srvs, ID3D11ShaderResourceView** currentState, 
-	const SGGraphicalEntityID & entity, ID3D11DeviceContext * context,
-	void(_stdcall ID3D11DeviceContext::* func)(UINT, UINT, ID3D11ShaderResourceView * const *))
+	SGBindStage stage, const SGGraphicalEntityID & entity, ID3D11DeviceContext * context)
 {
 	const UINT arrSize = D3D11_COMMONSHADER_INPUT_RESOURCE_SLOT_COUNT;
-	ID3D11ShaderResourceView* srvArr[arrSize] = {};
+	ID3D11ShaderResourceView* srvArr[arrSize];
+	ID3D11Resource* resourceArr[arrSize];
 	UINT counter = 0;
 	for (auto& srv : srvs)
-		srvArr[counter++] = GetSRV(srv, entity);
-
-	UINT startOfNewSRVData = static_cast<UINT>(-1);
-	for (unsigned int i = 0; i < counter; ++i)
 	{
-		if (currentState[i] != srvArr[i])
-		{
-			startOfNewSRVData = (startOfNewSRVData == static_cast<UINT>(-1)) ? i : startOfNewSRVData;
-			currentState[i] = srvArr[i];
-		}
+		resourceArr[counter] = nullptr;
+		srvArr[counter] = GetSRV(srv, entity, &resourceArr[counter]);
+		++counter;
 	}
 
-	if (startOfNewSRVData != static_cast<UINT>(-1))
-		(context->*func)(startOfNewSRVData, arrSize - startOfNewSRVData, srvArr + startOfNewSRVData);
+	UINT first;
+	UINT last;
+
+	if (FindChangedRange(currentState, srvArr, counter, first, last))
+	{
+		ContextShadowState& state = GetContextState(context);
+
+		for (UINT i = first; i <= last; ++i)
+			state.tracker.Bind({ stage, SGBindType::SHADER_RESOURCE, i }, GetResourceID(resourceArr[i]), state.hazards);
+
+		UnbindHazards(state, context);
+		SGProfiler::Count(SGCounter::SHADER_RESOURCE_CHANGES);
+		(context->*SetSRVs)(first, last - first + 1, srvArr + first);
+		std::copy(srvArr + first, srvArr + last + 1, currentState + first);
+	}
 }
 
+template<SG::D3D11RenderEngine::SetSamplersFunc SetSamplers>
 void SG::D3D11RenderEngine::SetSamplerStatesForShader(const std::vector<PipelineComponent>& samplers, ID3D11SamplerState** currentState, 
-	const SGGraphicalEntityID & entity, ID3D11DeviceContext * context, 
-	void(_stdcall ID3D11DeviceContext::* func)(UINT, UINT, ID3D11SamplerState * const *))
+	const SGGraphicalEntityID & entity, ID3D11DeviceContext * context)
 {
 	const UINT arrSize = D3D11_COMMONSHADER_SAMPLER_SLOT_COUNT;
-	ID3D11SamplerState* samplerArr[arrSize] = {};
+	ID3D11SamplerState* samplerArr[arrSize];
 	UINT counter = 0;
 	for (auto& sampler : samplers)
 		samplerArr[counter++] = GetSamplerState(sampler, entity);
 
-	UINT startOfNewSamplerData = static_cast<UINT>(-1);
-	for (unsigned int i = 0; i < counter; ++i)
+	UINT first;
+	UINT last;
+
+	if (FindChangedRange(currentState, samplerArr, counter, first, last))
 	{
-		if (currentState[i] != samplerArr[i])
-		{
-			startOfNewSamplerData = (startOfNewSamplerData == static_cast<UINT>(-1)) ? i : startOfNewSamplerData;
-			currentState[i] = samplerArr[i];
-		}
+		SGProfiler::Count(SGCounter::SAMPLER_CHANGES);
+		(context->*SetSamplers)(first, last - first + 1, samplerArr + first);
+		std::copy(samplerArr + first, samplerArr + last + 1, currentState + first);
+	}
+	else if (counter != 0)
+	{
+		SGProfiler::Count(SGCounter::SAMPLER_SETS_AVOIDED);
 	}
-
-	if(startOfNewSamplerData != -1)
-		(context->*func)(startOfNewSamplerData, arrSize - startOfNewSamplerData, samplerArr + startOfNewSamplerData);
 }
 
 ID3D11Buffer * SG::D3D11RenderEngine::GetBuffer(const PipelineComponent & component, const SGGraphicalEntityID & entity, ID3D11DeviceContext * context)
@@ -1173,14 +1929,14 @@ UINT SG::D3D11RenderEngine::GetStrideFromVB(const PipelineComponent & component,
 	return toReturn;
 }
 
-ID3D11ShaderResourceView * SG::D3D11RenderEngine::GetSRV(const ResourceView & view, const SGGraphicalEntityID & entity)
+ID3D11ShaderResourceView * SG::D3D11RenderEngine::GetSRV(const ResourceView & view, const SGGraphicalEntityID & entity, ID3D11Resource ** resource)
 {
 	ID3D11ShaderResourceView* toReturn = nullptr;
 	switch (view.component.source)
 	{
 	case Association::GLOBAL:
 	{
-		toReturn = view.type == ResourceView::ResourceType::TEXTURE ? textureHandler->GetSRV(view.component.resourceGuid) : bufferHandler->GetSRV(view.component.resourceGuid);
+		toReturn = view.type == ResourceView::ResourceType::TEXTURE ? textureHandler->GetSRV(view.component.resourceGuid, resource) : bufferHandler->GetSRV(view.component.resourceGuid, resource);
 	}
 	break;
 	case Association::GROUP:
@@ -1188,13 +1944,13 @@ ID3D11ShaderResourceView * SG::D3D11RenderEngine::GetSRV(const ResourceView & vi
 		entityMutex.lock();
 		SGGuid& groupGuid = graphicalEntities[entity].groupGuid;
 		entityMutex.unlock();
-		toReturn = view.type == ResourceView::ResourceType::TEXTURE ? textureHandler->GetSRV(view.component.resourceGuid, groupGuid) : bufferHandler->GetSRV(view.component.resourceGuid, groupGuid);
+		toReturn = view.type == ResourceView::ResourceType::TEXTURE ? textureHandler->GetSRV(view.component.resourceGuid, groupGuid, resource) : bufferHandler->GetSRV(view.component.resourceGuid, groupGuid, resource);
 	}
 	break;
 	case Association::ENTITY:
 	{
 		entityMutex.lock();
-		toReturn = view.type == ResourceView::ResourceType::TEXTURE ? textureHandler->GetSRV(view.component.resourceGuid, entity) : bufferHandler->GetSRV(view.component.resourceGuid, entity);
+		toReturn = view.type == ResourceView::ResourceType::TEXTURE ? textureHandler->GetSRV(view.component.resourceGuid, entity, resource) : bufferHandler->GetSRV(view.component.resourceGuid, entity, resource);
 		entityMutex.unlock();
 	}
 	break;
@@ -1203,14 +1959,14 @@ ID3D11ShaderResourceView * SG::D3D11RenderEngine::GetSRV(const ResourceView & vi
 	return toReturn;
 }
 
-ID3D11RenderTargetView* SG::D3D11RenderEngine::GetRTV(const ResourceView & view, const SGGraphicalEntityID & entity)
+ID3D11RenderTargetView* SG::D3D11RenderEngine::GetRTV(const ResourceView & view, const SGGraphicalEntityID & entity, ID3D11Resource ** resource)
 {
 	ID3D11RenderTargetView* toReturn = nullptr;
 	switch (view.component.source)
 	{
 	case Association::GLOBAL:
 	{
-		toReturn = view.type == ResourceView::ResourceType::TEXTURE ? textureHandler->GetRTV(view.component.resourceGuid) : nullptr;
+		toReturn = view.type == ResourceView::ResourceType::TEXTURE ? textureHandler->GetRTV(view.component.resourceGuid, resource) : nullptr;
 	}
 	break;
 	case Association::GROUP:
@@ -1218,13 +1974,13 @@ ID3D11RenderTargetView* SG::D3D11RenderEngine::GetRTV(const ResourceView & view,
 		entityMutex.lock();
 		SGGuid& groupGuid = graphicalEntities[entity].groupGuid;
 		entityMutex.unlock();
-		toReturn = view.type == ResourceView::ResourceType::TEXTURE ? textureHandler->GetRTV(view.component.resourceGuid, groupGuid) : nullptr;
+		toReturn = view.type == ResourceView::ResourceType::TEXTURE ? textureHandler->GetRTV(view.component.resourceGuid, groupGuid, resource) : nullptr;
 	}
 	break;
 	case Association::ENTITY:
 	{
 		entityMutex.lock();
-		toReturn = view.type == ResourceView::ResourceType::TEXTURE ? textureHandler->GetRTV(view.component.resourceGuid, entity) : nullptr;
+		toReturn = view.type == ResourceView::ResourceType::TEXTURE ? textureHandler->GetRTV(view.component.resourceGuid, entity, resource) : nullptr;
 		entityMutex.unlock();
 	}
 	break;
@@ -1233,14 +1989,14 @@ ID3D11RenderTargetView* SG::D3D11RenderEngine::GetRTV(const ResourceView & view,
 	return toReturn;
 }
 
-ID3D11DepthStencilView * SG::D3D11RenderEngine::GetDSV(const ResourceView & view, const SGGraphicalEntityID & entity)
+ID3D11DepthStencilView * SG::D3D11RenderEngine::GetDSV(const ResourceView & view, const SGGraphicalEntityID & entity, ID3D11Resource ** resource)
 {
 	ID3D11DepthStencilView* toReturn = nullptr;
 	switch (view.component.source)
 	{
 	case Association::GLOBAL:
 	{
-		toReturn = view.type == ResourceView::ResourceType::TEXTURE ? textureHandler->GetDSV(view.component.resourceGuid) : nullptr;
+		toReturn = view.type == ResourceView::ResourceType::TEXTURE ? textureHandler->GetDSV(view.component.resourceGuid, resource) : nullptr;
 	}
 	break;
 	case Association::GROUP:
@@ -1248,13 +2004,13 @@ ID3D11DepthStencilView * SG::D3D11RenderEngine::GetDSV(const ResourceView & view
 		entityMutex.lock();
 		SGGuid& groupGuid = graphicalEntities[entity].groupGuid;
 		entityMutex.unlock();
-		toReturn = view.type == ResourceView::ResourceType::TEXTURE ? textureHandler->GetDSV(view.component.resourceGuid, groupGuid) : nullptr;
+		toReturn = view.type == ResourceView::ResourceType::TEXTURE ? textureHandler->GetDSV(view.component.resourceGuid, groupGuid, resource) : nullptr;
 	}
 	break;
 	case Association::ENTITY:
 	{
 		entityMutex.lock();
-		toReturn = view.type == ResourceView::ResourceType::TEXTURE ? textureHandler->GetDSV(view.component.resourceGuid, entity) : nullptr;
+		toReturn = view.type == ResourceView::ResourceType::TEXTURE ? textureHandler->GetDSV(view.component.resourceGuid, entity, resource) : nullptr;
 		entityMutex.unlock();
 	}
 	break;
@@ -1263,14 +2019,14 @@ ID3D11DepthStencilView * SG::D3D11RenderEngine::GetDSV(const ResourceView & view
 	return toReturn;
 }
 
-ID3D11UnorderedAccessView * SG::D3D11RenderEngine::GetUAV(const ResourceView & view, const SGGraphicalEntityID & entity)
+ID3D11UnorderedAccessView * SG::D3D11RenderEngine::GetUAV(const ResourceView & view, const SGGraphicalEntityID & entity, ID3D11Resource ** resource)
 {
 	ID3D11UnorderedAccessView* toReturn = nullptr;
 	switch (view.component.source)
 	{
 	case Association::GLOBAL:
 	{
-		toReturn = view.type == ResourceView::ResourceType::TEXTURE ? textureHandler->GetUAV(view.component.resourceGuid) : bufferHandler->GetUAV(view.component.resourceGuid);
+		toReturn = view.type == ResourceView::ResourceType::TEXTURE ? textureHandler->GetUAV(view.component.resourceGuid, resource) : bufferHandler->GetUAV(view.component.resourceGuid, resource);
 	}
 	break;
 	case Association::GROUP:
@@ -1278,13 +2034,13 @@ ID3D11UnorderedAccessView * SG::D3D11RenderEngine::GetUAV(const ResourceView & v
 		entityMutex.lock();
 		SGGuid& groupGuid = graphicalEntities[entity].groupGuid;
 		entityMutex.unlock();
-		toReturn = view.type == ResourceView::ResourceType::TEXTURE ? textureHandler->GetUAV(view.component.resourceGuid, groupGuid) : bufferHandler->GetUAV(view.component.resourceGuid, groupGuid);
+		toReturn = view.type == ResourceView::ResourceType::TEXTURE ? textureHandler->GetUAV(view.component.resourceGuid, groupGuid, resource) : bufferHandler->GetUAV(view.component.resourceGuid, groupGuid, resource);
 	}
 	break;
 	case Association::ENTITY:
 	{
 		entityMutex.lock();
-		toReturn = view.type == ResourceView::ResourceType::TEXTURE ? textureHandler->GetUAV(view.component.resourceGuid, entity) : bufferHandler->GetUAV(view.component.resourceGuid, entity);
+		toReturn = view.type == ResourceView::ResourceType::TEXTURE ? textureHandler->GetUAV(view.component.resourceGuid, entity, resource) : bufferHandler->GetUAV(view.component.resourceGuid, entity, resource);
 		entityMutex.unlock();
 	}
 	break;
@@ -1327,6 +2083,63 @@ ID3D11RasterizerState * SG::D3D11RenderEngine::GetRasterizerState(const Pipeline
 	return toReturn;
 }
 
+ID3D11BlendState * SG::D3D11RenderEngine::GetBlendState(const PipelineComponent & component, const SGGraphicalEntityID & entity)
+{
+	ID3D11BlendState* toReturn = nullptr;
+
+	if (component.resourceGuid == SGGuid())
+		return toReturn;
+
+	switch (component.source)
+	{
+	case Association::GLOBAL:
+	{
+		toReturn = stateHandler->GetBlendState(component.resourceGuid);
+	}
+	break;
+	case Association::GROUP:
+	{
+		entityMutex.lock();
+		SGGuid& groupGuid = graphicalEntities[entity].groupGuid;
+		entityMutex.unlock();
+		toReturn = stateHandler->GetBlendState(component.resourceGuid, groupGuid);
+	}
+	break;
+	case Association::ENTITY:
+	{
+		entityMutex.lock();
+		toReturn = stateHandler->GetBlendState(component.resourceGuid, entity);
+		entityMutex.unlock();
+	}
+	break;
+	}
+
+	return toReturn;
+}
+
+const SG::D3D11StateBlockData & SG::D3D11RenderEngine::GetStateBlock(const PipelineComponent & component, const SGGraphicalEntityID & entity)
+{
+	switch (component.source)
+	{
+	case Association::GROUP:
+	{
+		entityMutex.lock();
+		SGGuid& groupGuid = graphicalEntities[entity].groupGuid;
+		entityMutex.unlock();
+		return stateHandler->GetStateBlock(component.resourceGuid, groupGuid);
+	}
+	case Association::ENTITY:
+	{
+		entityMutex.lock();
+		const D3D11StateBlockData& toReturn = stateHandler->GetStateBlock(component.resourceGuid, entity);
+		entityMutex.unlock();
+		return toReturn;
+	}
+	default:
+		return stateHandler->GetStateBlock(component.resourceGuid);
+	}
+}
+
 SG::D3D11DrawCallHandler::DrawCall SG::D3D11RenderEngine::GetDrawCall(const PipelineComponent & component, const SGGraphicalEntityID & entity)
 {
 	SG::D3D11DrawCallHandler::DrawCall toReturn;
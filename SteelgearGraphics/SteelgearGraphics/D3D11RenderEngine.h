@@ -3,8 +3,16 @@
 #include <d3d11_4.h>
 #include <exception>
 #include <stdexcept>
+#include <unordered_map>
+#include <unordered_set>
+#include <array>
+#include <utility>
 
 #include "SGRenderEngine.h"
+#include "SGRenderGraph.h"
+#include "SGTransientPlanner.h"
+#include "SGHazardTracker.h"
+#include "SGJobBalancer.h"
 
 #include "D3D11BufferHandler.h"
 #include "D3D11SamplerHandler.h"
@@ -13,6 +21,8 @@
 #include "D3D11TextureHandler.h"
 #include "D3D11PipelineManager.h"
 #include "D3D11DrawCallHandler.h"
+#include "D3D11TextureStreamer.h"
+#include "D3D11Readback.h"
 
 namespace SG
 {
@@ -34,6 +44,7 @@ namespace SG
 	{
 		ID3D11Buffer* buffer;
 		UINT offset;
+		DXGI_FORMAT format;
 	};
 
 	struct RenderPipelineState
@@ -46,11 +57,18 @@ namespace SG
 		RenderShaderState geometryShader;
 		RenderShaderState pixelShader;
 		ID3D11RenderTargetView* rtvs[8];
-		ID3D11UnorderedAccessView* uavs[8];
+		ID3D11UnorderedAccessView* uavs[8]; // Indexed by output slot, the first nrOfRTVs are taken by the render targets
+		UINT nrOfRTVs;
 		D3D11_VIEWPORT viewports[D3D11_VIEWPORT_AND_SCISSORRECT_OBJECT_COUNT_PER_PIPELINE];
+		UINT nrOfViewports;
 		ID3D11DepthStencilView* dsv;
 		ID3D11RasterizerState* rasterizerState;
 		ID3D11BlendState* blendState;
+		FLOAT blendFactor[4]; // Zeroed when the shadow is reset, so the first default blend state is always set
+		UINT sampleMask;
+		ID3D11DepthStencilState* depthStencilState;
+		UINT stencilRef;
+		size_t stateBlock; // Id of the applied state block, 0 if the states were set without one
 	};
 
 	struct ComputePipelineState
@@ -61,6 +79,63 @@ namespace SG
 		ID3D11SamplerState* samplers[D3D11_COMMONSHADER_SAMPLER_SLOT_COUNT];
 	};
 
+	// Everything bound to a context since its last command list was finished, shared by all jobs recorded on the context
+	struct ContextShadowState
+	{
+		D3D11_PRIMITIVE_TOPOLOGY topology;
+		ID3D11InputLayout* inputLayout;
+		ID3D11VertexShader* vertexShader;
+		ID3D11HullShader* hullShader;
+		ID3D11DomainShader* domainShader;
+		ID3D11GeometryShader* geometryShader;
+		ID3D11PixelShader* pixelShader;
+		ID3D11ComputeShader* computeShader;
+		RenderPipelineState render;
+		ComputePipelineState compute;
+		SGHazardTracker tracker;
+		std::vector<SGBindPoint> hazards; // Found by the tracker and not yet unbound
+	};
+
+	// A single pipeline job applied to a range of the entities of a graphics job
+	struct PipelineJobChunk
+	{
+		size_t graphicsJob;
+		std::pair<PipelineJobType, SGGuid> pipelineJob;
+		size_t entityStart;
+		size_t entityEnd;
+		double recordedTime;
+	};
+
+	// The order of a pipeline stays valid until one of its dependencies is added or removed
+	struct CompiledPipeline
+	{
+		std::vector<std::pair<PipelineJobType, SGGuid>> jobs; // Culled and reordered by the render graph
+		std::vector<SGGuid> dependencies; // The pipeline, its jobs and the global views they access
+		std::vector<SGGuid> transientViews;
+	};
+
+	// Guids left as the default are not rebound when the level is picked
+	struct SGLODLevel
+	{
+		SGGuid vertexBuffer;
+		SGGuid indexBuffer;
+		SGGuid drawCall;
+		SGGuid levelGroup; // Only used by LOD sets with a group association
+		float screenSizeThreshold = 0.0f;
+	};
+
+	// With an entity association the level resources are bound directly to the entity,
+	// with a group association the entity is moved to the group of the level so it can still be instanced
+	struct SGLODSet
+	{
+		Association association = Association::ENTITY;
+		SGGuid vertexBufferBindGuid;
+		SGGuid indexBufferBindGuid;
+		SGGuid drawCallBindGuid;
+		std::vector<SGLODLevel> levels; // Sorted from the highest to the lowest detail
+		float hysteresis = 0.1f;
+	};
+
 	class D3D11RenderEngine : public SGRenderEngine
 	{
 	public:
@@ -74,11 +149,19 @@ namespace SG
 		D3D11TextureHandler* TextureHandler();
 		D3D11PipelineManager* PipelineManager();
 		D3D11DrawCallHandler* DrawCallHandler();
+		D3D11TextureStreamer* TextureStreamer();
+		D3D11Readback* Readback();
+
+		SGResult CreateLODSet(const SGGuid& guid, const SGLODSet& lodSet);
+
+		/** Plan of the transient textures of a pipeline, available after the pipeline has been rendered once */
+		SGTransientPlan GetTransientPlan(const SGGuid& pipelineGuid);
 
 	private:
 		ID3D11Device* device = nullptr;
 		ID3D11DeviceContext* immediateContext = nullptr;
 		std::vector<ID3D11DeviceContext*> defferedContexts;
+		std::vector<ContextShadowState> contextStates; // One per deffered context, same order
 		IDXGISwapChain* swapChain = nullptr;
 
 		D3D11BufferHandler* bufferHandler;
@@ -88,78 +171,134 @@ namespace SG
 		D3D11TextureHandler* textureHandler;
 		D3D11PipelineManager* pipelineManager;
 		D3D11DrawCallHandler* drawCallHandler;
+		D3D11TextureStreamer* textureStreamer;
+		D3D11Readback* readback;
+		float streamingViewportHeight; // Pixels covered by a screen size of 1 when mips are requested for streamed textures
+		bool specializedDrawLoops;
+
+		std::vector<PipelineJobChunk> jobChunks;
+		std::vector<double> predictedChunkTimes; // Microseconds
+		std::vector<ID3D11CommandList*> segmentCommandLists; // One per segment of the balancer
+		SGJobBalancer jobBalancer;
+		std::unordered_map<SGGuid, SGLODSet> lodLevelBindings;
+		std::unordered_map<SGGuid, CompiledPipeline> compiledPipelines;
+		std::unordered_map<SGGuid, SGGuid> transientViewTextures;
+		std::vector<D3D11_TEXTURE2D_DESC> transientDescriptors; // Index is the descriptor key used when planning
+		std::vector<std::vector<ID3D11Texture2D*>> transientPool; // Backing textures per descriptor, reused between pipelines and frames
+		std::unordered_map<SGGuid, SGTransientPlan> transientPlans;
+		std::mutex transientMutex;
 
 		void CreateDeviceAndContext(const SGRenderSettings& settings);
+		ContextShadowState& GetContextState(ID3D11DeviceContext* context);
+		size_t GetResourceID(ID3D11Resource* resource);
+		void UnbindHazards(ContextShadowState& state, ID3D11DeviceContext* context);
+		void UnbindShaderResource(ContextShadowState& state, const SGBindPoint& bindPoint, ID3D11DeviceContext* context);
 		void CreateSwapChain(const SGRenderSettings& settings);
+		void CreateHeadlessBackBuffers(const SGRenderSettings& settings);
+		void Present();
 
 		void FinishFrame() override;
 		void SwapFrame() override;
 		void ExecuteJobs(const std::vector<SGGraphicsJob>& jobs) override;
+		void ApplyLODLevel(const SGGraphicalEntityID& entity, const SGGuid& lodSetGuid, unsigned int level) override;
+		void RequestTextureMips(const SGGraphicsJob& job) override;
 
-		void HandlePipelineJobs(const std::vector<SGGraphicsJob>& jobs, int startPos, int endPos, ID3D11DeviceContext* context);
+		const std::vector<std::pair<PipelineJobType, SGGuid>>& GetCompiledPipeline(const SGGuid& pipelineGuid);
+		void InvalidateCompiledPipelines(const std::vector<SGGuid>& changedGuids);
+		SGRenderGraphNode CreateRenderGraphNode(const std::pair<PipelineJobType, SGGuid>& job, std::vector<SGGuid>& dependencies);
+		void AddComponentRead(const PipelineComponent& component, SGRenderGraphNode& node);
+		void AddViewAccess(const ResourceView& view, bool read, bool write, SGRenderGraphNode& node, std::vector<SGGuid>& dependencies);
+		void CreateTransientTextures(const SGGuid& pipelineGuid, const SGPipeline& pipeline,
+			const std::vector<SGRenderGraphNode>& nodes, const SGCompiledRenderGraph& graph);
+		size_t GetTransientDescriptorKey(const SGTransientTexture& texture);
+		ID3D11Texture2D* GetTransientBacking(size_t descriptorKey, size_t poolIndex);
+		void CreateJobChunks(const std::vector<SGGraphicsJob>& jobs, size_t maxChunksPerJob);
+		size_t GetGroupEnd(const std::vector<SGGraphicalEntityID>& entities, size_t position, size_t endPos);
+		void PredictChunkTimes();
+		void RecordChunkSegments(const std::vector<SGGraphicsJob>& jobs, ID3D11DeviceContext* context);
+		void UpdateJobTimes();
+		void HandlePipelineJobs(const std::vector<SGGraphicsJob>& jobs, size_t startPos, size_t endPos, ID3D11DeviceContext* context);
 
-		void HandleRenderJob(const SGRenderJob& job, const std::vector<SGGraphicalEntityID>& entities, ID3D11DeviceContext* context);
+		void HandleRenderJob(const SGRenderJob& job, const std::vector<SGGraphicalEntityID>& entities,
+			size_t entityStart, size_t entityEnd, ID3D11DeviceContext* context);
 		D3D11_PRIMITIVE_TOPOLOGY TranslateTopology(const SGTopology& topology);
-		void SetShaders(const SGRenderJob& job, ID3D11DeviceContext* context);
+		void SetShaders(const SGRenderJob& job, ContextShadowState& state, ID3D11DeviceContext* context);
 		void HandleGlobalRenderJob(const SGRenderJob& job, ID3D11DeviceContext* context);
-		void HandleGroupRenderJob(const SGRenderJob& job, const std::vector<SGGraphicalEntityID>& entities, ID3D11DeviceContext* context);
-		void HandleEntityRenderJob(const SGRenderJob& job, const std::vector<SGGraphicalEntityID>& entities, ID3D11DeviceContext* context);
-
-		void HandleComputeJob(const SGComputeJob& job, const std::vector<SGGraphicalEntityID>& entities, ID3D11DeviceContext* context);
-		void HandleGlobalComputeJob(const SGComputeJob& job, ID3D11DeviceContext* context);
-
-		void ClearNecessaryResources(const SGRenderJob& job, ID3D11DeviceContext* context);
-		void ClearNecessaryResources(const SGComputeJob& job, ID3D11DeviceContext* context);
-		void ClearVertexBuffers(const std::vector<SGVertexBuffer>& vertexBuffers, ID3D11DeviceContext* context);
 
-		void ClearConstantBuffers(const SGRenderJob& job, ID3D11DeviceContext* context);
-		void ClearConstantBuffersForShader(const std::vector<ConstantBuffer>& constantBuffers,
-			ID3D11DeviceContext* context, void(_stdcall ID3D11DeviceContext::* func)(UINT, UINT, ID3D11Buffer* const*));
+		// Every render job shape has its own draw loop without branches for the stages it does not use
+		static constexpr unsigned int VERTEX_STAGE = D3D11PipelineManager::VERTEX_STAGE;
+		static constexpr unsigned int HULL_STAGE = D3D11PipelineManager::HULL_STAGE;
+		static constexpr unsigned int DOMAIN_STAGE = D3D11PipelineManager::DOMAIN_STAGE;
+		static constexpr unsigned int GEOMETRY_STAGE = D3D11PipelineManager::GEOMETRY_STAGE;
+		static constexpr unsigned int PIXEL_STAGE = D3D11PipelineManager::PIXEL_STAGE;
+		static constexpr unsigned int PER_DRAW_BINDINGS = D3D11PipelineManager::PER_DRAW_BINDINGS;
+		static constexpr size_t NR_OF_SHAPES = D3D11PipelineManager::NR_OF_SHAPES;
 
-		void ClearShaderResourceViews(const SGRenderJob& job, ID3D11DeviceContext* context);
-		void ClearShaderResourceViewsForShader(const std::vector<ResourceView>& srvs,
-			ID3D11DeviceContext* context, void(_stdcall ID3D11DeviceContext::* func)(UINT, UINT, ID3D11ShaderResourceView* const*));
+		using DrawLoop = void(D3D11RenderEngine::*)(const SGRenderJob&, const std::vector<SGGraphicalEntityID>&, size_t, size_t, ID3D11DeviceContext*);
+		using SetBuffersFunc = void(_stdcall ID3D11DeviceContext::*)(UINT, UINT, ID3D11Buffer*const*);
+		using SetSRVsFunc = void(_stdcall ID3D11DeviceContext::*)(UINT, UINT, ID3D11ShaderResourceView*const*);
+		using SetSamplersFunc = void(_stdcall ID3D11DeviceContext::*)(UINT, UINT, ID3D11SamplerState*const*);
 
-		void ClearOMViews(const SGRenderJob& job, ID3D11DeviceContext* context);
+		template<size_t... Shapes>
+		static std::array<DrawLoop, sizeof...(Shapes)> CreateGroupDrawLoops(std::index_sequence<Shapes...>);
+		template<size_t... Shapes>
+		static std::array<DrawLoop, sizeof...(Shapes)> CreateEntityDrawLoops(std::index_sequence<Shapes...>);
 
-		void SetConstantBuffers(const SGRenderJob& job, RenderPipelineState& currentState,
+		template<unsigned int Shape>
+		void HandleGroupRenderJob(const SGRenderJob& job, const std::vector<SGGraphicalEntityID>& entities,
+			size_t entityStart, size_t entityEnd, ID3D11DeviceContext* context);
+		template<unsigned int Shape>
+		void HandleEntityRenderJob(const SGRenderJob& job, const std::vector<SGGraphicalEntityID>& entities,
+			size_t entityStart, size_t entityEnd, ID3D11DeviceContext* context);
+		template<unsigned int Shape>
+		void SetDrawBindings(const SGRenderJob& job, RenderPipelineState& currentState,
 			const SGGraphicalEntityID& entity, ID3D11DeviceContext* context);
-		void SetShaderResourceViews(const SGRenderJob& job, RenderPipelineState& currentState,
-			const SGGraphicalEntityID& entity, ID3D11DeviceContext* context);
-		void SetSamplerStates(const SGRenderJob& job, RenderPipelineState& currentState,
+		template<SetBuffersFunc SetBuffers, SetSRVsFunc SetSRVs, SetSamplersFunc SetSamplers>
+		void SetShaderStageResources(const RenderShader& shader, RenderShaderState& currentState, SGBindStage stage,
 			const SGGraphicalEntityID& entity, ID3D11DeviceContext* context);
+
+		void HandleComputeJob(const SGComputeJob& job, const std::vector<SGGraphicalEntityID>& entities, ID3D11DeviceContext* context);
+		void HandleGlobalComputeJob(const SGComputeJob& job, ID3D11DeviceContext* context);
+
 		void SetVertexBuffers(const SGRenderJob& job, VertexBufferState currentState[],
 			const SGGraphicalEntityID& entity, ID3D11DeviceContext* context);
 		void SetIndexBuffer(const SGRenderJob& job, IndexBufferState& currentState,
 			const SGGraphicalEntityID& entity, ID3D11DeviceContext* context);
 		void SetOMViews(const SGRenderJob& job, RenderPipelineState& currentState,
 			const SGGraphicalEntityID& entity, ID3D11DeviceContext* context);
-		void SetViewports(const SGRenderJob& job, D3D11_VIEWPORT currentState[],
+		void SetViewports(const SGRenderJob& job, RenderPipelineState& currentState,
 			const SGGraphicalEntityID& entity, ID3D11DeviceContext* context);
 		void SetStates(const SGRenderJob& job, RenderPipelineState& currentState,
 			const SGGraphicalEntityID& entity, ID3D11DeviceContext* context);
+		void ApplyStateBlock(const D3D11StateBlockData& block, ContextShadowState& state, ID3D11DeviceContext* context);
+		void SetBlendState(ID3D11BlendState* blendState, const FLOAT blendFactor[4], UINT sampleMask,
+			RenderPipelineState& currentState, ID3D11DeviceContext* context);
+		void SetDepthStencilState(ID3D11DepthStencilState* depthStencilState, UINT stencilRef,
+			RenderPipelineState& currentState, ID3D11DeviceContext* context);
 		void ExecuteDrawCall(const SGRenderJob& job, const SGGraphicalEntityID& entity, unsigned int nrInGroup, ID3D11DeviceContext* context);
 		void ExecuteDrawCall(const SGRenderJob& job, const SGGraphicalEntityID& entity, ID3D11DeviceContext* context);
+		template<SetBuffersFunc SetBuffers>
 		void SetConstantBuffersForShader(const std::vector<ConstantBuffer>& buffers, ID3D11Buffer** currentState,
-			const SGGraphicalEntityID& entity, ID3D11DeviceContext* context,
-			void(_stdcall ID3D11DeviceContext::*func)(UINT, UINT, ID3D11Buffer*const*));
+			const SGGraphicalEntityID& entity, ID3D11DeviceContext* context);
+		template<SetSRVsFunc SetSRVs>
 		void SetShaderResourceViewsForShader(const std::vector<ResourceView>& srvs, ID3D11ShaderResourceView** currentState,
-			const SGGraphicalEntityID& entity, ID3D11DeviceContext* context,
-			void(_stdcall ID3D11DeviceContext::*func)(UINT, UINT, ID3D11ShaderResourceView *const*));
+			SGBindStage stage, const SGGraphicalEntityID& entity, ID3D11DeviceContext* context);
+		template<SetSamplersFunc SetSamplers>
 		void SetSamplerStatesForShader(const std::vector<PipelineComponent>& samplers, ID3D11SamplerState** currentState,
-			const SGGraphicalEntityID& entity, ID3D11DeviceContext* context,
-			void(_stdcall ID3D11DeviceContext::*func)(UINT, UINT, ID3D11SamplerState *const*));
+			const SGGraphicalEntityID& entity, ID3D11DeviceContext* context);
 
 		ID3D11Buffer* GetBuffer(const PipelineComponent& component, const SGGraphicalEntityID& entity, ID3D11DeviceContext* context);
 		ID3D11SamplerState* GetSamplerState(const PipelineComponent& component, const SGGraphicalEntityID& entity);
 		UINT GetOffset(const PipelineComponent& component, const SGGraphicalEntityID& entity);
 		UINT GetStride(const PipelineComponent& component, const SGGraphicalEntityID& entity);
 		UINT GetStrideFromVB(const PipelineComponent& component, const SGGraphicalEntityID& entity);
-		ID3D11ShaderResourceView* GetSRV(const ResourceView& view, const SGGraphicalEntityID& entity);
-		ID3D11RenderTargetView* GetRTV(const ResourceView& view, const SGGraphicalEntityID& entity);
-		ID3D11DepthStencilView* GetDSV(const ResourceView& view, const SGGraphicalEntityID& entity);
-		ID3D11UnorderedAccessView* GetUAV(const ResourceView& view, const SGGraphicalEntityID& entity);
+		ID3D11ShaderResourceView* GetSRV(const ResourceView& view, const SGGraphicalEntityID& entity, ID3D11Resource** resource);
+		ID3D11RenderTargetView* GetRTV(const ResourceView& view, const SGGraphicalEntityID& entity, ID3D11Resource** resource);
+		ID3D11DepthStencilView* GetDSV(const ResourceView& view, const SGGraphicalEntityID& entity, ID3D11Resource** resource);
+		ID3D11UnorderedAccessView* GetUAV(const ResourceView& view, const SGGraphicalEntityID& entity, ID3D11Resource** resource);
 		ID3D11RasterizerState* GetRasterizerState(const PipelineComponent& component, const SGGraphicalEntityID& entity);
+		ID3D11BlendState* GetBlendState(const PipelineComponent& component, const SGGraphicalEntityID& entity);
+		const D3D11StateBlockData& GetStateBlock(const PipelineComponent& component, const SGGraphicalEntityID& entity);
 		SG::D3D11DrawCallHandler::DrawCall GetDrawCall(const PipelineComponent& component, const SGGraphicalEntityID& entity);
 		SG::D3D11DrawCallHandler::DispatchCall GetDispatchCall(const PipelineComponent& component, const SGGraphicalEntityID& entity);
 		D3D11_VIEWPORT GetViewport(const PipelineComponent& component, const SGGraphicalEntityID& entity);
@@ -25,7 +25,7 @@ SG::D3D11ResourceViewData::~D3D11ResourceViewData()
 }
 
 SG::D3D11ResourceViewData::D3D11ResourceViewData(D3D11ResourceViewData&& other) : type(other.type), view(other.view),
-resourceGuid(std::move(other.resourceGuid))
+resourceGuid(std::move(other.resourceGuid)), resource(other.resource)
 {
 	other.view.srv = nullptr; // Since only ptrs it does not matter which is used here
 }
@@ -38,6 +38,7 @@ SG::D3D11ResourceViewData& SG::D3D11ResourceViewData::operator=(D3D11ResourceVie
 		view.srv = other.view.srv; // Since only ptrs it does not matter which is used here
 		other.view.srv = nullptr;
 		resourceGuid = std::move(other.resourceGuid);
+		resource = other.resource;
 	}
 
 	return *this;
@@ -25,6 +25,7 @@ namespace SG
 			ID3D11DepthStencilView* dsv;
 		} view;
 		SGGuid resourceGuid;
+		ID3D11Resource* resource = nullptr; // Set when the view is created so binds do not have to ask the view, not referenced since the view keeps it alive
 
 		D3D11ResourceViewData() = default;
 		~D3D11ResourceViewData();
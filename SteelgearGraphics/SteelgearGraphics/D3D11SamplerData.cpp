@@ -25,3 +25,14 @@ SG::D3D11SamplerData& SG::D3D11SamplerData::operator=(D3D11SamplerData&& other)
 	// NOW THAT FRAME MAPS ARE USED THEY ALL NEED THEM
 	// PROBABLY SHOULD RENAME THEM TO BETTER NAMES THAT REFLECT WHAT IS ACTUALLY DONE
 }
+
+SG::D3D11SamplerData SG::D3D11SamplerData::Share() const
+{
+	D3D11SamplerData toReturn;
+	toReturn.sampler = sampler;
+
+	if (sampler)
+		sampler->AddRef();
+
+	return toReturn;
+}
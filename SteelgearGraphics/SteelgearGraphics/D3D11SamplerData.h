@@ -13,5 +13,7 @@ namespace SG
 
 		D3D11SamplerData(D3D11SamplerData&& other);
 		D3D11SamplerData& operator=(D3D11SamplerData&& other);
+
+		D3D11SamplerData Share() const; // Another owner of the same sampler
 	};
 }
\ No newline at end of file
@@ -1,4 +1,5 @@
 #include "D3D11SamplerHandler.h"
+#include "D3D11Capture.h"
 
 SG::D3D11SamplerHandler::D3D11SamplerHandler(ID3D11Device * device)
 {
@@ -7,7 +8,9 @@ SG::D3D11SamplerHandler::D3D11SamplerHandler(ID3D11Device * device)
 
 SG::SGResult SG::D3D11SamplerHandler::CreateSampler(const SGGuid & guid, Filter filter, TextureAdressMode adressU, TextureAdressMode adressV, TextureAdressMode adressW, FLOAT mipLODBias, UINT maxAnisotropy, ComparisonFunction comparisonFunc, FLOAT borderColor[4], FLOAT minLOD, FLOAT maxLOD)
 {
+	SGCaptureScope capture(SGCaptureCall::CREATE_SAMPLER, guid, filter, adressU, adressV, adressW, mipLODBias, maxAnisotropy, comparisonFunc, SGCaptureBytes{ borderColor, sizeof(FLOAT) * 4 }, minLOD, maxLOD);
 	D3D11_SAMPLER_DESC desc;
+	ZeroMemory(&desc, sizeof(desc));
 	desc.Filter = TranslateFilter(filter);
 	desc.AddressU = TranslateAdressMode(adressU);
 	desc.AddressV = TranslateAdressMode(adressV);
@@ -19,32 +22,45 @@ SG::SGResult SG::D3D11SamplerHandler::CreateSampler(const SGGuid & guid, Filter
 	desc.MinLOD = minLOD;
 	desc.MaxLOD = maxLOD;
 
-	D3D11SamplerData toStore;
-	if(FAILED(device->CreateSamplerState(&desc, &toStore.sampler)))
-		return SGResult::FAIL;
+	D3D11SamplerData shared;
 
-	samplers.AddElement(guid, std::move(toStore));
+	if (!samplerTable.Acquire(guid, &desc, sizeof(desc), shared))
+	{
+		D3D11SamplerData toStore;
+		if(FAILED(device->CreateSamplerState(&desc, &toStore.sampler)))
+			return SGResult::FAIL;
+
+		samplerTable.Insert(guid, &desc, sizeof(desc), std::move(toStore), shared);
+	}
+
+	samplers.AddElement(guid, std::move(shared));
 
 	return SGResult::OK;
 }
 
 void SG::D3D11SamplerHandler::RemoveSampler(const SGGuid& guid)
 {
+	SGCaptureScope capture(SGCaptureCall::REMOVE_SAMPLER, guid);
 	samplers.RemoveElement(guid);
+	samplerTable.Release(guid);
 }
 
 SG::SGResult SG::D3D11SamplerHandler::BindSamplerToEntity(const SGGraphicalEntityID & entity, const SGGuid & samplerGuid, const SGGuid & bindGuid)
 {
+	SGCaptureScope capture(SGCaptureCall::BIND_SAMPLER_TO_ENTITY, entity, samplerGuid, bindGuid);
 	return SG::SGGraphicsHandler::BindElementToEntity(entity, samplerGuid, bindGuid, samplers);
 }
 
 SG::SGResult SG::D3D11SamplerHandler::BindSamplerToGroup(const SGGuid & group, const SGGuid & samplerGuid, const SGGuid & bindGuid)
 {
+	SGCaptureScope capture(SGCaptureCall::BIND_SAMPLER_TO_GROUP, group, samplerGuid, bindGuid);
 	return SG::SGGraphicsHandler::BindElementToGroup(group, samplerGuid, bindGuid, samplers);
 }
 
 void SG::D3D11SamplerHandler::FinishFrame()
 {
+	SGTraceScope scope("D3D11SamplerHandler::FinishFrame");
+
 	SG::SGGraphicsHandler::FinishFrame();
 
 	samplers.FinishFrame();
@@ -52,9 +68,11 @@ void SG::D3D11SamplerHandler::FinishFrame()
 
 void SG::D3D11SamplerHandler::SwapFrame()
 {
+	SGTraceScope scope("D3D11SamplerHandler::SwapFrame");
+
 	SG::SGGraphicsHandler::SwapFrame();
 
-	samplers.UpdateActive();
+	SGProfiler::Count(SGCounter::FRAME_MAP_OPERATIONS, samplers.UpdateActive());
 }
 
 D3D11_FILTER SG::D3D11SamplerHandler::TranslateFilter(const Filter & filter)
@@ -3,6 +3,7 @@
 #include <d3d11_4.h>
 
 #include "SGGraphicsHandler.h"
+#include "SGDedupTable.h"
 
 #include "D3D11CommonTypes.h"
 #include "D3D11SamplerData.h"
@@ -78,6 +79,7 @@ namespace SG
 		friend class D3D11RenderEngine;
 
 		FrameMap<SGGuid, D3D11SamplerData> samplers;
+		SGDedupTable<D3D11SamplerData> samplerTable; // Keyed by the description, guids with the same description share one sampler
 
 		ID3D11Device* device;
 
@@ -44,3 +44,37 @@ const SG::D3D11ShaderData& SG::D3D11ShaderData::operator=(D3D11ShaderData&& othe
 
 	return *this;
 }
+
+SG::D3D11ShaderData SG::D3D11ShaderData::Share() const
+{
+	D3D11ShaderData toReturn;
+	toReturn.type = type;
+	toReturn.shader = shader;
+
+	if (shader.vertex != nullptr) // Since only ptrs it does not matter which is used here
+	{
+		switch (type)
+		{
+		case ShaderType::VERTEX_SHADER:
+			shader.vertex->AddRef();
+			break;
+		case ShaderType::HULL_SHADER:
+			shader.hull->AddRef();
+			break;
+		case ShaderType::DOMAIN_SHADER:
+			shader.domain->AddRef();
+			break;
+		case ShaderType::GEOMETRY_SHADER:
+			shader.geometry->AddRef();
+			break;
+		case ShaderType::PIXEL_SHADER:
+			shader.pixel->AddRef();
+			break;
+		case ShaderType::COMPUTE_SHADER:
+			shader.compute->AddRef();
+			break;
+		}
+	}
+
+	return toReturn;
+}
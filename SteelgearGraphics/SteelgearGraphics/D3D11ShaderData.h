@@ -32,5 +32,7 @@ namespace SG
 
 		D3D11ShaderData(D3D11ShaderData&& other);
 		const D3D11ShaderData& operator=(D3D11ShaderData&& other);
+
+		D3D11ShaderData Share() const; // Another owner of the same shader
 	};
 }
\ No newline at end of file
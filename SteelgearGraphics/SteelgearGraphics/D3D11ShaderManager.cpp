@@ -1,12 +1,27 @@
 #include "D3D11ShaderManager.h"
+#include "D3D11Capture.h"
+#include "SGAssetPackWriter.h"
 
-SG::D3D11ShaderManager::D3D11ShaderManager(ID3D11Device * device)
+#include <cstring>
+
+SG::D3D11ShaderManager::D3D11ShaderManager(ID3D11Device * device, SGLoadQueue* loadQueue)
 {
 	this->device = device;
+	this->loadQueue = loadQueue;
 }
 
 SG::SGResult SG::D3D11ShaderManager::CreateInputLayout(const SGGuid& guid, const std::vector<SGInputElement>& inputElements, const void* shaderByteCode, UINT byteCodeLength)
 {
+	SGCaptureScope capture(SGCaptureCall::CREATE_INPUT_LAYOUT, guid, inputElements, SGCaptureBytes{ shaderByteCode, byteCodeLength }, byteCodeLength);
+	std::vector<unsigned char> content = GetInputLayoutContent(inputElements, shaderByteCode, byteCodeLength);
+	D3D11InputLayoutData shared;
+
+	if (inputLayoutTable.Acquire(guid, content.data(), content.size(), shared))
+	{
+		inputLayouts.AddElement(guid, std::move(shared));
+		return SGResult::OK;
+	}
+
 	std::vector<D3D11_INPUT_ELEMENT_DESC> d3d11InputElements;
 	d3d11InputElements.reserve(inputElements.size());
 
@@ -24,183 +39,420 @@ SG::SGResult SG::D3D11ShaderManager::CreateInputLayout(const SGGuid& guid, const
 	}
 
 	D3D11InputLayoutData toStore;
-	device->CreateInputLayout(&d3d11InputElements[0], static_cast<UINT>(d3d11InputElements.size()), shaderByteCode, byteCodeLength, &toStore.inputLayout);
-	inputLayouts.AddElement(guid, std::move(toStore));
+
+	if (FAILED(device->CreateInputLayout(d3d11InputElements.data(), static_cast<UINT>(d3d11InputElements.size()), shaderByteCode, byteCodeLength, &toStore.inputLayout)))
+		return SGResult::FAIL;
+
+	inputLayoutTable.Insert(guid, content.data(), content.size(), std::move(toStore), shared);
+	inputLayouts.AddElement(guid, std::move(shared));
 
 	return SGResult::OK;
 }
 
 void SG::D3D11ShaderManager::RemoveInputLayout(const SGGuid& guid)
 {
+	SGCaptureScope capture(SGCaptureCall::REMOVE_INPUT_LAYOUT, guid);
 	inputLayouts.RemoveElement(guid);
+	inputLayoutTable.Release(guid);
 }
 
 SG::SGResult SG::D3D11ShaderManager::CreateVertexShader(const SGGuid & guid, const void * shaderByteCode, SIZE_T byteCodeLength)
 {
-	ID3D11VertexShader* vs;
+	SGCaptureScope capture(SGCaptureCall::CREATE_VERTEX_SHADER, guid, SGCaptureBytes{ shaderByteCode, byteCodeLength }, byteCodeLength);
+	return StoreShader(guid, ShaderType::VERTEX_SHADER, shaderByteCode, byteCodeLength);
+}
 
-	if (FAILED(device->CreateVertexShader(shaderByteCode, byteCodeLength, nullptr, &vs)))
-		return SGResult::FAIL;
+SG::SGResult SG::D3D11ShaderManager::CreateHullShader(const SGGuid& guid, const void* shaderByteCode, SIZE_T byteCodeLength)
+{
+	SGCaptureScope capture(SGCaptureCall::CREATE_HULL_SHADER, guid, SGCaptureBytes{ shaderByteCode, byteCodeLength }, byteCodeLength);
+	return StoreShader(guid, ShaderType::HULL_SHADER, shaderByteCode, byteCodeLength);
+}
 
-	D3D11ShaderData toStore;
-	toStore.type = ShaderType::VERTEX_SHADER;
-	toStore.shader.vertex = vs;
-	shaders.AddElement(guid, std::move(toStore));
+SG::SGResult SG::D3D11ShaderManager::CreateDomainShader(const SGGuid& guid, const void* shaderByteCode, SIZE_T byteCodeLength)
+{
+	SGCaptureScope capture(SGCaptureCall::CREATE_DOMAIN_SHADER, guid, SGCaptureBytes{ shaderByteCode, byteCodeLength }, byteCodeLength);
+	return StoreShader(guid, ShaderType::DOMAIN_SHADER, shaderByteCode, byteCodeLength);
+}
 
-	return SGResult::OK;
+SG::SGResult SG::D3D11ShaderManager::CreateGeometryShader(const SGGuid& guid, const void* shaderByteCode, SIZE_T byteCodeLength)
+{
+	SGCaptureScope capture(SGCaptureCall::CREATE_GEOMETRY_SHADER, guid, SGCaptureBytes{ shaderByteCode, byteCodeLength }, byteCodeLength);
+	return StoreShader(guid, ShaderType::GEOMETRY_SHADER, shaderByteCode, byteCodeLength);
 }
 
-SG::SGResult SG::D3D11ShaderManager::CreateHullShader(const SGGuid& guid, const void* shaderByteCode, SIZE_T byteCodeLength)
+SG::SGResult SG::D3D11ShaderManager::CreatePixelShader(const SGGuid & guid, const void * shaderByteCode, SIZE_T byteCodeLength)
 {
-	ID3D11HullShader* hs;
+	SGCaptureScope capture(SGCaptureCall::CREATE_PIXEL_SHADER, guid, SGCaptureBytes{ shaderByteCode, byteCodeLength }, byteCodeLength);
+	return StoreShader(guid, ShaderType::PIXEL_SHADER, shaderByteCode, byteCodeLength);
+}
 
-	if (FAILED(device->CreateHullShader(shaderByteCode, byteCodeLength, nullptr, &hs)))
-		return SGResult::FAIL;
+SG::SGResult SG::D3D11ShaderManager::CreateComputeShader(const SGGuid & guid, const void * shaderByteCode, SIZE_T byteCodeLength)
+{
+	SGCaptureScope capture(SGCaptureCall::CREATE_COMPUTE_SHADER, guid, SGCaptureBytes{ shaderByteCode, byteCodeLength }, byteCodeLength);
+	return StoreShader(guid, ShaderType::COMPUTE_SHADER, shaderByteCode, byteCodeLength);
+}
 
-	D3D11ShaderData toStore;
-	toStore.type = ShaderType::HULL_SHADER;
-	toStore.shader.hull = hs;
-	shaders.AddElement(guid, std::move(toStore));
+SG::SGResult SG::D3D11ShaderManager::CreateShaderAsync(const SGGuid & guid, ShaderType type, const void * shaderByteCode, SIZE_T byteCodeLength,
+	const SGLoadCallback & onComplete)
+{
+	loadQueue->Enqueue(guid, byteCodeLength, [=]()
+	{
+		switch (type)
+		{
+		case ShaderType::VERTEX_SHADER:
+			return CreateVertexShader(guid, shaderByteCode, byteCodeLength);
+		case ShaderType::HULL_SHADER:
+			return CreateHullShader(guid, shaderByteCode, byteCodeLength);
+		case ShaderType::DOMAIN_SHADER:
+			return CreateDomainShader(guid, shaderByteCode, byteCodeLength);
+		case ShaderType::GEOMETRY_SHADER:
+			return CreateGeometryShader(guid, shaderByteCode, byteCodeLength);
+		case ShaderType::PIXEL_SHADER:
+			return CreatePixelShader(guid, shaderByteCode, byteCodeLength);
+		case ShaderType::COMPUTE_SHADER:
+			return CreateComputeShader(guid, shaderByteCode, byteCodeLength);
+		default:
+			return SGResult::FAIL;
+		}
+	}, onComplete);
 
 	return SGResult::OK;
 }
 
-SG::SGResult SG::D3D11ShaderManager::CreateDomainShader(const SGGuid& guid, const void* shaderByteCode, SIZE_T byteCodeLength)
+void SG::D3D11ShaderManager::RemoveShader(const SGGuid& guid)
 {
-	ID3D11DomainShader* ds;
+	SGCaptureScope capture(SGCaptureCall::REMOVE_SHADER, guid);
+	shaders.RemoveElement(guid);
+	shaderTable.Release(guid);
+}
 
-	if (FAILED(device->CreateDomainShader(shaderByteCode, byteCodeLength, nullptr, &ds)))
+SG::SGResult SG::D3D11ShaderManager::LoadShaderCache(const std::string & path)
+{
+	SGTraceScope scope("D3D11ShaderManager::LoadShaderCache");
+
+	if (shaderCache.Open(path) != SGResult::OK)
 		return SGResult::FAIL;
 
-	D3D11ShaderData toStore;
-	toStore.type = ShaderType::DOMAIN_SHADER;
-	toStore.shader.domain = ds;
-	shaders.AddElement(guid, std::move(toStore));
+	SGPackedShader packed;
+
+	for (auto& name : shaderCache.GetAssetNames())
+	{
+		if (shaderCache.GetShader(name, packed) != SGResult::OK)
+			continue;
+
+		ShaderType type = static_cast<ShaderType>(packed.type);
+		const void* byteCode = packed.byteCode;
+		SIZE_T byteCodeLength = packed.byteCodeLength;
+
+		loadQueue->Enqueue(name, byteCodeLength, [=]()
+		{
+			return PrecreateShader(type, byteCode, byteCodeLength);
+		});
+	}
 
 	return SGResult::OK;
 }
 
-SG::SGResult SG::D3D11ShaderManager::CreateGeometryShader(const SGGuid& guid, const void* shaderByteCode, SIZE_T byteCodeLength)
+SG::SGResult SG::D3D11ShaderManager::SaveShaderCache(const std::string & path)
 {
-	ID3D11GeometryShader* gs;
+	std::vector<std::pair<ShaderType, std::vector<unsigned char>>> toSave;
+	shaderTable.ForEach([&toSave](const std::vector<unsigned char>& content, const D3D11ShaderData& shader)
+	{
+		toSave.push_back({ shader.type, content });
+	});
 
-	if (FAILED(device->CreateGeometryShader(shaderByteCode, byteCodeLength, nullptr, &gs)))
-		return SGResult::FAIL;
+	// The names only have to be unique, the byte code is hashed again when the cache is loaded
+	SGAssetPackWriter writer;
 
-	D3D11ShaderData toStore;
-	toStore.type = ShaderType::GEOMETRY_SHADER;
-	toStore.shader.geometry = gs;
-	shaders.AddElement(guid, std::move(toStore));
+	for (size_t i = 0; i < toSave.size(); ++i)
+		writer.AddShader("SHADER_CACHE_" + std::to_string(i), { static_cast<unsigned int>(toSave[i].first), toSave[i].second.data(), toSave[i].second.size() });
 
-	return SGResult::OK;
+	return writer.Write(path);
 }
 
-SG::SGResult SG::D3D11ShaderManager::CreatePixelShader(const SGGuid & guid, const void * shaderByteCode, SIZE_T byteCodeLength)
+void SG::D3D11ShaderManager::TrimShaderCache()
 {
-	ID3D11PixelShader* ps;
+	shaderTable.Trim();
+}
 
-	if (FAILED(device->CreatePixelShader(shaderByteCode, byteCodeLength, nullptr, &ps)))
-		return SGResult::FAIL;
+void SG::D3D11ShaderManager::FinishFrame()
+{
+	SGTraceScope scope("D3D11ShaderManager::FinishFrame");
 
-	D3D11ShaderData toStore;
-	toStore.type = ShaderType::PIXEL_SHADER;
-	toStore.shader.pixel = ps;
-	shaders.AddElement(guid, std::move(toStore));
+	inputLayouts.FinishFrame();
+	shaders.FinishFrame();
+}
 
-	return SGResult::OK;
+void SG::D3D11ShaderManager::SwapFrame()
+{
+	SGTraceScope scope("D3D11ShaderManager::SwapFrame");
+
+	size_t nrOfOperations = inputLayouts.UpdateActive();
+	nrOfOperations += shaders.UpdateActive();
+	SGProfiler::Count(SGCounter::FRAME_MAP_OPERATIONS, nrOfOperations);
 }
 
-SG::SGResult SG::D3D11ShaderManager::CreateComputeShader(const SGGuid & guid, const void * shaderByteCode, SIZE_T byteCodeLength)
+SG::SGResult SG::D3D11ShaderManager::StoreShader(const SGGuid & guid, ShaderType type, const void * shaderByteCode, SIZE_T byteCodeLength)
 {
-	ID3D11ComputeShader* cs;
+	D3D11ShaderData shared;
+
+	if (!shaderTable.Acquire(guid, shaderByteCode, byteCodeLength, shared))
+	{
+		D3D11ShaderData toStore;
 
-	if (FAILED(device->CreateComputeShader(shaderByteCode, byteCodeLength, nullptr, &cs)))
+		if (CreateShaderObject(type, shaderByteCode, byteCodeLength, toStore) != SGResult::OK)
+			return SGResult::FAIL;
+
+		shaderTable.Insert(guid, shaderByteCode, byteCodeLength, std::move(toStore), shared);
+	}
+
+	// The byte code decides the stage, so the same byte code cannot be a valid shader for another stage
+	if (shared.type != type)
+	{
+		shaderTable.Release(guid);
 		return SGResult::FAIL;
+	}
+
+	shaders.AddElement(guid, std::move(shared));
+	return SGResult::OK;
+}
+
+SG::SGResult SG::D3D11ShaderManager::PrecreateShader(ShaderType type, const void * shaderByteCode, SIZE_T byteCodeLength)
+{
+	if (shaderTable.Contains(shaderByteCode, byteCodeLength))
+		return SGResult::OK;
 
 	D3D11ShaderData toStore;
-	toStore.type = ShaderType::COMPUTE_SHADER;
-	toStore.shader.compute = cs;
-	shaders.AddElement(guid, std::move(toStore));
+	D3D11ShaderData shared;
+
+	if (CreateShaderObject(type, shaderByteCode, byteCodeLength, toStore) != SGResult::OK)
+		return SGResult::FAIL;
 
+	shaderTable.Insert(SGGuid(), shaderByteCode, byteCodeLength, std::move(toStore), shared);
 	return SGResult::OK;
 }
 
-void SG::D3D11ShaderManager::RemoveShader(const SGGuid& guid)
+SG::SGResult SG::D3D11ShaderManager::CreateShaderObject(ShaderType type, const void * shaderByteCode, SIZE_T byteCodeLength, D3D11ShaderData & shader)
 {
-	shaders.RemoveElement(guid);
+	HRESULT hr = E_FAIL;
+	shader.type = type;
+	shader.shader.vertex = nullptr;
+
+	switch (type)
+	{
+	case ShaderType::VERTEX_SHADER:
+		hr = device->CreateVertexShader(shaderByteCode, byteCodeLength, nullptr, &shader.shader.vertex);
+		break;
+	case ShaderType::HULL_SHADER:
+		hr = device->CreateHullShader(shaderByteCode, byteCodeLength, nullptr, &shader.shader.hull);
+		break;
+	case ShaderType::DOMAIN_SHADER:
+		hr = device->CreateDomainShader(shaderByteCode, byteCodeLength, nullptr, &shader.shader.domain);
+		break;
+	case ShaderType::GEOMETRY_SHADER:
+		hr = device->CreateGeometryShader(shaderByteCode, byteCodeLength, nullptr, &shader.shader.geometry);
+		break;
+	case ShaderType::PIXEL_SHADER:
+		hr = device->CreatePixelShader(shaderByteCode, byteCodeLength, nullptr, &shader.shader.pixel);
+		break;
+	case ShaderType::COMPUTE_SHADER:
+		hr = device->CreateComputeShader(shaderByteCode, byteCodeLength, nullptr, &shader.shader.compute);
+		break;
+	}
+
+	if (FAILED(hr))
+	{
+		shader.shader.vertex = nullptr;
+		return SGResult::FAIL;
+	}
+
+	return SGResult::OK;
 }
 
-void SG::D3D11ShaderManager::FinishFrame()
+std::vector<unsigned char> SG::D3D11ShaderManager::GetInputLayoutContent(const std::vector<SGInputElement>& inputElements, const void * shaderByteCode, UINT byteCodeLength)
 {
-	inputLayouts.FinishFrame();
-	shaders.FinishFrame();
+	std::vector<unsigned char> toReturn;
+	auto append = [&toReturn](UINT value)
+	{
+		// Byte by byte so the content is the same whatever the byte order of the platform
+		for (int i = 0; i < 4; ++i)
+			toReturn.push_back(static_cast<unsigned char>(value >> (i * 8)));
+	};
+
+	for (auto& element : inputElements)
+	{
+		toReturn.insert(toReturn.end(), element.semanticName.begin(), element.semanticName.end());
+		toReturn.push_back(0);
+		append(element.semanticIndex);
+		append(static_cast<UINT>(element.format));
+		append(element.inputSlot);
+		append(element.alignedByteOffset);
+		append(element.instancedData ? 1 : 0);
+		append(element.instanceDataStepRate);
+	}
+
+	// The layout only depends on the input signature of the byte code, so shaders with the same inputs share layouts
+	const unsigned char* signature = static_cast<const unsigned char*>(shaderByteCode);
+	UINT signatureLength = byteCodeLength;
+	GetInputSignature(shaderByteCode, byteCodeLength, signature, signatureLength);
+	toReturn.insert(toReturn.end(), signature, signature + signatureLength);
+
+	return toReturn;
 }
 
-void SG::D3D11ShaderManager::SwapFrame()
+bool SG::D3D11ShaderManager::GetInputSignature(const void * shaderByteCode, UINT byteCodeLength, const unsigned char *& signature, UINT & signatureLength)
 {
-	inputLayouts.UpdateActive();
-	shaders.UpdateActive();
+	// The container is the magic, a checksum, a version, the total size, the number of chunks and the offset of each chunk
+	const unsigned char* bytes = static_cast<const unsigned char*>(shaderByteCode);
+	auto read = [bytes](UINT offset)
+	{
+		return static_cast<UINT>(bytes[offset]) | static_cast<UINT>(bytes[offset + 1]) << 8 |
+			static_cast<UINT>(bytes[offset + 2]) << 16 | static_cast<UINT>(bytes[offset + 3]) << 24;
+	};
+
+	if (byteCodeLength < 32 || std::memcmp(bytes, "DXBC", 4) != 0)
+		return false;
+
+	UINT nrOfChunks = read(28);
+
+	if (nrOfChunks > (byteCodeLength - 32) / 4)
+		return false;
+
+	for (UINT i = 0; i < nrOfChunks; ++i)
+	{
+		UINT offset = read(32 + i * 4);
+
+		if (offset > byteCodeLength - 8)
+			return false;
+
+		UINT chunkLength = read(offset + 4);
+
+		if (chunkLength > byteCodeLength - offset - 8)
+			return false;
+
+		if (std::memcmp(bytes + offset, "ISGN", 4) == 0 || std::memcmp(bytes + offset, "ISG1", 4) == 0)
+		{
+			signature = bytes + offset;
+			signatureLength = chunkLength + 8;
+			return true;
+		}
+	}
+
+	return false;
 }
 
-void SG::D3D11ShaderManager::SetInputLayout(const SGGuid & guid, ID3D11DeviceContext * context)
+void SG::D3D11ShaderManager::SetInputLayout(const SGGuid & guid, ID3D11InputLayout*& currentLayout, ID3D11DeviceContext * context)
 {
 	if constexpr (DEBUG_VERSION)
 		if (!inputLayouts.HasElement(guid))
 			throw std::runtime_error("Error setting input layout, guid not found");
 
-	context->IASetInputLayout(inputLayouts[guid].inputLayout);
+	ID3D11InputLayout* inputLayout = inputLayouts[guid].inputLayout;
+
+	if (inputLayout != currentLayout)
+	{
+		SGProfiler::Count(SGCounter::INPUT_ASSEMBLER_CHANGES);
+		context->IASetInputLayout(inputLayout);
+		currentLayout = inputLayout;
+	}
 }
 
-void SG::D3D11ShaderManager::SetVertexShader(const SGGuid & guid, ID3D11DeviceContext * context)
+void SG::D3D11ShaderManager::SetVertexShader(const SGGuid & guid, ID3D11VertexShader*& currentShader, ID3D11DeviceContext * context)
 {
 	if constexpr (DEBUG_VERSION)
 		if (!shaders.HasElement(guid))
 			throw std::runtime_error("Error setting vertex shader, guid not found");
 
-	context->VSSetShader(shaders[guid].shader.vertex, nullptr, 0);
+	ID3D11VertexShader* shader = shaders[guid].shader.vertex;
+
+	if (shader != currentShader)
+	{
+		SGProfiler::Count(SGCounter::SHADER_CHANGES);
+		context->VSSetShader(shader, nullptr, 0);
+		currentShader = shader;
+	}
 }
 
-void SG::D3D11ShaderManager::SetHullShader(const SGGuid& guid, ID3D11DeviceContext* context)
+void SG::D3D11ShaderManager::SetHullShader(const SGGuid & guid, ID3D11HullShader*& currentShader, ID3D11DeviceContext * context)
 {
 	if constexpr (DEBUG_VERSION)
-		if (!shaders.HasElement(guid))
+		if (guid != SGGuid() && !shaders.HasElement(guid))
 			throw std::runtime_error("Error setting hull shader, guid not found");
 
-	context->HSSetShader(shaders[guid].shader.hull, nullptr, 0);
+	// Stages without a shader are unbound so nothing is left over from an earlier job on the same context
+	ID3D11HullShader* shader = guid != SGGuid() ? shaders[guid].shader.hull : nullptr;
+
+	if (shader != currentShader)
+	{
+		SGProfiler::Count(SGCounter::SHADER_CHANGES);
+		context->HSSetShader(shader, nullptr, 0);
+		currentShader = shader;
+	}
 }
 
-void SG::D3D11ShaderManager::SetDomainShader(const SGGuid& guid, ID3D11DeviceContext* context)
+void SG::D3D11ShaderManager::SetDomainShader(const SGGuid & guid, ID3D11DomainShader*& currentShader, ID3D11DeviceContext * context)
 {
 	if constexpr (DEBUG_VERSION)
-		if (!shaders.HasElement(guid))
+		if (guid != SGGuid() && !shaders.HasElement(guid))
 			throw std::runtime_error("Error setting domain shader, guid not found");
 
-	context->DSSetShader(shaders[guid].shader.domain, nullptr, 0);
+	// Stages without a shader are unbound so nothing is left over from an earlier job on the same context
+	ID3D11DomainShader* shader = guid != SGGuid() ? shaders[guid].shader.domain : nullptr;
+
+	if (shader != currentShader)
+	{
+		SGProfiler::Count(SGCounter::SHADER_CHANGES);
+		context->DSSetShader(shader, nullptr, 0);
+		currentShader = shader;
+	}
 }
 
-void SG::D3D11ShaderManager::SetGeometryShader(const SGGuid& guid, ID3D11DeviceContext* context)
+void SG::D3D11ShaderManager::SetGeometryShader(const SGGuid & guid, ID3D11GeometryShader*& currentShader, ID3D11DeviceContext * context)
 {
 	if constexpr (DEBUG_VERSION)
-		if (!shaders.HasElement(guid))
+		if (guid != SGGuid() && !shaders.HasElement(guid))
 			throw std::runtime_error("Error setting geometry shader, guid not found");
 
-	context->GSSetShader(shaders[guid].shader.geometry, nullptr, 0);
+	// Stages without a shader are unbound so nothing is left over from an earlier job on the same context
+	ID3D11GeometryShader* shader = guid != SGGuid() ? shaders[guid].shader.geometry : nullptr;
+
+	if (shader != currentShader)
+	{
+		SGProfiler::Count(SGCounter::SHADER_CHANGES);
+		context->GSSetShader(shader, nullptr, 0);
+		currentShader = shader;
+	}
 }
 
-void SG::D3D11ShaderManager::SetPixelShader(const SGGuid & guid, ID3D11DeviceContext * context)
+void SG::D3D11ShaderManager::SetPixelShader(const SGGuid & guid, ID3D11PixelShader*& currentShader, ID3D11DeviceContext * context)
 {
 	if constexpr (DEBUG_VERSION)
-		if (!shaders.HasElement(guid))
+		if (guid != SGGuid() && !shaders.HasElement(guid))
 			throw std::runtime_error("Error setting pixel shader, guid not found");
 
-	context->PSSetShader(shaders[guid].shader.pixel, nullptr, 0);
+	// Stages without a shader are unbound so nothing is left over from an earlier job on the same context
+	ID3D11PixelShader* shader = guid != SGGuid() ? shaders[guid].shader.pixel : nullptr;
+
+	if (shader != currentShader)
+	{
+		SGProfiler::Count(SGCounter::SHADER_CHANGES);
+		context->PSSetShader(shader, nullptr, 0);
+		currentShader = shader;
+	}
 }
 
-void SG::D3D11ShaderManager::SetComputeShader(const SGGuid & guid, ID3D11DeviceContext * context)
+void SG::D3D11ShaderManager::SetComputeShader(const SGGuid & guid, ID3D11ComputeShader*& currentShader, ID3D11DeviceContext * context)
 {
 	if constexpr (DEBUG_VERSION)
 		if (!shaders.HasElement(guid))
 			throw std::runtime_error("Error setting compute shader, guid not found");
 
-	context->CSSetShader(shaders[guid].shader.compute, nullptr, 0);
+	ID3D11ComputeShader* shader = shaders[guid].shader.compute;
+
+	if (shader != currentShader)
+	{
+		SGProfiler::Count(SGCounter::SHADER_CHANGES);
+		context->CSSetShader(shader, nullptr, 0);
+		currentShader = shader;
+	}
 }
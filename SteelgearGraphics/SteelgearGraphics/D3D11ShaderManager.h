@@ -7,6 +7,8 @@
 #include "SGRenderEngine.h"
 #include "SGGuid.h"
 #include "FrameMap.h"
+#include "SGDedupTable.h"
+#include "SGAssetPack.h"
 
 #include "D3D11CommonTypes.h"
 #include "D3D11InputLayoutData.h"
@@ -29,7 +31,7 @@ namespace SG
 	{
 	public:
 
-		D3D11ShaderManager(ID3D11Device* device);
+		D3D11ShaderManager(ID3D11Device* device, SGLoadQueue* loadQueue);
 		~D3D11ShaderManager() = default;
 
 		SGResult CreateInputLayout(const SGGuid& guid, const std::vector<SGInputElement>& inputElements, const void* shaderByteCode, UINT byteCodeLength);
@@ -41,27 +43,46 @@ namespace SG
 		SGResult CreateGeometryShader(const SGGuid& guid, const void* shaderByteCode, SIZE_T byteCodeLength);
 		SGResult CreatePixelShader(const SGGuid& guid, const void* shaderByteCode, SIZE_T byteCodeLength);
 		SGResult CreateComputeShader(const SGGuid& guid, const void* shaderByteCode, SIZE_T byteCodeLength);
+		SGResult CreateShaderAsync(const SGGuid& guid, ShaderType type, const void* shaderByteCode, SIZE_T byteCodeLength,
+			const SGLoadCallback& onComplete = nullptr); // Created on a loader thread, the byte code has to stay valid until onComplete is called
 		void RemoveShader(const SGGuid& guid);
 
+		/** Shaders and input layouts created from identical content share one object, whatever guid they are created with.
+		The shader cache is a pack of the distinct byte code created so far, loading one creates its shaders on the loader
+		threads without any guid, so creating them later only has to find them. The pack stays open for that */
+		SGResult LoadShaderCache(const std::string& path);
+		SGResult SaveShaderCache(const std::string& path);
+		void TrimShaderCache(); // Destroys the cached shaders no guid was created from
+
 	private:
 
 		friend class D3D11RenderEngine;
 
 		FrameMap<SGGuid, D3D11InputLayoutData> inputLayouts;
 		FrameMap<SGGuid, D3D11ShaderData> shaders;
+		SGDedupTable<D3D11InputLayoutData> inputLayoutTable;
+		SGDedupTable<D3D11ShaderData> shaderTable;
+		SGAssetPack shaderCache;
 
 		ID3D11Device* device;
+		SGLoadQueue* loadQueue;
 
 		void FinishFrame();
 		void SwapFrame();
 
-		void SetInputLayout(const SGGuid& guid, ID3D11DeviceContext* context);
-		void SetVertexShader(const SGGuid& guid, ID3D11DeviceContext* context);
-		void SetHullShader(const SGGuid& guid, ID3D11DeviceContext* context);
-		void SetDomainShader(const SGGuid& guid, ID3D11DeviceContext* context);
-		void SetGeometryShader(const SGGuid& guid, ID3D11DeviceContext* context);
-		void SetPixelShader(const SGGuid& guid, ID3D11DeviceContext* context);
-		void SetComputeShader(const SGGuid& guid, ID3D11DeviceContext* context);
+		SGResult StoreShader(const SGGuid& guid, ShaderType type, const void* shaderByteCode, SIZE_T byteCodeLength);
+		SGResult PrecreateShader(ShaderType type, const void* shaderByteCode, SIZE_T byteCodeLength);
+		SGResult CreateShaderObject(ShaderType type, const void* shaderByteCode, SIZE_T byteCodeLength, D3D11ShaderData& shader);
+		std::vector<unsigned char> GetInputLayoutContent(const std::vector<SGInputElement>& inputElements, const void* shaderByteCode, UINT byteCodeLength);
+		bool GetInputSignature(const void* shaderByteCode, UINT byteCodeLength, const unsigned char*& signature, UINT& signatureLength);
+
+		void SetInputLayout(const SGGuid& guid, ID3D11InputLayout*& currentLayout, ID3D11DeviceContext* context);
+		void SetVertexShader(const SGGuid& guid, ID3D11VertexShader*& currentShader, ID3D11DeviceContext* context);
+		void SetHullShader(const SGGuid& guid, ID3D11HullShader*& currentShader, ID3D11DeviceContext* context);
+		void SetDomainShader(const SGGuid& guid, ID3D11DomainShader*& currentShader, ID3D11DeviceContext* context);
+		void SetGeometryShader(const SGGuid& guid, ID3D11GeometryShader*& currentShader, ID3D11DeviceContext* context);
+		void SetPixelShader(const SGGuid& guid, ID3D11PixelShader*& currentShader, ID3D11DeviceContext* context);
+		void SetComputeShader(const SGGuid& guid, ID3D11ComputeShader*& currentShader, ID3D11DeviceContext* context);
 
 	};
 }
\ No newline at end of file
@@ -0,0 +1,38 @@
+#include "D3D11StateBlockData.h"
+
+#include <cstring>
+#include <functional>
+
+bool SG::D3D11StateBlockData::SameContent(const D3D11StateBlockData & other) const
+{
+	return rasterizerState == other.rasterizerState && blendState == other.blendState && depthStencilState == other.depthStencilState &&
+		std::memcmp(blendFactor, other.blendFactor, sizeof(blendFactor)) == 0 && sampleMask == other.sampleMask &&
+		stencilRef == other.stencilRef && topology == other.topology && inputLayout == other.inputLayout &&
+		vertexShader == other.vertexShader && hullShader == other.hullShader && domainShader == other.domainShader &&
+		geometryShader == other.geometryShader && pixelShader == other.pixelShader;
+}
+
+size_t SG::D3D11StateBlockData::HashContent() const
+{
+	size_t toReturn = 0;
+	auto combine = [&toReturn](size_t value)
+	{
+		toReturn ^= value + 0x9e3779b9 + (toReturn << 6) + (toReturn >> 2);
+	};
+
+	for (const SGGuid* guid : { &rasterizerState, &blendState, &depthStencilState, &inputLayout,
+		&vertexShader, &hullShader, &domainShader, &geometryShader, &pixelShader })
+		combine(guid->GetID());
+
+	UINT factorBits[4];
+	std::memcpy(factorBits, blendFactor, sizeof(blendFactor));
+
+	for (UINT bits : factorBits)
+		combine(bits);
+
+	combine(sampleMask);
+	combine(stencilRef);
+	combine(static_cast<size_t>(topology));
+
+	return toReturn;
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <d3d11_4.h>
+
+#include "SGGuid.h"
+
+namespace SG
+{
+	struct D3D11StateBlockData
+	{
+		SGGuid rasterizerState;
+		SGGuid blendState;
+		SGGuid depthStencilState;
+		FLOAT blendFactor[4];
+		UINT sampleMask;
+		UINT stencilRef;
+		D3D11_PRIMITIVE_TOPOLOGY topology;
+		SGGuid inputLayout;
+		SGGuid vertexShader;
+		SGGuid hullShader;
+		SGGuid domainShader;
+		SGGuid geometryShader;
+		SGGuid pixelShader;
+		size_t id = 0; // Shared by all blocks with the same content, 0 is never used
+
+		D3D11StateBlockData() = default;
+		~D3D11StateBlockData() = default;
+
+		D3D11StateBlockData(const D3D11StateBlockData& other) = default;
+		D3D11StateBlockData& operator=(const D3D11StateBlockData& other) = default;
+		D3D11StateBlockData(D3D11StateBlockData&& other) = default;
+		D3D11StateBlockData& operator=(D3D11StateBlockData&& other) = default;
+
+		bool SameContent(const D3D11StateBlockData& other) const;
+		size_t HashContent() const;
+	};
+}
@@ -35,3 +35,28 @@ SG::D3D11StateData& SG::D3D11StateData::operator=(D3D11StateData&& other)
 
 	return *this;
 }
+
+SG::D3D11StateData SG::D3D11StateData::Share() const
+{
+	D3D11StateData toReturn;
+	toReturn.type = type;
+	toReturn.state = state;
+
+	if (state.rasterizer != nullptr) // Since only ptrs it does not matter which is used here
+	{
+		switch (type)
+		{
+		case StateType::RASTERIZER:
+			state.rasterizer->AddRef();
+			break;
+		case StateType::DEPTH_STENCIL:
+			state.depthStencil->AddRef();
+			break;
+		case StateType::BLEND:
+			state.blend->AddRef();
+			break;
+		}
+	}
+
+	return toReturn;
+}
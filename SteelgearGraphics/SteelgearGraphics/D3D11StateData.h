@@ -26,5 +26,7 @@ namespace SG
 
 		D3D11StateData(D3D11StateData&& other);
 		D3D11StateData& operator=(D3D11StateData&& other);
+
+		D3D11StateData Share() const; // Another owner of the same state
 	};
 }
\ No newline at end of file
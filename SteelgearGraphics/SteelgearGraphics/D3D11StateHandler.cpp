@@ -1,4 +1,5 @@
 #include "D3D11StateHandler.h"
+#include "D3D11Capture.h"
 
 SG::D3D11StateHandler::D3D11StateHandler(ID3D11Device * device)
 {
@@ -7,7 +8,9 @@ SG::D3D11StateHandler::D3D11StateHandler(ID3D11Device * device)
 
 SG::SGResult SG::D3D11StateHandler::CreateRasterizerState(const SGGuid & guid, FillMode fill, CullMode cull, BOOL frontCounterClockwise, INT depthBias, FLOAT depthBiasClamp, FLOAT slopeScaledDepthBias, BOOL depthClipEnable, BOOL scissorEnable, BOOL multisampleEnable, BOOL antialiasedEnable)
 {
+	SGCaptureScope capture(SGCaptureCall::CREATE_RASTERIZER_STATE, guid, fill, cull, frontCounterClockwise, depthBias, depthBiasClamp, slopeScaledDepthBias, depthClipEnable, scissorEnable, multisampleEnable, antialiasedEnable);
 	D3D11_RASTERIZER_DESC desc;
+	ZeroMemory(&desc, sizeof(desc));
 	desc.FillMode = fill == FillMode::SOLID ? D3D11_FILL_SOLID : D3D11_FILL_WIREFRAME;
 	
 	switch (cull)
@@ -34,23 +37,124 @@ SG::SGResult SG::D3D11StateHandler::CreateRasterizerState(const SGGuid & guid, F
 	desc.MultisampleEnable = multisampleEnable;
 	desc.AntialiasedLineEnable = antialiasedEnable;
 
-	D3D11StateData toStore;
-	toStore.type = StateType::RASTERIZER;
-	if (FAILED(device->CreateRasterizerState(&desc, &toStore.state.rasterizer)))
+	return StoreState(guid, StateType::RASTERIZER, &desc, sizeof(desc));
+}
+
+SG::SGResult SG::D3D11StateHandler::CreateDepthStencilState(const SGGuid & guid, BOOL depthEnable, DepthWriteMask mask, ComparisonFunction depthFunc, BOOL stencilEnable, UINT8 stencilReadMask, UINT8 stencilWriteMask, DepthStencilOp frontFaceStencilFailOp, DepthStencilOp frontFaceStencilDepthFailOp, DepthStencilOp frontFaceStencilPassOp, ComparisonFunction frontFaceStencilFunc, DepthStencilOp backFaceStencilFailOp, DepthStencilOp backFaceStencilDepthFailOp, DepthStencilOp backFaceStencilPassOp, ComparisonFunction backFaceStencilFunc)
+{
+	SGCaptureScope capture(SGCaptureCall::CREATE_DEPTH_STENCIL_STATE, guid, depthEnable, mask, depthFunc, stencilEnable, stencilReadMask, stencilWriteMask, frontFaceStencilFailOp, frontFaceStencilDepthFailOp, frontFaceStencilPassOp, frontFaceStencilFunc, backFaceStencilFailOp, backFaceStencilDepthFailOp, backFaceStencilPassOp, backFaceStencilFunc);
+	D3D11_DEPTH_STENCIL_DESC desc;
+	ZeroMemory(&desc, sizeof(desc)); // The padding is part of the content the state is shared by
+	desc.DepthEnable = depthEnable;
+	desc.DepthWriteMask = mask == DepthWriteMask::ALL ? D3D11_DEPTH_WRITE_MASK_ALL : D3D11_DEPTH_WRITE_MASK_ZERO;
+	desc.DepthFunc = TranslateComparisonFunction(depthFunc);
+	desc.StencilEnable = stencilEnable;
+	desc.StencilReadMask = stencilReadMask;
+	desc.StencilWriteMask = stencilWriteMask;
+	desc.FrontFace.StencilFailOp = TranslateStencilOp(frontFaceStencilFailOp);
+	desc.FrontFace.StencilDepthFailOp = TranslateStencilOp(frontFaceStencilDepthFailOp);
+	desc.FrontFace.StencilPassOp = TranslateStencilOp(frontFaceStencilPassOp);
+	desc.FrontFace.StencilFunc = TranslateComparisonFunction(frontFaceStencilFunc);
+	desc.BackFace.StencilFailOp = TranslateStencilOp(backFaceStencilFailOp);
+	desc.BackFace.StencilDepthFailOp = TranslateStencilOp(backFaceStencilDepthFailOp);
+	desc.BackFace.StencilPassOp = TranslateStencilOp(backFaceStencilPassOp);
+	desc.BackFace.StencilFunc = TranslateComparisonFunction(backFaceStencilFunc);
+
+	return StoreState(guid, StateType::DEPTH_STENCIL, &desc, sizeof(desc));
+}
+
+SG::SGResult SG::D3D11StateHandler::CreateBlendState(const SGGuid & guid, BOOL alphaToCoverageEnable, BOOL independentBlendEnable, std::vector<RenderTargetBlending> renderTargets)
+{
+	SGCaptureScope capture(SGCaptureCall::CREATE_BLEND_STATE, guid, alphaToCoverageEnable, independentBlendEnable, renderTargets);
+	if (renderTargets.size() > 8)
 		return SGResult::FAIL;
 
-	states.AddElement(guid, std::move(toStore));
+	D3D11_BLEND_DESC desc;
+	ZeroMemory(&desc, sizeof(desc)); // The padding is part of the content the state is shared by
+	desc.AlphaToCoverageEnable = alphaToCoverageEnable;
+	desc.IndependentBlendEnable = independentBlendEnable;
 
-	return SGResult::OK;
+	for (unsigned int i = 0; i < 8; ++i)
+	{
+		D3D11_RENDER_TARGET_BLEND_DESC& target = desc.RenderTarget[i];
+
+		if (i < renderTargets.size())
+		{
+			target.BlendEnable = renderTargets[i].blendEnable;
+			target.SrcBlend = TranslateBlend(renderTargets[i].srcBlend);
+			target.DestBlend = TranslateBlend(renderTargets[i].destBlend);
+			target.BlendOp = TranslateBlendOp(renderTargets[i].blendOp);
+			target.SrcBlendAlpha = TranslateBlend(renderTargets[i].srcBlendAlpha);
+			target.DestBlendAlpha = TranslateBlend(renderTargets[i].destBlendAlpha);
+			target.BlendOpAlpha = TranslateBlendOp(renderTargets[i].blendOpAlpha);
+			target.RenderTargetWriteMask = renderTargets[i].renderTargetWriteMask;
+		}
+		else
+		{
+			target.BlendEnable = FALSE;
+			target.SrcBlend = D3D11_BLEND_ONE;
+			target.DestBlend = D3D11_BLEND_ZERO;
+			target.BlendOp = D3D11_BLEND_OP_ADD;
+			target.SrcBlendAlpha = D3D11_BLEND_ONE;
+			target.DestBlendAlpha = D3D11_BLEND_ZERO;
+			target.BlendOpAlpha = D3D11_BLEND_OP_ADD;
+			target.RenderTargetWriteMask = D3D11_COLOR_WRITE_ENABLE_ALL;
+		}
+	}
+
+	return StoreState(guid, StateType::BLEND, &desc, sizeof(desc));
 }
 
 void SG::D3D11StateHandler::RemoveState(const SGGuid& guid)
 {
+	SGCaptureScope capture(SGCaptureCall::REMOVE_STATE, guid);
 	states.RemoveElement(guid);
+	stateTable.Release(guid);
+}
+
+SG::SGResult SG::D3D11StateHandler::StoreState(const SGGuid & guid, StateType type, const void * desc, size_t descSize)
+{
+	unsigned char content[sizeof(D3D11_BLEND_DESC) + 1];
+	content[0] = static_cast<unsigned char>(type);
+	memcpy(content + 1, desc, descSize);
+	D3D11StateData shared;
+
+	if (!stateTable.Acquire(guid, content, descSize + 1, shared))
+	{
+		D3D11StateData toStore;
+		toStore.type = type;
+		HRESULT hr = E_FAIL;
+
+		switch (type)
+		{
+		case StateType::RASTERIZER:
+			hr = device->CreateRasterizerState(static_cast<const D3D11_RASTERIZER_DESC*>(desc), &toStore.state.rasterizer);
+			break;
+		case StateType::DEPTH_STENCIL:
+			hr = device->CreateDepthStencilState(static_cast<const D3D11_DEPTH_STENCIL_DESC*>(desc), &toStore.state.depthStencil);
+			break;
+		case StateType::BLEND:
+			hr = device->CreateBlendState(static_cast<const D3D11_BLEND_DESC*>(desc), &toStore.state.blend);
+			break;
+		}
+
+		if (FAILED(hr))
+		{
+			toStore.state.rasterizer = nullptr;
+			return SGResult::FAIL;
+		}
+
+		stateTable.Insert(guid, content, descSize + 1, std::move(toStore), shared);
+	}
+
+	states.AddElement(guid, std::move(shared));
+
+	return SGResult::OK;
 }
 
 SG::SGResult SG::D3D11StateHandler::CreateViewport(const SGGuid & guid, FLOAT topLeftX, FLOAT topLeftY, FLOAT width, FLOAT height, FLOAT minDepth, FLOAT maxDepth)
 {
+	SGCaptureScope capture(SGCaptureCall::CREATE_VIEWPORT, guid, topLeftX, topLeftY, width, height, minDepth, maxDepth);
 	D3D11ViewportData toStore;
 
 	toStore.viewport.TopLeftX = topLeftX;
@@ -67,50 +171,173 @@ SG::SGResult SG::D3D11StateHandler::CreateViewport(const SGGuid & guid, FLOAT to
 
 void SG::D3D11StateHandler::RemoveViewport(const SGGuid& guid)
 {
+	SGCaptureScope capture(SGCaptureCall::REMOVE_VIEWPORT, guid);
 	viewports.RemoveElement(guid);
 }
 
+SG::SGResult SG::D3D11StateHandler::CreateDepthStencilData(const SGGuid & guid, UINT stencilRef)
+{
+	SGCaptureScope capture(SGCaptureCall::CREATE_DEPTH_STENCIL_DATA, guid, stencilRef);
+	D3D11SetData toStore;
+	toStore.depthStencil.stencilRef = stencilRef;
+
+	setData.AddElement(guid, std::move(toStore));
+
+	return SGResult::OK;
+}
+
+SG::SGResult SG::D3D11StateHandler::CreateBlendData(const SGGuid & guid, const FLOAT blendFactor[4], UINT sampleMask)
+{
+	SGCaptureScope capture(SGCaptureCall::CREATE_BLEND_DATA, guid, SGCaptureBytes{ blendFactor, sizeof(FLOAT) * 4 }, sampleMask);
+	D3D11SetData toStore;
+
+	for (int i = 0; i < 4; ++i)
+		toStore.blend.blendFactor[i] = blendFactor[i];
+
+	toStore.blend.sampleMask = sampleMask;
+
+	setData.AddElement(guid, std::move(toStore));
+
+	return SGResult::OK;
+}
+
 void SG::D3D11StateHandler::RemoveStateData(const SGGuid& guid)
 {
+	SGCaptureScope capture(SGCaptureCall::REMOVE_STATE_DATA, guid);
 	setData.RemoveElement(guid);
 }
 
+SG::SGResult SG::D3D11StateHandler::CreateStateBlock(const SGGuid & guid, const SGStateBlock & block)
+{
+	SGCaptureScope capture(SGCaptureCall::CREATE_STATE_BLOCK, guid, block);
+	D3D11StateBlockData toStore;
+	toStore.rasterizerState = block.rasterizerState;
+	toStore.blendState = block.blendState;
+	toStore.depthStencilState = block.depthStencilState;
+	toStore.topology = block.topology;
+	toStore.inputLayout = block.inputLayout;
+	toStore.vertexShader = block.vertexShader;
+	toStore.hullShader = block.hullShader;
+	toStore.domainShader = block.domainShader;
+	toStore.geometryShader = block.geometryShader;
+	toStore.pixelShader = block.pixelShader;
+
+	for (int i = 0; i < 4; ++i)
+		toStore.blendFactor[i] = 1.0f;
+
+	toStore.sampleMask = 0xffffffff;
+	toStore.stencilRef = 0;
+
+	if (block.blendData != SGGuid())
+	{
+		if (!setData.Exists(block.blendData))
+			return SGResult::GUID_MISSING;
+
+		const BlendSetData& blend = setData.GetElement(block.blendData).blend;
+
+		for (int i = 0; i < 4; ++i)
+			toStore.blendFactor[i] = blend.blendFactor[i];
+
+		toStore.sampleMask = blend.sampleMask;
+	}
+
+	if (block.depthStencilData != SGGuid())
+	{
+		if (!setData.Exists(block.depthStencilData))
+			return SGResult::GUID_MISSING;
+
+		toStore.stencilRef = setData.GetElement(block.depthStencilData).depthStencil.stencilRef;
+	}
+
+	stateBlockMutex.lock();
+	std::vector<D3D11StateBlockData>& sameHash = stateBlockIDs[toStore.HashContent()];
+
+	for (auto& existing : sameHash)
+	{
+		if (existing.SameContent(toStore))
+		{
+			toStore.id = existing.id;
+			break;
+		}
+	}
+
+	if (toStore.id == 0)
+	{
+		toStore.id = ++nrOfStateBlockIDs;
+		sameHash.push_back(toStore);
+	}
+	stateBlockMutex.unlock();
+
+	stateBlocks.AddElement(guid, std::move(toStore));
+
+	return SGResult::OK;
+}
+
+void SG::D3D11StateHandler::RemoveStateBlock(const SGGuid & guid)
+{
+	SGCaptureScope capture(SGCaptureCall::REMOVE_STATE_BLOCK, guid);
+	stateBlocks.RemoveElement(guid);
+}
+
 SG::SGResult SG::D3D11StateHandler::BindStateToEntity(const SGGraphicalEntityID & entity, const SGGuid & stateGuid, const SGGuid & bindGuid)
 {
+	SGCaptureScope capture(SGCaptureCall::BIND_STATE_TO_ENTITY, entity, stateGuid, bindGuid);
 	return SG::SGGraphicsHandler::BindElementToEntity(entity, stateGuid, bindGuid, states);
 }
 
 SG::SGResult SG::D3D11StateHandler::BindStateToGroup(const SGGuid & group, const SGGuid & stateGuid, const SGGuid & bindGuid)
 {
+	SGCaptureScope capture(SGCaptureCall::BIND_STATE_TO_GROUP, group, stateGuid, bindGuid);
 	return SG::SGGraphicsHandler::BindElementToGroup(group, stateGuid, bindGuid, states);
 }
 
+SG::SGResult SG::D3D11StateHandler::BindStateBlockToEntity(const SGGraphicalEntityID & entity, const SGGuid & blockGuid, const SGGuid & bindGuid)
+{
+	SGCaptureScope capture(SGCaptureCall::BIND_STATE_BLOCK_TO_ENTITY, entity, blockGuid, bindGuid);
+	return SG::SGGraphicsHandler::BindElementToEntity(entity, blockGuid, bindGuid, stateBlocks);
+}
+
+SG::SGResult SG::D3D11StateHandler::BindStateBlockToGroup(const SGGuid & group, const SGGuid & blockGuid, const SGGuid & bindGuid)
+{
+	SGCaptureScope capture(SGCaptureCall::BIND_STATE_BLOCK_TO_GROUP, group, blockGuid, bindGuid);
+	return SG::SGGraphicsHandler::BindElementToGroup(group, blockGuid, bindGuid, stateBlocks);
+}
+
 SG::SGResult SG::D3D11StateHandler::BindViewportToEntity(const SGGraphicalEntityID & entity, const SGGuid & viewportGuid, const SGGuid & bindGuid)
 {
+	SGCaptureScope capture(SGCaptureCall::BIND_VIEWPORT_TO_ENTITY, entity, viewportGuid, bindGuid);
 	return SG::SGGraphicsHandler::BindElementToEntity(entity, viewportGuid, bindGuid, viewports);
 }
 
 SG::SGResult SG::D3D11StateHandler::BindViewportToGroup(const SGGuid & group, const SGGuid & viewportGuid, const SGGuid & bindGuid)
 {
+	SGCaptureScope capture(SGCaptureCall::BIND_VIEWPORT_TO_GROUP, group, viewportGuid, bindGuid);
 	return SG::SGGraphicsHandler::BindElementToGroup(group, viewportGuid, bindGuid, viewports);
 }
 
 void SG::D3D11StateHandler::FinishFrame()
 {
+	SGTraceScope scope("D3D11StateHandler::FinishFrame");
+
 	SG::SGGraphicsHandler::FinishFrame();
 
 	states.FinishFrame();
 	setData.FinishFrame();
 	viewports.FinishFrame();
+	stateBlocks.FinishFrame();
 }
 
 void SG::D3D11StateHandler::SwapFrame()
 {
+	SGTraceScope scope("D3D11StateHandler::SwapFrame");
+
 	SG::SGGraphicsHandler::SwapFrame();
 
-	states.UpdateActive();
-	setData.UpdateActive();
-	viewports.UpdateActive();
+	size_t nrOfOperations = states.UpdateActive();
+	nrOfOperations += setData.UpdateActive();
+	nrOfOperations += viewports.UpdateActive();
+	nrOfOperations += stateBlocks.UpdateActive();
+	SGProfiler::Count(SGCounter::FRAME_MAP_OPERATIONS, nrOfOperations);
 }
 
 ID3D11RasterizerState * SG::D3D11StateHandler::GetRazterizerState(const SGGuid & guid)
@@ -146,6 +373,65 @@ ID3D11RasterizerState * SG::D3D11StateHandler::GetRazterizerState(const SGGuid &
 	return SG::SGGraphicsHandler::GetEntityElement(guid, entity, states, "rasterizer state", { stateTypeCheck }).state.rasterizer;
 }
 
+ID3D11BlendState * SG::D3D11StateHandler::GetBlendState(const SGGuid & guid)
+{
+	auto stateTypeCheck = [](const D3D11StateData& element)
+	{
+		if (element.type != StateType::BLEND)
+			throw std::runtime_error("Error fetching blend state, guid does not match a blend state");
+	};
+
+	return SG::SGGraphicsHandler::GetGlobalElement(guid, states, "blend state", { stateTypeCheck }).state.blend;
+}
+
+ID3D11BlendState * SG::D3D11StateHandler::GetBlendState(const SGGuid & guid, const SGGuid & groupGuid)
+{
+	auto stateTypeCheck = [](const D3D11StateData& element)
+	{
+		if (element.type != StateType::BLEND)
+			throw std::runtime_error("Error fetching blend state, guid does not match a blend state");
+	};
+
+	return SG::SGGraphicsHandler::GetGroupElement(guid, groupGuid, states, "blend state", { stateTypeCheck }).state.blend;
+}
+
+ID3D11BlendState * SG::D3D11StateHandler::GetBlendState(const SGGuid & guid, const SGGraphicalEntityID & entity)
+{
+	auto stateTypeCheck = [](const D3D11StateData& element)
+	{
+		if (element.type != StateType::BLEND)
+			throw std::runtime_error("Error fetching blend state, guid does not match a blend state");
+	};
+
+	return SG::SGGraphicsHandler::GetEntityElement(guid, entity, states, "blend state", { stateTypeCheck }).state.blend;
+}
+
+ID3D11DepthStencilState * SG::D3D11StateHandler::GetDepthStencilState(const SGGuid & guid)
+{
+	auto stateTypeCheck = [](const D3D11StateData& element)
+	{
+		if (element.type != StateType::DEPTH_STENCIL)
+			throw std::runtime_error("Error fetching depth stencil state, guid does not match a depth stencil state");
+	};
+
+	return SG::SGGraphicsHandler::GetGlobalElement(guid, states, "depth stencil state", { stateTypeCheck }).state.depthStencil;
+}
+
+const SG::D3D11StateBlockData & SG::D3D11StateHandler::GetStateBlock(const SGGuid & guid)
+{
+	return SG::SGGraphicsHandler::GetGlobalElement(guid, stateBlocks, "state block");
+}
+
+const SG::D3D11StateBlockData & SG::D3D11StateHandler::GetStateBlock(const SGGuid & guid, const SGGuid & groupGuid)
+{
+	return SG::SGGraphicsHandler::GetGroupElement(guid, groupGuid, stateBlocks, "state block");
+}
+
+const SG::D3D11StateBlockData & SG::D3D11StateHandler::GetStateBlock(const SGGuid & guid, const SGGraphicalEntityID & entity)
+{
+	return SG::SGGraphicsHandler::GetEntityElement(guid, entity, stateBlocks, "state block");
+}
+
 const D3D11_VIEWPORT& SG::D3D11StateHandler::GetViewport(const SGGuid & guid)
 {
 	return SG::SGGraphicsHandler::GetGlobalElement(guid, viewports, "viewport").viewport;
@@ -160,3 +446,115 @@ const D3D11_VIEWPORT& SG::D3D11StateHandler::GetViewport(const SGGuid & guid, co
 {
 	return SG::SGGraphicsHandler::GetEntityElement(guid, entity, viewports, "viewport").viewport;
 }
+
+D3D11_COMPARISON_FUNC SG::D3D11StateHandler::TranslateComparisonFunction(const ComparisonFunction & compFunc)
+{
+	switch (compFunc)
+	{
+	case SG::ComparisonFunction::NEVER:
+		return D3D11_COMPARISON_NEVER;
+	case SG::ComparisonFunction::LESS:
+		return D3D11_COMPARISON_LESS;
+	case SG::ComparisonFunction::EQUAL:
+		return D3D11_COMPARISON_EQUAL;
+	case SG::ComparisonFunction::LESS_EQUAL:
+		return D3D11_COMPARISON_LESS_EQUAL;
+	case SG::ComparisonFunction::GREATER:
+		return D3D11_COMPARISON_GREATER;
+	case SG::ComparisonFunction::NOT_EQUAL:
+		return D3D11_COMPARISON_NOT_EQUAL;
+	case SG::ComparisonFunction::GREATER_EQUAL:
+		return D3D11_COMPARISON_GREATER_EQUAL;
+	case SG::ComparisonFunction::ALWAYS:
+		return D3D11_COMPARISON_ALWAYS;
+	default:
+		throw std::runtime_error("Error, unknown comparison function");
+	}
+}
+
+D3D11_STENCIL_OP SG::D3D11StateHandler::TranslateStencilOp(const DepthStencilOp & op)
+{
+	switch (op)
+	{
+	case SG::DepthStencilOp::KEEP:
+		return D3D11_STENCIL_OP_KEEP;
+	case SG::DepthStencilOp::ZERO:
+		return D3D11_STENCIL_OP_ZERO;
+	case SG::DepthStencilOp::REPLACE:
+		return D3D11_STENCIL_OP_REPLACE;
+	case SG::DepthStencilOp::INCR_SAT:
+		return D3D11_STENCIL_OP_INCR_SAT;
+	case SG::DepthStencilOp::DECR_SAT:
+		return D3D11_STENCIL_OP_DECR_SAT;
+	case SG::DepthStencilOp::INVERT:
+		return D3D11_STENCIL_OP_INVERT;
+	case SG::DepthStencilOp::INCR:
+		return D3D11_STENCIL_OP_INCR;
+	case SG::DepthStencilOp::DECR:
+		return D3D11_STENCIL_OP_DECR;
+	default:
+		throw std::runtime_error("Error, unknown stencil operation");
+	}
+}
+
+D3D11_BLEND SG::D3D11StateHandler::TranslateBlend(const Blend & blend)
+{
+	switch (blend)
+	{
+	case SG::Blend::ZERO:
+		return D3D11_BLEND_ZERO;
+	case SG::Blend::ONE:
+		return D3D11_BLEND_ONE;
+	case SG::Blend::SRC_COLOR:
+		return D3D11_BLEND_SRC_COLOR;
+	case SG::Blend::INV_SRC_COLOR:
+		return D3D11_BLEND_INV_SRC_COLOR;
+	case SG::Blend::SRC_ALPHA:
+		return D3D11_BLEND_SRC_ALPHA;
+	case SG::Blend::INV_SRC_ALPHA:
+		return D3D11_BLEND_INV_SRC_ALPHA;
+	case SG::Blend::DEST_ALPHA:
+		return D3D11_BLEND_DEST_ALPHA;
+	case SG::Blend::INV_DEST_ALPHA:
+		return D3D11_BLEND_INV_DEST_ALPHA;
+	case SG::Blend::DEST_COLOR:
+		return D3D11_BLEND_DEST_COLOR;
+	case SG::Blend::INV_DEST_COLOR:
+		return D3D11_BLEND_INV_DEST_COLOR;
+	case SG::Blend::SRC_ALPHA_SAT:
+		return D3D11_BLEND_SRC_ALPHA_SAT;
+	case SG::Blend::BLEND_FACTOR:
+		return D3D11_BLEND_BLEND_FACTOR;
+	case SG::Blend::INV_BLEND_FACTOR:
+		return D3D11_BLEND_INV_BLEND_FACTOR;
+	case SG::Blend::SRC1_COLOR:
+		return D3D11_BLEND_SRC1_COLOR;
+	case SG::Blend::INV_SRC1_COLOR:
+		return D3D11_BLEND_INV_SRC1_COLOR;
+	case SG::Blend::SRC1_ALPHA:
+		return D3D11_BLEND_SRC1_ALPHA;
+	case SG::Blend::INV_SRC1_ALPHA:
+		return D3D11_BLEND_INV_SRC1_ALPHA;
+	default:
+		throw std::runtime_error("Error, unknown blend");
+	}
+}
+
+D3D11_BLEND_OP SG::D3D11StateHandler::TranslateBlendOp(const BlendOp & op)
+{
+	switch (op)
+	{
+	case SG::BlendOp::ADD:
+		return D3D11_BLEND_OP_ADD;
+	case SG::BlendOp::SUBTRACT:
+		return D3D11_BLEND_OP_SUBTRACT;
+	case SG::BlendOp::REV_SUBTRACT:
+		return D3D11_BLEND_OP_REV_SUBTRACT;
+	case SG::BlendOp::MIN:
+		return D3D11_BLEND_OP_MIN;
+	case SG::BlendOp::MAX:
+		return D3D11_BLEND_OP_MAX;
+	default:
+		throw std::runtime_error("Error, unknown blend operation");
+	}
+}
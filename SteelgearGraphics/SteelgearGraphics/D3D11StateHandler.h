@@ -2,12 +2,17 @@
 
 #include <d3d11_4.h>
 #include <utility>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
 
 #include "SGGraphicsHandler.h"
+#include "SGDedupTable.h"
 
 #include "D3D11CommonTypes.h"
 #include "D3D11StateData.h"
 #include "D3D11SetData.h"
+#include "D3D11StateBlockData.h"
 #include "D3D11ViewportData.h"
 
 
@@ -86,6 +91,25 @@ namespace SG
 		UINT8 renderTargetWriteMask;
 	};
 
+	// Everything set for a draw besides the resources, empty guids use the default state or set data
+	struct SGStateBlock
+	{
+		SGGuid rasterizerState;
+		SGGuid blendState;
+		SGGuid depthStencilState;
+		SGGuid blendData;
+		SGGuid depthStencilData;
+		D3D11_PRIMITIVE_TOPOLOGY topology = D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST;
+		SGGuid inputLayout;
+		SGGuid vertexShader;
+		SGGuid hullShader;
+		SGGuid domainShader;
+		SGGuid geometryShader;
+		SGGuid pixelShader;
+	};
+
+	/** States are created from their translated descriptions, guids with the same description share one state object.
+	The render engine only sets a state when the object differs from the one that is set, so shared states are never set twice */
 	class D3D11StateHandler : public SGGraphicsHandler
 	{
 	public:
@@ -111,9 +135,17 @@ namespace SG
 		SGResult CreateBlendData(const SGGuid& guid, const FLOAT blendFactor[4], UINT sampleMask);
 		void RemoveStateData(const SGGuid& guid);
 
+		/** Blend and depth stencil data are copied when the block is created. Blocks with the same content get the same id,
+		so a block only has to be applied when the id differs from the one that was applied last */
+		SGResult CreateStateBlock(const SGGuid& guid, const SGStateBlock& block);
+		void RemoveStateBlock(const SGGuid& guid);
+
 		SGResult BindStateToEntity(const SGGraphicalEntityID& entity, const SGGuid& stateGuid, const SGGuid& bindGuid);
 		SGResult BindStateToGroup(const SGGuid& group, const SGGuid& stateGuid, const SGGuid& bindGuid);
 
+		SGResult BindStateBlockToEntity(const SGGraphicalEntityID& entity, const SGGuid& blockGuid, const SGGuid& bindGuid);
+		SGResult BindStateBlockToGroup(const SGGuid& group, const SGGuid& blockGuid, const SGGuid& bindGuid);
+
 		SGResult BindViewportToEntity(const SGGraphicalEntityID& entity, const SGGuid& viewportGuid, const SGGuid& bindGuid);
 		SGResult BindViewportToGroup(const SGGuid& group, const SGGuid& viewportGuid, const SGGuid& bindGuid);
 
@@ -123,20 +155,41 @@ namespace SG
 		friend class D3D11RenderEngine;
 
 		FrameMap<SGGuid, D3D11StateData> states;
+		SGDedupTable<D3D11StateData> stateTable; // Keyed by the type followed by the description
 		FrameMap<SGGuid, D3D11SetData> setData;
 		FrameMap<SGGuid, D3D11ViewportData> viewports;
+		FrameMap<SGGuid, D3D11StateBlockData> stateBlocks;
+		std::unordered_map<size_t, std::vector<D3D11StateBlockData>> stateBlockIDs; // Content hash to one block of every id with that hash
+		size_t nrOfStateBlockIDs = 0;
+		std::mutex stateBlockMutex;
 
 		ID3D11Device* device;
 
 		void FinishFrame() override;
 		void SwapFrame() override;
 
+		SGResult StoreState(const SGGuid& guid, StateType type, const void* desc, size_t descSize);
+
 		ID3D11RasterizerState* GetRazterizerState(const SGGuid& guid);
 		ID3D11RasterizerState* GetRazterizerState(const SGGuid& guid, const SGGuid& groupGuid);
 		ID3D11RasterizerState* GetRazterizerState(const SGGuid& guid, const SGGraphicalEntityID& entity);
 
+		ID3D11BlendState* GetBlendState(const SGGuid& guid);
+		ID3D11BlendState* GetBlendState(const SGGuid& guid, const SGGuid& groupGuid);
+		ID3D11BlendState* GetBlendState(const SGGuid& guid, const SGGraphicalEntityID& entity);
+		ID3D11DepthStencilState* GetDepthStencilState(const SGGuid& guid);
+
+		const D3D11StateBlockData& GetStateBlock(const SGGuid& guid);
+		const D3D11StateBlockData& GetStateBlock(const SGGuid& guid, const SGGuid& groupGuid);
+		const D3D11StateBlockData& GetStateBlock(const SGGuid& guid, const SGGraphicalEntityID& entity);
+
 		const D3D11_VIEWPORT& GetViewport(const SGGuid& guid);
 		const D3D11_VIEWPORT& GetViewport(const SGGuid& guid, const SGGuid& groupGuid);
 		const D3D11_VIEWPORT& GetViewport(const SGGuid& guid, const SGGraphicalEntityID& entity);
+
+		D3D11_COMPARISON_FUNC TranslateComparisonFunction(const ComparisonFunction& compFunc);
+		D3D11_STENCIL_OP TranslateStencilOp(const DepthStencilOp& op);
+		D3D11_BLEND TranslateBlend(const Blend& blend);
+		D3D11_BLEND_OP TranslateBlendOp(const BlendOp& op);
 	};
 }
\ No newline at end of file
@@ -3,6 +3,7 @@
 #include <d3d11_4.h>
 
 #include "D3D11CommonTypes.h"
+#include "SGRegionStaging.h"
 #include "TripleBufferedData.h"
 
 namespace SG
@@ -29,7 +30,7 @@ namespace SG
 			ID3D11Texture2D* texture2D;
 			ID3D11Texture3D* texture3D;
 		} texture;
-		TripleBufferedData<UpdateData> updatedData;
+		TripleBufferedData<SGRegionStaging> updatedData; // Regions staged by UpdateTexture
 
 		D3D11TextureData() = default;
 		~D3D11TextureData();
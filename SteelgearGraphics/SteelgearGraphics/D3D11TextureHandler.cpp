@@ -1,60 +1,223 @@
 #include "D3D11TextureHandler.h"
+#include "D3D11Capture.h"
 
-SG::D3D11TextureHandler::D3D11TextureHandler(ID3D11Device * device)
+#include <algorithm>
+
+SG::D3D11TextureHandler::D3D11TextureHandler(ID3D11Device * device, SGLoadQueue* loadQueue, size_t updateBudgetPerFrame)
 {
 	this->device = device;
+	this->loadQueue = loadQueue;
+	this->updateBudgetPerFrame = updateBudgetPerFrame;
 }
 
-SG::SGResult SG::D3D11TextureHandler::CreateTexture2D(const SGGuid & guid, const SGTextureData & generalSettings, UINT width, UINT height, UINT arraySize, const DXGI_SAMPLE_DESC & sampleDesc, bool texturecube)
+SG::SGResult SG::D3D11TextureHandler::CreateTexture1D(const SGGuid & guid, const SGTextureData & generalSettings, UINT width, UINT arraySize)
 {
-	D3D11_TEXTURE2D_DESC desc;
+	SGCaptureScope capture(SGCaptureCall::CREATE_TEXTURE_1D, guid, SGCaptureTextureData{ generalSettings, width, 1, arraySize }, width, arraySize);
+
+	// A block is four texels high, which a one dimensional texture can not hold
+	if (IsBlockCompressed(generalSettings.format))
+		return SGResult::FAIL;
+
+	D3D11_TEXTURE1D_DESC desc;
 	desc.Width = width;
-	desc.Height = height;
 	desc.MipLevels = generalSettings.mipLevels;
 	desc.ArraySize = arraySize;
 	desc.Format = generalSettings.format;
-	desc.SampleDesc = sampleDesc;
 	SetUsageAndCPUAccessFlags(generalSettings, desc.Usage, desc.CPUAccessFlags);
 	SetBindflags(generalSettings, desc.BindFlags);
 	desc.MiscFlags = 0 | (generalSettings.generateMips ? D3D11_RESOURCE_MISC_GENERATE_MIPS : 0) | (generalSettings.resourceClamp ? D3D11_RESOURCE_MISC_RESOURCE_CLAMP : 0);
+
+	std::vector<D3D11_SUBRESOURCE_DATA> data;
+
+	if (generalSettings.data.size() && !GetInitialData(generalSettings, width, 1, 1, GetMipLevels(generalSettings, width, 1, 1), arraySize, data))
+		return SGResult::FAIL;
+
+	ID3D11Texture1D* texture;
+
+	if (FAILED(device->CreateTexture1D(&desc, data.size() ? data.data() : nullptr, &texture)))
+		return SGResult::FAIL;
+
+	D3D11TextureData toStore;
+	toStore.type = (arraySize > 1) ? TextureType::TEXTURE_ARRAY_1D : TextureType::TEXTURE_1D;
+	toStore.texture.texture1D = texture;
+	textures.AddElement(guid, std::move(toStore));
+
+	return SGResult::OK;
+}
+
+SG::SGResult SG::D3D11TextureHandler::CreateTexture2D(const SGGuid & guid, const SGTextureData & generalSettings, UINT width, UINT height, UINT arraySize, const DXGI_SAMPLE_DESC & sampleDesc, bool texturecube)
+{
+	SGCaptureScope capture(SGCaptureCall::CREATE_TEXTURE_2D, guid, SGCaptureTextureData{ generalSettings, width, height, arraySize }, width, height, arraySize, sampleDesc, texturecube);
+
+	if (!ValidBlockDimensions(generalSettings.format, width, height))
+		return SGResult::FAIL;
+
+	SGTextureData withMips;
+	std::vector<SGMipImage> generatedMips;
+	bool cpuMips = CanGenerateMips(generalSettings, arraySize);
+
+	if (cpuMips && !GenerateInitialMips(generalSettings, width, height, 1, withMips, generatedMips))
+		return SGResult::FAIL;
+
+	const SGTextureData& settings = cpuMips ? withMips : generalSettings;
+
+	D3D11_TEXTURE2D_DESC desc;
+	desc.Width = width;
+	desc.Height = height;
+	desc.MipLevels = settings.mipLevels;
+	desc.ArraySize = arraySize;
+	desc.Format = settings.format;
+	desc.SampleDesc = sampleDesc;
+	SetUsageAndCPUAccessFlags(settings, desc.Usage, desc.CPUAccessFlags);
+	SetBindflags(settings, desc.BindFlags);
+	desc.MiscFlags = 0 | (settings.generateMips ? D3D11_RESOURCE_MISC_GENERATE_MIPS : 0) | (settings.resourceClamp ? D3D11_RESOURCE_MISC_RESOURCE_CLAMP : 0);
 	desc.MiscFlags |= (texturecube ? D3D11_RESOURCE_MISC_TEXTURECUBE : 0);
 
+	std::vector<D3D11_SUBRESOURCE_DATA> data;
+
+	if (settings.data.size() && !GetInitialData(settings, width, height, 1, GetMipLevels(settings, width, height, 1), arraySize, data))
+		return SGResult::FAIL;
+
 	ID3D11Texture2D* texture;
 
-	if (generalSettings.data.size())
-	{
-		if (generalSettings.data.size() < arraySize * generalSettings.mipLevels)
-			return SG::SGResult::FAIL;
+	if (FAILED(device->CreateTexture2D(&desc, data.size() ? data.data() : nullptr, &texture)))
+		return SGResult::FAIL;
 
-		// does not take into account the mip maps but the stack cannot store an infinite amount
-		D3D11_SUBRESOURCE_DATA data[D3D11_REQ_TEXTURE2D_ARRAY_AXIS_DIMENSION]; 
-		int formatSize = GetFormatElementSize(generalSettings.format);
+	D3D11TextureData toStore;
+	toStore.type = (arraySize > 1) ? (texturecube ? TextureType::TEXTURE_CUBE : TextureType::TEXTURE_ARRAY_2D) : TextureType::TEXTURE_2D;
+	toStore.texture.texture2D = texture;
+	textures.AddElement(guid, std::move(toStore));
 
-		for (unsigned int i = 0; i < arraySize; ++i)
-		{
-			int mipLevelDivision = 1;
-			
-			for (unsigned int j = 0; j < generalSettings.mipLevels; ++j)
-			{
-				data[i * generalSettings.mipLevels + j].pSysMem = generalSettings.data[i * generalSettings.mipLevels + j];
-				data[i * generalSettings.mipLevels + j].SysMemPitch = (width / mipLevelDivision) * formatSize;
-				data[i * generalSettings.mipLevels + j].SysMemSlicePitch = 0;
-				mipLevelDivision *= 2;
-			}
-		}
+	return SGResult::OK;
+}
+
+SG::SGResult SG::D3D11TextureHandler::CreateCompressedTexture2D(const SGGuid & guid, const SGTextureData & generalSettings, UINT width, UINT height, UINT arraySize,
+	const SGCompressionSettings & compression, bool texturecube, SGThreadPool * threadPool)
+{
+	if (generalSettings.format != DXGI_FORMAT_R8G8B8A8_UNORM && generalSettings.format != DXGI_FORMAT_R8G8B8A8_UNORM_SRGB)
+		return SGResult::FAIL;
+
+	SGTextureData withMips;
+	std::vector<SGMipImage> generatedMips;
+	bool cpuMips = CanGenerateMips(generalSettings, arraySize);
+
+	if (cpuMips && !GenerateInitialMips(generalSettings, width, height, 1, withMips, generatedMips))
+		return SGResult::FAIL;
 
-		if (FAILED(device->CreateTexture2D(&desc, data, &texture)))
+	const SGTextureData& uncompressed = cpuMips ? withMips : generalSettings;
+	UINT mipLevels = GetMipLevels(uncompressed, width, height, 1);
+
+	if (uncompressed.data.size() != static_cast<size_t>(arraySize) * mipLevels || uncompressed.rowPitches.size())
+		return SGResult::FAIL;
+
+	// The compressed subresources are tightly packed, which is what the texture creation assumes without row pitches
+	std::vector<SGCompressedImage> compressed(uncompressed.data.size());
+	SGMipImage source;
+
+	for (size_t i = 0; i < compressed.size(); ++i)
+	{
+		source.width = GetMipDimension(width, static_cast<UINT>(i % mipLevels));
+		source.height = GetMipDimension(height, static_cast<UINT>(i % mipLevels));
+		const unsigned char* texels = static_cast<const unsigned char*>(uncompressed.data[i]);
+		source.texels.assign(texels, texels + static_cast<size_t>(source.width) * source.height * 4);
+
+		if (CompressImage(source, compression, compressed[i], threadPool) != SGResult::OK)
 			return SGResult::FAIL;
 	}
-	else
+
+	SGTextureData settings = uncompressed;
+	settings.format = GetCompressedFormat(compression.format, generalSettings.format == DXGI_FORMAT_R8G8B8A8_UNORM_SRGB);
+	settings.generateMips = false;
+	settings.data.clear();
+
+	for (auto& image : compressed)
+		settings.data.push_back(image.blocks.data());
+
+	DXGI_SAMPLE_DESC sampleDesc = { 1, 0 };
+	return CreateTexture2D(guid, settings, width, height, arraySize, sampleDesc, texturecube);
+}
+
+SG::SGResult SG::D3D11TextureHandler::CreateTexture2DAsync(const SGGuid & guid, const SGTextureData & generalSettings, UINT width, UINT height, UINT arraySize,
+	const DXGI_SAMPLE_DESC & sampleDesc, bool texturecube, const SGLoadCallback & onComplete)
+{
+	size_t uploadSize = 0;
+	UINT mipLevels = GetMipLevels(generalSettings, width, height, 1);
+
+	for (size_t i = 0; i < generalSettings.data.size(); ++i)
 	{
-		if (FAILED(device->CreateTexture2D(&desc, nullptr, &texture)))
-			return SGResult::FAIL;
+		SGSubresourcePitch pitch = GetSubresourcePitch(generalSettings.format, width, height, 1, mipLevels, static_cast<UINT>(i));
+		size_t rowPitch = i < generalSettings.rowPitches.size() ? generalSettings.rowPitches[i] : pitch.rowPitch;
+		uploadSize += rowPitch * pitch.nrOfRows;
 	}
 
+	loadQueue->Enqueue(guid, uploadSize, [=]()
+	{
+		return CreateTexture2D(guid, generalSettings, width, height, arraySize, sampleDesc, texturecube);
+	}, onComplete);
+
+	return SGResult::OK;
+}
+
+SG::SGResult SG::D3D11TextureHandler::CreatePackedTexture(const SGGuid & guid, const SGPackedTexture & packed, const SGTextureData & generalSettings)
+{
+	if (packed.depth > 1)
+		return packed.arraySize > 1 ? SGResult::FAIL : CreateTexture3D(guid, GetPackedSettings(packed, generalSettings), packed.width, packed.height, packed.depth);
+
+	DXGI_SAMPLE_DESC sampleDesc = { 1, 0 };
+	return CreateTexture2D(guid, GetPackedSettings(packed, generalSettings), packed.width, packed.height, packed.arraySize, sampleDesc, packed.textureCube);
+}
+
+SG::SGResult SG::D3D11TextureHandler::CreatePackedTextureAsync(const SGGuid & guid, const SGPackedTexture & packed, const SGTextureData & generalSettings,
+	const SGLoadCallback & onComplete)
+{
+	// Only two dimensional textures are created on the loader threads for now
+	if (packed.depth > 1)
+		return SGResult::FAIL;
+
+	DXGI_SAMPLE_DESC sampleDesc = { 1, 0 };
+	return CreateTexture2DAsync(guid, GetPackedSettings(packed, generalSettings), packed.width, packed.height, packed.arraySize, sampleDesc,
+		packed.textureCube, onComplete);
+}
+
+SG::SGResult SG::D3D11TextureHandler::CreateTexture3D(const SGGuid & guid, const SGTextureData & generalSettings, UINT width, UINT height, UINT depth)
+{
+	SGCaptureScope capture(SGCaptureCall::CREATE_TEXTURE_3D, guid, SGCaptureTextureData{ generalSettings, width, height, 1, depth }, width, height, depth);
+
+	if (!ValidBlockDimensions(generalSettings.format, width, height))
+		return SGResult::FAIL;
+
+	SGTextureData withMips;
+	std::vector<SGMipImage> generatedMips;
+	bool cpuMips = CanGenerateMips(generalSettings, 1);
+
+	if (cpuMips && !GenerateInitialMips(generalSettings, width, height, depth, withMips, generatedMips))
+		return SGResult::FAIL;
+
+	const SGTextureData& settings = cpuMips ? withMips : generalSettings;
+
+	D3D11_TEXTURE3D_DESC desc;
+	desc.Width = width;
+	desc.Height = height;
+	desc.Depth = depth;
+	desc.MipLevels = settings.mipLevels;
+	desc.Format = settings.format;
+	SetUsageAndCPUAccessFlags(settings, desc.Usage, desc.CPUAccessFlags);
+	SetBindflags(settings, desc.BindFlags);
+	desc.MiscFlags = 0 | (settings.generateMips ? D3D11_RESOURCE_MISC_GENERATE_MIPS : 0) | (settings.resourceClamp ? D3D11_RESOURCE_MISC_RESOURCE_CLAMP : 0);
+
+	std::vector<D3D11_SUBRESOURCE_DATA> data;
+
+	if (settings.data.size() && !GetInitialData(settings, width, height, depth, GetMipLevels(settings, width, height, depth), 1, data))
+		return SGResult::FAIL;
+
+	ID3D11Texture3D* texture;
+
+	if (FAILED(device->CreateTexture3D(&desc, data.size() ? data.data() : nullptr, &texture)))
+		return SGResult::FAIL;
+
 	D3D11TextureData toStore;
-	toStore.type = (arraySize > 1) ? (texturecube ? TextureType::TEXTURE_CUBE : TextureType::TEXTURE_ARRAY_2D) : TextureType::TEXTURE_2D;
-	toStore.texture.texture2D = texture;
+	toStore.type = TextureType::TEXTURE_3D;
+	toStore.texture.texture3D = texture;
 	textures.AddElement(guid, std::move(toStore));
 
 	return SGResult::OK;
@@ -62,13 +225,85 @@ SG::SGResult SG::D3D11TextureHandler::CreateTexture2D(const SGGuid & guid, const
 
 void SG::D3D11TextureHandler::RemoveTexture(const SGGuid& guid)
 {
+	SGCaptureScope capture(SGCaptureCall::REMOVE_TEXTURE, guid);
 	textures.RemoveElement(guid);
 }
 
+SG::SGResult SG::D3D11TextureHandler::UpdateTexture(const SGGuid & guid, UINT subresource, const std::optional<D3D11_BOX>& box, const void * data, UINT rowPitch)
+{
+	if (!textures.Exists(guid))
+		return SGResult::GUID_MISSING;
+
+	D3D11TextureData& textureData = textures.GetElement(guid);
+	SubresourceInfo info;
+
+	// The updates are made with UpdateSubresource, which only writes to default textures that are neither depth stencils nor multisampled
+	if (!GetSubresourceInfo(textureData, subresource, info) || info.usage != D3D11_USAGE_DEFAULT || (info.bindFlags & D3D11_BIND_DEPTH_STENCIL) ||
+		info.sampleCount != 1 || IsPlanar(info.format))
+		return SGResult::FAIL;
+
+	DXGI_FORMAT format = info.format;
+	SGUpdateRegion region;
+	region.subresource = subresource;
+	region.right = info.width;
+	region.bottom = info.height;
+	region.back = info.depth;
+
+	if (box.has_value())
+	{
+		if (box->left >= box->right || box->top >= box->bottom || box->front >= box->back ||
+			box->right > region.right || box->bottom > region.bottom || box->back > region.back)
+			return SGResult::FAIL;
+
+		// Block compressed regions start on a block and end on one or at the edge of the mip
+		if (IsBlockCompressed(format))
+		{
+			SGFormatInfo formatInfo = GetFormatInfo(format);
+
+			if (box->left % formatInfo.blockWidth != 0 || box->top % formatInfo.blockHeight != 0 ||
+				(box->right % formatInfo.blockWidth != 0 && box->right != region.right) ||
+				(box->bottom % formatInfo.blockHeight != 0 && box->bottom != region.bottom))
+				return SGResult::FAIL;
+		}
+
+		region.left = box->left;
+		region.top = box->top;
+		region.front = box->front;
+		region.right = box->right;
+		region.bottom = box->bottom;
+		region.back = box->back;
+	}
+
+	size_t rowSize = GetRowPitch(format, region.right - region.left);
+	size_t nrOfRows = GetNrOfRows(format, region.bottom - region.top);
+	size_t sourcePitch = rowPitch != 0 ? rowPitch : rowSize;
+
+	if (rowSize == 0 || sourcePitch < rowSize)
+		return SGResult::FAIL;
+
+	size_t dataSize = sourcePitch * (nrOfRows * (region.back - region.front) - 1) + rowSize;
+	SGCaptureScope capture(SGCaptureCall::UPDATE_TEXTURE, guid, subresource, box, SGCaptureBytes{ data, dataSize }, rowPitch);
+
+	// Locked as a whole, since threads updating the same texture stage into the same memory
+	frameBufferMutex.lock();
+	SGRegionStaging& staging = textureData.updatedData.GetToUpdate();
+	bool firstThisFrame = staging.Empty();
+	staging.AddRegion(region, data, rowSize, nrOfRows, sourcePitch, sourcePitch * nrOfRows);
+	textureData.updatedData.MarkAsUpdated();
+
+	if (firstThisFrame)
+		updatedFrameBuffer.push_back(guid);
+
+	frameBufferMutex.unlock();
+
+	return SGResult::OK;
+}
+
 SG::SGResult SG::D3D11TextureHandler::CreateSRV(const SGGuid & guid, const SGGuid & textureGuid,
 	std::optional<DXGI_FORMAT> format, std::optional<TextureType> viewDimension,
 	std::optional<UINT> mostDetailedMip, std::optional<UINT> mipLevels)
 {
+	SGCaptureScope capture(SGCaptureCall::CREATE_TEXTURE_SRV, guid, textureGuid, format, viewDimension, mostDetailedMip, mipLevels);
 	if constexpr (DEBUG_VERSION)
 	{
 		if (!textures.Exists(textureGuid))
@@ -117,6 +352,7 @@ SG::SGResult SG::D3D11TextureHandler::CreateSRV(const SGGuid & guid, const SGGui
 		return SGResult::FAIL;
 
 	toStore.resourceGuid = textureGuid;
+	toStore.resource = textureData.texture.texture2D;
 	views.AddElement(guid, std::move(toStore));
 
 	return SGResult::OK;
@@ -126,6 +362,7 @@ SG::SGResult SG::D3D11TextureHandler::CreateSRVTextureArray(const SGGuid & guid,
 	std::optional<DXGI_FORMAT> format, std::optional<TextureType> viewDimension, std::optional<UINT> mostDetailedMip,
 	std::optional<UINT> mipLevels, std::optional<UINT> firstArraySlice, std::optional<UINT> arraySize)
 {
+	SGCaptureScope capture(SGCaptureCall::CREATE_TEXTURE_SRV_ARRAY, guid, textureGuid, format, viewDimension, mostDetailedMip, mipLevels, firstArraySlice, arraySize);
 	if constexpr (DEBUG_VERSION)
 	{
 		if (!textures.Exists(textureGuid))
@@ -177,6 +414,7 @@ SG::SGResult SG::D3D11TextureHandler::CreateSRVTextureArray(const SGGuid & guid,
 		return SGResult::FAIL;
 
 	toStore.resourceGuid = textureGuid;
+	toStore.resource = textureData.texture.texture2D;
 	views.AddElement(guid, std::move(toStore));
 
 	return SGResult::OK;
@@ -186,6 +424,7 @@ SG::SGResult SG::D3D11TextureHandler::CreateUAV(const SGGuid & guid, const SGGui
 	std::optional<DXGI_FORMAT> format, std::optional<TextureType> viewDimension, std::optional<UINT> mipSlice,
 	std::optional<UINT> firstWSlice, std::optional<UINT> wSize)
 {
+	SGCaptureScope capture(SGCaptureCall::CREATE_TEXTURE_UAV, guid, textureGuid, format, viewDimension, mipSlice, firstWSlice, wSize);
 	if constexpr (DEBUG_VERSION)
 	{
 		if (!textures.Exists(textureGuid))
@@ -225,6 +464,7 @@ SG::SGResult SG::D3D11TextureHandler::CreateUAV(const SGGuid & guid, const SGGui
 		return SGResult::FAIL;
 
 	toStore.resourceGuid = textureGuid;
+	toStore.resource = textureData.texture.texture2D;
 	views.AddElement(guid, std::move(toStore));
 
 	return SGResult::OK;
@@ -234,6 +474,7 @@ SG::SGResult SG::D3D11TextureHandler::CreateUAVTextureArray(const SGGuid & guid,
 	std::optional<DXGI_FORMAT> format, std::optional<TextureType> viewDimension, std::optional<UINT> mipSlice,
 	std::optional<UINT> firstArraySlice, std::optional<UINT> arraySize)
 {
+	SGCaptureScope capture(SGCaptureCall::CREATE_TEXTURE_UAV_ARRAY, guid, textureGuid, format, viewDimension, mipSlice, firstArraySlice, arraySize);
 	if constexpr (DEBUG_VERSION)
 	{
 		if (!textures.Exists(textureGuid))
@@ -271,6 +512,7 @@ SG::SGResult SG::D3D11TextureHandler::CreateUAVTextureArray(const SGGuid & guid,
 		return SGResult::FAIL;
 
 	toStore.resourceGuid = textureGuid;
+	toStore.resource = textureData.texture.texture2D;
 	views.AddElement(guid, std::move(toStore));
 
 	return SGResult::OK;
@@ -280,6 +522,7 @@ SG::SGResult SG::D3D11TextureHandler::CreateRTV(const SGGuid & guid, const SGGui
 	std::optional<DXGI_FORMAT> format, std::optional<TextureType> viewDimension,
 	std::optional<UINT> mipSlice, std::optional<UINT> firstWSlice, std::optional<UINT> wSize)
 {
+	SGCaptureScope capture(SGCaptureCall::CREATE_RTV, guid, textureGuid, format, viewDimension, mipSlice, firstWSlice, wSize);
 	if constexpr (DEBUG_VERSION)
 	{
 		if (!textures.Exists(textureGuid))
@@ -322,6 +565,7 @@ SG::SGResult SG::D3D11TextureHandler::CreateRTV(const SGGuid & guid, const SGGui
 		return SGResult::FAIL;
 
 	toStore.resourceGuid = textureGuid;
+	toStore.resource = textureData.texture.texture2D;
 	views.AddElement(guid, std::move(toStore));
 
 	return SGResult::OK;
@@ -334,6 +578,7 @@ SG::SGResult SG::D3D11TextureHandler::CreateRTVTextureArray(const SGGuid& guid,
 	std::optional<UINT> firstArraySlice,
 	std::optional<UINT> arraySize)
 {
+	SGCaptureScope capture(SGCaptureCall::CREATE_RTV_ARRAY, guid, textureGuid, format, viewDimension, mipSlice, firstArraySlice, arraySize);
 	if constexpr (DEBUG_VERSION)
 	{
 		if (!textures.Exists(textureGuid))
@@ -376,6 +621,7 @@ SG::SGResult SG::D3D11TextureHandler::CreateRTVTextureArray(const SGGuid& guid,
 		return SGResult::FAIL;
 
 	toStore.resourceGuid = textureGuid;
+	toStore.resource = textureData.texture.texture2D;
 	views.AddElement(guid, std::move(toStore));
 
 	return SGResult::OK;
@@ -388,6 +634,7 @@ SG::SGResult SG::D3D11TextureHandler::CreateDSV(const SGGuid & guid, const SGGui
 	std::optional<bool> readOnlyStencil,
 	std::optional<UINT> mipSlice)
 {
+	SGCaptureScope capture(SGCaptureCall::CREATE_DSV, guid, textureGuid, format, viewDimension, readOnlyDepth, readOnlyStencil, mipSlice);
 	if constexpr (DEBUG_VERSION)
 	{
 		if (!textures.Exists(textureGuid))
@@ -427,6 +674,7 @@ SG::SGResult SG::D3D11TextureHandler::CreateDSV(const SGGuid & guid, const SGGui
 		return SGResult::FAIL;
 
 	toStore.resourceGuid = textureGuid;
+	toStore.resource = textureData.texture.texture2D;
 	views.AddElement(guid, std::move(toStore));
 
 	return SGResult::OK;
@@ -441,6 +689,7 @@ SG::SGResult SG::D3D11TextureHandler::CreateDSVTextureArray(const SGGuid & guid,
 	std::optional<UINT> firstArraySlice,
 	std::optional<UINT> arraySize)
 {
+	SGCaptureScope capture(SGCaptureCall::CREATE_DSV_ARRAY, guid, textureGuid, format, viewDimension, readOnlyDepth, readOnlyStencil, mipSlice, firstArraySlice, arraySize);
 	if constexpr (DEBUG_VERSION)
 	{
 		if (!textures.Exists(textureGuid))
@@ -487,6 +736,26 @@ SG::SGResult SG::D3D11TextureHandler::CreateDSVTextureArray(const SGGuid & guid,
 		return SGResult::FAIL;
 
 	toStore.resourceGuid = textureGuid;
+	toStore.resource = textureData.texture.texture2D;
+	views.AddElement(guid, std::move(toStore));
+
+	return SGResult::OK;
+}
+
+SG::SGResult SG::D3D11TextureHandler::CreatePlaceholderView(const SGGuid & guid, const SGGuid & placeholderGuid)
+{
+	SGCaptureScope capture(SGCaptureCall::CREATE_PLACEHOLDER_VIEW, guid, placeholderGuid);
+	if (!views.Exists(placeholderGuid))
+		return SG::SGResult::GUID_MISSING;
+
+	// Shares the view of the placeholder, the reference added here is released when the real view replaces it
+	const D3D11ResourceViewData& placeholder = views.GetElement(placeholderGuid);
+	D3D11ResourceViewData toStore;
+	toStore.type = placeholder.type;
+	toStore.view.srv = placeholder.view.srv;
+	toStore.view.srv->AddRef();
+	toStore.resourceGuid = placeholder.resourceGuid;
+	toStore.resource = placeholder.resource;
 	views.AddElement(guid, std::move(toStore));
 
 	return SGResult::OK;
@@ -494,16 +763,19 @@ SG::SGResult SG::D3D11TextureHandler::CreateDSVTextureArray(const SGGuid & guid,
 
 void SG::D3D11TextureHandler::RemoveView(const SGGuid& guid)
 {
+	SGCaptureScope capture(SGCaptureCall::REMOVE_TEXTURE_VIEW, guid);
 	views.RemoveElement(guid);
 }
 
 SG::SGResult SG::D3D11TextureHandler::BindViewToEntity(const SGGraphicalEntityID & entity, const SGGuid & viewGuid, const SGGuid & bindGuid)
 {
+	SGCaptureScope capture(SGCaptureCall::BIND_TEXTURE_VIEW_TO_ENTITY, entity, viewGuid, bindGuid);
 	return SG::SGGraphicsHandler::BindElementToEntity(entity, viewGuid, bindGuid, views);
 }
 
 SG::SGResult SG::D3D11TextureHandler::BindViewToGroup(const SGGuid & group, const SGGuid & viewGuid, const SGGuid & bindGuid)
 {
+	SGCaptureScope capture(SGCaptureCall::BIND_TEXTURE_VIEW_TO_GROUP, group, viewGuid, bindGuid);
 	return SG::SGGraphicsHandler::BindElementToGroup(group, viewGuid, bindGuid, views);
 }
 
@@ -517,6 +789,8 @@ void SG::D3D11TextureHandler::AddTexture2D(const SGGuid & guid, ID3D11Texture2D
 
 void SG::D3D11TextureHandler::FinishFrame()
 {
+	SGTraceScope scope("D3D11TextureHandler::FinishFrame");
+
 	// No need to lock since this function is called only by the render engine during certain conditions
 	SGGraphicsHandler::FinishFrame();
 
@@ -524,7 +798,16 @@ void SG::D3D11TextureHandler::FinishFrame()
 	views.FinishFrame();
 	
 	for (auto& guid : updatedFrameBuffer)
-		textures[guid].updatedData.SwitchUpdateBuffer();
+	{
+		TripleBufferedData<SGRegionStaging>& updatedData = textures.GetElement(guid).updatedData;
+
+		// Regions of an earlier frame the render thread has not switched to yet go before the new ones, so skipped frames lose nothing
+		if (&updatedData.GetLastUpdated() != &updatedData.GetActive())
+			updatedData.GetToUpdate().TakePending(updatedData.GetLastUpdated());
+
+		updatedData.SwitchUpdateBuffer();
+		updatedData.GetToUpdate().Clear();
+	}
 
 	updatedTotalBuffer.insert(updatedTotalBuffer.end(), updatedFrameBuffer.begin(), updatedFrameBuffer.end());
 	updatedFrameBuffer.clear();
@@ -532,87 +815,159 @@ void SG::D3D11TextureHandler::FinishFrame()
 
 void SG::D3D11TextureHandler::SwapFrame()
 {
+	SGTraceScope scope("D3D11TextureHandler::SwapFrame");
+
 	// No need to lock since this function is called only by the render engine during certain conditions
 	SGGraphicsHandler::SwapFrame();
 
-	textures.UpdateActive();
-	views.UpdateActive();
+	changedViews.clear();
+	size_t nrOfOperations = textures.UpdateActive();
+	nrOfOperations += views.UpdateActive(&changedViews);
+	SGProfiler::Count(SGCounter::FRAME_MAP_OPERATIONS, nrOfOperations);
 	
 	for (auto& guid : updatedTotalBuffer)
-		textures[guid].updatedData.SwitchActiveBuffer();
+	{
+		if (!textures.HasElement(guid))
+			continue;
+
+		TripleBufferedData<SGRegionStaging>& updatedData = textures[guid].updatedData;
+		SGRegionStaging& previous = updatedData.GetActive();
+		updatedData.SwitchActiveBuffer();
+
+		// Regions the budget held back are uploaded before the newer ones
+		if (&updatedData.GetActive() != &previous)
+			updatedData.GetActive().TakePending(previous);
+
+		if (updatedData.GetActive().Pending() && std::find(pendingUploads.begin(), pendingUploads.end(), guid) == pendingUploads.end())
+			pendingUploads.push_back(guid);
+	}
 
 	updatedTotalBuffer.clear();
 }
 
-ID3D11ShaderResourceView * SG::D3D11TextureHandler::GetSRV(const SGGuid & guid)
+void SG::D3D11TextureHandler::UploadUpdates(ID3D11DeviceContext * context)
 {
-	void* toReturn = SG::D3D11GraphicsHandler::GetGlobalResourceView(guid, ResourceViewType::SRV, views, "texture");
+	SGTraceScope scope("D3D11TextureHandler::UploadUpdates");
+
+	size_t uploaded = 0;
+	size_t nrOfPending = 0;
+
+	for (auto& guid : pendingUploads)
+	{
+		if (!textures.HasElement(guid))
+			continue;
+
+		D3D11TextureData& textureData = textures[guid];
+		SGRegionStaging& staging = textureData.updatedData.GetActive();
+
+		// A region larger than the whole budget is uploaded when it is the first of the frame, or it would never be
+		while (staging.Pending() && (uploaded == 0 || uploaded + staging.NextRegion().GetSize() <= updateBudgetPerFrame))
+		{
+			const SGStagedRegion& staged = staging.NextRegion();
+			const SGUpdateRegion& region = staged.region;
+			D3D11_BOX box = { region.left, region.top, region.front, region.right, region.bottom, region.back };
+			SGProfiler::Count(SGCounter::BYTES_UPLOADED, staged.GetSize());
+			context->UpdateSubresource(GetResource(textureData), region.subresource, &box, staging.GetData(staged),
+				static_cast<UINT>(staged.rowSize), static_cast<UINT>(staged.rowSize * staged.nrOfRows));
+			uploaded += staged.GetSize();
+			staging.PopRegion();
+		}
+
+		if (staging.Pending())
+			pendingUploads[nrOfPending++] = guid;
+		else
+			textureData.updatedData.MarkAsNotUpdated();
+	}
+
+	pendingUploads.resize(nrOfPending);
+}
+
+bool SG::D3D11TextureHandler::GetBoundView(const SGGuid & bindGuid, const SGGraphicalEntityID & entity, const SGGuid & groupGuid, SGGuid & viewGuid)
+{
+	if (entityData.HasElement(entity) && entityData[entity].HasElement(bindGuid))
+	{
+		viewGuid = entityData[entity][bindGuid].GetActive();
+		return true;
+	}
+
+	if (groupData.HasElement(groupGuid) && groupData[groupGuid].HasElement(bindGuid))
+	{
+		viewGuid = groupData[groupGuid][bindGuid].GetActive();
+		return true;
+	}
+
+	return false;
+}
+
+ID3D11ShaderResourceView * SG::D3D11TextureHandler::GetSRV(const SGGuid & guid, ID3D11Resource ** resource)
+{
+	void* toReturn = SG::D3D11GraphicsHandler::GetGlobalResourceView(guid, ResourceViewType::SRV, views, "texture", resource);
 	return static_cast<ID3D11ShaderResourceView*>(toReturn);
 }
 
-ID3D11ShaderResourceView * SG::D3D11TextureHandler::GetSRV(const SGGuid & guid, const SGGuid & groupGuid)
+ID3D11ShaderResourceView * SG::D3D11TextureHandler::GetSRV(const SGGuid & guid, const SGGuid & groupGuid, ID3D11Resource ** resource)
 {
-	void* toReturn = SG::D3D11GraphicsHandler::GetGroupResourceView(guid, groupGuid, ResourceViewType::SRV, views, "texture");
+	void* toReturn = SG::D3D11GraphicsHandler::GetGroupResourceView(guid, groupGuid, ResourceViewType::SRV, views, "texture", resource);
 	return static_cast<ID3D11ShaderResourceView*>(toReturn);
 }
 
-ID3D11ShaderResourceView * SG::D3D11TextureHandler::GetSRV(const SGGuid & guid, const SGGraphicalEntityID & entity)
+ID3D11ShaderResourceView * SG::D3D11TextureHandler::GetSRV(const SGGuid & guid, const SGGraphicalEntityID & entity, ID3D11Resource ** resource)
 {
-	void* toReturn = SG::D3D11GraphicsHandler::GetEntityResourceView(guid, entity, ResourceViewType::SRV, views, "texture");
+	void* toReturn = SG::D3D11GraphicsHandler::GetEntityResourceView(guid, entity, ResourceViewType::SRV, views, "texture", resource);
 	return static_cast<ID3D11ShaderResourceView*>(toReturn);
 }
 
-ID3D11UnorderedAccessView * SG::D3D11TextureHandler::GetUAV(const SGGuid & guid)
+ID3D11UnorderedAccessView * SG::D3D11TextureHandler::GetUAV(const SGGuid & guid, ID3D11Resource ** resource)
 {
-	void* toReturn = SG::D3D11GraphicsHandler::GetGlobalResourceView(guid, ResourceViewType::UAV, views, "texture");
+	void* toReturn = SG::D3D11GraphicsHandler::GetGlobalResourceView(guid, ResourceViewType::UAV, views, "texture", resource);
 	return static_cast<ID3D11UnorderedAccessView*>(toReturn);
 }
 
-ID3D11UnorderedAccessView * SG::D3D11TextureHandler::GetUAV(const SGGuid & guid, const SGGuid & groupGuid)
+ID3D11UnorderedAccessView * SG::D3D11TextureHandler::GetUAV(const SGGuid & guid, const SGGuid & groupGuid, ID3D11Resource ** resource)
 {
-	void* toReturn = SG::D3D11GraphicsHandler::GetGroupResourceView(guid, groupGuid, ResourceViewType::UAV, views, "texture");
+	void* toReturn = SG::D3D11GraphicsHandler::GetGroupResourceView(guid, groupGuid, ResourceViewType::UAV, views, "texture", resource);
 	return static_cast<ID3D11UnorderedAccessView*>(toReturn);
 }
 
-ID3D11UnorderedAccessView * SG::D3D11TextureHandler::GetUAV(const SGGuid & guid, const SGGraphicalEntityID & entity)
+ID3D11UnorderedAccessView * SG::D3D11TextureHandler::GetUAV(const SGGuid & guid, const SGGraphicalEntityID & entity, ID3D11Resource ** resource)
 {
-	void* toReturn = SG::D3D11GraphicsHandler::GetEntityResourceView(guid, entity, ResourceViewType::UAV, views, "texture");
+	void* toReturn = SG::D3D11GraphicsHandler::GetEntityResourceView(guid, entity, ResourceViewType::UAV, views, "texture", resource);
 	return static_cast<ID3D11UnorderedAccessView*>(toReturn);
 }
 
-ID3D11RenderTargetView * SG::D3D11TextureHandler::GetRTV(const SGGuid & guid)
+ID3D11RenderTargetView * SG::D3D11TextureHandler::GetRTV(const SGGuid & guid, ID3D11Resource ** resource)
 {
-	void* toReturn = SG::D3D11GraphicsHandler::GetGlobalResourceView(guid, ResourceViewType::RTV, views, "texture");
+	void* toReturn = SG::D3D11GraphicsHandler::GetGlobalResourceView(guid, ResourceViewType::RTV, views, "texture", resource);
 	return static_cast<ID3D11RenderTargetView*>(toReturn);
 }
 
-ID3D11RenderTargetView * SG::D3D11TextureHandler::GetRTV(const SGGuid & guid, const SGGuid & groupGuid)
+ID3D11RenderTargetView * SG::D3D11TextureHandler::GetRTV(const SGGuid & guid, const SGGuid & groupGuid, ID3D11Resource ** resource)
 {
-	void* toReturn = SG::D3D11GraphicsHandler::GetGroupResourceView(guid, groupGuid, ResourceViewType::RTV, views, "texture");
+	void* toReturn = SG::D3D11GraphicsHandler::GetGroupResourceView(guid, groupGuid, ResourceViewType::RTV, views, "texture", resource);
 	return static_cast<ID3D11RenderTargetView*>(toReturn);
 }
 
-ID3D11RenderTargetView * SG::D3D11TextureHandler::GetRTV(const SGGuid & guid, const SGGraphicalEntityID & entity)
+ID3D11RenderTargetView * SG::D3D11TextureHandler::GetRTV(const SGGuid & guid, const SGGraphicalEntityID & entity, ID3D11Resource ** resource)
 {
-	void* toReturn = SG::D3D11GraphicsHandler::GetEntityResourceView(guid, entity, ResourceViewType::RTV, views, "texture");
+	void* toReturn = SG::D3D11GraphicsHandler::GetEntityResourceView(guid, entity, ResourceViewType::RTV, views, "texture", resource);
 	return static_cast<ID3D11RenderTargetView*>(toReturn);
 }
 
-ID3D11DepthStencilView * SG::D3D11TextureHandler::GetDSV(const SGGuid & guid)
+ID3D11DepthStencilView * SG::D3D11TextureHandler::GetDSV(const SGGuid & guid, ID3D11Resource ** resource)
 {
-	void* toReturn = SG::D3D11GraphicsHandler::GetGlobalResourceView(guid, ResourceViewType::DSV, views, "texture");
+	void* toReturn = SG::D3D11GraphicsHandler::GetGlobalResourceView(guid, ResourceViewType::DSV, views, "texture", resource);
 	return static_cast<ID3D11DepthStencilView*>(toReturn);
 }
 
-ID3D11DepthStencilView * SG::D3D11TextureHandler::GetDSV(const SGGuid & guid, const SGGuid & groupGuid)
+ID3D11DepthStencilView * SG::D3D11TextureHandler::GetDSV(const SGGuid & guid, const SGGuid & groupGuid, ID3D11Resource ** resource)
 {
-	void* toReturn = SG::D3D11GraphicsHandler::GetGroupResourceView(guid, groupGuid, ResourceViewType::DSV, views, "texture");
+	void* toReturn = SG::D3D11GraphicsHandler::GetGroupResourceView(guid, groupGuid, ResourceViewType::DSV, views, "texture", resource);
 	return static_cast<ID3D11DepthStencilView*>(toReturn);
 }
 
-ID3D11DepthStencilView * SG::D3D11TextureHandler::GetDSV(const SGGuid & guid, const SGGraphicalEntityID & entity)
+ID3D11DepthStencilView * SG::D3D11TextureHandler::GetDSV(const SGGuid & guid, const SGGraphicalEntityID & entity, ID3D11Resource ** resource)
 {
-	void* toReturn = SG::D3D11GraphicsHandler::GetEntityResourceView(guid, entity, ResourceViewType::DSV, views, "texture");
+	void* toReturn = SG::D3D11GraphicsHandler::GetEntityResourceView(guid, entity, ResourceViewType::DSV, views, "texture", resource);
 	return static_cast<ID3D11DepthStencilView*>(toReturn);
 }
 
@@ -864,3 +1219,196 @@ SG::D3D11TextureHandler::TextureDesc SG::D3D11TextureHandler::GetDesc(const D3D1
 
 	return toReturn;
 }
+
+ID3D11Resource * SG::D3D11TextureHandler::GetResource(const D3D11TextureData & storedData)
+{
+	switch (storedData.type)
+	{
+	case TextureType::TEXTURE_1D:
+	case TextureType::TEXTURE_ARRAY_1D:
+		return storedData.texture.texture1D;
+	case TextureType::TEXTURE_3D:
+		return storedData.texture.texture3D;
+	default:
+		return storedData.texture.texture2D;
+	}
+}
+
+bool SG::D3D11TextureHandler::GetSubresourceInfo(const D3D11TextureData & storedData, UINT subresource, SubresourceInfo & info)
+{
+	TextureDesc desc = GetDesc(storedData);
+	UINT mipLevels = 0;
+	UINT nrOfSubresources = 0;
+	info.height = 1;
+	info.depth = 1;
+	info.sampleCount = 1;
+
+	switch (storedData.type)
+	{
+	case TextureType::TEXTURE_1D:
+	case TextureType::TEXTURE_ARRAY_1D:
+		info.format = desc.desc1D.Format;
+		info.width = desc.desc1D.Width;
+		info.usage = desc.desc1D.Usage;
+		info.bindFlags = desc.desc1D.BindFlags;
+		mipLevels = desc.desc1D.MipLevels;
+		nrOfSubresources = mipLevels * desc.desc1D.ArraySize;
+		break;
+	case TextureType::TEXTURE_3D:
+		info.format = desc.desc3D.Format;
+		info.width = desc.desc3D.Width;
+		info.height = desc.desc3D.Height;
+		info.depth = desc.desc3D.Depth;
+		info.usage = desc.desc3D.Usage;
+		info.bindFlags = desc.desc3D.BindFlags;
+		mipLevels = desc.desc3D.MipLevels;
+		nrOfSubresources = mipLevels;
+		break;
+	default:
+		info.format = desc.desc2D.Format;
+		info.width = desc.desc2D.Width;
+		info.height = desc.desc2D.Height;
+		info.usage = desc.desc2D.Usage;
+		info.bindFlags = desc.desc2D.BindFlags;
+		info.sampleCount = desc.desc2D.SampleDesc.Count;
+		mipLevels = desc.desc2D.MipLevels;
+		nrOfSubresources = mipLevels * desc.desc2D.ArraySize;
+		break;
+	}
+
+	if (subresource >= nrOfSubresources)
+		return false;
+
+	info.width = GetMipDimension(info.width, subresource % mipLevels);
+	info.height = GetMipDimension(info.height, subresource % mipLevels);
+	info.depth = GetMipDimension(info.depth, subresource % mipLevels);
+	return true;
+}
+
+SG::SGTextureData SG::D3D11TextureHandler::GetPackedSettings(const SGPackedTexture & packed, const SGTextureData & generalSettings)
+{
+	SGTextureData toReturn = generalSettings;
+	toReturn.format = static_cast<DXGI_FORMAT>(packed.format);
+	toReturn.mipLevels = packed.mipLevels;
+	toReturn.generateMips = false;
+	toReturn.rowPitches = packed.rowPitches;
+	toReturn.data.clear();
+
+	// The device only reads the initial data, so the read only mapping of the pack can be handed to it directly
+	for (auto& subresource : packed.data)
+		toReturn.data.push_back(const_cast<void*>(subresource));
+
+	return toReturn;
+}
+
+UINT SG::D3D11TextureHandler::GetMipLevels(const SGTextureData & generalSettings, UINT width, UINT height, UINT depth)
+{
+	return generalSettings.mipLevels != 0 ? generalSettings.mipLevels : GetNrOfMipLevels(width, height, depth);
+}
+
+bool SG::D3D11TextureHandler::GetInitialData(const SGTextureData & generalSettings, UINT width, UINT height, UINT depth, UINT mipLevels, UINT nrOfSlices,
+	std::vector<D3D11_SUBRESOURCE_DATA>& data)
+{
+	UINT nrOfSubresources = mipLevels * nrOfSlices;
+
+	if (generalSettings.data.size() < nrOfSubresources)
+		return false;
+
+	if (generalSettings.rowPitches.size() && generalSettings.rowPitches.size() < generalSettings.data.size())
+		return false;
+
+	data.resize(nrOfSubresources);
+
+	for (UINT i = 0; i < nrOfSubresources; ++i)
+	{
+		SGSubresourcePitch pitch = GetSubresourcePitch(generalSettings.format, width, height, depth, mipLevels, i);
+		size_t rowPitch = generalSettings.rowPitches.size() ? generalSettings.rowPitches[i] : pitch.rowPitch;
+
+		if (rowPitch == 0)
+			return false;
+
+		data[i].pSysMem = generalSettings.data[i];
+		data[i].SysMemPitch = static_cast<UINT>(rowPitch);
+		data[i].SysMemSlicePitch = static_cast<UINT>(rowPitch * pitch.nrOfRows);
+	}
+
+	return true;
+}
+
+bool SG::D3D11TextureHandler::CanGenerateMips(const SGTextureData & generalSettings, UINT nrOfSlices)
+{
+	// Only the most detailed mip of every slice is given, and in a format the mip generator can read
+	if (generalSettings.mipLevels == 1 || generalSettings.data.size() != nrOfSlices || generalSettings.rowPitches.size())
+		return false;
+
+	switch (generalSettings.format)
+	{
+	case DXGI_FORMAT_R8G8B8A8_UNORM:
+	case DXGI_FORMAT_R8G8B8A8_UNORM_SRGB:
+	case DXGI_FORMAT_B8G8R8A8_UNORM:
+	case DXGI_FORMAT_B8G8R8A8_UNORM_SRGB:
+		return true;
+	default:
+		return false;
+	}
+}
+
+bool SG::D3D11TextureHandler::GenerateInitialMips(const SGTextureData & generalSettings, UINT width, UINT height, UINT depth, SGTextureData & withMips,
+	std::vector<SGMipImage>& mips)
+{
+	SGMipSettings mipSettings;
+	mipSettings.srgb = generalSettings.format == DXGI_FORMAT_R8G8B8A8_UNORM_SRGB || generalSettings.format == DXGI_FORMAT_B8G8R8A8_UNORM_SRGB;
+	mipSettings.mipLevels = generalSettings.mipLevels;
+
+	SGMipImage source;
+	source.width = width;
+	source.height = height;
+	source.depth = depth;
+	std::vector<SGMipImage> sliceMips;
+
+	for (auto& slice : generalSettings.data)
+	{
+		const unsigned char* texels = static_cast<const unsigned char*>(slice);
+		source.texels.assign(texels, texels + static_cast<size_t>(width) * height * depth * 4);
+
+		if (GenerateMips(source, mipSettings, sliceMips, nullptr) != SGResult::OK)
+			return false;
+
+		for (auto& mip : sliceMips)
+			mips.push_back(std::move(mip));
+	}
+
+	withMips = generalSettings;
+	withMips.mipLevels = static_cast<UINT>(sliceMips.size());
+	withMips.data.clear();
+
+	for (auto& mip : mips)
+		withMips.data.push_back(mip.texels.data());
+
+	return true;
+}
+
+bool SG::D3D11TextureHandler::ValidBlockDimensions(DXGI_FORMAT format, UINT width, UINT height)
+{
+	// The most detailed mip of a block compressed texture has to consist of whole blocks, the smaller mips are padded
+	if (!IsBlockCompressed(format))
+		return true;
+
+	SGFormatInfo info = GetFormatInfo(format);
+	return width % info.blockWidth == 0 && height % info.blockHeight == 0;
+}
+
+DXGI_FORMAT SG::D3D11TextureHandler::GetCompressedFormat(SGBlockFormat format, bool srgb)
+{
+	switch (format)
+	{
+	case SGBlockFormat::BC1:
+		return srgb ? DXGI_FORMAT_BC1_UNORM_SRGB : DXGI_FORMAT_BC1_UNORM;
+	case SGBlockFormat::BC3:
+		return srgb ? DXGI_FORMAT_BC3_UNORM_SRGB : DXGI_FORMAT_BC3_UNORM;
+	case SGBlockFormat::BC5:
+		return DXGI_FORMAT_BC5_UNORM; // Two channels are data such as normals, never colour
+	default:
+		return srgb ? DXGI_FORMAT_BC7_UNORM_SRGB : DXGI_FORMAT_BC7_UNORM;
+	}
+}
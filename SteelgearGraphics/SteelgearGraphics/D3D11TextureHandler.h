@@ -1,5 +1,6 @@
 #pragma once
 
+#include <mutex>
 #include <optional>
 
 #include <d3d11_4.h>
@@ -8,6 +9,9 @@
 
 #include "D3D11CommonTypes.h"
 #include "D3D11TextureData.h"
+#include "SGAssetPack.h"
+#include "SGBlockCompressor.h"
+#include "SGMipGenerator.h"
 
 namespace SG
 {
@@ -30,9 +34,8 @@ namespace SG
 		std::vector<TextureBinding> textureBindings;
 		bool generateMips;
 		bool resourceClamp;
-		std::vector<void*> data;
-		//UINT bytesPerRow;
-		//UINT rowsPerSlice;
+		std::vector<void*> data; // When only mip 0 of every slice is given in an 8 bit RGBA or BGRA format, the other mips are generated on the CPU
+		std::vector<UINT> rowPitches; // One per entry in data, rows are assumed to be tightly packed when empty
 	};
 
 	class D3D11TextureHandler : public D3D11GraphicsHandler
@@ -40,14 +43,27 @@ namespace SG
 	public:
 
 
-		D3D11TextureHandler(ID3D11Device* device);
+		D3D11TextureHandler(ID3D11Device* device, SGLoadQueue* loadQueue, size_t updateBudgetPerFrame);
 		~D3D11TextureHandler() = default;
 
 		SGResult CreateTexture1D(const SGGuid& guid, const SGTextureData& generalSettings, UINT width, UINT arraySize);
 		SGResult CreateTexture2D(const SGGuid& guid, const SGTextureData& generalSettings, UINT width, UINT height, UINT arraySize, const DXGI_SAMPLE_DESC& sampleDesc, bool texturecube);
+		SGResult CreateCompressedTexture2D(const SGGuid& guid, const SGTextureData& generalSettings, UINT width, UINT height, UINT arraySize,
+			const SGCompressionSettings& compression, bool texturecube = false, SGThreadPool* threadPool = nullptr); // data is 8 bit RGBA, mips are generated when only mip 0 is given
+		SGResult CreateTexture2DAsync(const SGGuid& guid, const SGTextureData& generalSettings, UINT width, UINT height, UINT arraySize, const DXGI_SAMPLE_DESC& sampleDesc, bool texturecube,
+			const SGLoadCallback& onComplete = nullptr); // Created on a loader thread, the initial data has to stay valid until onComplete is called
+		SGResult CreatePackedTexture(const SGGuid& guid, const SGPackedTexture& packed, const SGTextureData& generalSettings); // Format, mips and data are taken from the pack
+		SGResult CreatePackedTextureAsync(const SGGuid& guid, const SGPackedTexture& packed, const SGTextureData& generalSettings, const SGLoadCallback& onComplete = nullptr);
 		SGResult CreateTexture3D(const SGGuid& guid, const SGTextureData& generalSettings, UINT width, UINT height, UINT depth);
 		void RemoveTexture(const SGGuid& guid);
 
+		/**
+			Copies the region of the subresource into staging memory, it is uploaded after the frame is rendered and at most updateBudgetPerFrame bytes are uploaded each frame.
+			The whole subresource is updated without a box. Updates of the same texture in a frame that line up are uploaded as one region.
+			A rowPitch of 0 means the rows are tightly packed, slices always follow each other directly
+		*/
+		SGResult UpdateTexture(const SGGuid& guid, UINT subresource, const std::optional<D3D11_BOX>& box, const void* data, UINT rowPitch = 0);
+
 		SGResult CreateSRV(const SGGuid& guid, const SGGuid& textureGuid,
 			std::optional<DXGI_FORMAT> format = std::nullopt,
 			std::optional<TextureType> viewDimension = std::nullopt,
@@ -102,6 +118,10 @@ namespace SG
 			std::optional<UINT> firstArraySlice = std::nullopt,
 			std::optional<UINT> arraySize = std::nullopt);
 
+		/**
+			guid refers to the same view as placeholderGuid until a view is created with guid, so it can be bound while its texture is loading
+		*/
+		SGResult CreatePlaceholderView(const SGGuid& guid, const SGGuid& placeholderGuid);
 		void RemoveView(const SGGuid& guid);
 
 		SGResult BindViewToEntity(const SGGraphicalEntityID& entity, const SGGuid& viewGuid, const SGGuid& bindGuid);
@@ -110,6 +130,7 @@ namespace SG
 	private:
 
 		friend class D3D11RenderEngine;
+		friend class D3D11Readback;
 
 		union TextureDesc
 		{
@@ -124,13 +145,30 @@ namespace SG
 			}
 		};
 
+		// The mip a subresource is part of
+		struct SubresourceInfo
+		{
+			DXGI_FORMAT format;
+			UINT width;
+			UINT height;
+			UINT depth;
+			D3D11_USAGE usage;
+			UINT bindFlags;
+			UINT sampleCount;
+		};
+
 		FrameMap<SGGuid, D3D11TextureData> textures;
 		FrameMap<SGGuid, D3D11ResourceViewData> views;
+		std::vector<SGGuid> changedViews; // Added or removed by the last swap
 
 		std::vector<SGGuid> updatedFrameBuffer;
 		std::vector<SGGuid> updatedTotalBuffer;
+		std::mutex frameBufferMutex;
+		std::vector<SGGuid> pendingUploads; // Textures with staged regions left to upload, only used by the render thread
+		size_t updateBudgetPerFrame;
 
 		ID3D11Device* device;
+		SGLoadQueue* loadQueue;
 
 		void SetUsageAndCPUAccessFlags(const SGTextureData & generalSettings, D3D11_USAGE& usage, UINT& cpuAccessFlags);
 		void SetBindflags(const SGTextureData & generalSettings, UINT& flags);
@@ -140,26 +178,39 @@ namespace SG
 		D3D11_DSV_DIMENSION GetDSVDimension(TextureType type);
 
 		TextureDesc GetDesc(const D3D11TextureData& storedData);
+		ID3D11Resource* GetResource(const D3D11TextureData& storedData);
+		bool GetSubresourceInfo(const D3D11TextureData& storedData, UINT subresource, SubresourceInfo& info); // False if there is no such subresource
+		SGTextureData GetPackedSettings(const SGPackedTexture& packed, const SGTextureData& generalSettings);
+		UINT GetMipLevels(const SGTextureData& generalSettings, UINT width, UINT height, UINT depth); // 0 is resolved to the full chain
+		bool GetInitialData(const SGTextureData& generalSettings, UINT width, UINT height, UINT depth, UINT mipLevels, UINT nrOfSlices,
+			std::vector<D3D11_SUBRESOURCE_DATA>& data); // Rows are tightly packed unless pitches are given
+		bool ValidBlockDimensions(DXGI_FORMAT format, UINT width, UINT height);
+		DXGI_FORMAT GetCompressedFormat(SGBlockFormat format, bool srgb);
+		bool CanGenerateMips(const SGTextureData& generalSettings, UINT nrOfSlices);
+		bool GenerateInitialMips(const SGTextureData& generalSettings, UINT width, UINT height, UINT depth, SGTextureData& withMips,
+			std::vector<SGMipImage>& mips); // withMips points into mips
 
 		void AddTexture2D(const SGGuid& guid, ID3D11Texture2D* texture);
+		bool GetBoundView(const SGGuid& bindGuid, const SGGraphicalEntityID& entity, const SGGuid& groupGuid, SGGuid& viewGuid); // Entity binds take precedence over group binds
 
 		void FinishFrame() override;
 		void SwapFrame() override;
+		void UploadUpdates(ID3D11DeviceContext* context); // Staged regions in the order they were staged until the budget of the frame is used
 
-		ID3D11ShaderResourceView* GetSRV(const SGGuid& guid);
-		ID3D11ShaderResourceView* GetSRV(const SGGuid& guid, const SGGuid& groupGuid);
-		ID3D11ShaderResourceView* GetSRV(const SGGuid& guid, const SGGraphicalEntityID& entity);
+		ID3D11ShaderResourceView* GetSRV(const SGGuid& guid, ID3D11Resource** resource = nullptr);
+		ID3D11ShaderResourceView* GetSRV(const SGGuid& guid, const SGGuid& groupGuid, ID3D11Resource** resource = nullptr);
+		ID3D11ShaderResourceView* GetSRV(const SGGuid& guid, const SGGraphicalEntityID& entity, ID3D11Resource** resource = nullptr);
 
-		ID3D11UnorderedAccessView* GetUAV(const SGGuid& guid);
-		ID3D11UnorderedAccessView* GetUAV(const SGGuid& guid, const SGGuid& groupGuid);
-		ID3D11UnorderedAccessView* GetUAV(const SGGuid& guid, const SGGraphicalEntityID& entity);
+		ID3D11UnorderedAccessView* GetUAV(const SGGuid& guid, ID3D11Resource** resource = nullptr);
+		ID3D11UnorderedAccessView* GetUAV(const SGGuid& guid, const SGGuid& groupGuid, ID3D11Resource** resource = nullptr);
+		ID3D11UnorderedAccessView* GetUAV(const SGGuid& guid, const SGGraphicalEntityID& entity, ID3D11Resource** resource = nullptr);
 
-		ID3D11RenderTargetView* GetRTV(const SGGuid& guid);
-		ID3D11RenderTargetView* GetRTV(const SGGuid& guid, const SGGuid& groupGuid);
-		ID3D11RenderTargetView* GetRTV(const SGGuid& guid, const SGGraphicalEntityID& entity);
+		ID3D11RenderTargetView* GetRTV(const SGGuid& guid, ID3D11Resource** resource = nullptr);
+		ID3D11RenderTargetView* GetRTV(const SGGuid& guid, const SGGuid& groupGuid, ID3D11Resource** resource = nullptr);
+		ID3D11RenderTargetView* GetRTV(const SGGuid& guid, const SGGraphicalEntityID& entity, ID3D11Resource** resource = nullptr);
 
-		ID3D11DepthStencilView* GetDSV(const SGGuid& guid);
-		ID3D11DepthStencilView* GetDSV(const SGGuid& guid, const SGGuid& groupGuid);
-		ID3D11DepthStencilView* GetDSV(const SGGuid& guid, const SGGraphicalEntityID& entity);
+		ID3D11DepthStencilView* GetDSV(const SGGuid& guid, ID3D11Resource** resource = nullptr);
+		ID3D11DepthStencilView* GetDSV(const SGGuid& guid, const SGGuid& groupGuid, ID3D11Resource** resource = nullptr);
+		ID3D11DepthStencilView* GetDSV(const SGGuid& guid, const SGGraphicalEntityID& entity, ID3D11Resource** resource = nullptr);
 	};
 }
\ No newline at end of file
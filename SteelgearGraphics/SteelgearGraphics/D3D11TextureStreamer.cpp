@@ -0,0 +1,192 @@
+#include "D3D11TextureStreamer.h"
+
+#include <algorithm>
+
+SG::D3D11TextureStreamer::D3D11TextureStreamer(D3D11TextureHandler * textureHandler, SGLoadQueue * loadQueue, size_t budget) : residency(budget)
+{
+	this->textureHandler = textureHandler;
+	this->loadQueue = loadQueue;
+}
+
+SG::SGResult SG::D3D11TextureStreamer::AddStreamedTexture(const SGGuid & viewGuid, const SGTextureData & generalSettings, UINT width, UINT height, unsigned int minimumResidentMips)
+{
+	if (generalSettings.mipLevels == 0 || generalSettings.data.size() != generalSettings.mipLevels)
+		return SGResult::FAIL;
+
+	StreamedTexture toAdd;
+	toAdd.generalSettings = generalSettings;
+	toAdd.generalSettings.generateMips = false;
+	toAdd.width = width;
+	toAdd.height = height;
+
+	std::string identifier = viewGuid.GetIdentifier();
+	toAdd.textures[0] = SGGuid(identifier + "_STREAMED_0");
+	toAdd.textures[1] = SGGuid(identifier + "_STREAMED_1");
+
+	std::vector<size_t> mipSizes;
+
+	for (unsigned int i = 0; i < generalSettings.mipLevels; ++i)
+		mipSizes.push_back(GetMipSize(generalSettings.format, width, height, i));
+
+	// Streaming never makes a mip that is not whole blocks the most detailed one, since the texture could not be created from it
+	if (IsBlockCompressed(generalSettings.format))
+	{
+		SGFormatInfo formatInfo = GetFormatInfo(generalSettings.format);
+		unsigned int nrOfTopMips = 0;
+
+		while (nrOfTopMips < generalSettings.mipLevels && GetMipDimension(width, nrOfTopMips) % formatInfo.blockWidth == 0 &&
+			GetMipDimension(height, nrOfTopMips) % formatInfo.blockHeight == 0)
+			++nrOfTopMips;
+
+		if (nrOfTopMips != 0)
+			minimumResidentMips = std::max(minimumResidentMips, generalSettings.mipLevels - nrOfTopMips + 1);
+	}
+
+	residency.AddTexture(viewGuid, mipSizes, minimumResidentMips);
+	SGResult result = CreateResidentTexture(viewGuid, toAdd.textures[0], toAdd.generalSettings, width, height, residency.GetResidentMip(viewGuid));
+
+	if (result != SGResult::OK)
+	{
+		residency.RemoveTexture(viewGuid);
+		return result;
+	}
+
+	streamMutex.lock();
+	streamedTextures[viewGuid] = std::move(toAdd);
+	streamMutex.unlock();
+
+	return SGResult::OK;
+}
+
+void SG::D3D11TextureStreamer::RemoveStreamedTexture(const SGGuid & viewGuid)
+{
+	std::lock_guard<std::mutex> lock(streamMutex);
+	auto texture = streamedTextures.find(viewGuid);
+
+	if (texture == streamedTextures.end())
+		return;
+
+	// A change still in flight removes its texture when it finishes
+	residency.RemoveTexture(viewGuid);
+	textureHandler->RemoveView(viewGuid);
+	textureHandler->RemoveTexture(texture->second.textures[texture->second.activeTexture]);
+	streamedTextures.erase(texture);
+}
+
+void SG::D3D11TextureStreamer::RequestMip(const SGGuid & viewGuid, unsigned int mip, float priority)
+{
+	residency.RequestMip(viewGuid, mip, priority);
+}
+
+void SG::D3D11TextureStreamer::RequestScreenSize(const SGGuid & viewGuid, float screenSize, float viewportHeight, float priority)
+{
+	streamMutex.lock();
+	auto texture = streamedTextures.find(viewGuid);
+
+	if (texture == streamedTextures.end())
+	{
+		streamMutex.unlock();
+		return;
+	}
+
+	UINT width = texture->second.width;
+	UINT height = texture->second.height;
+	streamMutex.unlock();
+
+	// The screen size is a radius relative to half the viewport, so it is also the diameter relative to the whole viewport
+	residency.RequestMip(viewGuid, SGTextureResidency::MipForScreenSize(width, height, screenSize * viewportHeight), priority);
+}
+
+SG::SGTextureResidency * SG::D3D11TextureStreamer::Residency()
+{
+	return &residency;
+}
+
+void SG::D3D11TextureStreamer::FinishFrame()
+{
+	SGTraceScope scope("D3D11TextureStreamer::FinishFrame");
+
+	changes.clear();
+	residency.Update(changes);
+	std::lock_guard<std::mutex> lock(streamMutex);
+
+	for (auto& change : changes)
+	{
+		auto found = streamedTextures.find(change.guid);
+
+		if (found == streamedTextures.end())
+			continue;
+
+		StreamedTexture& texture = found->second;
+		unsigned int nextTexture = 1 - texture.activeTexture;
+		SGGuid textureGuid = texture.textures[nextTexture];
+		SGTextureData generalSettings = texture.generalSettings;
+		UINT width = texture.width;
+		UINT height = texture.height;
+		unsigned int residentMip = change.residentMip;
+		unsigned int previousResidentMip = change.previousResidentMip;
+		size_t uploadSize = 0;
+
+		for (unsigned int i = residentMip; i < generalSettings.mipLevels; ++i)
+			uploadSize += GetMipSize(generalSettings.format, width, height, i);
+
+		// The view was replaced when the load finished, so the previous texture is no longer used when this is called
+		SGLoadCallback onComplete = [this, textureGuid, nextTexture, previousResidentMip](const SGGuid& viewGuid, SGResult result)
+		{
+			std::lock_guard<std::mutex> lock(streamMutex);
+			auto found = streamedTextures.find(viewGuid);
+
+			if (found == streamedTextures.end())
+			{
+				textureHandler->RemoveTexture(textureGuid);
+				return;
+			}
+
+			if (result == SGResult::OK)
+			{
+				textureHandler->RemoveTexture(found->second.textures[found->second.activeTexture]);
+				found->second.activeTexture = nextTexture;
+			}
+			else
+			{
+				textureHandler->RemoveTexture(textureGuid);
+				residency.SetResidentMip(viewGuid, previousResidentMip);
+			}
+
+			residency.SetLocked(viewGuid, false);
+		};
+
+		SGGuid viewGuid = change.guid;
+		residency.SetLocked(viewGuid, true);
+		loadQueue->Enqueue(viewGuid, uploadSize, [=]()
+		{
+			return CreateResidentTexture(viewGuid, textureGuid, generalSettings, width, height, residentMip);
+		}, onComplete);
+	}
+}
+
+SG::SGResult SG::D3D11TextureStreamer::CreateResidentTexture(const SGGuid & viewGuid, const SGGuid & textureGuid, const SGTextureData & generalSettings,
+	UINT width, UINT height, unsigned int residentMip)
+{
+	SGTextureData residentSettings = generalSettings;
+	residentSettings.mipLevels = generalSettings.mipLevels - residentMip;
+	residentSettings.data.assign(generalSettings.data.begin() + residentMip, generalSettings.data.end());
+
+	if (generalSettings.rowPitches.size())
+		residentSettings.rowPitches.assign(generalSettings.rowPitches.begin() + residentMip, generalSettings.rowPitches.end());
+	DXGI_SAMPLE_DESC sampleDesc = { 1, 0 };
+
+	SGResult result = textureHandler->CreateTexture2D(textureGuid, residentSettings, std::max<UINT>(width >> residentMip, 1),
+		std::max<UINT>(height >> residentMip, 1), 1, sampleDesc, false);
+
+	if (result != SGResult::OK)
+		return result;
+
+	return textureHandler->CreateSRV(viewGuid, textureGuid);
+}
+
+size_t SG::D3D11TextureStreamer::GetMipSize(DXGI_FORMAT format, UINT width, UINT height, unsigned int mip)
+{
+	// Same layout as the initial data of CreateTexture2D
+	return GetSlicePitch(format, GetMipDimension(width, mip), GetMipDimension(height, mip));
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "SGTextureResidency.h"
+#include "SGLoadQueue.h"
+#include "D3D11TextureHandler.h"
+
+namespace SG
+{
+	/** Streams the mips of textures in and out of the texture handler within the budget of its residency.
+	A streamed texture is known by the guid of its shader resource view, which always views the resident mips.
+	A residency change creates a texture with only the resident mips on a loader thread, the view is replaced through the
+	view frame map so the swap happens at a frame boundary, and the previous texture is removed once the new one is in use */
+	class D3D11TextureStreamer
+	{
+	public:
+		D3D11TextureStreamer(D3D11TextureHandler* textureHandler, SGLoadQueue* loadQueue, size_t budget);
+		~D3D11TextureStreamer() = default;
+
+		/** generalSettings needs the data of every mip of a single texture, the data has to stay valid until the texture is removed */
+		SGResult AddStreamedTexture(const SGGuid& viewGuid, const SGTextureData& generalSettings, UINT width, UINT height, unsigned int minimumResidentMips = 1);
+		void RemoveStreamedTexture(const SGGuid& viewGuid);
+
+		void RequestMip(const SGGuid& viewGuid, unsigned int mip, float priority = 1.0f);
+		/** screenSize as computed for LOD selection, relative to half the height of the viewport */
+		void RequestScreenSize(const SGGuid& viewGuid, float screenSize, float viewportHeight, float priority = 1.0f);
+
+		SGTextureResidency* Residency();
+
+	private:
+		friend class D3D11RenderEngine;
+
+		struct StreamedTexture
+		{
+			SGTextureData generalSettings;
+			UINT width;
+			UINT height;
+			SGGuid textures[2]; // The resident texture and the one being created
+			unsigned int activeTexture = 0;
+		};
+
+		D3D11TextureHandler* textureHandler;
+		SGLoadQueue* loadQueue;
+		SGTextureResidency residency;
+		std::mutex streamMutex;
+		std::unordered_map<SGGuid, StreamedTexture> streamedTextures;
+		std::vector<SGResidencyChange> changes;
+
+		void FinishFrame();
+		SGResult CreateResidentTexture(const SGGuid& viewGuid, const SGGuid& textureGuid, const SGTextureData& generalSettings,
+			UINT width, UINT height, unsigned int residentMip);
+		static size_t GetMipSize(DXGI_FORMAT format, UINT width, UINT height, unsigned int mip);
+	};
+}
@@ -56,7 +56,7 @@ namespace SG
 		void RemoveElement(const Key& elementKey);
 
 		void FinishFrame();
-		void UpdateActive();
+		size_t UpdateActive(std::vector<Key>* changedKeys = nullptr); // Returns the number of operations applied, their keys are added to changedKeys
 	};
 
 	template<typename Key, typename StoredType>
@@ -197,13 +197,17 @@ namespace SG
 	template<typename Key, typename StoredType>
 	inline void FrameMap<Key, StoredType>::FinishFrame()
 	{
+		// Loader threads can add elements while the frame is finished
+		updateMutex.lock();
 		nrToUpdate = storedOperations.size();
+		updateMutex.unlock();
 	}
 
 	template<typename Key, typename StoredType>
-	inline void FrameMap<Key, StoredType>::UpdateActive()
+	inline size_t FrameMap<Key, StoredType>::UpdateActive(std::vector<Key>* changedKeys)
 	{
 		updateMutex.lock();
+		size_t nrOfApplied = nrToUpdate;
 
 		for (decltype(nrToUpdate) i = 0; i < nrToUpdate; ++i)
 		{
@@ -213,12 +217,20 @@ namespace SG
 			{
 				std::pair<Key, StoredType>& add = std::get<std::pair<Key, StoredType>>(storedOperations[i].data);
 				activeElements[add.first] = std::move(add.second);
+
+				if (changedKeys != nullptr)
+					changedKeys->push_back(add.first);
+
 				break;
 			}
 			case OperationType::REMOVE:
 			{
 				Key& remove = std::get<Key>(storedOperations[i].data);
 				activeElements.erase(remove);
+
+				if (changedKeys != nullptr)
+					changedKeys->push_back(remove);
+
 				break;
 			}
 			default:
@@ -229,5 +241,7 @@ namespace SG
 		storedOperations.erase(storedOperations.begin(), storedOperations.begin() + nrToUpdate);
 		nrToUpdate = 0;
 		updateMutex.unlock();
+
+		return nrOfApplied;
 	}
 }
\ No newline at end of file
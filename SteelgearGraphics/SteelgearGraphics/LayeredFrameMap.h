@@ -54,7 +54,7 @@ namespace SG
 		void RemoveElement(const OuterKey& outerKey);
 
 		void FinishFrame();
-		void UpdateActive();
+		size_t UpdateActive(); // Returns the number of operations applied
 	};
 
 	
@@ -174,9 +174,10 @@ namespace SG
 	}
 
 	template<typename OuterKey, typename InnerKey, typename StoredType>
-	inline void LayeredFrameMap<OuterKey, InnerKey, StoredType>::UpdateActive()
+	inline size_t LayeredFrameMap<OuterKey, InnerKey, StoredType>::UpdateActive()
 	{
 		updateMutex.lock();
+		size_t nrOfApplied = nrToUpdate;
 
 		for (decltype(nrToUpdate) i = 0; i < nrToUpdate; ++i)
 		{
@@ -219,6 +220,8 @@ namespace SG
 		nrToUpdate = 0;
 
 		updateMutex.unlock();
+
+		return nrOfApplied;
 	}
 
 }
\ No newline at end of file
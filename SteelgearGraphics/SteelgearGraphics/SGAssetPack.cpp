@@ -0,0 +1,321 @@
+#include "SGAssetPack.h"
+#include "SGTrace.h"
+
+#include <climits>
+#include <cstring>
+
+#ifdef _WIN32
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+SG::SGAssetPack::~SGAssetPack()
+{
+	Close();
+}
+
+SG::SGResult SG::SGAssetPack::Open(const std::string & path)
+{
+	SGTraceScope scope("SGAssetPack::Open");
+	Close();
+
+#ifdef _WIN32
+	file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+
+	if (file == INVALID_HANDLE_VALUE)
+	{
+		file = nullptr;
+		return SGResult::FAIL;
+	}
+
+	LARGE_INTEGER fileSize;
+
+	if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart < static_cast<LONGLONG>(sizeof(SGAssetPackHeader)))
+	{
+		Close();
+		return SGResult::FAIL;
+	}
+
+	size = static_cast<size_t>(fileSize.QuadPart);
+	mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+
+	if (mapping == nullptr)
+	{
+		Close();
+		return SGResult::FAIL;
+	}
+
+	view = static_cast<const unsigned char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+
+	if (view == nullptr)
+	{
+		Close();
+		return SGResult::FAIL;
+	}
+#else
+	int descriptor = open(path.c_str(), O_RDONLY);
+
+	if (descriptor < 0)
+		return SGResult::FAIL;
+
+	struct stat status;
+
+	if (fstat(descriptor, &status) != 0 || status.st_size < static_cast<off_t>(sizeof(SGAssetPackHeader)))
+	{
+		close(descriptor);
+		return SGResult::FAIL;
+	}
+
+	// The mapping keeps the file open on its own
+	size = static_cast<size_t>(status.st_size);
+	void* mapped = mmap(nullptr, size, PROT_READ, MAP_SHARED, descriptor, 0);
+	close(descriptor);
+
+	if (mapped == MAP_FAILED)
+	{
+		size = 0;
+		return SGResult::FAIL;
+	}
+
+	view = static_cast<const unsigned char*>(mapped);
+#endif
+
+	const SGAssetPackHeader* header = reinterpret_cast<const SGAssetPackHeader*>(view);
+
+	if (std::memcmp(header->magic, MAGIC, sizeof(MAGIC)) != 0 || header->version != VERSION || header->fileSize != size ||
+		!InFile(header->indexOffset, static_cast<uint64_t>(header->nrOfAssets) * sizeof(SGAssetPackEntry)))
+	{
+		Close();
+		return SGResult::FAIL;
+	}
+
+	const SGAssetPackEntry* entries = reinterpret_cast<const SGAssetPackEntry*>(view + header->indexOffset);
+
+	for (uint32_t i = 0; i < header->nrOfAssets; ++i)
+	{
+		if (!Validate(entries[i]))
+		{
+			Close();
+			return SGResult::FAIL;
+		}
+
+		const char* name = reinterpret_cast<const char*>(view + entries[i].nameOffset);
+		index[SGGuid(std::string(name, entries[i].nameLength))] = &entries[i];
+	}
+
+	return SGResult::OK;
+}
+
+void SG::SGAssetPack::Close()
+{
+	index.clear();
+
+#ifdef _WIN32
+	if (view != nullptr)
+		UnmapViewOfFile(view);
+
+	if (mapping != nullptr)
+		CloseHandle(mapping);
+
+	if (file != nullptr)
+		CloseHandle(file);
+#else
+	if (view != nullptr)
+		munmap(const_cast<unsigned char*>(view), size);
+#endif
+
+	view = nullptr;
+	mapping = nullptr;
+	file = nullptr;
+	size = 0;
+}
+
+bool SG::SGAssetPack::HasAsset(const SGGuid & name) const
+{
+	return index.find(name) != index.end();
+}
+
+std::vector<SG::SGGuid> SG::SGAssetPack::GetAssetNames() const
+{
+	std::vector<SGGuid> toReturn;
+	toReturn.reserve(index.size());
+
+	for (auto& entry : index)
+		toReturn.push_back(entry.first);
+
+	return toReturn;
+}
+
+SG::SGResult SG::SGAssetPack::GetTexture(const SGGuid & name, SGPackedTexture & texture) const
+{
+	if (!HasAsset(name))
+		return SGResult::GUID_MISSING;
+
+	const SGAssetPackEntry* entry = FindEntry(name, SGAssetType::TEXTURE);
+
+	if (entry == nullptr)
+		return SGResult::FAIL;
+
+	texture.format = entry->format;
+	texture.width = entry->width;
+	texture.height = entry->height;
+	texture.depth = entry->depth;
+	texture.arraySize = entry->arraySize;
+	texture.mipLevels = entry->mipLevels;
+	texture.textureCube = entry->textureCube != 0;
+	texture.data.clear();
+	texture.rowPitches.clear();
+	texture.slicePitches.clear();
+
+	const SGAssetPackSubresource* subresources = reinterpret_cast<const SGAssetPackSubresource*>(view + entry->tableOffset);
+
+	for (uint32_t i = 0; i < entry->arraySize * entry->mipLevels; ++i)
+	{
+		texture.data.push_back(view + subresources[i].offset);
+		texture.rowPitches.push_back(subresources[i].rowPitch);
+		texture.slicePitches.push_back(subresources[i].slicePitch);
+	}
+
+	return SGResult::OK;
+}
+
+SG::SGResult SG::SGAssetPack::GetMesh(const SGGuid & name, SGPackedMesh & mesh) const
+{
+	if (!HasAsset(name))
+		return SGResult::GUID_MISSING;
+
+	const SGAssetPackEntry* entry = FindEntry(name, SGAssetType::MESH);
+
+	if (entry == nullptr)
+		return SGResult::FAIL;
+
+	mesh.stride = entry->width;
+	mesh.nrOfVertices = entry->height;
+	mesh.vertices = view + entry->dataOffset;
+	mesh.vertexDataSize = entry->width * entry->height;
+	mesh.indexSize = entry->depth;
+	mesh.nrOfIndices = entry->arraySize;
+	mesh.indices = entry->arraySize != 0 ? view + entry->indexDataOffset : nullptr;
+	mesh.indexDataSize = entry->depth * entry->arraySize;
+
+	return SGResult::OK;
+}
+
+SG::SGResult SG::SGAssetPack::GetShader(const SGGuid & name, SGPackedShader & shader) const
+{
+	if (!HasAsset(name))
+		return SGResult::GUID_MISSING;
+
+	const SGAssetPackEntry* entry = FindEntry(name, SGAssetType::SHADER);
+
+	if (entry == nullptr)
+		return SGResult::FAIL;
+
+	shader.type = entry->format;
+	shader.byteCode = view + entry->dataOffset;
+	shader.byteCodeLength = static_cast<size_t>(entry->dataSize);
+
+	return SGResult::OK;
+}
+
+void SG::SGAssetPack::Prefetch(const SGGuid & name) const
+{
+	Prefetch(std::vector<SGGuid>(1, name));
+}
+
+void SG::SGAssetPack::Prefetch(const std::vector<SGGuid>& names) const
+{
+#ifdef _WIN32
+	std::vector<WIN32_MEMORY_RANGE_ENTRY> ranges;
+	ranges.reserve(names.size());
+
+	for (auto& name : names)
+	{
+		auto found = index.find(name);
+
+		if (found != index.end() && found->second->dataSize != 0)
+			ranges.push_back({ const_cast<unsigned char*>(view + found->second->dataOffset), static_cast<SIZE_T>(found->second->dataSize) });
+	}
+
+	// Only a hint, the pages are faulted in as usual if the system declines
+	if (ranges.size() != 0)
+		PrefetchVirtualMemory(GetCurrentProcess(), ranges.size(), ranges.data(), 0);
+#else
+	// The data of every asset starts on a page, which madvise needs
+	for (auto& name : names)
+	{
+		auto found = index.find(name);
+
+		if (found != index.end() && found->second->dataSize != 0)
+			madvise(const_cast<unsigned char*>(view + found->second->dataOffset), static_cast<size_t>(found->second->dataSize), MADV_WILLNEED);
+	}
+#endif
+}
+
+const SG::SGAssetPackEntry * SG::SGAssetPack::FindEntry(const SGGuid & name, SGAssetType type) const
+{
+	auto found = index.find(name);
+
+	if (found == index.end() || found->second->type != type)
+		return nullptr;
+
+	return found->second;
+}
+
+bool SG::SGAssetPack::InFile(uint64_t offset, uint64_t length) const
+{
+	return offset <= size && length <= size - offset;
+}
+
+bool SG::SGAssetPack::Validate(const SGAssetPackEntry & entry) const
+{
+	if (!InFile(entry.nameOffset, entry.nameLength) || !InFile(entry.dataOffset, entry.dataSize))
+		return false;
+
+	uint64_t dataEnd = entry.dataOffset + entry.dataSize;
+
+	switch (entry.type)
+	{
+	case SGAssetType::TEXTURE:
+	{
+		uint64_t nrOfSubresources = static_cast<uint64_t>(entry.arraySize) * entry.mipLevels;
+
+		if (nrOfSubresources == 0 || entry.depth == 0 || !InFile(entry.tableOffset, nrOfSubresources * sizeof(SGAssetPackSubresource)))
+			return false;
+
+		const SGAssetPackSubresource* subresources = reinterpret_cast<const SGAssetPackSubresource*>(view + entry.tableOffset);
+
+		for (uint64_t i = 0; i < nrOfSubresources; ++i)
+		{
+			uint32_t mip = static_cast<uint32_t>(i % entry.mipLevels);
+			uint64_t depth = mip < 32 && (entry.depth >> mip) > 1 ? entry.depth >> mip : 1;
+			const SGAssetPackSubresource& subresource = subresources[i];
+
+			if (subresource.offset < entry.dataOffset || subresource.offset > dataEnd || subresource.size > dataEnd - subresource.offset ||
+				static_cast<uint64_t>(subresource.slicePitch) * depth > subresource.size)
+				return false;
+		}
+
+		return true;
+	}
+	case SGAssetType::MESH:
+	{
+		uint64_t vertexDataSize = static_cast<uint64_t>(entry.width) * entry.height;
+		uint64_t indexDataSize = static_cast<uint64_t>(entry.depth) * entry.arraySize;
+
+		if (vertexDataSize > entry.dataSize || vertexDataSize > UINT_MAX || indexDataSize > UINT_MAX)
+			return false;
+
+		return indexDataSize == 0 || (entry.indexDataOffset >= entry.dataOffset + vertexDataSize && entry.indexDataOffset <= dataEnd &&
+			indexDataSize <= dataEnd - entry.indexDataOffset);
+	}
+	case SGAssetType::SHADER:
+		return true;
+	default:
+		return false;
+	}
+}
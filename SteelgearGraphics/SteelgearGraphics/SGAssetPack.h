@@ -0,0 +1,138 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "SGGuid.h"
+#include "SGResult.h"
+
+namespace SG
+{
+	enum class SGAssetType : uint32_t
+	{
+		TEXTURE,
+		MESH,
+		SHADER
+	};
+
+	// Views into an open pack, the pointers stay valid until the pack is closed and point to read only memory
+	struct SGPackedTexture
+	{
+		unsigned int format; // DXGI_FORMAT
+		unsigned int width;
+		unsigned int height;
+		unsigned int depth;
+		unsigned int arraySize;
+		unsigned int mipLevels;
+		bool textureCube;
+		std::vector<const void*> data; // One subresource per mip level of every array slice, the same order as SGTextureData::data
+		std::vector<unsigned int> rowPitches;
+		std::vector<unsigned int> slicePitches; // Bytes of one depth slice, or of the whole subresource for textures without depth
+	};
+
+	struct SGPackedMesh
+	{
+		const void* vertices;
+		unsigned int vertexDataSize;
+		unsigned int stride;
+		unsigned int nrOfVertices;
+		const void* indices; // nullptr for meshes without indices
+		unsigned int indexDataSize;
+		unsigned int indexSize; // 2 or 4
+		unsigned int nrOfIndices;
+	};
+
+	struct SGPackedShader
+	{
+		unsigned int type; // ShaderType
+		const void* byteCode;
+		size_t byteCodeLength;
+	};
+
+	/* The layout of a pack is the header, the index, the subresource tables, the names and then the data of every asset.
+	The data of an asset starts on its own page so it can be prefetched and evicted without touching its neighbours,
+	subresources and index data within it are aligned to SUBRESOURCE_ALIGNMENT. All offsets are from the start of the file */
+	struct SGAssetPackHeader
+	{
+		char magic[8];
+		uint32_t version;
+		uint32_t nrOfAssets;
+		uint64_t indexOffset;
+		uint64_t fileSize;
+	};
+
+	struct SGAssetPackEntry
+	{
+		SGAssetType type;
+		uint32_t nameLength;
+		uint64_t nameOffset;
+		uint64_t dataOffset;
+		uint64_t dataSize;
+		uint64_t tableOffset; // Subresource table of textures
+		uint64_t indexDataOffset; // Index data of meshes
+		uint32_t format; // Textures, or the shader type of shaders
+		uint32_t width; // Textures, or the stride of meshes
+		uint32_t height; // Textures, or the number of vertices of meshes
+		uint32_t depth; // Textures, or the index size of meshes
+		uint32_t arraySize; // Textures, or the number of indices of meshes
+		uint32_t mipLevels;
+		uint32_t textureCube;
+		uint32_t padding;
+	};
+
+	struct SGAssetPackSubresource
+	{
+		uint64_t offset;
+		uint64_t size;
+		uint32_t rowPitch;
+		uint32_t slicePitch;
+	};
+
+	static_assert(sizeof(SGAssetPackHeader) == 32 && sizeof(SGAssetPackEntry) == 80 && sizeof(SGAssetPackSubresource) == 24,
+		"The pack layout is read straight from the mapping and may not change with the compiler");
+
+	/** Read only view of a pack written by SGAssetPackWriter. The file is mapped into memory, so the initial data given to
+	the handlers points straight into the mapping and is paged in from the file when the device reads it.
+	Prefetch asks the system to read the pages of the given assets ahead of time, so creating them does not fault page by page.
+	Every offset is validated on Open, lookups can be made from any thread */
+	class SGAssetPack
+	{
+	public:
+		SGAssetPack() = default;
+		~SGAssetPack();
+
+		SGAssetPack(const SGAssetPack& other) = delete;
+		SGAssetPack& operator=(const SGAssetPack& other) = delete;
+
+		SGResult Open(const std::string& path);
+		void Close(); // Resources created from the pack do not need it anymore, but asynchronous creations still in flight do
+
+		bool HasAsset(const SGGuid& name) const;
+		std::vector<SGGuid> GetAssetNames() const;
+		SGResult GetTexture(const SGGuid& name, SGPackedTexture& texture) const;
+		SGResult GetMesh(const SGGuid& name, SGPackedMesh& mesh) const;
+		SGResult GetShader(const SGGuid& name, SGPackedShader& shader) const;
+
+		void Prefetch(const SGGuid& name) const;
+		void Prefetch(const std::vector<SGGuid>& names) const; // One request for all of them, so the reads can be merged
+
+		static constexpr char MAGIC[8] = { 'S', 'G', 'A', 'S', 'S', 'E', 'T', 'S' };
+		static constexpr uint32_t VERSION = 1;
+		static constexpr uint64_t PAGE_ALIGNMENT = 4096;
+		static constexpr uint64_t SUBRESOURCE_ALIGNMENT = 16;
+
+	private:
+		void* file = nullptr; // Only used on Windows, elsewhere the view is all that is kept of an open pack
+		void* mapping = nullptr;
+		const unsigned char* view = nullptr;
+		size_t size = 0;
+		std::unordered_map<SGGuid, const SGAssetPackEntry*> index;
+
+		const SGAssetPackEntry* FindEntry(const SGGuid& name, SGAssetType type) const;
+		bool InFile(uint64_t offset, uint64_t length) const;
+		bool Validate(const SGAssetPackEntry& entry) const;
+	};
+}
@@ -0,0 +1,192 @@
+#include "SGAssetPackWriter.h"
+
+#include <cstring>
+#include <fstream>
+
+SG::SGResult SG::SGAssetPackWriter::AddTexture(const std::string & name, const SGPackedTexture & texture)
+{
+	size_t nrOfSubresources = static_cast<size_t>(texture.arraySize) * texture.mipLevels;
+
+	if (HasName(name) || nrOfSubresources == 0 || texture.depth == 0 || texture.data.size() != nrOfSubresources ||
+		texture.rowPitches.size() != nrOfSubresources || texture.slicePitches.size() != nrOfSubresources)
+		return SGResult::FAIL;
+
+	Asset toAdd;
+	std::memset(&toAdd.entry, 0, sizeof(toAdd.entry));
+	toAdd.name = name;
+	toAdd.entry.type = SGAssetType::TEXTURE;
+	toAdd.entry.format = texture.format;
+	toAdd.entry.width = texture.width;
+	toAdd.entry.height = texture.height;
+	toAdd.entry.depth = texture.depth;
+	toAdd.entry.arraySize = texture.arraySize;
+	toAdd.entry.mipLevels = texture.mipLevels;
+	toAdd.entry.textureCube = texture.textureCube ? 1 : 0;
+
+	uint64_t offset = 0;
+
+	for (size_t i = 0; i < nrOfSubresources; ++i)
+	{
+		unsigned int mip = static_cast<unsigned int>(i % texture.mipLevels);
+		uint64_t depth = (texture.depth >> mip) > 1 ? texture.depth >> mip : 1;
+		uint64_t subresourceSize = texture.slicePitches[i] * depth;
+
+		toAdd.blocks.push_back({ texture.data[i], subresourceSize, offset });
+		toAdd.subresources.push_back({ offset, subresourceSize, texture.rowPitches[i], texture.slicePitches[i] });
+		offset = Align(offset + subresourceSize, SGAssetPack::SUBRESOURCE_ALIGNMENT);
+	}
+
+	toAdd.entry.dataSize = offset;
+	assets.push_back(std::move(toAdd));
+
+	return SGResult::OK;
+}
+
+SG::SGResult SG::SGAssetPackWriter::AddMesh(const std::string & name, const SGPackedMesh & mesh)
+{
+	uint64_t vertexDataSize = static_cast<uint64_t>(mesh.stride) * mesh.nrOfVertices;
+	uint64_t indexDataSize = static_cast<uint64_t>(mesh.indexSize) * mesh.nrOfIndices;
+
+	if (HasName(name) || vertexDataSize == 0 || (mesh.nrOfIndices != 0 && (mesh.indices == nullptr || (mesh.indexSize != 2 && mesh.indexSize != 4))))
+		return SGResult::FAIL;
+
+	Asset toAdd;
+	std::memset(&toAdd.entry, 0, sizeof(toAdd.entry));
+	toAdd.name = name;
+	toAdd.entry.type = SGAssetType::MESH;
+	toAdd.entry.width = mesh.stride;
+	toAdd.entry.height = mesh.nrOfVertices;
+	toAdd.entry.depth = mesh.indexSize;
+	toAdd.entry.arraySize = mesh.nrOfIndices;
+	toAdd.blocks.push_back({ mesh.vertices, vertexDataSize, 0 });
+
+	uint64_t indexOffset = Align(vertexDataSize, SGAssetPack::SUBRESOURCE_ALIGNMENT);
+
+	if (indexDataSize != 0)
+		toAdd.blocks.push_back({ mesh.indices, indexDataSize, indexOffset });
+
+	// Written as an offset from the start of the data of the asset until the layout is known
+	toAdd.entry.indexDataOffset = indexOffset;
+	toAdd.entry.dataSize = indexOffset + indexDataSize;
+	assets.push_back(std::move(toAdd));
+
+	return SGResult::OK;
+}
+
+SG::SGResult SG::SGAssetPackWriter::AddShader(const std::string & name, const SGPackedShader & shader)
+{
+	if (HasName(name) || shader.byteCode == nullptr || shader.byteCodeLength == 0)
+		return SGResult::FAIL;
+
+	Asset toAdd;
+	std::memset(&toAdd.entry, 0, sizeof(toAdd.entry));
+	toAdd.name = name;
+	toAdd.entry.type = SGAssetType::SHADER;
+	toAdd.entry.format = shader.type;
+	toAdd.entry.dataSize = shader.byteCodeLength;
+	toAdd.blocks.push_back({ shader.byteCode, shader.byteCodeLength, 0 });
+	assets.push_back(std::move(toAdd));
+
+	return SGResult::OK;
+}
+
+SG::SGResult SG::SGAssetPackWriter::Write(const std::string & path)
+{
+	// Everything before the data is laid out first, so each part can be written in a single pass
+	SGAssetPackHeader header;
+	std::memcpy(header.magic, SGAssetPack::MAGIC, sizeof(header.magic));
+	header.version = SGAssetPack::VERSION;
+	header.nrOfAssets = static_cast<uint32_t>(assets.size());
+	header.indexOffset = sizeof(SGAssetPackHeader);
+
+	uint64_t offset = header.indexOffset + assets.size() * sizeof(SGAssetPackEntry);
+	std::vector<SGAssetPackEntry> entries;
+	std::vector<SGAssetPackSubresource> subresources;
+
+	for (auto& asset : assets)
+	{
+		entries.push_back(asset.entry);
+
+		if (asset.subresources.size() != 0)
+		{
+			entries.back().tableOffset = offset;
+			offset += asset.subresources.size() * sizeof(SGAssetPackSubresource);
+		}
+	}
+
+	for (size_t i = 0; i < assets.size(); ++i)
+	{
+		entries[i].nameOffset = offset;
+		entries[i].nameLength = static_cast<uint32_t>(assets[i].name.size());
+		offset += assets[i].name.size();
+	}
+
+	for (size_t i = 0; i < assets.size(); ++i)
+	{
+		offset = Align(offset, SGAssetPack::PAGE_ALIGNMENT);
+		entries[i].dataOffset = offset;
+
+		if (entries[i].type == SGAssetType::MESH)
+			entries[i].indexDataOffset += offset;
+
+		for (auto subresource : assets[i].subresources)
+		{
+			subresource.offset += offset;
+			subresources.push_back(subresource);
+		}
+
+		offset += entries[i].dataSize;
+	}
+
+	header.fileSize = offset;
+	std::ofstream file(path, std::ios::binary | std::ios::trunc);
+
+	if (!file.is_open())
+		return SGResult::FAIL;
+
+	file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+	file.write(reinterpret_cast<const char*>(entries.data()), entries.size() * sizeof(SGAssetPackEntry));
+	file.write(reinterpret_cast<const char*>(subresources.data()), subresources.size() * sizeof(SGAssetPackSubresource));
+
+	for (auto& asset : assets)
+		file.write(asset.name.data(), asset.name.size());
+
+	const char padding[SGAssetPack::PAGE_ALIGNMENT] = {};
+	uint64_t written = static_cast<uint64_t>(file.tellp());
+
+	for (size_t i = 0; i < assets.size(); ++i)
+	{
+		for (auto& block : assets[i].blocks)
+		{
+			uint64_t blockOffset = entries[i].dataOffset + block.offset;
+			file.write(padding, blockOffset - written);
+			file.write(static_cast<const char*>(block.data), block.size);
+			written = blockOffset + block.size;
+		}
+
+		uint64_t assetEnd = entries[i].dataOffset + entries[i].dataSize;
+		file.write(padding, assetEnd - written);
+		written = assetEnd;
+	}
+
+	return file.good() ? SGResult::OK : SGResult::FAIL;
+}
+
+void SG::SGAssetPackWriter::Clear()
+{
+	assets.clear();
+}
+
+bool SG::SGAssetPackWriter::HasName(const std::string & name) const
+{
+	for (auto& asset : assets)
+		if (asset.name == name)
+			return true;
+
+	return false;
+}
+
+uint64_t SG::SGAssetPackWriter::Align(uint64_t value, uint64_t alignment)
+{
+	return (value + alignment - 1) / alignment * alignment;
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "SGAssetPack.h"
+
+namespace SG
+{
+	/** Builds a pack that SGAssetPack can map. The assets are only referenced when added, the data they point to has to stay
+	valid until Write has returned. Subresources of textures are stored with the pitches they were given, so the pack can hold
+	any layout the device accepts as initial data, including block compressed formats */
+	class SGAssetPackWriter
+	{
+	public:
+		SGAssetPackWriter() = default;
+		~SGAssetPackWriter() = default;
+
+		SGResult AddTexture(const std::string& name, const SGPackedTexture& texture); // Needs the data, row pitch and slice pitch of every subresource
+		SGResult AddMesh(const std::string& name, const SGPackedMesh& mesh);
+		SGResult AddShader(const std::string& name, const SGPackedShader& shader);
+
+		SGResult Write(const std::string& path);
+		void Clear();
+
+	private:
+		struct Block
+		{
+			const void* data;
+			uint64_t size;
+			uint64_t offset; // From the start of the data of the asset
+		};
+
+		struct Asset
+		{
+			std::string name;
+			SGAssetPackEntry entry;
+			std::vector<Block> blocks;
+			std::vector<SGAssetPackSubresource> subresources; // Offsets from the start of the data of the asset until written
+		};
+
+		std::vector<Asset> assets;
+
+		bool HasName(const std::string& name) const;
+		static uint64_t Align(uint64_t value, uint64_t alignment);
+	};
+}
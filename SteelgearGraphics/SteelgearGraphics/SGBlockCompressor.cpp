@@ -0,0 +1,811 @@
+#include "SGBlockCompressor.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstdint>
+#include <emmintrin.h>
+
+namespace
+{
+	const size_t BLOCKS_PER_TASK = 64;
+
+	// The texels of a 4x4 block as one array per channel in the range [0, 255], texels outside of mask do not affect the endpoints
+	struct Block
+	{
+		float channels[4][16] = {};
+		unsigned int mask = 0xffff;
+	};
+
+	struct QualityParameters
+	{
+		int axisIterations;
+		int refinements;
+	};
+
+	QualityParameters GetParameters(SG::SGCompressionQuality quality)
+	{
+		switch (quality)
+		{
+		case SG::SGCompressionQuality::FAST:
+			return { 1, 0 };
+		case SG::SGCompressionQuality::HIGH:
+			return { 8, 3 };
+		default:
+			return { 4, 1 };
+		}
+	}
+
+	// Blocks are little endian bit streams, the first field in the lowest bits
+	struct BlockWriter
+	{
+		uint64_t bits[2] = {};
+		unsigned int position = 0;
+
+		void Write(uint32_t value, unsigned int nrOfBits)
+		{
+			for (unsigned int i = 0; i < nrOfBits; ++i, ++position)
+				bits[position / 64] |= static_cast<uint64_t>((value >> i) & 1) << (position % 64);
+		}
+
+		void Store(unsigned char* output, size_t size) const
+		{
+			for (size_t i = 0; i < size; ++i)
+				output[i] = static_cast<unsigned char>(bits[i / 8] >> ((i % 8) * 8));
+		}
+	};
+
+	float Clamp(float value, float low, float high)
+	{
+		return std::min(std::max(value, low), high);
+	}
+
+	void LoadBlock(const SG::SGMipImage& image, size_t x, size_t y, size_t z, Block& block)
+	{
+		for (size_t i = 0; i < 16; ++i)
+		{
+			size_t texelX = std::min<size_t>(x + i % 4, image.width - 1);
+			size_t texelY = std::min<size_t>(y + i / 4, image.height - 1);
+			const unsigned char* texel = &image.texels[((z * image.height + texelY) * image.width + texelX) * 4];
+
+			for (size_t j = 0; j < 4; ++j)
+				block.channels[j][i] = texel[j];
+		}
+	}
+
+	/** Stores the index of the closest palette entry for every texel and returns the squared error of the texels in the mask.
+	Four texels are compared against a palette entry at a time */
+	float SelectIndices(const Block& block, const float(*palette)[4], unsigned int paletteSize, unsigned char indices[16])
+	{
+		float distances[16];
+
+		for (int group = 0; group < 16; group += 4)
+		{
+			__m128 texels[4];
+
+			for (int i = 0; i < 4; ++i)
+				texels[i] = _mm_loadu_ps(block.channels[i] + group);
+
+			__m128 best = _mm_set1_ps(FLT_MAX);
+			__m128i bestIndices = _mm_setzero_si128();
+
+			for (unsigned int i = 0; i < paletteSize; ++i)
+			{
+				__m128 distance = _mm_setzero_ps();
+
+				for (int j = 0; j < 4; ++j)
+				{
+					__m128 difference = _mm_sub_ps(texels[j], _mm_set1_ps(palette[i][j]));
+					distance = _mm_add_ps(distance, _mm_mul_ps(difference, difference));
+				}
+
+				__m128i closer = _mm_castps_si128(_mm_cmplt_ps(distance, best));
+				best = _mm_min_ps(distance, best);
+				bestIndices = _mm_or_si128(_mm_and_si128(closer, _mm_set1_epi32(static_cast<int>(i))), _mm_andnot_si128(closer, bestIndices));
+			}
+
+			int32_t selected[4];
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(selected), bestIndices);
+			_mm_storeu_ps(distances + group, best);
+
+			for (int i = 0; i < 4; ++i)
+				indices[group + i] = static_cast<unsigned char>(selected[i]);
+		}
+
+		float error = 0.0f;
+
+		for (int i = 0; i < 16; ++i)
+		{
+			if (block.mask & (1 << i))
+				error += distances[i];
+		}
+
+		return error;
+	}
+
+	/** Endpoints at the extremes of the texels projected onto their principal axis, which is found by power iteration on the covariance */
+	void FitEndpoints(const Block& block, unsigned int nrOfChannels, int iterations, float endpoint0[4], float endpoint1[4])
+	{
+		float mean[4] = {};
+		float low[4] = { FLT_MAX, FLT_MAX, FLT_MAX, FLT_MAX };
+		float high[4] = { -FLT_MAX, -FLT_MAX, -FLT_MAX, -FLT_MAX };
+		float count = 0.0f;
+
+		for (int i = 0; i < 16; ++i)
+		{
+			if (!(block.mask & (1 << i)))
+				continue;
+
+			for (unsigned int j = 0; j < nrOfChannels; ++j)
+			{
+				mean[j] += block.channels[j][i];
+				low[j] = std::min(low[j], block.channels[j][i]);
+				high[j] = std::max(high[j], block.channels[j][i]);
+			}
+
+			count += 1.0f;
+		}
+
+		float covariance[4][4] = {};
+		float axis[4] = {};
+
+		for (unsigned int j = 0; j < nrOfChannels; ++j)
+		{
+			mean[j] /= count;
+			axis[j] = high[j] - low[j]; // The diagonal of the bounding box is a good first guess
+		}
+
+		for (int i = 0; i < 16; ++i)
+		{
+			if (!(block.mask & (1 << i)))
+				continue;
+
+			for (unsigned int j = 0; j < nrOfChannels; ++j)
+				for (unsigned int k = 0; k < nrOfChannels; ++k)
+					covariance[j][k] += (block.channels[j][i] - mean[j]) * (block.channels[k][i] - mean[k]);
+		}
+
+		for (int iteration = 0; iteration < iterations; ++iteration)
+		{
+			float next[4] = {};
+			float largest = 0.0f;
+
+			for (unsigned int j = 0; j < nrOfChannels; ++j)
+			{
+				for (unsigned int k = 0; k < nrOfChannels; ++k)
+					next[j] += covariance[j][k] * axis[k];
+
+				largest = std::max(largest, std::fabs(next[j]));
+			}
+
+			if (largest == 0.0f)
+				break;
+
+			for (unsigned int j = 0; j < nrOfChannels; ++j)
+				axis[j] = next[j] / largest;
+		}
+
+		float lengthSquared = 0.0f;
+
+		for (unsigned int j = 0; j < nrOfChannels; ++j)
+			lengthSquared += axis[j] * axis[j];
+
+		float lowest = 0.0f;
+		float highest = 0.0f;
+
+		for (int i = 0; i < 16 && lengthSquared > 0.0f; ++i)
+		{
+			if (!(block.mask & (1 << i)))
+				continue;
+
+			float projection = 0.0f;
+
+			for (unsigned int j = 0; j < nrOfChannels; ++j)
+				projection += (block.channels[j][i] - mean[j]) * axis[j];
+
+			lowest = std::min(lowest, projection / lengthSquared);
+			highest = std::max(highest, projection / lengthSquared);
+		}
+
+		for (unsigned int j = 0; j < 4; ++j)
+		{
+			endpoint0[j] = j < nrOfChannels ? Clamp(mean[j] + highest * axis[j], 0.0f, 255.0f) : 0.0f;
+			endpoint1[j] = j < nrOfChannels ? Clamp(mean[j] + lowest * axis[j], 0.0f, 255.0f) : 0.0f;
+		}
+	}
+
+	/** Least squares endpoints for the chosen indices, weights[i] is how far palette entry i lies from endpoint0 towards endpoint1.
+	Fails when every texel uses the same weight, since the endpoints are not determined then */
+	bool RefineEndpoints(const Block& block, unsigned int nrOfChannels, const unsigned char indices[16], const float* weights,
+		float endpoint0[4], float endpoint1[4])
+	{
+		float aa = 0.0f;
+		float ab = 0.0f;
+		float bb = 0.0f;
+		float ax[4] = {};
+		float bx[4] = {};
+
+		for (int i = 0; i < 16; ++i)
+		{
+			if (!(block.mask & (1 << i)))
+				continue;
+
+			float b = weights[indices[i]];
+			float a = 1.0f - b;
+			aa += a * a;
+			ab += a * b;
+			bb += b * b;
+
+			for (unsigned int j = 0; j < nrOfChannels; ++j)
+			{
+				ax[j] += a * block.channels[j][i];
+				bx[j] += b * block.channels[j][i];
+			}
+		}
+
+		float determinant = aa * bb - ab * ab;
+
+		if (std::fabs(determinant) < 1e-6f)
+			return false;
+
+		for (unsigned int j = 0; j < nrOfChannels; ++j)
+		{
+			endpoint0[j] = Clamp((bb * ax[j] - ab * bx[j]) / determinant, 0.0f, 255.0f);
+			endpoint1[j] = Clamp((aa * bx[j] - ab * ax[j]) / determinant, 0.0f, 255.0f);
+		}
+
+		return true;
+	}
+
+	unsigned int To565(const float colour[4])
+	{
+		unsigned int red = static_cast<unsigned int>(colour[0] * 31.0f / 255.0f + 0.5f);
+		unsigned int green = static_cast<unsigned int>(colour[1] * 63.0f / 255.0f + 0.5f);
+		unsigned int blue = static_cast<unsigned int>(colour[2] * 31.0f / 255.0f + 0.5f);
+		return red << 11 | green << 5 | blue;
+	}
+
+	void From565(unsigned int packed, float colour[4])
+	{
+		unsigned int red = packed >> 11 & 31;
+		unsigned int green = packed >> 5 & 63;
+		unsigned int blue = packed & 31;
+		colour[0] = static_cast<float>(red << 3 | red >> 2);
+		colour[1] = static_cast<float>(green << 2 | green >> 4);
+		colour[2] = static_cast<float>(blue << 3 | blue >> 2);
+		colour[3] = 0.0f;
+	}
+
+	/** Colour block of BC1 and BC3. With punchThrough, texels with alpha below 128 make the block use three colours and transparent black */
+	void EncodeBC1(const Block& block, const QualityParameters& parameters, bool punchThrough, unsigned char* output)
+	{
+		static const float FOUR_COLOUR_WEIGHTS[4] = { 0.0f, 1.0f, 1.0f / 3.0f, 2.0f / 3.0f };
+		static const float THREE_COLOUR_WEIGHTS[4] = { 0.0f, 1.0f, 0.5f, 0.0f };
+
+		Block colour = block;
+
+		for (int i = 0; i < 16; ++i)
+		{
+			colour.channels[3][i] = 0.0f;
+
+			if (punchThrough && block.channels[3][i] < 128.0f)
+				colour.mask &= ~(1u << i);
+		}
+
+		BlockWriter writer;
+
+		if (colour.mask == 0)
+		{
+			// Every texel is transparent, which is index 3 when the endpoints select three colours
+			writer.Write(0, 32);
+			writer.Write(0xffffffff, 32);
+			writer.Store(output, 8);
+			return;
+		}
+
+		bool threeColour = colour.mask != 0xffff;
+		float endpoint0[4];
+		float endpoint1[4];
+		FitEndpoints(colour, 3, parameters.axisIterations, endpoint0, endpoint1);
+
+		unsigned char indices[16];
+		unsigned char bestIndices[16] = {};
+		unsigned int best0 = 0;
+		unsigned int best1 = 0;
+		float bestError = FLT_MAX;
+
+		for (int refinement = 0; refinement <= parameters.refinements; ++refinement)
+		{
+			unsigned int colour0 = To565(endpoint0);
+			unsigned int colour1 = To565(endpoint1);
+
+			// The order of the endpoints selects the mode, four colours need the first to be the larger
+			if (threeColour ? colour0 > colour1 : colour0 < colour1)
+			{
+				std::swap(colour0, colour1);
+				std::swap(endpoint0, endpoint1);
+			}
+
+			float palette[4][4] = {};
+			From565(colour0, palette[0]);
+			From565(colour1, palette[1]);
+
+			for (int j = 0; j < 3; ++j)
+			{
+				if (threeColour)
+				{
+					palette[2][j] = (palette[0][j] + palette[1][j]) / 2.0f;
+				}
+				else
+				{
+					palette[2][j] = (2.0f * palette[0][j] + palette[1][j]) / 3.0f;
+					palette[3][j] = (palette[0][j] + 2.0f * palette[1][j]) / 3.0f;
+				}
+			}
+
+			float error = SelectIndices(colour, palette, threeColour ? 3 : 4, indices);
+
+			if (error < bestError)
+			{
+				bestError = error;
+				best0 = colour0;
+				best1 = colour1;
+				std::copy(indices, indices + 16, bestIndices);
+			}
+
+			if (refinement == parameters.refinements ||
+				!RefineEndpoints(colour, 3, indices, threeColour ? THREE_COLOUR_WEIGHTS : FOUR_COLOUR_WEIGHTS, endpoint0, endpoint1))
+				break;
+		}
+
+		writer.Write(best0, 16);
+		writer.Write(best1, 16);
+
+		for (int i = 0; i < 16; ++i)
+			writer.Write(colour.mask & (1 << i) ? bestIndices[i] : 3, 2);
+
+		writer.Store(output, 8);
+	}
+
+	/** Single channel block used for the alpha of BC3 and both channels of BC5. With sixValueMode the mode with exact 0 and 255 is tried too */
+	void EncodeBC4(const float values[16], const QualityParameters& parameters, bool sixValueMode, unsigned char* output)
+	{
+		static const float EIGHT_VALUE_WEIGHTS[8] = { 0.0f, 1.0f, 1.0f / 7.0f, 2.0f / 7.0f, 3.0f / 7.0f, 4.0f / 7.0f, 5.0f / 7.0f, 6.0f / 7.0f };
+
+		Block block;
+		std::copy(values, values + 16, block.channels[0]);
+
+		float endpoint0[4] = { *std::max_element(values, values + 16) };
+		float endpoint1[4] = { *std::min_element(values, values + 16) };
+		unsigned char indices[16];
+		unsigned char bestIndices[16] = {};
+		unsigned int best0 = 0;
+		unsigned int best1 = 0;
+		float bestError = FLT_MAX;
+
+		for (int refinement = 0; refinement <= parameters.refinements; ++refinement)
+		{
+			unsigned int value0 = static_cast<unsigned int>(endpoint0[0] + 0.5f);
+			unsigned int value1 = static_cast<unsigned int>(endpoint1[0] + 0.5f);
+
+			// Eight values need the first endpoint to be the larger
+			if (value0 < value1)
+			{
+				std::swap(value0, value1);
+				std::swap(endpoint0, endpoint1);
+			}
+
+			float palette[8][4] = {};
+			palette[0][0] = static_cast<float>(value0);
+			palette[1][0] = static_cast<float>(value1);
+
+			for (int i = 2; i < 8; ++i)
+				palette[i][0] = ((8 - i) * palette[0][0] + (i - 1) * palette[1][0]) / 7.0f;
+
+			float error = SelectIndices(block, palette, 8, indices);
+
+			if (error < bestError)
+			{
+				bestError = error;
+				best0 = value0;
+				best1 = value1;
+				std::copy(indices, indices + 16, bestIndices);
+			}
+
+			if (refinement == parameters.refinements || !RefineEndpoints(block, 1, indices, EIGHT_VALUE_WEIGHTS, endpoint0, endpoint1))
+				break;
+		}
+
+		if (sixValueMode)
+		{
+			// Texels at exactly 0 or 255 are left to the two fixed values, the six others only have to cover the rest
+			float low = 255.0f;
+			float high = 0.0f;
+
+			for (int i = 0; i < 16; ++i)
+			{
+				if (values[i] > 0.0f && values[i] < 255.0f)
+				{
+					low = std::min(low, values[i]);
+					high = std::max(high, values[i]);
+				}
+			}
+
+			unsigned int value0 = low <= high ? static_cast<unsigned int>(low + 0.5f) : 0;
+			unsigned int value1 = low <= high ? static_cast<unsigned int>(high + 0.5f) : 0;
+			float palette[8][4] = {};
+			palette[0][0] = static_cast<float>(value0);
+			palette[1][0] = static_cast<float>(value1);
+
+			for (int i = 2; i < 6; ++i)
+				palette[i][0] = ((6 - i) * palette[0][0] + (i - 1) * palette[1][0]) / 5.0f;
+
+			palette[7][0] = 255.0f;
+			float error = SelectIndices(block, palette, 8, indices);
+
+			if (error < bestError)
+			{
+				best0 = value0;
+				best1 = value1;
+				std::copy(indices, indices + 16, bestIndices);
+			}
+		}
+
+		BlockWriter writer;
+		writer.Write(best0, 8);
+		writer.Write(best1, 8);
+
+		for (int i = 0; i < 16; ++i)
+			writer.Write(bestIndices[i], 3);
+
+		writer.Store(output, 8);
+	}
+
+	/** Seven bits per channel and a shared lowest bit, which is picked to fit the endpoint best unless pBit is 0 or 1 */
+	void QuantizeBC7Endpoint(const float endpoint[4], int pBit, unsigned int quantized[4], unsigned int& chosenPBit)
+	{
+		float bestError = FLT_MAX;
+
+		for (unsigned int bit = 0; bit < 2; ++bit)
+		{
+			if (pBit >= 0 && bit != static_cast<unsigned int>(pBit))
+				continue;
+
+			unsigned int values[4];
+			float error = 0.0f;
+
+			for (int i = 0; i < 4; ++i)
+			{
+				values[i] = static_cast<unsigned int>(Clamp(std::floor((endpoint[i] - bit) / 2.0f + 0.5f), 0.0f, 127.0f));
+				float difference = static_cast<float>(values[i] * 2 + bit) - endpoint[i];
+				error += difference * difference;
+			}
+
+			if (error < bestError)
+			{
+				bestError = error;
+				chosenPBit = bit;
+				std::copy(values, values + 4, quantized);
+			}
+		}
+	}
+
+	/** BC7 mode 6, a single subset of RGBA endpoints with four bit indices */
+	void EncodeBC7(const Block& block, const QualityParameters& parameters, bool tryAllPBits, unsigned char* output)
+	{
+		static const unsigned int INDEX_WEIGHTS[16] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+		float refineWeights[16];
+
+		for (int i = 0; i < 16; ++i)
+			refineWeights[i] = INDEX_WEIGHTS[i] / 64.0f;
+
+		float endpoint0[4];
+		float endpoint1[4];
+		FitEndpoints(block, 4, parameters.axisIterations, endpoint0, endpoint1);
+
+		unsigned int best0[4] = {};
+		unsigned int best1[4] = {};
+		unsigned int bestPBit0 = 0;
+		unsigned int bestPBit1 = 0;
+		unsigned char bestIndices[16] = {};
+		float bestError = FLT_MAX;
+
+		for (int refinement = 0; refinement <= parameters.refinements; ++refinement)
+		{
+			unsigned char indices[16];
+			unsigned char iterationIndices[16];
+			float iterationError = FLT_MAX;
+
+			// -1 lets each endpoint pick its own shared bit, the others force a combination of them
+			for (int combination = tryAllPBits ? 0 : -1; combination < (tryAllPBits ? 4 : 0); ++combination)
+			{
+				unsigned int quantized0[4];
+				unsigned int quantized1[4];
+				unsigned int pBit0 = 0;
+				unsigned int pBit1 = 0;
+				QuantizeBC7Endpoint(endpoint0, combination < 0 ? -1 : combination & 1, quantized0, pBit0);
+				QuantizeBC7Endpoint(endpoint1, combination < 0 ? -1 : combination >> 1, quantized1, pBit1);
+
+				float palette[16][4];
+
+				for (int i = 0; i < 16; ++i)
+				{
+					for (int j = 0; j < 4; ++j)
+					{
+						unsigned int value0 = quantized0[j] * 2 + pBit0;
+						unsigned int value1 = quantized1[j] * 2 + pBit1;
+						palette[i][j] = static_cast<float>(((64 - INDEX_WEIGHTS[i]) * value0 + INDEX_WEIGHTS[i] * value1 + 32) >> 6);
+					}
+				}
+
+				float error = SelectIndices(block, palette, 16, indices);
+
+				if (error < iterationError)
+				{
+					iterationError = error;
+					std::copy(indices, indices + 16, iterationIndices);
+				}
+
+				if (error < bestError)
+				{
+					bestError = error;
+					std::copy(quantized0, quantized0 + 4, best0);
+					std::copy(quantized1, quantized1 + 4, best1);
+					bestPBit0 = pBit0;
+					bestPBit1 = pBit1;
+					std::copy(indices, indices + 16, bestIndices);
+				}
+			}
+
+			if (refinement == parameters.refinements || !RefineEndpoints(block, 4, iterationIndices, refineWeights, endpoint0, endpoint1))
+				break;
+		}
+
+		// The highest bit of the first index is left out, so it has to be below 8
+		if (bestIndices[0] >= 8)
+		{
+			std::swap(best0, best1);
+			std::swap(bestPBit0, bestPBit1);
+
+			for (auto& index : bestIndices)
+				index = static_cast<unsigned char>(15 - index);
+		}
+
+		BlockWriter writer;
+		writer.Write(1 << 6, 7);
+
+		for (int i = 0; i < 4; ++i)
+		{
+			writer.Write(best0[i], 7);
+			writer.Write(best1[i], 7);
+		}
+
+		writer.Write(bestPBit0, 1);
+		writer.Write(bestPBit1, 1);
+		writer.Write(bestIndices[0], 3);
+
+		for (int i = 1; i < 16; ++i)
+			writer.Write(bestIndices[i], 4);
+
+		writer.Store(output, 16);
+	}
+
+	uint64_t ReadBits(const unsigned char* bytes)
+	{
+		uint64_t bits = 0;
+
+		for (int i = 7; i >= 0; --i)
+			bits = bits << 8 | bytes[i];
+
+		return bits;
+	}
+
+	void DecodeBC1(const unsigned char* block, bool alwaysFourColours, unsigned char texels[16][4])
+	{
+		unsigned int colour0 = block[0] | block[1] << 8;
+		unsigned int colour1 = block[2] | block[3] << 8;
+		float endpoints[2][4];
+		From565(colour0, endpoints[0]);
+		From565(colour1, endpoints[1]);
+		int palette[4][4] = {};
+
+		for (int c = 0; c < 3; ++c)
+		{
+			palette[0][c] = static_cast<int>(endpoints[0][c]);
+			palette[1][c] = static_cast<int>(endpoints[1][c]);
+
+			if (alwaysFourColours || colour0 > colour1)
+			{
+				palette[2][c] = (2 * palette[0][c] + palette[1][c]) / 3;
+				palette[3][c] = (palette[0][c] + 2 * palette[1][c]) / 3;
+			}
+			else
+			{
+				palette[2][c] = (palette[0][c] + palette[1][c]) / 2;
+			}
+		}
+
+		// Three colour blocks use the last index for transparent black
+		palette[0][3] = palette[1][3] = palette[2][3] = 255;
+		palette[3][3] = alwaysFourColours || colour0 > colour1 ? 255 : 0;
+		uint64_t indices = ReadBits(block) >> 32;
+
+		for (int i = 0; i < 16; ++i)
+		{
+			for (int c = 0; c < 4; ++c)
+				texels[i][c] = static_cast<unsigned char>(palette[indices >> (i * 2) & 3][c]);
+		}
+	}
+
+	void DecodeBC4(const unsigned char* block, int channel, unsigned char texels[16][4])
+	{
+		int value0 = block[0];
+		int value1 = block[1];
+		int palette[8] = { value0, value1 };
+
+		for (int i = 2; i < 8; ++i)
+		{
+			if (value0 > value1)
+				palette[i] = ((8 - i) * value0 + (i - 1) * value1) / 7;
+			else
+				palette[i] = i < 6 ? ((6 - i) * value0 + (i - 1) * value1) / 5 : (i == 6 ? 0 : 255);
+		}
+
+		uint64_t indices = ReadBits(block) >> 16;
+
+		for (int i = 0; i < 16; ++i)
+			texels[i][channel] = static_cast<unsigned char>(palette[indices >> (i * 3) & 7]);
+	}
+
+	bool DecodeBC7(const unsigned char* block, unsigned char texels[16][4])
+	{
+		static const int WEIGHTS[16] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+		uint64_t low = ReadBits(block);
+		uint64_t high = ReadBits(block + 8);
+
+		if ((low & 0x7f) != 0x40)
+			return false;
+
+		int endpoints[2][4];
+
+		for (int c = 0; c < 4; ++c)
+		{
+			endpoints[0][c] = static_cast<int>(low >> (7 + c * 14) & 0x7f) << 1 | static_cast<int>(low >> 63);
+			endpoints[1][c] = static_cast<int>(low >> (14 + c * 14) & 0x7f) << 1 | static_cast<int>(high & 1);
+		}
+
+		// The index of the first texel has one bit less, its highest bit is always 0
+		uint64_t indices = high >> 1;
+
+		for (int i = 0; i < 16; ++i)
+		{
+			int weight = i == 0 ? WEIGHTS[indices & 7] : WEIGHTS[indices >> (i * 4 - 1) & 15];
+
+			for (int c = 0; c < 4; ++c)
+				texels[i][c] = static_cast<unsigned char>(((64 - weight) * endpoints[0][c] + weight * endpoints[1][c] + 32) >> 6);
+		}
+
+		return true;
+	}
+}
+
+SG::SGResult SG::CompressImage(const SGMipImage & image, const SGCompressionSettings & settings, SGCompressedImage & compressed, SGThreadPool * threadPool)
+{
+	size_t nrOfTexels = static_cast<size_t>(image.width) * image.height * image.depth;
+
+	if (nrOfTexels == 0 || image.texels.size() != nrOfTexels * 4)
+		return SGResult::FAIL;
+
+	size_t blocksWide = (image.width + 3) / 4;
+	size_t blocksHigh = (image.height + 3) / 4;
+	size_t bytesPerBlock = GetBytesPerBlock(settings.format);
+
+	compressed.format = settings.format;
+	compressed.width = image.width;
+	compressed.height = image.height;
+	compressed.depth = image.depth;
+	compressed.rowPitch = static_cast<unsigned int>(blocksWide * bytesPerBlock);
+	compressed.slicePitch = static_cast<unsigned int>(blocksHigh * compressed.rowPitch);
+	compressed.blocks.resize(static_cast<size_t>(compressed.slicePitch) * image.depth);
+
+	QualityParameters parameters = GetParameters(settings.quality);
+	bool tryAllModes = settings.quality == SGCompressionQuality::HIGH;
+	unsigned char* blocks = compressed.blocks.data();
+
+	RunTasks(threadPool, blocksWide * blocksHigh * image.depth, BLOCKS_PER_TASK, [&](size_t start, size_t end)
+	{
+		for (size_t i = start; i < end; ++i)
+		{
+			Block block;
+			LoadBlock(image, i % blocksWide * 4, i / blocksWide % blocksHigh * 4, i / (blocksWide * blocksHigh), block);
+			unsigned char* output = blocks + i * bytesPerBlock;
+
+			switch (settings.format)
+			{
+			case SGBlockFormat::BC1:
+				EncodeBC1(block, parameters, true, output);
+				break;
+			case SGBlockFormat::BC3:
+				EncodeBC4(block.channels[3], parameters, tryAllModes, output);
+				EncodeBC1(block, parameters, false, output + 8);
+				break;
+			case SGBlockFormat::BC5:
+				EncodeBC4(block.channels[0], parameters, tryAllModes, output);
+				EncodeBC4(block.channels[1], parameters, tryAllModes, output + 8);
+				break;
+			default:
+				EncodeBC7(block, parameters, tryAllModes, output);
+				break;
+			}
+		}
+	});
+
+	return SGResult::OK;
+}
+
+SG::SGResult SG::DecompressImage(const SGCompressedImage & compressed, SGMipImage & image)
+{
+	size_t blocksWide = (compressed.width + 3) / 4;
+	size_t blocksHigh = (compressed.height + 3) / 4;
+	size_t bytesPerBlock = GetBytesPerBlock(compressed.format);
+
+	if (blocksWide == 0 || blocksHigh == 0 || compressed.depth == 0 || compressed.rowPitch < blocksWide * bytesPerBlock ||
+		compressed.slicePitch < blocksHigh * compressed.rowPitch || compressed.blocks.size() < static_cast<size_t>(compressed.slicePitch) * compressed.depth)
+		return SGResult::FAIL;
+
+	image.width = compressed.width;
+	image.height = compressed.height;
+	image.depth = compressed.depth;
+	image.texels.resize(static_cast<size_t>(image.width) * image.height * image.depth * 4);
+
+	for (size_t z = 0; z < image.depth; ++z)
+	{
+		for (size_t blockY = 0; blockY < blocksHigh; ++blockY)
+		{
+			for (size_t blockX = 0; blockX < blocksWide; ++blockX)
+			{
+				const unsigned char* block = compressed.blocks.data() + z * compressed.slicePitch + blockY * compressed.rowPitch + blockX * bytesPerBlock;
+				unsigned char texels[16][4] = {};
+
+				switch (compressed.format)
+				{
+				case SGBlockFormat::BC1:
+					DecodeBC1(block, false, texels);
+					break;
+				case SGBlockFormat::BC3:
+					DecodeBC1(block + 8, true, texels);
+					DecodeBC4(block, 3, texels);
+					break;
+				case SGBlockFormat::BC5:
+					DecodeBC4(block, 0, texels);
+					DecodeBC4(block + 8, 1, texels);
+
+					for (auto& texel : texels)
+						texel[3] = 255;
+					break;
+				default:
+					if (!DecodeBC7(block, texels))
+						return SGResult::FAIL;
+					break;
+				}
+
+				// Texels of blocks reaching past the edge are dropped
+				for (size_t y = blockY * 4; y < std::min<size_t>(blockY * 4 + 4, image.height); ++y)
+				{
+					for (size_t x = blockX * 4; x < std::min<size_t>(blockX * 4 + 4, image.width); ++x)
+					{
+						const unsigned char* texel = texels[(y - blockY * 4) * 4 + x - blockX * 4];
+						std::copy(texel, texel + 4, image.texels.begin() + ((z * image.height + y) * image.width + x) * 4);
+					}
+				}
+			}
+		}
+	}
+
+	return SGResult::OK;
+}
+
+unsigned int SG::GetBytesPerBlock(SGBlockFormat format)
+{
+	return format == SGBlockFormat::BC1 ? 8 : 16;
+}
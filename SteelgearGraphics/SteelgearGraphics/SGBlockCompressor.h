@@ -0,0 +1,52 @@
+#pragma once
+
+#include <vector>
+
+#include "SGMipGenerator.h"
+#include "SGResult.h"
+#include "SGThreadPool.h"
+
+namespace SG
+{
+	enum class SGBlockFormat
+	{
+		BC1, // RGB with one bit alpha, 8 bytes per block
+		BC3, // RGBA, 16 bytes per block
+		BC5, // Two channels taken from red and green, 16 bytes per block
+		BC7 // RGBA, 16 bytes per block
+	};
+
+	enum class SGCompressionQuality
+	{
+		FAST, // Endpoints straight from the principal axis of each block
+		NORMAL, // Endpoints refined once by least squares
+		HIGH // More refinement, and every alternative encoding a format offers is tried
+	};
+
+	struct SGCompressionSettings
+	{
+		SGBlockFormat format = SGBlockFormat::BC7;
+		SGCompressionQuality quality = SGCompressionQuality::NORMAL;
+	};
+
+	// Blocks are stored row by row and slice by slice, a slice is compressed on its own
+	struct SGCompressedImage
+	{
+		SGBlockFormat format = SGBlockFormat::BC7;
+		unsigned int width = 0;
+		unsigned int height = 0;
+		unsigned int depth = 1;
+		unsigned int rowPitch = 0; // Bytes in a row of blocks
+		unsigned int slicePitch = 0;
+		std::vector<unsigned char> blocks;
+	};
+
+	/** Blocks reaching past the edge of the image repeat its last row and column. BC7 blocks are all mode 6, a single subset with
+	seven bits per channel and a shared bit per endpoint. threadPool can be nullptr */
+	SGResult CompressImage(const SGMipImage& image, const SGCompressionSettings& settings, SGCompressedImage& compressed, SGThreadPool* threadPool);
+
+	/** Decodes by the format specification, the reference the compression is measured against. BC5 decodes with blue at 0 and
+	alpha at 255, BC7 blocks in any other mode than 6 fail */
+	SGResult DecompressImage(const SGCompressedImage& compressed, SGMipImage& image);
+	unsigned int GetBytesPerBlock(SGBlockFormat format);
+}
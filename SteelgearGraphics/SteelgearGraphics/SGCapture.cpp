@@ -0,0 +1,252 @@
+#include "SGCapture.h"
+#include "SGRenderEngine.h"
+
+#include <atomic>
+#include <cstring>
+#include <fstream>
+#include <mutex>
+#include <stdexcept>
+#include <unordered_set>
+
+namespace
+{
+	std::mutex captureMutex;
+	std::atomic<bool> captureActive = false;
+	std::ofstream captureFile;
+	SG::SGCaptureStream recordStream;
+	SG::SGCaptureStream declarationStream;
+	std::unordered_set<size_t> declaredGuids;
+	unsigned int framesToCapture = 0;
+	unsigned int capturedFrames = 0;
+	thread_local unsigned int captureDepth = 0;
+
+	void WriteRecord(SG::SGCaptureCall call, const SG::SGCaptureStream& payload)
+	{
+		// The header is as large as the alignment, so the payload keeps the alignment it was written with
+		unsigned int header[4] = { static_cast<unsigned int>(call), 0, 0, 0 };
+		unsigned long long size = payload.bytes.size();
+		std::memcpy(header + 2, &size, sizeof(size));
+		const char padding[SG::SGCaptureStream::BLOCK_ALIGNMENT] = {};
+
+		captureFile.write(reinterpret_cast<const char*>(header), sizeof(header));
+		captureFile.write(reinterpret_cast<const char*>(payload.bytes.data()), payload.bytes.size());
+		captureFile.write(padding, SG::SGCaptureStream::Aligned(payload.bytes.size()) - payload.bytes.size());
+	}
+
+	void ClearStream(SG::SGCaptureStream& stream)
+	{
+		stream.bytes.clear();
+		stream.position = 0;
+		stream.writtenGuids.clear();
+	}
+
+	void CloseCapture()
+	{
+		captureActive = false;
+		captureFile.close();
+		declaredGuids.clear();
+	}
+}
+
+void SG::SGCaptureStream::Write(const void * data, size_t size)
+{
+	const unsigned char* toWrite = static_cast<const unsigned char*>(data);
+	bytes.insert(bytes.end(), toWrite, toWrite + size);
+}
+
+void SG::SGCaptureStream::Read(void * data, size_t size)
+{
+	if (position + size > bytes.size())
+		throw std::runtime_error("Error reading capture, data ends in the middle of a call");
+
+	std::memcpy(data, bytes.data() + position, size);
+	position += size;
+}
+
+void SG::SGCaptureStream::WriteBlock(const void * data, size_t size)
+{
+	unsigned long long blockSize = data != nullptr ? size : 0;
+	Write(&blockSize, sizeof(blockSize));
+	bytes.resize(Aligned(bytes.size()));
+	Write(data, static_cast<size_t>(blockSize));
+}
+
+const void * SG::SGCaptureStream::ReadBlock(size_t & size)
+{
+	unsigned long long blockSize;
+	Read(&blockSize, sizeof(blockSize));
+	position = Aligned(position);
+	size = static_cast<size_t>(blockSize);
+
+	if (position + size > bytes.size())
+		throw std::runtime_error("Error reading capture, data ends in the middle of a call");
+
+	const void* toReturn = size != 0 ? bytes.data() + position : nullptr;
+	position += size;
+	return toReturn;
+}
+
+size_t SG::SGCaptureStream::Aligned(size_t size)
+{
+	return (size + BLOCK_ALIGNMENT - 1) / BLOCK_ALIGNMENT * BLOCK_ALIGNMENT;
+}
+
+void SG::CaptureWrite(SGCaptureStream & stream, const SGCaptureBytes & bytes)
+{
+	stream.WriteBlock(bytes.data, bytes.size);
+}
+
+void SG::CaptureWrite(SGCaptureStream & stream, const SGGuid & guid)
+{
+	size_t id = guid.GetID();
+	CaptureWrite(stream, static_cast<unsigned long long>(id));
+
+	if (id != 0)
+		stream.writtenGuids.push_back(guid);
+}
+
+void SG::CaptureRead(SGCaptureStream & stream, SGGuid & guid)
+{
+	unsigned long long id;
+	CaptureRead(stream, id);
+
+	if (id == 0)
+	{
+		guid = SGGuid();
+		return;
+	}
+
+	auto declared = stream.readGuids.find(static_cast<size_t>(id));
+
+	if (declared == stream.readGuids.end())
+		throw std::runtime_error("Error reading capture, guid used before it was declared");
+
+	guid = declared->second;
+}
+
+void SG::CaptureWrite(SGCaptureStream & stream, const std::string & text)
+{
+	CaptureWrite(stream, static_cast<unsigned long long>(text.size()));
+	stream.Write(text.data(), text.size());
+}
+
+void SG::CaptureRead(SGCaptureStream & stream, std::string & text)
+{
+	unsigned long long size;
+	CaptureRead(stream, size);
+	text.resize(static_cast<size_t>(size));
+	stream.Read(&text[0], text.size());
+}
+
+void SG::CaptureWrite(SGCaptureStream & stream, const SGFrustum & frustum)
+{
+	stream.Write(&frustum, sizeof(frustum));
+}
+
+void SG::CaptureRead(SGCaptureStream & stream, SGFrustum & frustum)
+{
+	stream.Read(&frustum, sizeof(frustum));
+}
+
+void SG::CaptureWrite(SGCaptureStream & stream, const SGLODCamera & camera)
+{
+	stream.Write(&camera, sizeof(camera));
+}
+
+void SG::CaptureRead(SGCaptureStream & stream, SGLODCamera & camera)
+{
+	stream.Read(&camera, sizeof(camera));
+}
+
+void SG::CaptureWrite(SGCaptureStream & stream, const SGGraphicsJob & job)
+{
+	CaptureWriteAll(stream, job.pipelineGuid, job.entitiesToRender, job.cullingFrustums, job.occlusionCulling, job.lodSelection, job.streamedTextureBinds);
+}
+
+void SG::CaptureRead(SGCaptureStream & stream, SGGraphicsJob & job)
+{
+	CaptureReadAll(stream, job.pipelineGuid, job.entitiesToRender, job.cullingFrustums, job.occlusionCulling, job.lodSelection, job.streamedTextureBinds);
+}
+
+bool SG::BeginCapture(const std::string & path, unsigned int nrOfFrames)
+{
+	if constexpr (!CAPTURE_VERSION)
+	{
+		(void)path;
+		(void)nrOfFrames;
+		return false;
+	}
+
+	std::lock_guard<std::mutex> lock(captureMutex);
+
+	if (captureActive)
+		return false;
+
+	captureFile.open(path, std::ios::binary | std::ios::trunc);
+
+	if (!captureFile.is_open())
+		return false;
+
+	const char magic[8] = { 'S', 'G', 'C', 'A', 'P', 'T', 'U', 'R' };
+	const unsigned int version[2] = { 2, 0 };
+	captureFile.write(magic, sizeof(magic));
+	captureFile.write(reinterpret_cast<const char*>(version), sizeof(version));
+
+	framesToCapture = nrOfFrames;
+	capturedFrames = 0;
+	captureActive = true;
+	return true;
+}
+
+void SG::EndCapture()
+{
+	std::lock_guard<std::mutex> lock(captureMutex);
+
+	if (captureActive)
+		CloseCapture();
+}
+
+bool SG::EnterCaptureScope()
+{
+	return captureDepth++ == 0 && captureActive;
+}
+
+void SG::LeaveCaptureScope()
+{
+	--captureDepth;
+}
+
+SG::SGCaptureStream & SG::BeginCaptureRecord()
+{
+	captureMutex.lock();
+	ClearStream(recordStream);
+	return recordStream;
+}
+
+void SG::EndCaptureRecord(SGCaptureCall call)
+{
+	// The capture may have ended between entering the scope and taking the lock
+	if (!captureActive)
+	{
+		captureMutex.unlock();
+		return;
+	}
+
+	for (const SGGuid& guid : recordStream.writtenGuids)
+	{
+		if (declaredGuids.insert(guid.GetID()).second)
+		{
+			ClearStream(declarationStream);
+			CaptureWrite(declarationStream, static_cast<unsigned long long>(guid.GetID()));
+			CaptureWrite(declarationStream, guid.GetIdentifier());
+			WriteRecord(SGCaptureCall::DECLARE_GUID, declarationStream);
+		}
+	}
+
+	WriteRecord(call, recordStream);
+
+	if (call == SGCaptureCall::RENDER && framesToCapture != 0 && ++capturedFrames >= framesToCapture)
+		CloseCapture();
+
+	captureMutex.unlock();
+}
@@ -0,0 +1,341 @@
+#pragma once
+
+#include <cstddef>
+#include <optional>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "SGGuid.h"
+#include "SGLODSelection.h"
+
+#ifdef _SGG_CAPTURE
+constexpr bool CAPTURE_VERSION = true;
+#else
+constexpr bool CAPTURE_VERSION = false;
+#endif
+
+namespace SG
+{
+	struct SGGraphicsJob;
+
+	// Stored in the capture file, new calls are only added at the end
+	enum class SGCaptureCall : unsigned int
+	{
+		DECLARE_GUID,
+		CREATE_ENTITY,
+		SET_ENTITY_TO_GROUP,
+		SET_ENTITY_BOUNDING_SPHERE,
+		SET_ENTITY_BOUNDING_BOX,
+		SET_LOD_CAMERA,
+		SET_ENTITY_LOD_SET,
+		RENDER,
+		ADD_OCCLUDER,
+		REMOVE_OCCLUDER,
+		SET_OCCLUDER_TRANSFORM,
+		SET_VIEW_PROJECTION,
+		CREATE_LOD_SET,
+		CREATE_VERTEX_BUFFER,
+		CREATE_INDEX_BUFFER,
+		CREATE_CONSTANT_BUFFER,
+		REMOVE_BUFFER,
+		CREATE_BUFFER_OFFSET,
+		REMOVE_BUFFER_OFFSET,
+		CREATE_BUFFER_STRIDE,
+		REMOVE_BUFFER_STRIDE,
+		CREATE_BUFFER_SRV,
+		CREATE_BUFFER_UAV,
+		REMOVE_BUFFER_VIEW,
+		BIND_BUFFER_TO_ENTITY,
+		BIND_BUFFER_TO_GROUP,
+		BIND_OFFSET_TO_ENTITY,
+		BIND_OFFSET_TO_GROUP,
+		BIND_STRIDE_TO_ENTITY,
+		BIND_STRIDE_TO_GROUP,
+		BIND_BUFFER_VIEW_TO_ENTITY,
+		BIND_BUFFER_VIEW_TO_GROUP,
+		UPDATE_BUFFER,
+		CREATE_SAMPLER,
+		REMOVE_SAMPLER,
+		BIND_SAMPLER_TO_ENTITY,
+		BIND_SAMPLER_TO_GROUP,
+		CREATE_INPUT_LAYOUT,
+		REMOVE_INPUT_LAYOUT,
+		CREATE_VERTEX_SHADER,
+		CREATE_HULL_SHADER,
+		CREATE_DOMAIN_SHADER,
+		CREATE_GEOMETRY_SHADER,
+		CREATE_PIXEL_SHADER,
+		CREATE_COMPUTE_SHADER,
+		REMOVE_SHADER,
+		CREATE_RASTERIZER_STATE,
+		CREATE_DEPTH_STENCIL_STATE,
+		CREATE_BLEND_STATE,
+		REMOVE_STATE,
+		CREATE_VIEWPORT,
+		REMOVE_VIEWPORT,
+		CREATE_DEPTH_STENCIL_DATA,
+		CREATE_BLEND_DATA,
+		REMOVE_STATE_DATA,
+		CREATE_STATE_BLOCK,
+		REMOVE_STATE_BLOCK,
+		BIND_STATE_TO_ENTITY,
+		BIND_STATE_TO_GROUP,
+		BIND_STATE_BLOCK_TO_ENTITY,
+		BIND_STATE_BLOCK_TO_GROUP,
+		BIND_VIEWPORT_TO_ENTITY,
+		BIND_VIEWPORT_TO_GROUP,
+		CREATE_TEXTURE_2D,
+		REMOVE_TEXTURE,
+		CREATE_TEXTURE_SRV,
+		CREATE_TEXTURE_SRV_ARRAY,
+		CREATE_TEXTURE_UAV,
+		CREATE_TEXTURE_UAV_ARRAY,
+		CREATE_RTV,
+		CREATE_RTV_ARRAY,
+		CREATE_DSV,
+		CREATE_DSV_ARRAY,
+		REMOVE_TEXTURE_VIEW,
+		BIND_TEXTURE_VIEW_TO_ENTITY,
+		BIND_TEXTURE_VIEW_TO_GROUP,
+		CREATE_RENDER_JOB,
+		REMOVE_RENDER_JOB,
+		CREATE_COMPUTE_JOB,
+		REMOVE_COMPUTE_JOB,
+		CREATE_CLEAR_RENDER_TARGET_JOB,
+		REMOVE_CLEAR_RENDER_TARGET_JOB,
+		CREATE_CLEAR_DEPTH_STENCIL_JOB,
+		REMOVE_CLEAR_DEPTH_STENCIL_JOB,
+		CREATE_PIPELINE,
+		REMOVE_PIPELINE,
+		CREATE_DRAW_CALL,
+		CREATE_DRAW_INDEXED_CALL,
+		CREATE_DRAW_INSTANCED_CALL,
+		CREATE_DRAW_INDEXED_INSTANCED_CALL,
+		REMOVE_DRAW_CALL,
+		CREATE_DISPATCH_CALL,
+		CREATE_DISPATCH_INDIRECT_CALL,
+		REMOVE_DISPATCH_CALL,
+		BIND_DRAW_CALL_TO_ENTITY,
+		BIND_DRAW_CALL_TO_GROUP,
+		BIND_DISPATCH_CALL_TO_ENTITY,
+		BIND_DISPATCH_CALL_TO_GROUP,
+		CREATE_TEXTURE_1D, // Added after the first version, so earlier captures keep their call numbers
+		CREATE_TEXTURE_3D,
+		UPDATE_TEXTURE,
+		CREATE_PLACEHOLDER_VIEW
+	};
+
+	// Memory a call reads through a pointer, read back as a pointer into the stream or nullptr if the size is 0
+	struct SGCaptureBytes
+	{
+		const void* data;
+		size_t size;
+	};
+
+	/** Bytes of a capture, written when capturing and read when replaying. Blocks of memory are aligned to BLOCK_ALIGNMENT
+	from the start of the stream, so a pointer into the stream can be handed to the call that is replayed.
+	Guids are stored as their id, the identifier of each id is declared once in the capture before it is used */
+	class SGCaptureStream
+	{
+	public:
+		static constexpr size_t BLOCK_ALIGNMENT = 16;
+
+		std::vector<unsigned char> bytes;
+		size_t position = 0;
+		std::vector<SGGuid> writtenGuids; // Written since the last clear, declared by the capture if they are new
+		std::unordered_map<size_t, SGGuid> readGuids; // Captured id to the guid with the same identifier in this process
+
+		void Write(const void* data, size_t size);
+		void Read(void* data, size_t size);
+		void WriteBlock(const void* data, size_t size);
+		const void* ReadBlock(size_t& size);
+
+		static size_t Aligned(size_t size);
+	};
+
+	template<typename T>
+	std::enable_if_t<std::is_arithmetic_v<T> || std::is_enum_v<T>> CaptureWrite(SGCaptureStream& stream, const T& value);
+	template<typename T>
+	std::enable_if_t<std::is_arithmetic_v<T> || std::is_enum_v<T>> CaptureRead(SGCaptureStream& stream, T& value);
+	template<typename T>
+	void CaptureRead(SGCaptureStream& stream, T*& pointer);
+	template<typename T>
+	void CaptureWrite(SGCaptureStream& stream, const std::vector<T>& values);
+	template<typename T>
+	void CaptureRead(SGCaptureStream& stream, std::vector<T>& values);
+	template<typename T>
+	void CaptureWrite(SGCaptureStream& stream, const std::optional<T>& value);
+	template<typename T>
+	void CaptureRead(SGCaptureStream& stream, std::optional<T>& value);
+	template<typename First, typename Second>
+	void CaptureWrite(SGCaptureStream& stream, const std::pair<First, Second>& value);
+	template<typename First, typename Second>
+	void CaptureRead(SGCaptureStream& stream, std::pair<First, Second>& value);
+
+	void CaptureWrite(SGCaptureStream& stream, const SGCaptureBytes& bytes);
+	void CaptureWrite(SGCaptureStream& stream, const SGGuid& guid);
+	void CaptureRead(SGCaptureStream& stream, SGGuid& guid);
+	void CaptureWrite(SGCaptureStream& stream, const std::string& text);
+	void CaptureRead(SGCaptureStream& stream, std::string& text);
+	void CaptureWrite(SGCaptureStream& stream, const SGFrustum& frustum);
+	void CaptureRead(SGCaptureStream& stream, SGFrustum& frustum);
+	void CaptureWrite(SGCaptureStream& stream, const SGLODCamera& camera);
+	void CaptureRead(SGCaptureStream& stream, SGLODCamera& camera);
+	void CaptureWrite(SGCaptureStream& stream, const SGGraphicsJob& job);
+	void CaptureRead(SGCaptureStream& stream, SGGraphicsJob& job);
+
+	template<typename... Values>
+	void CaptureWriteAll(SGCaptureStream& stream, const Values&... values);
+	template<typename... Values>
+	void CaptureReadAll(SGCaptureStream& stream, Values&... values);
+
+	/** Every public call made while a capture is active is written to the capture file together with the data it reads,
+	until EndCapture or until nrOfFrames calls to Render have been captured if it is not 0.
+	Captures should begin before the render engine is created, since resources that already exist are not part of it.
+	Everything compiles to nothing unless _SGG_CAPTURE is defined */
+	bool BeginCapture(const std::string& path, unsigned int nrOfFrames = 0);
+	void EndCapture();
+
+	bool EnterCaptureScope(); // True if the scope is the outermost one of the thread and a capture is active
+	void LeaveCaptureScope();
+	SGCaptureStream& BeginCaptureRecord(); // Locks the capture until EndCaptureRecord
+	void EndCaptureRecord(SGCaptureCall call);
+
+	/** Captures a call when it is the outermost captured call of its thread. Calls made by the engine while the scope
+	is alive are part of the outer call and not captured, a scope without a call only keeps internal work out of the capture */
+	class SGCaptureScope
+	{
+	public:
+		SGCaptureScope();
+		template<typename... Arguments>
+		SGCaptureScope(SGCaptureCall call, const Arguments&... arguments);
+		~SGCaptureScope();
+
+		SGCaptureScope(const SGCaptureScope& other) = delete;
+		SGCaptureScope& operator=(const SGCaptureScope& other) = delete;
+	};
+
+	template<typename T>
+	inline std::enable_if_t<std::is_arithmetic_v<T> || std::is_enum_v<T>> CaptureWrite(SGCaptureStream& stream, const T& value)
+	{
+		stream.Write(&value, sizeof(T));
+	}
+
+	template<typename T>
+	inline std::enable_if_t<std::is_arithmetic_v<T> || std::is_enum_v<T>> CaptureRead(SGCaptureStream& stream, T& value)
+	{
+		stream.Read(&value, sizeof(T));
+	}
+
+	template<typename T>
+	inline void CaptureRead(SGCaptureStream& stream, T*& pointer)
+	{
+		size_t size;
+		pointer = static_cast<T*>(const_cast<void*>(stream.ReadBlock(size)));
+	}
+
+	template<typename T>
+	inline void CaptureWrite(SGCaptureStream& stream, const std::vector<T>& values)
+	{
+		CaptureWrite(stream, static_cast<unsigned long long>(values.size()));
+
+		if constexpr (std::is_arithmetic_v<T>)
+			stream.Write(values.data(), values.size() * sizeof(T));
+		else
+			for (auto& value : values)
+				CaptureWrite(stream, value);
+	}
+
+	template<typename T>
+	inline void CaptureRead(SGCaptureStream& stream, std::vector<T>& values)
+	{
+		unsigned long long size;
+		CaptureRead(stream, size);
+		values.resize(static_cast<size_t>(size));
+
+		if constexpr (std::is_arithmetic_v<T>)
+			stream.Read(values.data(), values.size() * sizeof(T));
+		else
+			for (auto& value : values)
+				CaptureRead(stream, value);
+	}
+
+	template<typename T>
+	inline void CaptureWrite(SGCaptureStream& stream, const std::optional<T>& value)
+	{
+		CaptureWrite(stream, value.has_value());
+
+		if (value.has_value())
+			CaptureWrite(stream, *value);
+	}
+
+	template<typename T>
+	inline void CaptureRead(SGCaptureStream& stream, std::optional<T>& value)
+	{
+		bool hasValue;
+		CaptureRead(stream, hasValue);
+		value.reset();
+
+		if (hasValue)
+		{
+			T toRead;
+			CaptureRead(stream, toRead);
+			value = toRead;
+		}
+	}
+
+	template<typename First, typename Second>
+	inline void CaptureWrite(SGCaptureStream& stream, const std::pair<First, Second>& value)
+	{
+		CaptureWrite(stream, value.first);
+		CaptureWrite(stream, value.second);
+	}
+
+	template<typename First, typename Second>
+	inline void CaptureRead(SGCaptureStream& stream, std::pair<First, Second>& value)
+	{
+		CaptureRead(stream, value.first);
+		CaptureRead(stream, value.second);
+	}
+
+	template<typename... Values>
+	inline void CaptureWriteAll(SGCaptureStream& stream, const Values&... values)
+	{
+		(CaptureWrite(stream, values), ...);
+	}
+
+	template<typename... Values>
+	inline void CaptureReadAll(SGCaptureStream& stream, Values&... values)
+	{
+		(CaptureRead(stream, values), ...);
+	}
+
+	inline SGCaptureScope::SGCaptureScope()
+	{
+		if constexpr (CAPTURE_VERSION)
+			EnterCaptureScope();
+	}
+
+	template<typename... Arguments>
+	inline SGCaptureScope::SGCaptureScope(SGCaptureCall call, const Arguments&... arguments)
+	{
+		if constexpr (CAPTURE_VERSION)
+		{
+			if (EnterCaptureScope())
+			{
+				SGCaptureStream& stream = BeginCaptureRecord();
+				CaptureWriteAll(stream, arguments...);
+				EndCaptureRecord(call);
+			}
+		}
+	}
+
+	inline SGCaptureScope::~SGCaptureScope()
+	{
+		if constexpr (CAPTURE_VERSION)
+			LeaveCaptureScope();
+	}
+}
@@ -0,0 +1,172 @@
+#include "SGCulling.h"
+
+#include <cfloat>
+#include <cmath>
+#include <emmintrin.h>
+
+namespace
+{
+	const size_t ENTITIES_PER_TASK = 4096;
+
+	SG::SGPlane NormalizePlane(float x, float y, float z, float w)
+	{
+		float length = std::sqrt(x * x + y * y + z * z);
+		float inverse = length > 0.0f ? 1.0f / length : 0.0f;
+		return { x * inverse, y * inverse, z * inverse, w * inverse };
+	}
+
+	void CullRange(const SG::SGEntityBounds& bounds, const std::vector<SG::SGFrustum>& frustums,
+		const SG::SGGraphicalEntityID* entities, size_t count, std::vector<SG::SGGraphicalEntityID>& visibleEntities)
+	{
+		const __m128 zero = _mm_setzero_ps();
+		const __m128 absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff));
+		size_t i = 0;
+
+		for (; i + 4 <= count; i += 4)
+		{
+			const SG::SGGraphicalEntityID* e = entities + i;
+			__m128 centerX = _mm_setr_ps(bounds.centerX[e[0]], bounds.centerX[e[1]], bounds.centerX[e[2]], bounds.centerX[e[3]]);
+			__m128 centerY = _mm_setr_ps(bounds.centerY[e[0]], bounds.centerY[e[1]], bounds.centerY[e[2]], bounds.centerY[e[3]]);
+			__m128 centerZ = _mm_setr_ps(bounds.centerZ[e[0]], bounds.centerZ[e[1]], bounds.centerZ[e[2]], bounds.centerZ[e[3]]);
+			__m128 extentX = _mm_setr_ps(bounds.extentX[e[0]], bounds.extentX[e[1]], bounds.extentX[e[2]], bounds.extentX[e[3]]);
+			__m128 extentY = _mm_setr_ps(bounds.extentY[e[0]], bounds.extentY[e[1]], bounds.extentY[e[2]], bounds.extentY[e[3]]);
+			__m128 extentZ = _mm_setr_ps(bounds.extentZ[e[0]], bounds.extentZ[e[1]], bounds.extentZ[e[2]], bounds.extentZ[e[3]]);
+			__m128 radius = _mm_setr_ps(bounds.radius[e[0]], bounds.radius[e[1]], bounds.radius[e[2]], bounds.radius[e[3]]);
+			__m128 visible = zero;
+
+			for (auto& frustum : frustums)
+			{
+				__m128 inside = _mm_cmpeq_ps(zero, zero);
+
+				for (auto& plane : frustum.planes)
+				{
+					__m128 planeX = _mm_set1_ps(plane.x);
+					__m128 planeY = _mm_set1_ps(plane.y);
+					__m128 planeZ = _mm_set1_ps(plane.z);
+
+					__m128 distance = _mm_add_ps(_mm_add_ps(_mm_mul_ps(planeX, centerX), _mm_mul_ps(planeY, centerY)),
+						_mm_add_ps(_mm_mul_ps(planeZ, centerZ), _mm_set1_ps(plane.w)));
+					__m128 boxReach = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_and_ps(planeX, absMask), extentX),
+						_mm_mul_ps(_mm_and_ps(planeY, absMask), extentY)), _mm_mul_ps(_mm_and_ps(planeZ, absMask), extentZ));
+
+					inside = _mm_and_ps(inside, _mm_cmpge_ps(_mm_add_ps(distance, radius), zero));
+					inside = _mm_and_ps(inside, _mm_cmpge_ps(_mm_add_ps(distance, boxReach), zero));
+				}
+
+				visible = _mm_or_ps(visible, inside);
+			}
+
+			int mask = _mm_movemask_ps(visible);
+
+			for (int j = 0; j < 4; ++j)
+			{
+				if (mask & (1 << j))
+					visibleEntities.push_back(e[j]);
+			}
+		}
+
+		for (; i < count; ++i)
+		{
+			SG::SGGraphicalEntityID entity = entities[i];
+
+			for (auto& frustum : frustums)
+			{
+				bool inside = true;
+
+				for (auto& plane : frustum.planes)
+				{
+					float distance = plane.x * bounds.centerX[entity] + plane.y * bounds.centerY[entity] +
+						plane.z * bounds.centerZ[entity] + plane.w;
+					float boxReach = std::fabs(plane.x) * bounds.extentX[entity] + std::fabs(plane.y) * bounds.extentY[entity] +
+						std::fabs(plane.z) * bounds.extentZ[entity];
+
+					inside = inside && distance + bounds.radius[entity] >= 0.0f && distance + boxReach >= 0.0f;
+				}
+
+				if (inside)
+				{
+					visibleEntities.push_back(entity);
+					break;
+				}
+			}
+		}
+	}
+}
+
+SG::SGFrustum SG::CreateFrustumFromMatrix(const float viewProjection[16])
+{
+	auto m = [viewProjection](int row, int column) { return viewProjection[row * 4 + column]; };
+	SGFrustum frustum;
+
+	frustum.planes[0] = NormalizePlane(m(0, 3) + m(0, 0), m(1, 3) + m(1, 0), m(2, 3) + m(2, 0), m(3, 3) + m(3, 0)); // Left
+	frustum.planes[1] = NormalizePlane(m(0, 3) - m(0, 0), m(1, 3) - m(1, 0), m(2, 3) - m(2, 0), m(3, 3) - m(3, 0)); // Right
+	frustum.planes[2] = NormalizePlane(m(0, 3) + m(0, 1), m(1, 3) + m(1, 1), m(2, 3) + m(2, 1), m(3, 3) + m(3, 1)); // Bottom
+	frustum.planes[3] = NormalizePlane(m(0, 3) - m(0, 1), m(1, 3) - m(1, 1), m(2, 3) - m(2, 1), m(3, 3) - m(3, 1)); // Top
+	frustum.planes[4] = NormalizePlane(m(0, 2), m(1, 2), m(2, 2), m(3, 2)); // Near
+	frustum.planes[5] = NormalizePlane(m(0, 3) - m(0, 2), m(1, 3) - m(1, 2), m(2, 3) - m(2, 2), m(3, 3) - m(3, 2)); // Far
+
+	return frustum;
+}
+
+void SG::SGEntityBounds::AddEntity()
+{
+	// Entities without bounds are never culled
+	centerX.push_back(0.0f);
+	centerY.push_back(0.0f);
+	centerZ.push_back(0.0f);
+	extentX.push_back(FLT_MAX);
+	extentY.push_back(FLT_MAX);
+	extentZ.push_back(FLT_MAX);
+	radius.push_back(FLT_MAX);
+}
+
+void SG::SGEntityBounds::SetSphere(SGGraphicalEntityID entity, float x, float y, float z, float sphereRadius)
+{
+	centerX[entity] = x;
+	centerY[entity] = y;
+	centerZ[entity] = z;
+	extentX[entity] = sphereRadius;
+	extentY[entity] = sphereRadius;
+	extentZ[entity] = sphereRadius;
+	radius[entity] = sphereRadius;
+}
+
+void SG::SGEntityBounds::SetBox(SGGraphicalEntityID entity, const float center[3], const float extents[3])
+{
+	centerX[entity] = center[0];
+	centerY[entity] = center[1];
+	centerZ[entity] = center[2];
+	extentX[entity] = extents[0];
+	extentY[entity] = extents[1];
+	extentZ[entity] = extents[2];
+	radius[entity] = std::sqrt(extents[0] * extents[0] + extents[1] * extents[1] + extents[2] * extents[2]);
+}
+
+size_t SG::SGEntityBounds::Size() const
+{
+	return radius.size();
+}
+
+void SG::CullEntities(const SGEntityBounds& bounds, const std::vector<SGFrustum>& frustums,
+	const std::vector<SGGraphicalEntityID>& entities, std::vector<SGGraphicalEntityID>& visibleEntities,
+	SGThreadPool* threadPool)
+{
+	size_t nrOfTasks = (entities.size() + ENTITIES_PER_TASK - 1) / ENTITIES_PER_TASK;
+
+	if (threadPool == nullptr || threadPool->GetNrOfThreads() == 0 || nrOfTasks <= 1)
+	{
+		CullRange(bounds, frustums, entities.data(), entities.size(), visibleEntities);
+		return;
+	}
+
+	// Every task culls into its own list so the original order can be restored when merging
+	std::vector<std::vector<SGGraphicalEntityID>> taskResults(nrOfTasks);
+
+	RunTasks(threadPool, entities.size(), ENTITIES_PER_TASK, [&](size_t start, size_t end)
+	{
+		CullRange(bounds, frustums, entities.data() + start, end - start, taskResults[start / ENTITIES_PER_TASK]);
+	});
+
+	for (auto& result : taskResults)
+		visibleEntities.insert(visibleEntities.end(), result.begin(), result.end());
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <vector>
+
+#include "SGGraphicalEntity.h"
+#include "SGThreadPool.h"
+
+namespace SG
+{
+	struct SGPlane
+	{
+		float x = 0.0f;
+		float y = 0.0f;
+		float z = 0.0f;
+		float w = 0.0f;
+	};
+
+	// Planes point inwards, a point p is inside a plane if dot(p, plane.xyz) + plane.w >= 0
+	struct SGFrustum
+	{
+		SGPlane planes[6];
+	};
+
+	/** viewProjection is a row major matrix used as v * M, clip space depth is in the range [0, w] */
+	SGFrustum CreateFrustumFromMatrix(const float viewProjection[16]);
+
+	// Bounds are stored as a sphere and a box around the same center,
+	// an entity is visible if both are intersecting the frustum
+	struct SGEntityBounds
+	{
+		std::vector<float> centerX;
+		std::vector<float> centerY;
+		std::vector<float> centerZ;
+		std::vector<float> extentX;
+		std::vector<float> extentY;
+		std::vector<float> extentZ;
+		std::vector<float> radius;
+
+		void AddEntity();
+		void SetSphere(SGGraphicalEntityID entity, float x, float y, float z, float sphereRadius);
+		void SetBox(SGGraphicalEntityID entity, const float center[3], const float extents[3]);
+		size_t Size() const;
+	};
+
+	/** Entities are appended to visibleEntities in the same order as in entities, threadPool can be nullptr */
+	void CullEntities(const SGEntityBounds& bounds, const std::vector<SGFrustum>& frustums,
+		const std::vector<SGGraphicalEntityID>& entities, std::vector<SGGraphicalEntityID>& visibleEntities,
+		SGThreadPool* threadPool);
+}
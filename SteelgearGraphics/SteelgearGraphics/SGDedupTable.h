@@ -0,0 +1,195 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "SGGuid.h"
+
+namespace SG
+{
+	/** 64 bit FNV-1a over the bytes, it only depends on the bytes so it is the same on every platform and between runs */
+	uint64_t HashContent(const void* data, size_t size, uint64_t hash = 14695981039346656037ull);
+
+	/** Shares one object between every guid created from the same content. Lookups hash the content and then compare it
+	byte for byte with the stored copy, so a hash collision can never alias different objects.
+	The table owns one reference to every object and hands out new ones through T::Share, an object is destroyed when the
+	last guid referencing it is released. Objects inserted without a guid stay until they are referenced and released, or trimmed */
+	template<typename T>
+	class SGDedupTable
+	{
+	public:
+		SGDedupTable() = default;
+		~SGDedupTable() = default;
+
+		SGDedupTable(const SGDedupTable<T>& other) = delete;
+		SGDedupTable<T>& operator=(const SGDedupTable<T>& other) = delete;
+
+		bool Acquire(const SGGuid& guid, const void* content, size_t size, T& shared); // False when no object was created from the content
+		void Insert(const SGGuid& guid, const void* content, size_t size, T&& value, T& shared); // Shares an identical object inserted meanwhile instead
+		bool Contains(const void* content, size_t size);
+		void Release(const SGGuid& guid);
+		void Trim(); // Destroys the objects no guid references
+
+		size_t Size();
+		template<typename Function>
+		void ForEach(Function function); // Called with the content and the object of every entry while the table is locked
+
+	private:
+		struct Entry
+		{
+			std::vector<unsigned char> content;
+			T value;
+			unsigned int references = 0;
+		};
+
+		typedef std::unordered_multimap<uint64_t, Entry> EntryMap;
+
+		std::mutex tableMutex;
+		EntryMap entries;
+		std::unordered_map<SGGuid, Entry*> owners;
+
+		typename EntryMap::iterator Find(uint64_t hash, const void* content, size_t size);
+		void AddReference(const SGGuid& guid, Entry& entry, T& shared);
+		void RemoveReference(const SGGuid& guid);
+	};
+
+	template<typename T>
+	inline bool SGDedupTable<T>::Acquire(const SGGuid& guid, const void* content, size_t size, T& shared)
+	{
+		std::lock_guard<std::mutex> lock(tableMutex);
+		auto found = Find(HashContent(content, size), content, size);
+
+		if (found == entries.end())
+			return false;
+
+		AddReference(guid, found->second, shared);
+		return true;
+	}
+
+	template<typename T>
+	inline void SGDedupTable<T>::Insert(const SGGuid& guid, const void* content, size_t size, T&& value, T& shared)
+	{
+		std::lock_guard<std::mutex> lock(tableMutex);
+		uint64_t hash = HashContent(content, size);
+		auto found = Find(hash, content, size);
+
+		if (found == entries.end())
+		{
+			const unsigned char* bytes = static_cast<const unsigned char*>(content);
+			found = entries.emplace(hash, Entry{ std::vector<unsigned char>(bytes, bytes + size), std::move(value) });
+		}
+
+		AddReference(guid, found->second, shared);
+	}
+
+	template<typename T>
+	inline bool SGDedupTable<T>::Contains(const void* content, size_t size)
+	{
+		std::lock_guard<std::mutex> lock(tableMutex);
+		return Find(HashContent(content, size), content, size) != entries.end();
+	}
+
+	template<typename T>
+	inline void SGDedupTable<T>::Release(const SGGuid& guid)
+	{
+		std::lock_guard<std::mutex> lock(tableMutex);
+		RemoveReference(guid);
+	}
+
+	template<typename T>
+	inline void SGDedupTable<T>::Trim()
+	{
+		std::lock_guard<std::mutex> lock(tableMutex);
+
+		for (auto entry = entries.begin(); entry != entries.end();)
+		{
+			if (entry->second.references == 0)
+				entry = entries.erase(entry);
+			else
+				++entry;
+		}
+	}
+
+	template<typename T>
+	inline size_t SGDedupTable<T>::Size()
+	{
+		std::lock_guard<std::mutex> lock(tableMutex);
+		return entries.size();
+	}
+
+	template<typename T>
+	template<typename Function>
+	inline void SGDedupTable<T>::ForEach(Function function)
+	{
+		std::lock_guard<std::mutex> lock(tableMutex);
+
+		for (auto& entry : entries)
+			function(entry.second.content, static_cast<const T&>(entry.second.value));
+	}
+
+	template<typename T>
+	inline typename SGDedupTable<T>::EntryMap::iterator SGDedupTable<T>::Find(uint64_t hash, const void* content, size_t size)
+	{
+		auto range = entries.equal_range(hash);
+
+		for (auto entry = range.first; entry != range.second; ++entry)
+		{
+			const std::vector<unsigned char>& stored = entry->second.content;
+
+			if (stored.size() == size && (size == 0 || std::memcmp(stored.data(), content, size) == 0))
+				return entry;
+		}
+
+		return entries.end();
+	}
+
+	template<typename T>
+	inline void SGDedupTable<T>::AddReference(const SGGuid& guid, Entry& entry, T& shared)
+	{
+		shared = entry.value.Share();
+
+		if (guid == SGGuid())
+			return;
+
+		// A guid that is created again stops referencing what it was created from before
+		auto owner = owners.find(guid);
+
+		if (owner != owners.end() && owner->second == &entry)
+			return;
+
+		++entry.references;
+		RemoveReference(guid);
+		owners[guid] = &entry;
+	}
+
+	template<typename T>
+	inline void SGDedupTable<T>::RemoveReference(const SGGuid& guid)
+	{
+		auto owner = owners.find(guid);
+
+		if (owner == owners.end())
+			return;
+
+		Entry* entry = owner->second;
+		owners.erase(owner);
+
+		if (--entry->references != 0)
+			return;
+
+		uint64_t hash = HashContent(entry->content.data(), entry->content.size());
+		auto range = entries.equal_range(hash);
+
+		for (auto stored = range.first; stored != range.second; ++stored)
+		{
+			if (&stored->second == entry)
+			{
+				entries.erase(stored);
+				return;
+			}
+		}
+	}
+}
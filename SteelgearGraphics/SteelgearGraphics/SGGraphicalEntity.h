@@ -1,11 +1,18 @@
 #pragma once
 
+#include <vector>
+
 #include "SGGuid.h"
 
 namespace SG
 {
 	struct SGGraphicalEntity
 	{
-		SGGuid groupGuid;
+		SGGuid groupGuid; // Used when rendering, a new group is switched to at the start of the frame it was set in
+		SGGuid updatedGroupGuid; // The latest group set, used while a frame is updated
+		SGGuid lodSetGuid;
+		unsigned int lodLevel = ~0u; // No level has been selected yet
 	};
+
+	typedef std::vector<SGGraphicalEntity>::size_type SGGraphicalEntityID;
 }
\ No newline at end of file
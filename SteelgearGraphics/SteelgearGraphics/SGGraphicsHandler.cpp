@@ -43,16 +43,17 @@ void SG::SGGraphicsHandler::SwapFrame()
 {
 	// No need to lock since this function is called only by the render engine during certain conditions
 
-	entityData.UpdateActive();
+	size_t nrOfOperations = entityData.UpdateActive();
 
 	for (auto& pair : updatedEntitiesTotalBuffer)
 		entityData[pair.first][pair.second].SwitchActiveBuffer();
 
 	updatedEntitiesTotalBuffer.clear();
-	groupData.UpdateActive();
+	nrOfOperations += groupData.UpdateActive();
 
 	for (auto& pair : updatedGroupsTotalBuffer)
 		groupData[pair.first][pair.second].SwitchActiveBuffer();
 
 	updatedGroupsTotalBuffer.clear();
+	SGProfiler::Count(SGCounter::FRAME_MAP_OPERATIONS, nrOfOperations);
 }
\ No newline at end of file
@@ -40,4 +40,22 @@ namespace SG
 	{
 		return myID;
 	}
+
+	std::string SGGuid::GetIdentifier() const
+	{
+		std::string toReturn;
+		guids.lock();
+
+		for (auto& guid : guids)
+		{
+			if (guid.second == myID)
+			{
+				toReturn = guid.first;
+				break;
+			}
+		}
+
+		guids.unlock();
+		return toReturn;
+	}
 }
\ No newline at end of file
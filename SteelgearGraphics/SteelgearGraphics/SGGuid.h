@@ -23,6 +23,7 @@ namespace SG
 		bool operator!=(const SGGuid& other) const;
 
 		size_t GetID() const;
+		std::string GetIdentifier() const; // Searches all guids, not meant to be used often
 	};
 
 }
@@ -0,0 +1,76 @@
+#include "SGHazardTracker.h"
+
+#include <algorithm>
+
+bool SG::SGBindPoint::IsOutput() const
+{
+	return type == SGBindType::RENDER_TARGET || type == SGBindType::DEPTH_STENCIL || type == SGBindType::UNORDERED_ACCESS;
+}
+
+bool SG::SGBindPoint::operator==(const SGBindPoint & other) const
+{
+	return stage == other.stage && type == other.type && slot == other.slot;
+}
+
+void SG::SGHazardTracker::Bind(const SGBindPoint & bindPoint, size_t resource, std::vector<SGBindPoint>& hazards)
+{
+	unsigned int key = GetKey(bindPoint);
+	auto previous = resourceAtBindPoint.find(key);
+
+	if (previous != resourceAtBindPoint.end())
+	{
+		if (previous->second == resource)
+			return;
+
+		Forget(bindPoint, previous->second);
+		resourceAtBindPoint.erase(previous);
+	}
+
+	if (resource == 0)
+		return;
+
+	std::vector<SGBindPoint>& bindPoints = bindPointsOfResource[resource];
+	bool output = bindPoint.IsOutput();
+	bool computeStage = bindPoint.stage == SGBindStage::COMPUTE_SHADER;
+
+	// Inputs never conflict with each other and neither do outputs of the same stage, they are set together
+	auto conflicting = std::stable_partition(bindPoints.begin(), bindPoints.end(), [output, computeStage](const SGBindPoint& bound)
+	{
+		if (!bound.IsOutput())
+			return !output;
+
+		return output && (bound.stage == SGBindStage::COMPUTE_SHADER) == computeStage;
+	});
+
+	for (auto it = conflicting; it != bindPoints.end(); ++it)
+	{
+		resourceAtBindPoint.erase(GetKey(*it));
+		hazards.push_back(*it);
+	}
+
+	bindPoints.erase(conflicting, bindPoints.end());
+	bindPoints.push_back(bindPoint);
+	resourceAtBindPoint[key] = resource;
+}
+
+void SG::SGHazardTracker::Reset()
+{
+	bindPointsOfResource.clear();
+	resourceAtBindPoint.clear();
+}
+
+unsigned int SG::SGHazardTracker::GetKey(const SGBindPoint & bindPoint)
+{
+	// Slots never go above 128 (input resources)
+	return (static_cast<unsigned int>(bindPoint.stage) << 16) | (static_cast<unsigned int>(bindPoint.type) << 8) | bindPoint.slot;
+}
+
+void SG::SGHazardTracker::Forget(const SGBindPoint & bindPoint, size_t resource)
+{
+	auto bindPoints = bindPointsOfResource.find(resource);
+	auto& points = bindPoints->second;
+	points.erase(std::find(points.begin(), points.end(), bindPoint));
+
+	if (points.empty())
+		bindPointsOfResource.erase(bindPoints);
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <cstddef>
+#include <unordered_map>
+#include <vector>
+
+namespace SG
+{
+	enum class SGBindStage
+	{
+		INPUT_ASSEMBLER,
+		VERTEX_SHADER,
+		HULL_SHADER,
+		DOMAIN_SHADER,
+		GEOMETRY_SHADER,
+		PIXEL_SHADER,
+		COMPUTE_SHADER,
+		OUTPUT_MERGER
+	};
+
+	enum class SGBindType
+	{
+		VERTEX_BUFFER,
+		INDEX_BUFFER,
+		SHADER_RESOURCE,
+		RENDER_TARGET,
+		DEPTH_STENCIL,
+		UNORDERED_ACCESS
+	};
+
+	struct SGBindPoint
+	{
+		SGBindStage stage;
+		SGBindType type;
+		unsigned int slot = 0;
+
+		bool IsOutput() const;
+		bool operator==(const SGBindPoint& other) const;
+	};
+
+	/** Keeps track of where resources are bound on a context to find the bindings that conflict with a new one.
+	Resources are identified by any unique number except 0, which is used for unbinding.
+	A resource bound as output can not be bound as input at the same time and the outputs of the output merger
+	and the compute stage exclude each other, the runtime silently unbinds the older binding in both cases */
+	class SGHazardTracker
+	{
+	public:
+		SGHazardTracker() = default;
+		~SGHazardTracker() = default;
+
+		/** Adds the bind points that hold the resource and conflict with binding it to bindPoint to hazards.
+		These are forgotten by the tracker and have to be unbound by the caller before the new binding is made */
+		void Bind(const SGBindPoint& bindPoint, size_t resource, std::vector<SGBindPoint>& hazards);
+		void Reset();
+
+	private:
+		std::unordered_map<size_t, std::vector<SGBindPoint>> bindPointsOfResource;
+		std::unordered_map<unsigned int, size_t> resourceAtBindPoint; // Key from GetKey
+
+		static unsigned int GetKey(const SGBindPoint& bindPoint);
+		void Forget(const SGBindPoint& bindPoint, size_t resource);
+	};
+}
@@ -0,0 +1,78 @@
+#include "SGJobBalancer.h"
+
+#include <algorithm>
+#include <numeric>
+
+double SG::SGJobBalancer::PredictTime(const SGGuid & job, size_t nrOfEntities) const
+{
+	auto found = timePerEntity.find(job);
+	return (found != timePerEntity.end() ? found->second : DEFAULT_TIME_PER_ENTITY) * std::max<size_t>(nrOfEntities, 1);
+}
+
+void SG::SGJobBalancer::AddRecordedTime(const SGGuid & job, size_t nrOfEntities, double time)
+{
+	if (nrOfEntities == 0)
+		return;
+
+	double recordedPerEntity = time / nrOfEntities;
+	auto result = timePerEntity.emplace(job, recordedPerEntity);
+
+	if (!result.second)
+		result.first->second += SMOOTHING * (recordedPerEntity - result.first->second);
+}
+
+void SG::SGJobBalancer::CreateSegments(const std::vector<double>& predictedChunkTimes, size_t nrOfSegments)
+{
+	segments.clear();
+	nextSegment = 0;
+	nrOfSegments = std::min(nrOfSegments, predictedChunkTimes.size());
+
+	if (nrOfSegments == 0)
+	{
+		segmentOrder.clear();
+		return;
+	}
+
+	double totalTime = std::accumulate(predictedChunkTimes.begin(), predictedChunkTimes.end(), 0.0);
+	double targetTime = totalTime / nrOfSegments;
+	SGChunkSegment currentSegment = { 0, 0, 0.0 };
+
+	for (size_t i = 0; i < predictedChunkTimes.size(); ++i)
+	{
+		currentSegment.predictedTime += predictedChunkTimes[i];
+		currentSegment.chunkEnd = i + 1;
+
+		if (currentSegment.predictedTime >= targetTime && segments.size() + 1 < nrOfSegments)
+		{
+			segments.push_back(currentSegment);
+			currentSegment = { i + 1, i + 1, 0.0 };
+		}
+	}
+
+	if (currentSegment.chunkEnd > currentSegment.chunkStart)
+		segments.push_back(currentSegment);
+
+	// The stable sort keeps the order deterministic between segments with the same prediction
+	segmentOrder.resize(segments.size());
+	std::iota(segmentOrder.begin(), segmentOrder.end(), 0);
+	std::stable_sort(segmentOrder.begin(), segmentOrder.end(), [this](size_t first, size_t second)
+	{
+		return segments[first].predictedTime > segments[second].predictedTime;
+	});
+}
+
+const std::vector<SG::SGChunkSegment>& SG::SGJobBalancer::GetSegments() const
+{
+	return segments;
+}
+
+bool SG::SGJobBalancer::TakeSegment(size_t & segment)
+{
+	size_t next = nextSegment++;
+
+	if (next >= segmentOrder.size())
+		return false;
+
+	segment = segmentOrder[next];
+	return true;
+}
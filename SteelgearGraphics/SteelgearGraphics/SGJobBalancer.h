@@ -0,0 +1,45 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <unordered_map>
+#include <vector>
+
+#include "SGGuid.h"
+
+namespace SG
+{
+	// A contiguous range of chunks that is recorded into one command list
+	struct SGChunkSegment
+	{
+		size_t chunkStart;
+		size_t chunkEnd;
+		double predictedTime;
+	};
+
+	/** Groups the chunks of a frame into contiguous segments of about the same predicted recording time and hands them out
+	longest predicted first (LPT), so a thread that finishes early keeps taking work. Predictions come from a moving average of the
+	time per entity each job took in earlier frames. Segments can be taken from any thread, everything else is called from one */
+	class SGJobBalancer
+	{
+	public:
+		SGJobBalancer() = default;
+		~SGJobBalancer() = default;
+
+		double PredictTime(const SGGuid& job, size_t nrOfEntities) const; // Jobs without entities, like clears, are predicted as one entity
+		void AddRecordedTime(const SGGuid& job, size_t nrOfEntities, double time);
+
+		void CreateSegments(const std::vector<double>& predictedChunkTimes, size_t nrOfSegments); // At most nrOfSegments
+		const std::vector<SGChunkSegment>& GetSegments() const; // In chunk order
+		bool TakeSegment(size_t& segment); // Index of the next segment to record, false when every segment has been taken
+
+		static constexpr double DEFAULT_TIME_PER_ENTITY = 2.0; // Used for jobs that have not been recorded before
+		static constexpr double SMOOTHING = 0.2;
+
+	private:
+		std::vector<SGChunkSegment> segments;
+		std::vector<size_t> segmentOrder;
+		std::atomic<size_t> nextSegment = 0;
+		std::unordered_map<SGGuid, double> timePerEntity; // Moving average from earlier frames
+	};
+}
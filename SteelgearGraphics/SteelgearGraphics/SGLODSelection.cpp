@@ -0,0 +1,70 @@
+#include "SGLODSelection.h"
+
+#include <cfloat>
+#include <cmath>
+#include <emmintrin.h>
+
+void SG::ComputeScreenSizes(const SGEntityBounds & bounds, const SGLODCamera & camera,
+	const SGGraphicalEntityID * entities, size_t count, float * sizes)
+{
+	const __m128 cameraX = _mm_set1_ps(camera.position[0]);
+	const __m128 cameraY = _mm_set1_ps(camera.position[1]);
+	const __m128 cameraZ = _mm_set1_ps(camera.position[2]);
+	const __m128 scale = _mm_set1_ps(camera.projectionScale);
+	const __m128 largest = _mm_set1_ps(FLT_MAX);
+	size_t i = 0;
+
+	for (; i + 4 <= count; i += 4)
+	{
+		const SGGraphicalEntityID* e = entities + i;
+		__m128 deltaX = _mm_sub_ps(_mm_setr_ps(bounds.centerX[e[0]], bounds.centerX[e[1]], bounds.centerX[e[2]], bounds.centerX[e[3]]), cameraX);
+		__m128 deltaY = _mm_sub_ps(_mm_setr_ps(bounds.centerY[e[0]], bounds.centerY[e[1]], bounds.centerY[e[2]], bounds.centerY[e[3]]), cameraY);
+		__m128 deltaZ = _mm_sub_ps(_mm_setr_ps(bounds.centerZ[e[0]], bounds.centerZ[e[1]], bounds.centerZ[e[2]], bounds.centerZ[e[3]]), cameraZ);
+		__m128 radius = _mm_setr_ps(bounds.radius[e[0]], bounds.radius[e[1]], bounds.radius[e[2]], bounds.radius[e[3]]);
+
+		__m128 distance = _mm_sqrt_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(deltaX, deltaX), _mm_mul_ps(deltaY, deltaY)), _mm_mul_ps(deltaZ, deltaZ)));
+
+		// Inside of the sphere the entity covers the screen whatever the field of view, which also keeps entities
+		// without bounds at the highest detail
+		__m128 inside = _mm_cmple_ps(distance, radius);
+		__m128 size = _mm_div_ps(_mm_mul_ps(radius, scale), _mm_max_ps(distance, radius));
+		_mm_storeu_ps(sizes + i, _mm_or_ps(_mm_and_ps(inside, largest), _mm_andnot_ps(inside, size)));
+	}
+
+	for (; i < count; ++i)
+	{
+		SGGraphicalEntityID entity = entities[i];
+		float deltaX = bounds.centerX[entity] - camera.position[0];
+		float deltaY = bounds.centerY[entity] - camera.position[1];
+		float deltaZ = bounds.centerZ[entity] - camera.position[2];
+		float distance = std::sqrt(deltaX * deltaX + deltaY * deltaY + deltaZ * deltaZ);
+		sizes[i] = distance > bounds.radius[entity] ? bounds.radius[entity] * camera.projectionScale / distance : FLT_MAX;
+	}
+}
+
+unsigned int SG::SelectLODLevel(const SGLODThresholds & thresholds, unsigned int currentLevel, float screenSize)
+{
+	const unsigned int nrOfLevels = static_cast<unsigned int>(thresholds.screenSizes.size());
+
+	if (currentLevel >= nrOfLevels)
+	{
+		unsigned int level = 0;
+
+		while (level + 1 < nrOfLevels && screenSize < thresholds.screenSizes[level])
+			++level;
+
+		return level;
+	}
+
+	// A level is only left when the size has moved past the threshold by the hysteresis margin,
+	// so entities close to a threshold do not flicker between two levels
+	unsigned int level = currentLevel;
+
+	while (level > 0 && screenSize >= thresholds.screenSizes[level - 1] * (1.0f + thresholds.hysteresis))
+		--level;
+
+	while (level + 1 < nrOfLevels && screenSize < thresholds.screenSizes[level] * (1.0f - thresholds.hysteresis))
+		++level;
+
+	return level;
+}
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <vector>
+
+#include "SGGraphicalEntity.h"
+#include "SGCulling.h"
+
+namespace SG
+{
+	struct SGLODCamera
+	{
+		float position[3] = { 0.0f, 0.0f, 0.0f };
+		float projectionScale = 1.0f; // 1 / tan(fovY / 2), element [1][1] of a perspective projection matrix
+	};
+
+	// Level i is used while the projected size is at least screenSizes[i], sizes are sorted from high to low
+	struct SGLODThresholds
+	{
+		std::vector<float> screenSizes;
+		float hysteresis = 0.1f;
+	};
+
+	/** Projected radius of the bounding sphere relative to half the screen height, FLT_MAX when the camera is inside of the sphere.
+	sizes needs room for count floats */
+	void ComputeScreenSizes(const SGEntityBounds& bounds, const SGLODCamera& camera,
+		const SGGraphicalEntityID* entities, size_t count, float* sizes);
+
+	/** currentLevel outside of the thresholds means no level has been picked yet */
+	unsigned int SelectLODLevel(const SGLODThresholds& thresholds, unsigned int currentLevel, float screenSize);
+}
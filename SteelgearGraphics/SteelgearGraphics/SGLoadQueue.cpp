@@ -0,0 +1,132 @@
+#include "SGLoadQueue.h"
+#include "SGTrace.h"
+
+SG::SGLoadQueue::SGLoadQueue(unsigned int nrOfLoaderThreads, size_t uploadBudgetPerFrame)
+{
+	uploadBudget = uploadBudgetPerFrame;
+
+	for (unsigned int i = 0; i < (nrOfLoaderThreads >= 1 ? nrOfLoaderThreads : 1); ++i)
+		loaderThreads.emplace_back(&SG::SGLoadQueue::LoaderThreadFunction, this);
+}
+
+SG::SGLoadQueue::~SGLoadQueue()
+{
+	Stop();
+}
+
+void SG::SGLoadQueue::Enqueue(const SGGuid & guid, size_t uploadSize, const std::function<SGResult(void)>& load, const SGLoadCallback & onComplete)
+{
+	loadMutex.lock();
+	toStart.push_back({ guid, uploadSize, load, onComplete });
+	pending.insert(guid);
+	loadMutex.unlock();
+
+	loadAvailable.notify_one();
+}
+
+bool SG::SGLoadQueue::IsPending(const SGGuid & guid)
+{
+	std::lock_guard<std::mutex> lock(loadMutex);
+	return pending.find(guid) != pending.end();
+}
+
+size_t SG::SGLoadQueue::GetNrOfPending()
+{
+	std::lock_guard<std::mutex> lock(loadMutex);
+	return pending.size();
+}
+
+void SG::SGLoadQueue::SetUploadBudget(size_t uploadBudgetPerFrame)
+{
+	loadMutex.lock();
+	uploadBudget = uploadBudgetPerFrame;
+	loadMutex.unlock();
+
+	loadAvailable.notify_all();
+}
+
+void SG::SGLoadQueue::FinishFrame()
+{
+	std::vector<Load> notifyNow;
+
+	loadMutex.lock();
+	notifyNow.swap(toNotify);
+	toNotify.swap(finished);
+	bytesStartedThisFrame = 0;
+
+	for (auto& load : notifyNow)
+		pending.erase(load.guid);
+
+	loadMutex.unlock();
+
+	loadAvailable.notify_all();
+
+	// Called without the lock so the callbacks can enqueue new loads
+	for (auto& load : notifyNow)
+	{
+		if (load.onComplete)
+			load.onComplete(load.guid, load.result);
+	}
+}
+
+void SG::SGLoadQueue::Flush()
+{
+	std::unique_lock<std::mutex> lock(loadMutex);
+	flushing = true;
+	loadAvailable.notify_all();
+	loadFinished.wait(lock, [this]() { return (toStart.empty() && nrOfStarted == 0) || !active; });
+	flushing = false;
+}
+
+void SG::SGLoadQueue::Stop()
+{
+	loadMutex.lock();
+	active = false;
+	toStart.clear();
+	loadMutex.unlock();
+
+	loadAvailable.notify_all();
+	loadFinished.notify_all();
+
+	for (auto& thread : loaderThreads)
+	{
+		if (thread.joinable())
+			thread.join();
+	}
+}
+
+void SG::SGLoadQueue::LoaderThreadFunction()
+{
+	SetTraceThreadName("SGLoadQueue loader");
+	std::unique_lock<std::mutex> lock(loadMutex);
+
+	while (active)
+	{
+		if (toStart.empty() || !CanStart(toStart.front()))
+		{
+			loadAvailable.wait(lock);
+			continue;
+		}
+
+		Load load = std::move(toStart.front());
+		toStart.pop_front();
+		bytesStartedThisFrame += load.uploadSize;
+		++nrOfStarted;
+		lock.unlock();
+
+		{
+			SGTraceScope scope("SGLoadQueue load");
+			load.result = load.load();
+		}
+
+		lock.lock();
+		--nrOfStarted;
+		finished.push_back(std::move(load));
+		loadFinished.notify_all();
+	}
+}
+
+bool SG::SGLoadQueue::CanStart(const Load & load) const
+{
+	return flushing || bytesStartedThisFrame == 0 || bytesStartedThisFrame + load.uploadSize <= uploadBudget;
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+#include "SGGuid.h"
+#include "SGResult.h"
+
+namespace SG
+{
+	// Called with the guid the load was enqueued with and the result of the load
+	typedef std::function<void(const SGGuid&, SGResult)> SGLoadCallback;
+
+	/** Runs resource loads on its own threads so the caller never waits for decoding or device creation.
+	A load only starts while the bytes started this frame are within the upload budget, a load larger than the budget
+	starts alone at the start of a frame. Loads are started in the order they were enqueued.
+	Loads add their resources to the frame maps of the handlers like any other creation, so a load that finished before
+	FinishFrame becomes visible when that frame is swapped. The callbacks are called on the thread calling FinishFrame,
+	one frame after the load finished, so the resource is in use by then.
+	Nothing in here touches the device, the loads are plain functions */
+	class SGLoadQueue
+	{
+	public:
+		SGLoadQueue(unsigned int nrOfLoaderThreads, size_t uploadBudgetPerFrame);
+		~SGLoadQueue();
+
+		SGLoadQueue(const SGLoadQueue& other) = delete;
+		SGLoadQueue& operator=(const SGLoadQueue& other) = delete;
+
+		void Enqueue(const SGGuid& guid, size_t uploadSize, const std::function<SGResult(void)>& load, const SGLoadCallback& onComplete = nullptr);
+		bool IsPending(const SGGuid& guid); // True from Enqueue until the callback of the load is called
+		size_t GetNrOfPending();
+
+		void SetUploadBudget(size_t uploadBudgetPerFrame);
+		void FinishFrame(); // Calls the callbacks of the loads collected last frame, collects the finished loads and resets the budget
+		void Flush(); // Waits until every enqueued load has finished, ignoring the budget
+		void Stop(); // Waits for the loads in progress, loads not yet started are dropped without their callbacks
+
+	private:
+		struct Load
+		{
+			SGGuid guid;
+			size_t uploadSize;
+			std::function<SGResult(void)> load;
+			SGLoadCallback onComplete;
+			SGResult result = SGResult::OK;
+		};
+
+		std::mutex loadMutex;
+		std::condition_variable loadAvailable;
+		std::condition_variable loadFinished;
+		std::deque<Load> toStart;
+		std::vector<Load> finished;
+		std::vector<Load> toNotify;
+		std::unordered_set<SGGuid> pending;
+		std::vector<std::thread> loaderThreads;
+		size_t uploadBudget;
+		size_t bytesStartedThisFrame = 0;
+		unsigned int nrOfStarted = 0; // Loads that are running right now
+		bool flushing = false;
+		bool active = true;
+
+		void LoaderThreadFunction();
+		bool CanStart(const Load& load) const;
+	};
+}
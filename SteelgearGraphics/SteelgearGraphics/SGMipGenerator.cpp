@@ -0,0 +1,345 @@
+#include "SGMipGenerator.h"
+
+#include <algorithm>
+#include <cmath>
+#include <emmintrin.h>
+
+namespace
+{
+	const size_t TEXELS_PER_TASK = 16384;
+	const float FILTER_RADIUS = 3.0f; // Of the windowed sinc filters, in destination texels
+	const float KAISER_ALPHA = 4.0f;
+	const float PI = 3.14159265358979f;
+
+	// The source texels one destination texel is made from, texels outside of the image are folded onto its edge
+	struct Tap
+	{
+		size_t first = 0;
+		std::vector<float> weights;
+	};
+
+	float Sinc(float x)
+	{
+		if (std::fabs(x) < 1e-6f)
+			return 1.0f;
+
+		return std::sin(PI * x) / (PI * x);
+	}
+
+	float BesselI0(float x)
+	{
+		float sum = 1.0f;
+		float term = 1.0f;
+
+		for (int k = 1; k < 32 && term > sum * 1e-8f; ++k)
+		{
+			float factor = x * 0.5f / k;
+			term *= factor * factor;
+			sum += term;
+		}
+
+		return sum;
+	}
+
+	float WindowedSinc(SG::SGMipFilter filter, float x)
+	{
+		float t = x / FILTER_RADIUS;
+
+		if (t * t >= 1.0f)
+			return 0.0f;
+
+		if (filter == SG::SGMipFilter::LANCZOS)
+			return Sinc(x) * Sinc(t);
+
+		return Sinc(x) * BesselI0(KAISER_ALPHA * std::sqrt(1.0f - t * t)) / BesselI0(KAISER_ALPHA);
+	}
+
+	std::vector<Tap> CreateTaps(size_t sourceSize, size_t destinationSize, SG::SGMipFilter filter)
+	{
+		std::vector<Tap> taps(destinationSize);
+		float scale = static_cast<float>(sourceSize) / destinationSize;
+
+		for (size_t i = 0; i < destinationSize; ++i)
+		{
+			Tap& tap = taps[i];
+
+			if (filter == SG::SGMipFilter::BOX)
+			{
+				// Weighted by how much of each source texel is covered, so odd sizes are averaged correctly
+				float start = i * scale;
+				float end = start + scale;
+				tap.first = static_cast<size_t>(start);
+				size_t last = std::min(sourceSize, static_cast<size_t>(std::ceil(end)));
+
+				for (size_t j = tap.first; j < last; ++j)
+					tap.weights.push_back(std::min(end, j + 1.0f) - std::max(start, static_cast<float>(j)));
+			}
+			else
+			{
+				float center = (i + 0.5f) * scale;
+				long long first = static_cast<long long>(std::floor(center - FILTER_RADIUS * scale));
+				long long last = static_cast<long long>(std::ceil(center + FILTER_RADIUS * scale));
+				tap.first = static_cast<size_t>(std::max(first, 0ll));
+				tap.weights.resize(static_cast<size_t>(std::min<long long>(last, sourceSize - 1)) - tap.first + 1, 0.0f);
+
+				for (long long j = first; j <= last; ++j)
+				{
+					size_t clamped = static_cast<size_t>(std::min<long long>(std::max(j, 0ll), sourceSize - 1));
+					tap.weights[clamped - tap.first] += WindowedSinc(filter, (j + 0.5f - center) / scale);
+				}
+			}
+
+			float sum = 0.0f;
+
+			for (float weight : tap.weights)
+				sum += weight;
+
+			for (float& weight : tap.weights)
+				weight /= sum;
+		}
+
+		return taps;
+	}
+
+	/** The image is seen as outer blocks of sourceLength lines along the filtered axis, each line holding inner texels.
+	A destination line is the weighted sum of whole source lines, which keeps every load and store contiguous */
+	void ResampleAxis(const float* source, float* destination, const std::vector<Tap>& taps, size_t sourceLength, size_t inner,
+		size_t outer, SG::SGThreadPool* threadPool)
+	{
+		size_t nrOfLines = outer * taps.size();
+		size_t linesPerTask = std::max<size_t>(TEXELS_PER_TASK / inner, 1);
+
+		SG::RunTasks(threadPool, nrOfLines, linesPerTask, [=, &taps](size_t start, size_t end)
+		{
+			const __m128 zero = _mm_setzero_ps();
+
+			for (size_t line = start; line < end; ++line)
+			{
+				const Tap& tap = taps[line % taps.size()];
+				const float* block = source + (line / taps.size()) * sourceLength * inner * 4;
+				float* output = destination + line * inner * 4;
+
+				for (size_t i = 0; i < inner; ++i)
+					_mm_storeu_ps(output + i * 4, zero);
+
+				for (size_t j = 0; j < tap.weights.size(); ++j)
+				{
+					const __m128 weight = _mm_set1_ps(tap.weights[j]);
+					const float* input = block + (tap.first + j) * inner * 4;
+
+					for (size_t i = 0; i < inner; ++i)
+						_mm_storeu_ps(output + i * 4, _mm_add_ps(_mm_loadu_ps(output + i * 4), _mm_mul_ps(_mm_loadu_ps(input + i * 4), weight)));
+				}
+			}
+		});
+	}
+
+	float SRGBToLinear(float value)
+	{
+		return value <= 0.04045f ? value / 12.92f : std::pow((value + 0.055f) / 1.055f, 2.4f);
+	}
+
+	struct SRGBTables
+	{
+		float toLinear[256];
+		float thresholds[255]; // Linear value where encoding starts to round up to the next byte
+
+		SRGBTables()
+		{
+			for (int i = 0; i < 256; ++i)
+				toLinear[i] = SRGBToLinear(i / 255.0f);
+
+			for (int i = 0; i < 255; ++i)
+				thresholds[i] = SRGBToLinear((i + 0.5f) / 255.0f);
+		}
+	};
+
+	const SRGBTables& GetSRGBTables()
+	{
+		static const SRGBTables tables;
+		return tables;
+	}
+
+	void ToFloat(const unsigned char* texels, size_t nrOfTexels, bool srgb, float* output, SG::SGThreadPool* threadPool)
+	{
+		const SRGBTables& tables = GetSRGBTables();
+
+		SG::RunTasks(threadPool, nrOfTexels, TEXELS_PER_TASK, [=, &tables](size_t start, size_t end)
+		{
+			const __m128 inverse = _mm_set1_ps(1.0f / 255.0f);
+			const __m128i zero = _mm_setzero_si128();
+
+			for (size_t i = start; i < end; ++i)
+			{
+				__m128i bytes = _mm_cvtsi32_si128(texels[i * 4] | texels[i * 4 + 1] << 8 | texels[i * 4 + 2] << 16 | texels[i * 4 + 3] << 24);
+				__m128i values = _mm_unpacklo_epi16(_mm_unpacklo_epi8(bytes, zero), zero);
+				_mm_storeu_ps(output + i * 4, _mm_mul_ps(_mm_cvtepi32_ps(values), inverse));
+
+				if (srgb)
+				{
+					for (size_t j = 0; j < 3; ++j)
+						output[i * 4 + j] = tables.toLinear[texels[i * 4 + j]];
+				}
+			}
+		});
+	}
+
+	void ToBytes(const float* texels, size_t nrOfTexels, bool srgb, float alphaScale, unsigned char* output, SG::SGThreadPool* threadPool)
+	{
+		const SRGBTables& tables = GetSRGBTables();
+
+		SG::RunTasks(threadPool, nrOfTexels, TEXELS_PER_TASK, [=, &tables](size_t start, size_t end)
+		{
+			const __m128 scale = _mm_setr_ps(255.0f, 255.0f, 255.0f, 255.0f * alphaScale);
+			const __m128 half = _mm_set1_ps(0.5f);
+			const __m128 zero = _mm_setzero_ps();
+			const __m128 maximum = _mm_set1_ps(255.0f);
+
+			for (size_t i = start; i < end; ++i)
+			{
+				__m128 values = _mm_min_ps(_mm_max_ps(_mm_add_ps(_mm_mul_ps(_mm_loadu_ps(texels + i * 4), scale), half), zero), maximum);
+				__m128i integers = _mm_cvttps_epi32(values);
+				integers = _mm_packs_epi32(integers, integers);
+				int packed = _mm_cvtsi128_si32(_mm_packus_epi16(integers, integers));
+
+				for (size_t j = 0; j < 4; ++j)
+					output[i * 4 + j] = static_cast<unsigned char>(packed >> (j * 8));
+
+				if (srgb)
+				{
+					for (size_t j = 0; j < 3; ++j)
+						output[i * 4 + j] = static_cast<unsigned char>(std::upper_bound(tables.thresholds, tables.thresholds + 255, texels[i * 4 + j]) - tables.thresholds);
+				}
+			}
+		});
+	}
+
+	float GetAlphaCoverage(const float* texels, size_t nrOfTexels, float reference, float alphaScale)
+	{
+		size_t covered = 0;
+
+		for (size_t i = 0; i < nrOfTexels; ++i)
+		{
+			if (texels[i * 4 + 3] * alphaScale > reference)
+				++covered;
+		}
+
+		return static_cast<float>(covered) / nrOfTexels;
+	}
+
+	/** Filtering smooths alpha towards its average, which makes alpha tested geometry thin out or grow in the smaller mips.
+	Coverage only grows with the scale, so the scale that restores it is found with a binary search */
+	float FindAlphaScale(const float* texels, size_t nrOfTexels, float reference, float coverage)
+	{
+		float low = 0.0f;
+		float high = 1.0f;
+
+		while (GetAlphaCoverage(texels, nrOfTexels, reference, high) < coverage && high < 256.0f)
+		{
+			low = high;
+			high *= 2.0f;
+		}
+
+		for (int i = 0; i < 16; ++i)
+		{
+			float middle = (low + high) * 0.5f;
+
+			if (GetAlphaCoverage(texels, nrOfTexels, reference, middle) < coverage)
+				low = middle;
+			else
+				high = middle;
+		}
+
+		// A small mip can only reach a few coverages, so the closest one is used when none matches
+		float lowError = coverage - GetAlphaCoverage(texels, nrOfTexels, reference, low);
+		float highError = GetAlphaCoverage(texels, nrOfTexels, reference, high) - coverage;
+		return lowError < highError ? low : high;
+	}
+}
+
+SG::SGResult SG::GenerateMips(const SGMipImage & source, const SGMipSettings & settings, std::vector<SGMipImage>& mips, SGThreadPool * threadPool)
+{
+	size_t nrOfTexels = static_cast<size_t>(source.width) * source.height * source.depth;
+
+	if (nrOfTexels == 0 || source.texels.size() != nrOfTexels * 4)
+		return SGResult::FAIL;
+
+	unsigned int fullChain = GetNrOfMipLevels(source.width, source.height, source.depth);
+	unsigned int mipLevels = settings.mipLevels != 0 ? settings.mipLevels : fullChain;
+
+	if (mipLevels > fullChain)
+		return SGResult::FAIL;
+
+	mips.clear();
+	mips.resize(mipLevels);
+	mips[0] = source;
+
+	// Filtering continues from the unquantized previous mip, so rounding errors do not add up along the chain
+	std::vector<float> current(nrOfTexels * 4);
+	std::vector<float> filtered;
+	ToFloat(source.texels.data(), nrOfTexels, settings.srgb, current.data(), threadPool);
+
+	bool preserveCoverage = settings.alphaReference >= 0.0f;
+	float coverage = preserveCoverage ? GetAlphaCoverage(current.data(), nrOfTexels, settings.alphaReference, 1.0f) : 0.0f;
+	size_t width = source.width;
+	size_t height = source.height;
+	size_t depth = source.depth;
+
+	for (unsigned int mip = 1; mip < mipLevels; ++mip)
+	{
+		size_t nextWidth = std::max<size_t>(width / 2, 1);
+		size_t nextHeight = std::max<size_t>(height / 2, 1);
+		size_t nextDepth = std::max<size_t>(depth / 2, 1);
+
+		if (nextWidth != width)
+		{
+			filtered.resize(nextWidth * height * depth * 4);
+			ResampleAxis(current.data(), filtered.data(), CreateTaps(width, nextWidth, settings.filter), width, 1, height * depth, threadPool);
+			current.swap(filtered);
+		}
+
+		if (nextHeight != height)
+		{
+			filtered.resize(nextWidth * nextHeight * depth * 4);
+			ResampleAxis(current.data(), filtered.data(), CreateTaps(height, nextHeight, settings.filter), height, nextWidth, depth, threadPool);
+			current.swap(filtered);
+		}
+
+		if (nextDepth != depth)
+		{
+			filtered.resize(nextWidth * nextHeight * nextDepth * 4);
+			ResampleAxis(current.data(), filtered.data(), CreateTaps(depth, nextDepth, settings.filter), depth, nextWidth * nextHeight, 1, threadPool);
+			current.swap(filtered);
+		}
+
+		width = nextWidth;
+		height = nextHeight;
+		depth = nextDepth;
+		nrOfTexels = width * height * depth;
+
+		SGMipImage& image = mips[mip];
+		image.width = static_cast<unsigned int>(width);
+		image.height = static_cast<unsigned int>(height);
+		image.depth = static_cast<unsigned int>(depth);
+		image.texels.resize(nrOfTexels * 4);
+
+		float alphaScale = preserveCoverage ? FindAlphaScale(current.data(), nrOfTexels, settings.alphaReference, coverage) : 1.0f;
+		ToBytes(current.data(), nrOfTexels, settings.srgb, alphaScale, image.texels.data(), threadPool);
+	}
+
+	return SGResult::OK;
+}
+
+unsigned int SG::GetNrOfMipLevels(unsigned int width, unsigned int height, unsigned int depth)
+{
+	unsigned int largest = std::max(std::max(width, height), depth);
+	unsigned int mipLevels = 1;
+
+	while (largest > 1)
+	{
+		largest /= 2;
+		++mipLevels;
+	}
+
+	return mipLevels;
+}
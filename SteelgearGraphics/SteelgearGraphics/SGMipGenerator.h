@@ -0,0 +1,38 @@
+#pragma once
+
+#include <vector>
+
+#include "SGResult.h"
+#include "SGThreadPool.h"
+
+namespace SG
+{
+	enum class SGMipFilter
+	{
+		BOX, // Averages the texels each destination texel covers
+		KAISER, // Kaiser windowed sinc, sharper than box with little ringing
+		LANCZOS // Lanczos windowed sinc, the sharpest but rings on hard edges
+	};
+
+	struct SGMipSettings
+	{
+		SGMipFilter filter = SGMipFilter::BOX;
+		bool srgb = false; // Colour is filtered in linear space and stored as sRGB, alpha is always linear
+		float alphaReference = -1.0f; // Every mip keeps the share of texels above this alpha test threshold that mip 0 has, disabled when negative
+		unsigned int mipLevels = 0; // Including mip 0, 0 makes the full chain
+	};
+
+	// Four 8 bit channels per texel with alpha last, rows and slices are tightly packed
+	struct SGMipImage
+	{
+		unsigned int width = 0;
+		unsigned int height = 0;
+		unsigned int depth = 1;
+		std::vector<unsigned char> texels;
+	};
+
+	/** mips[i] is mip i of source with mips[0] being a copy of it. Every axis is halved on its own, so a volume shrinks in depth too.
+	Nothing depends on the graphics API, so chains can be made when baking assets as well as before creating textures. threadPool can be nullptr */
+	SGResult GenerateMips(const SGMipImage& source, const SGMipSettings& settings, std::vector<SGMipImage>& mips, SGThreadPool* threadPool);
+	unsigned int GetNrOfMipLevels(unsigned int width, unsigned int height, unsigned int depth = 1);
+}
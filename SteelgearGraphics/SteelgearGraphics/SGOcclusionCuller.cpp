@@ -0,0 +1,505 @@
+#include "SGOcclusionCuller.h"
+#include "SGCapture.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+#include <emmintrin.h>
+
+namespace
+{
+	const unsigned int TILE_SIZE = 8;
+	const float NEAR_W = 1e-5f;
+
+	void MultiplyMatrices(const float first[16], const float second[16], float result[16])
+	{
+		for (int row = 0; row < 4; ++row)
+		{
+			for (int column = 0; column < 4; ++column)
+			{
+				result[row * 4 + column] = first[row * 4 + 0] * second[0 * 4 + column] + first[row * 4 + 1] * second[1 * 4 + column] +
+					first[row * 4 + 2] * second[2 * 4 + column] + first[row * 4 + 3] * second[3 * 4 + column];
+			}
+		}
+	}
+
+	bool InvertMatrix(const float m[16], float result[16])
+	{
+		float inverse[16];
+
+		inverse[0] = m[5] * m[10] * m[15] - m[5] * m[11] * m[14] - m[9] * m[6] * m[15] + m[9] * m[7] * m[14] + m[13] * m[6] * m[11] - m[13] * m[7] * m[10];
+		inverse[4] = -m[4] * m[10] * m[15] + m[4] * m[11] * m[14] + m[8] * m[6] * m[15] - m[8] * m[7] * m[14] - m[12] * m[6] * m[11] + m[12] * m[7] * m[10];
+		inverse[8] = m[4] * m[9] * m[15] - m[4] * m[11] * m[13] - m[8] * m[5] * m[15] + m[8] * m[7] * m[13] + m[12] * m[5] * m[11] - m[12] * m[7] * m[9];
+		inverse[12] = -m[4] * m[9] * m[14] + m[4] * m[10] * m[13] + m[8] * m[5] * m[14] - m[8] * m[6] * m[13] - m[12] * m[5] * m[10] + m[12] * m[6] * m[9];
+		inverse[1] = -m[1] * m[10] * m[15] + m[1] * m[11] * m[14] + m[9] * m[2] * m[15] - m[9] * m[3] * m[14] - m[13] * m[2] * m[11] + m[13] * m[3] * m[10];
+		inverse[5] = m[0] * m[10] * m[15] - m[0] * m[11] * m[14] - m[8] * m[2] * m[15] + m[8] * m[3] * m[14] + m[12] * m[2] * m[11] - m[12] * m[3] * m[10];
+		inverse[9] = -m[0] * m[9] * m[15] + m[0] * m[11] * m[13] + m[8] * m[1] * m[15] - m[8] * m[3] * m[13] - m[12] * m[1] * m[11] + m[12] * m[3] * m[9];
+		inverse[13] = m[0] * m[9] * m[14] - m[0] * m[10] * m[13] - m[8] * m[1] * m[14] + m[8] * m[2] * m[13] + m[12] * m[1] * m[10] - m[12] * m[2] * m[9];
+		inverse[2] = m[1] * m[6] * m[15] - m[1] * m[7] * m[14] - m[5] * m[2] * m[15] + m[5] * m[3] * m[14] + m[13] * m[2] * m[7] - m[13] * m[3] * m[6];
+		inverse[6] = -m[0] * m[6] * m[15] + m[0] * m[7] * m[14] + m[4] * m[2] * m[15] - m[4] * m[3] * m[14] - m[12] * m[2] * m[7] + m[12] * m[3] * m[6];
+		inverse[10] = m[0] * m[5] * m[15] - m[0] * m[7] * m[13] - m[4] * m[1] * m[15] + m[4] * m[3] * m[13] + m[12] * m[1] * m[7] - m[12] * m[3] * m[5];
+		inverse[14] = -m[0] * m[5] * m[14] + m[0] * m[6] * m[13] + m[4] * m[1] * m[14] - m[4] * m[2] * m[13] - m[12] * m[1] * m[6] + m[12] * m[2] * m[5];
+		inverse[3] = -m[1] * m[6] * m[11] + m[1] * m[7] * m[10] + m[5] * m[2] * m[11] - m[5] * m[3] * m[10] - m[9] * m[2] * m[7] + m[9] * m[3] * m[6];
+		inverse[7] = m[0] * m[6] * m[11] - m[0] * m[7] * m[10] - m[4] * m[2] * m[11] + m[4] * m[3] * m[10] + m[8] * m[2] * m[7] - m[8] * m[3] * m[6];
+		inverse[11] = -m[0] * m[5] * m[11] + m[0] * m[7] * m[9] + m[4] * m[1] * m[11] - m[4] * m[3] * m[9] - m[8] * m[1] * m[7] + m[8] * m[3] * m[5];
+		inverse[15] = m[0] * m[5] * m[10] - m[0] * m[6] * m[9] - m[4] * m[1] * m[10] + m[4] * m[2] * m[9] + m[8] * m[1] * m[6] - m[8] * m[2] * m[5];
+
+		float determinant = m[0] * inverse[0] + m[1] * inverse[4] + m[2] * inverse[8] + m[3] * inverse[12];
+
+		if (determinant == 0.0f)
+			return false;
+
+		for (int i = 0; i < 16; ++i)
+			result[i] = inverse[i] / determinant;
+
+		return true;
+	}
+
+	void TransformPoint(const float m[16], float x, float y, float z, float result[4])
+	{
+		for (int column = 0; column < 4; ++column)
+			result[column] = x * m[column] + y * m[4 + column] + z * m[8 + column] + m[12 + column];
+	}
+}
+
+SG::SGOcclusionCuller::SGOcclusionCuller(const SGOccluderSettings & settings)
+{
+	this->settings = settings;
+	this->settings.width = ((settings.width + TILE_SIZE - 1) / TILE_SIZE) * TILE_SIZE;
+	this->settings.height = ((settings.height + TILE_SIZE - 1) / TILE_SIZE) * TILE_SIZE;
+
+	if (this->settings.width == 0 || this->settings.height == 0)
+		throw std::runtime_error("Error creating occlusion culler, depth buffer can not be empty");
+
+	tilesX = this->settings.width / TILE_SIZE;
+	tilesY = this->settings.height / TILE_SIZE;
+	depthBuffer.resize(this->settings.width * this->settings.height, 1.0f);
+	previousDepthBuffer.resize(depthBuffer.size(), 1.0f);
+	depthAge.resize(depthBuffer.size(), 0);
+	previousDepthAge.resize(depthBuffer.size(), 0);
+	tileMaxDepth.resize(tilesX * tilesY, 1.0f);
+
+	for (int i = 0; i < 16; ++i)
+		viewProjection[i] = previousViewProjection[i] = (i % 5 == 0) ? 1.0f : 0.0f;
+}
+
+void SG::SGOcclusionCuller::AddOccluder(const SGGuid & guid, const std::vector<float>& positions, const std::vector<unsigned int>& indices)
+{
+	SGCaptureScope capture(SGCaptureCall::ADD_OCCLUDER, guid, positions, indices);
+	for (auto index : indices)
+		if (static_cast<size_t>(index) * 3 + 2 >= positions.size())
+			throw std::runtime_error("Error adding occluder, index out of range");
+
+	Occluder occluder;
+	occluder.positions = positions;
+	occluder.indices = indices;
+
+	for (int i = 0; i < 16; ++i)
+		occluder.worldMatrix[i] = (i % 5 == 0) ? 1.0f : 0.0f;
+
+	occluderMutex.lock();
+
+	if (occluders.find(guid) == occluders.end())
+		occluderOrder.push_back(guid);
+
+	occluders[guid] = std::move(occluder);
+	occluderMutex.unlock();
+}
+
+void SG::SGOcclusionCuller::RemoveOccluder(const SGGuid & guid)
+{
+	SGCaptureScope capture(SGCaptureCall::REMOVE_OCCLUDER, guid);
+	occluderMutex.lock();
+	occluders.erase(guid);
+	occluderOrder.erase(std::remove(occluderOrder.begin(), occluderOrder.end(), guid), occluderOrder.end());
+	hasPreviousFrame = false;
+	occluderMutex.unlock();
+}
+
+void SG::SGOcclusionCuller::SetOccluderTransform(const SGGuid & guid, const float worldMatrix[16])
+{
+	SGCaptureScope capture(SGCaptureCall::SET_OCCLUDER_TRANSFORM, guid, SGCaptureBytes{ worldMatrix, sizeof(float) * 16 });
+	occluderMutex.lock();
+	auto occluder = occluders.find(guid);
+
+	if (occluder == occluders.end())
+	{
+		occluderMutex.unlock();
+		throw std::runtime_error("Error setting occluder transform, guid does not exist");
+	}
+
+	std::memcpy(occluder->second.worldMatrix, worldMatrix, sizeof(float) * 16);
+	hasPreviousFrame = false;
+	occluderMutex.unlock();
+}
+
+void SG::SGOcclusionCuller::SetViewProjection(const float viewProjection[16])
+{
+	SGCaptureScope capture(SGCaptureCall::SET_VIEW_PROJECTION, SGCaptureBytes{ viewProjection, sizeof(float) * 16 });
+	std::memcpy(this->viewProjection, viewProjection, sizeof(float) * 16);
+}
+
+void SG::SGOcclusionCuller::RenderOccluders(SGThreadPool * threadPool)
+{
+	depthBuffer.swap(previousDepthBuffer);
+	depthAge.swap(previousDepthAge);
+	std::fill(depthBuffer.begin(), depthBuffer.end(), 1.0f);
+	std::fill(depthAge.begin(), depthAge.end(), 0);
+
+	// The history is only trusted if no occluder changed since it was rendered
+	occluderMutex.lock();
+	TransformOccluders();
+	bool reproject = settings.temporalReprojection && hasPreviousFrame;
+	hasPreviousFrame = true;
+	occluderMutex.unlock();
+
+	// The buffer is split into horizontal bands so no two threads ever write to the same pixel
+	size_t nrOfBands = (threadPool != nullptr ? threadPool->GetNrOfThreads() : 0) + 1;
+	size_t rowsPerBand = (settings.height + nrOfBands - 1) / nrOfBands;
+
+	RunTasks(threadPool, settings.height, rowsPerBand, [this](size_t start, size_t end)
+	{
+		RasterizeBand(static_cast<int>(start), static_cast<int>(end));
+	});
+
+	if (reproject)
+		ReprojectPreviousFrame();
+
+	UpdateTileDepths();
+
+	std::memcpy(previousViewProjection, viewProjection, sizeof(float) * 16);
+}
+
+void SG::SGOcclusionCuller::CullEntities(const SGEntityBounds & bounds, const std::vector<SGGraphicalEntityID>& entities,
+	std::vector<SGGraphicalEntityID>& visibleEntities) const
+{
+	for (auto& entity : entities)
+	{
+		if (IsVisible(bounds, entity))
+			visibleEntities.push_back(entity);
+	}
+}
+
+const std::vector<float>& SG::SGOcclusionCuller::GetDepthBuffer() const
+{
+	return depthBuffer;
+}
+
+void SG::SGOcclusionCuller::TransformOccluders()
+{
+	triangles.clear();
+
+	framesPerRound = 1;
+
+	if (occluderOrder.size() == 0)
+		return;
+
+	const float width = static_cast<float>(settings.width);
+	const float height = static_cast<float>(settings.height);
+	size_t renderedTriangles = 0;
+	size_t nrOfRendered = 0;
+
+	if (nextOccluder >= occluderOrder.size())
+		nextOccluder = 0;
+
+	// With a triangle budget the occluders are rendered round robin, what is skipped is covered by the reprojection
+	while (nrOfRendered < occluderOrder.size())
+	{
+		const Occluder& occluder = occluders[occluderOrder[nextOccluder]];
+
+		if (settings.maxTrianglesPerFrame != 0 && nrOfRendered != 0 &&
+			renderedTriangles + occluder.indices.size() / 3 > settings.maxTrianglesPerFrame)
+			break;
+
+		float worldViewProjection[16];
+		MultiplyMatrices(occluder.worldMatrix, viewProjection, worldViewProjection);
+
+		for (size_t i = 0; i + 2 < occluder.indices.size(); i += 3)
+		{
+			ScreenTriangle triangle;
+			bool clipped = false;
+
+			for (int j = 0; j < 3; ++j)
+			{
+				const float* position = &occluder.positions[occluder.indices[i + j] * 3];
+				float clip[4];
+				TransformPoint(worldViewProjection, position[0], position[1], position[2], clip);
+
+				// Triangles crossing the near plane are skipped, which only makes the culling less aggressive
+				if (clip[3] < NEAR_W || clip[2] < 0.0f)
+				{
+					clipped = true;
+					break;
+				}
+
+				float inverseW = 1.0f / clip[3];
+				triangle.x[j] = (clip[0] * inverseW * 0.5f + 0.5f) * width;
+				triangle.y[j] = (0.5f - clip[1] * inverseW * 0.5f) * height;
+				triangle.z[j] = std::min(clip[2] * inverseW, 1.0f);
+			}
+
+			if (clipped)
+				continue;
+
+			float area = (triangle.x[1] - triangle.x[0]) * (triangle.y[2] - triangle.y[0]) -
+				(triangle.y[1] - triangle.y[0]) * (triangle.x[2] - triangle.x[0]);
+
+			if (area == 0.0f)
+				continue;
+
+			// Occluders are treated as double sided, make every triangle wind the same way so the
+			// edge functions in RasterizeBand are positive inside of it
+			if (area > 0.0f)
+			{
+				std::swap(triangle.x[1], triangle.x[2]);
+				std::swap(triangle.y[1], triangle.y[2]);
+				std::swap(triangle.z[1], triangle.z[2]);
+			}
+
+			float minY = std::min(triangle.y[0], std::min(triangle.y[1], triangle.y[2]));
+			float maxY = std::max(triangle.y[0], std::max(triangle.y[1], triangle.y[2]));
+			float minX = std::min(triangle.x[0], std::min(triangle.x[1], triangle.x[2]));
+			float maxX = std::max(triangle.x[0], std::max(triangle.x[1], triangle.x[2]));
+
+			if (maxX < 0.0f || maxY < 0.0f || minX >= width || minY >= height)
+				continue;
+
+			triangle.minY = std::max(static_cast<int>(std::floor(minY)), 0);
+			triangle.maxY = std::min(static_cast<int>(std::ceil(maxY)), static_cast<int>(settings.height) - 1);
+			triangles.push_back(triangle);
+		}
+
+		renderedTriangles += occluder.indices.size() / 3;
+		++nrOfRendered;
+		nextOccluder = (nextOccluder + 1) % occluderOrder.size();
+	}
+
+	framesPerRound = static_cast<unsigned int>((occluderOrder.size() + nrOfRendered - 1) / nrOfRendered);
+}
+
+void SG::SGOcclusionCuller::RasterizeBand(int startY, int endY)
+{
+	const int width = static_cast<int>(settings.width);
+	const __m128 pixelOffsets = _mm_setr_ps(0.5f, 1.5f, 2.5f, 3.5f);
+	const __m128 zero = _mm_setzero_ps();
+
+	for (auto& triangle : triangles)
+	{
+		int minY = std::max(triangle.minY, startY);
+		int maxY = std::min(triangle.maxY, endY - 1);
+
+		if (minY > maxY)
+			continue;
+
+		float minXf = std::min(triangle.x[0], std::min(triangle.x[1], triangle.x[2]));
+		float maxXf = std::max(triangle.x[0], std::max(triangle.x[1], triangle.x[2]));
+		int minX = std::max(static_cast<int>(std::floor(minXf)), 0) & ~3;
+		int maxX = std::min(static_cast<int>(std::ceil(maxXf)), width - 1);
+
+		// Edge functions E(p) = a * x + b * y + c, edge i is opposite of vertex i
+		float a[3];
+		float b[3];
+		float c[3];
+
+		for (int i = 0; i < 3; ++i)
+		{
+			int from = (i + 1) % 3;
+			int to = (i + 2) % 3;
+			a[i] = triangle.y[to] - triangle.y[from];
+			b[i] = triangle.x[from] - triangle.x[to];
+			c[i] = -(a[i] * triangle.x[from] + b[i] * triangle.y[from]);
+		}
+
+		float area = a[0] * triangle.x[0] + b[0] * triangle.y[0] + c[0];
+		__m128 zWeight0 = _mm_set1_ps(triangle.z[0] / area);
+		__m128 zWeight1 = _mm_set1_ps(triangle.z[1] / area);
+		__m128 zWeight2 = _mm_set1_ps(triangle.z[2] / area);
+
+		for (int y = minY; y <= maxY; ++y)
+		{
+			float pixelY = y + 0.5f;
+			__m128 rowEdge0 = _mm_set1_ps(b[0] * pixelY + c[0]);
+			__m128 rowEdge1 = _mm_set1_ps(b[1] * pixelY + c[1]);
+			__m128 rowEdge2 = _mm_set1_ps(b[2] * pixelY + c[2]);
+			float* row = &depthBuffer[y * width];
+
+			for (int x = minX; x <= maxX; x += 4)
+			{
+				__m128 pixelX = _mm_add_ps(_mm_set1_ps(static_cast<float>(x)), pixelOffsets);
+				__m128 edge0 = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(a[0]), pixelX), rowEdge0);
+				__m128 edge1 = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(a[1]), pixelX), rowEdge1);
+				__m128 edge2 = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(a[2]), pixelX), rowEdge2);
+
+				__m128 covered = _mm_and_ps(_mm_and_ps(_mm_cmpge_ps(edge0, zero), _mm_cmpge_ps(edge1, zero)), _mm_cmpge_ps(edge2, zero));
+
+				if (_mm_movemask_ps(covered) == 0)
+					continue;
+
+				__m128 depth = _mm_add_ps(_mm_add_ps(_mm_mul_ps(edge0, zWeight0), _mm_mul_ps(edge1, zWeight1)), _mm_mul_ps(edge2, zWeight2));
+				__m128 current = _mm_loadu_ps(row + x);
+				__m128 nearest = _mm_min_ps(current, depth);
+				_mm_storeu_ps(row + x, _mm_or_ps(_mm_and_ps(covered, nearest), _mm_andnot_ps(covered, current)));
+			}
+		}
+	}
+}
+
+void SG::SGOcclusionCuller::ReprojectPreviousFrame()
+{
+	float inversePrevious[16];
+
+	if (!InvertMatrix(previousViewProjection, inversePrevious))
+		return;
+
+	float reprojection[16];
+	MultiplyMatrices(inversePrevious, viewProjection, reprojection);
+
+	const int width = static_cast<int>(settings.width);
+	const int height = static_cast<int>(settings.height);
+	std::vector<float> reprojected(depthBuffer.size(), 1.0f);
+	std::vector<unsigned int> reprojectedAge(depthBuffer.size(), 0);
+
+	for (int y = 0; y < height; ++y)
+	{
+		for (int x = 0; x < width; ++x)
+		{
+			float previousDepth = previousDepthBuffer[y * width + x];
+			unsigned int age = previousDepthAge[y * width + x] + 1;
+
+			// Reprojected depth expires once its occluder has had a frame to be rendered again,
+			// otherwise the history would carry it from frame to frame forever
+			if (previousDepth >= 1.0f || age > framesPerRound)
+				continue;
+
+			float ndcX = (x + 0.5f) / width * 2.0f - 1.0f;
+			float ndcY = 1.0f - (y + 0.5f) / height * 2.0f;
+			float clip[4];
+			TransformPoint(reprojection, ndcX, ndcY, previousDepth, clip);
+
+			if (clip[3] < NEAR_W || clip[2] < 0.0f)
+				continue;
+
+			float inverseW = 1.0f / clip[3];
+			int newX = static_cast<int>((clip[0] * inverseW * 0.5f + 0.5f) * width);
+			int newY = static_cast<int>((0.5f - clip[1] * inverseW * 0.5f) * height);
+
+			if (newX < 0 || newY < 0 || newX >= width || newY >= height)
+				continue;
+
+			float depth = clip[2] * inverseW;
+			size_t target = newY * width + newX;
+
+			if (depth < reprojected[target])
+			{
+				reprojected[target] = depth;
+				reprojectedAge[target] = age;
+			}
+		}
+	}
+
+	// Only pixels without a fresh occluder take the reprojected depth
+	for (size_t i = 0; i < depthBuffer.size(); ++i)
+	{
+		if (depthBuffer[i] >= 1.0f)
+		{
+			depthBuffer[i] = reprojected[i];
+			depthAge[i] = reprojectedAge[i];
+		}
+	}
+}
+
+void SG::SGOcclusionCuller::UpdateTileDepths()
+{
+	const unsigned int width = settings.width;
+
+	for (unsigned int tileY = 0; tileY < tilesY; ++tileY)
+	{
+		for (unsigned int tileX = 0; tileX < tilesX; ++tileX)
+		{
+			__m128 farthest = _mm_setzero_ps();
+
+			for (unsigned int y = tileY * TILE_SIZE; y < (tileY + 1) * TILE_SIZE; ++y)
+			{
+				const float* row = &depthBuffer[y * width + tileX * TILE_SIZE];
+				farthest = _mm_max_ps(farthest, _mm_max_ps(_mm_loadu_ps(row), _mm_loadu_ps(row + 4)));
+			}
+
+			float values[4];
+			_mm_storeu_ps(values, farthest);
+			tileMaxDepth[tileY * tilesX + tileX] = std::max(std::max(values[0], values[1]), std::max(values[2], values[3]));
+		}
+	}
+}
+
+bool SG::SGOcclusionCuller::IsVisible(const SGEntityBounds & bounds, SGGraphicalEntityID entity) const
+{
+	if (bounds.radius[entity] >= FLT_MAX)
+		return true;
+
+	const float width = static_cast<float>(settings.width);
+	const float height = static_cast<float>(settings.height);
+	float minX = FLT_MAX;
+	float minY = FLT_MAX;
+	float maxX = -FLT_MAX;
+	float maxY = -FLT_MAX;
+	float minDepth = FLT_MAX;
+
+	for (int corner = 0; corner < 8; ++corner)
+	{
+		float clip[4];
+		TransformPoint(viewProjection,
+			bounds.centerX[entity] + ((corner & 1) ? bounds.extentX[entity] : -bounds.extentX[entity]),
+			bounds.centerY[entity] + ((corner & 2) ? bounds.extentY[entity] : -bounds.extentY[entity]),
+			bounds.centerZ[entity] + ((corner & 4) ? bounds.extentZ[entity] : -bounds.extentZ[entity]), clip);
+
+		// Bounds touching the near plane can not be projected and are always visible
+		if (clip[3] < NEAR_W || clip[2] < 0.0f)
+			return true;
+
+		float inverseW = 1.0f / clip[3];
+		float screenX = (clip[0] * inverseW * 0.5f + 0.5f) * width;
+		float screenY = (0.5f - clip[1] * inverseW * 0.5f) * height;
+		minX = std::min(minX, screenX);
+		maxX = std::max(maxX, screenX);
+		minY = std::min(minY, screenY);
+		maxY = std::max(maxY, screenY);
+		minDepth = std::min(minDepth, clip[2] * inverseW);
+	}
+
+	// Outside of the screen is left to the frustum culling
+	if (maxX < 0.0f || maxY < 0.0f || minX >= width || minY >= height)
+		return true;
+
+	int startX = std::max(static_cast<int>(std::floor(minX)), 0);
+	int startY = std::max(static_cast<int>(std::floor(minY)), 0);
+	int endX = std::min(static_cast<int>(std::ceil(maxX)), static_cast<int>(settings.width) - 1);
+	int endY = std::min(static_cast<int>(std::ceil(maxY)), static_cast<int>(settings.height) - 1);
+
+	// Tiles where even the farthest occluder is in front of the bounds are skipped without looking at the pixels
+	for (int tileY = startY / TILE_SIZE; tileY <= endY / static_cast<int>(TILE_SIZE); ++tileY)
+	{
+		for (int tileX = startX / TILE_SIZE; tileX <= endX / static_cast<int>(TILE_SIZE); ++tileX)
+		{
+			if (tileMaxDepth[tileY * tilesX + tileX] < minDepth)
+				continue;
+
+			int pixelStartY = std::max(startY, tileY * static_cast<int>(TILE_SIZE));
+			int pixelEndY = std::min(endY, (tileY + 1) * static_cast<int>(TILE_SIZE) - 1);
+			int pixelStartX = std::max(startX, tileX * static_cast<int>(TILE_SIZE));
+			int pixelEndX = std::min(endX, (tileX + 1) * static_cast<int>(TILE_SIZE) - 1);
+
+			for (int y = pixelStartY; y <= pixelEndY; ++y)
+			{
+				for (int x = pixelStartX; x <= pixelEndX; ++x)
+				{
+					if (depthBuffer[y * settings.width + x] >= minDepth)
+						return true;
+				}
+			}
+		}
+	}
+
+	return false;
+}
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <vector>
+#include <unordered_map>
+#include <mutex>
+
+#include "SGGuid.h"
+#include "SGGraphicalEntity.h"
+#include "SGCulling.h"
+#include "SGThreadPool.h"
+
+namespace SG
+{
+	struct SGOccluderSettings
+	{
+		unsigned int width = 256; // Rounded up to a multiple of 8
+		unsigned int height = 128; // Rounded up to a multiple of 8
+		bool temporalReprojection = true;
+		size_t maxTrianglesPerFrame = 0; // 0 means no limit, otherwise occluders are rendered round robin and their depth is reprojected until they are rendered again
+	};
+
+	// Renders occluder meshes into a low resolution depth buffer on the CPU and tests entity bounds against it.
+	// Matrices are row major and used as v * M, depth is in the range [0, 1] with 0 being the near plane
+	class SGOcclusionCuller
+	{
+	public:
+		SGOcclusionCuller(const SGOccluderSettings& settings = SGOccluderSettings());
+		~SGOcclusionCuller() = default;
+
+		/** positions are tightly packed xyz triplets in object space */
+		void AddOccluder(const SGGuid& guid, const std::vector<float>& positions, const std::vector<unsigned int>& indices);
+		void RemoveOccluder(const SGGuid& guid);
+		void SetOccluderTransform(const SGGuid& guid, const float worldMatrix[16]);
+		void SetViewProjection(const float viewProjection[16]);
+
+		void RenderOccluders(SGThreadPool* threadPool);
+		void CullEntities(const SGEntityBounds& bounds, const std::vector<SGGraphicalEntityID>& entities,
+			std::vector<SGGraphicalEntityID>& visibleEntities) const;
+
+		const std::vector<float>& GetDepthBuffer() const;
+
+	private:
+		struct Occluder
+		{
+			std::vector<float> positions;
+			std::vector<unsigned int> indices;
+			float worldMatrix[16];
+		};
+
+		struct ScreenTriangle
+		{
+			float x[3];
+			float y[3];
+			float z[3];
+			int minY;
+			int maxY;
+		};
+
+		SGOccluderSettings settings;
+		std::unordered_map<SGGuid, Occluder> occluders;
+		std::vector<SGGuid> occluderOrder;
+		size_t nextOccluder = 0;
+		std::mutex occluderMutex;
+
+		float viewProjection[16];
+		float previousViewProjection[16];
+		bool hasPreviousFrame = false; // Cleared when an occluder moves or is removed, since its old depth would keep culling
+		unsigned int framesPerRound = 1; // Frames it takes to render every occluder once
+
+		std::vector<ScreenTriangle> triangles;
+		std::vector<float> depthBuffer;
+		std::vector<float> previousDepthBuffer;
+		std::vector<unsigned int> depthAge; // Frames since the depth of a pixel was rasterized, 0 if it was this frame
+		std::vector<unsigned int> previousDepthAge;
+		std::vector<float> tileMaxDepth;
+		unsigned int tilesX;
+		unsigned int tilesY;
+
+		void TransformOccluders();
+		void RasterizeBand(int startY, int endY);
+		void ReprojectPreviousFrame();
+		void UpdateTileDepths();
+		bool IsVisible(const SGEntityBounds& bounds, SGGraphicalEntityID entity) const;
+	};
+}
@@ -0,0 +1,228 @@
+#include "SGProfiler.h"
+
+#include <algorithm>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace
+{
+	const size_t nrOfCounters = static_cast<size_t>(SG::SGCounter::NR_OF_COUNTERS);
+
+	struct ThreadCounterBlock
+	{
+		std::atomic<unsigned long long> counters[nrOfCounters] = {};
+	};
+
+	// Blocks are never freed, so the totals stay correct after a thread has exited
+	std::mutex registryMutex;
+	std::vector<std::unique_ptr<ThreadCounterBlock>> registry;
+	thread_local ThreadCounterBlock* threadBlock = nullptr;
+
+	double MicrosecondsSince(std::chrono::steady_clock::time_point start)
+	{
+		return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+	}
+}
+
+void SG::SGFrameProfile::AddPipelineTime(size_t guidID, double microseconds)
+{
+	for (unsigned int i = 0; i < nrOfPipelineTimes; ++i)
+	{
+		if (pipelineTimes[i].guidID == guidID)
+		{
+			pipelineTimes[i].microseconds += microseconds;
+			return;
+		}
+	}
+
+	if (nrOfPipelineTimes < MAX_PROFILED_TIMES)
+		pipelineTimes[nrOfPipelineTimes++] = { guidID, microseconds };
+}
+
+void SG::SGFrameProfile::AddJobTime(size_t guidID, double microseconds)
+{
+	for (unsigned int i = 0; i < nrOfJobTimes; ++i)
+	{
+		if (jobTimes[i].guidID == guidID)
+		{
+			jobTimes[i].microseconds += microseconds;
+			return;
+		}
+	}
+
+	if (nrOfJobTimes < MAX_PROFILED_TIMES)
+		jobTimes[nrOfJobTimes++] = { guidID, microseconds };
+}
+
+std::atomic<unsigned long long>* SG::SGProfiler::ThreadCounters()
+{
+	if (threadBlock == nullptr)
+	{
+		registryMutex.lock();
+		registry.push_back(std::make_unique<ThreadCounterBlock>());
+		threadBlock = registry.back().get();
+		registryMutex.unlock();
+	}
+
+	return threadBlock->counters;
+}
+
+void SG::SGProfiler::BeginFrame()
+{
+	if constexpr (PROFILING_VERSION)
+	{
+		current = SGFrameProfile();
+		frameStart = std::chrono::steady_clock::now();
+	}
+}
+
+void SG::SGProfiler::BeginRecording()
+{
+	if constexpr (PROFILING_VERSION)
+		current.swapTime = MicrosecondsSince(frameStart);
+}
+
+SG::SGFrameProfile & SG::SGProfiler::CurrentFrame()
+{
+	return current;
+}
+
+void SG::SGProfiler::EndFrame()
+{
+	if constexpr (PROFILING_VERSION)
+	{
+		unsigned long long totals[nrOfCounters] = {};
+
+		registryMutex.lock();
+		for (auto& block : registry)
+			for (size_t i = 0; i < nrOfCounters; ++i)
+				totals[i] += block->counters[i].load(std::memory_order_relaxed);
+		registryMutex.unlock();
+
+		// Counters are never reset since other threads write them, the frame gets the difference since the last frame
+		for (size_t i = 0; i < nrOfCounters; ++i)
+		{
+			current.counters[i] = totals[i] - counterTotals[i];
+			counterTotals[i] = totals[i];
+		}
+
+		unsigned long long frame = nrOfFrames.load(std::memory_order_relaxed);
+		current.frame = frame;
+		current.frameTime = MicrosecondsSince(frameStart);
+
+		FrameSlot& slot = history[frame % HISTORY];
+		unsigned long long sequence = slot.sequence.load(std::memory_order_relaxed);
+		slot.sequence.store(sequence + 1, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_release);
+		slot.profile = current;
+		slot.sequence.store(sequence + 2, std::memory_order_release);
+
+		nrOfFrames.store(frame + 1, std::memory_order_release);
+	}
+}
+
+bool SG::SGProfiler::GetLatestFrame(SGFrameProfile & profile) const
+{
+	if constexpr (PROFILING_VERSION)
+	{
+		unsigned long long frames = nrOfFrames.load(std::memory_order_acquire);
+
+		if (frames == 0)
+			return false;
+
+		return ReadFrame((frames - 1) % HISTORY, profile);
+	}
+	else
+	{
+		(void)profile;
+		return false;
+	}
+}
+
+SG::SGProfileStatistics SG::SGProfiler::GetCounterStatistics(SGCounter counter, size_t nrOfFrames) const
+{
+	return GetStatistics(nrOfFrames, [counter](const SGFrameProfile& profile)
+	{
+		return static_cast<double>(profile.counters[static_cast<size_t>(counter)]);
+	});
+}
+
+SG::SGProfileStatistics SG::SGProfiler::GetFrameTimeStatistics(size_t nrOfFrames) const
+{
+	return GetStatistics(nrOfFrames, [](const SGFrameProfile& profile) { return profile.frameTime; });
+}
+
+SG::SGProfileStatistics SG::SGProfiler::GetRecordingTimeStatistics(size_t nrOfFrames) const
+{
+	return GetStatistics(nrOfFrames, [](const SGFrameProfile& profile) { return profile.recordingTime; });
+}
+
+bool SG::SGProfiler::ReadFrame(size_t slot, SGFrameProfile & profile) const
+{
+	const FrameSlot& toRead = history[slot];
+
+	while (true)
+	{
+		unsigned long long before = toRead.sequence.load(std::memory_order_acquire);
+
+		if (before & 1)
+			continue;
+
+		profile = toRead.profile;
+		std::atomic_thread_fence(std::memory_order_acquire);
+
+		if (toRead.sequence.load(std::memory_order_relaxed) == before)
+			return before != 0;
+	}
+}
+
+template<typename Selector>
+SG::SGProfileStatistics SG::SGProfiler::GetStatistics(size_t nrOfFrames, Selector selector) const
+{
+	SGProfileStatistics toReturn;
+
+	if constexpr (PROFILING_VERSION)
+	{
+		unsigned long long frames = this->nrOfFrames.load(std::memory_order_acquire);
+		size_t toUse = static_cast<size_t>(std::min<unsigned long long>({ frames, nrOfFrames, HISTORY }));
+		std::vector<double> values;
+		values.reserve(toUse);
+		SGFrameProfile profile;
+
+		for (size_t i = 0; i < toUse; ++i)
+		{
+			// A frame that has been overwritten by a newer one while reading is skipped
+			if (ReadFrame((frames - 1 - i) % HISTORY, profile) && profile.frame == frames - 1 - i)
+				values.push_back(selector(profile));
+		}
+
+		if (values.empty())
+			return toReturn;
+
+		std::sort(values.begin(), values.end());
+		auto percentile = [&values](double fraction)
+		{
+			return values[static_cast<size_t>(fraction * (values.size() - 1) + 0.5)];
+		};
+
+		double sum = 0.0;
+
+		for (double value : values)
+			sum += value;
+
+		toReturn.average = sum / values.size();
+		toReturn.median = percentile(0.5);
+		toReturn.percentile95 = percentile(0.95);
+		toReturn.percentile99 = percentile(0.99);
+		toReturn.maximum = values.back();
+		toReturn.nrOfFrames = values.size();
+	}
+	else
+	{
+		(void)nrOfFrames;
+		(void)selector;
+	}
+
+	return toReturn;
+}
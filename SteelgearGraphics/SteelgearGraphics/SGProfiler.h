@@ -0,0 +1,128 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+
+#ifdef _SGG_PROFILING
+constexpr bool PROFILING_VERSION = true;
+#else
+constexpr bool PROFILING_VERSION = false;
+#endif
+
+namespace SG
+{
+	enum class SGCounter
+	{
+		DRAWS,
+		DISPATCHES,
+		INPUT_ASSEMBLER_CHANGES,
+		SHADER_CHANGES,
+		CONSTANT_BUFFER_CHANGES,
+		SHADER_RESOURCE_CHANGES,
+		SAMPLER_CHANGES,
+		OUTPUT_MERGER_CHANGES,
+		RASTERIZER_CHANGES,
+		BLEND_DEPTH_STENCIL_CHANGES,
+		HAZARD_UNBINDS,
+		MAPS,
+		BYTES_UPLOADED,
+		FRAME_MAP_OPERATIONS,
+		STATE_SETS_AVOIDED, // Rasterizer, blend and depth stencil sets skipped because the same object was already set
+		SAMPLER_SETS_AVOIDED, // Sampler sets skipped because every sampler was already set
+		NR_OF_COUNTERS
+	};
+
+	// Guids are stored by id, compare with SGGuid::GetID
+	struct SGProfiledTime
+	{
+		size_t guidID = 0;
+		double microseconds = 0.0;
+	};
+
+	struct SGFrameProfile
+	{
+		static constexpr size_t MAX_PROFILED_TIMES = 32; // Pipelines and jobs after this are only part of recordingTime
+
+		unsigned long long frame = 0;
+		unsigned long long counters[static_cast<size_t>(SGCounter::NR_OF_COUNTERS)] = {};
+		double frameTime = 0.0; // From the start of the swap until the frame was presented, all times in microseconds
+		double swapTime = 0.0;
+		double recordingTime = 0.0; // Summed over all recording threads
+		double workerWaitTime = 0.0; // Render thread waiting for the other recording threads to finish
+		unsigned int nrOfPipelineTimes = 0;
+		SGProfiledTime pipelineTimes[MAX_PROFILED_TIMES];
+		unsigned int nrOfJobTimes = 0;
+		SGProfiledTime jobTimes[MAX_PROFILED_TIMES];
+
+		void AddPipelineTime(size_t guidID, double microseconds);
+		void AddJobTime(size_t guidID, double microseconds);
+	};
+
+	struct SGProfileStatistics
+	{
+		double average = 0.0;
+		double median = 0.0;
+		double percentile95 = 0.0;
+		double percentile99 = 0.0;
+		double maximum = 0.0;
+		size_t nrOfFrames = 0;
+	};
+
+	/** Counters are kept per thread and summed when a frame ends. Finished frames are kept in a ring that can be read
+	from any thread without locks, a read that overlaps with the ring wrapping around is retried.
+	Everything compiles to nothing unless _SGG_PROFILING is defined */
+	class SGProfiler
+	{
+	public:
+		static constexpr size_t HISTORY = PROFILING_VERSION ? 128 : 1;
+
+		SGProfiler() = default;
+		~SGProfiler() = default;
+
+		SGProfiler(const SGProfiler& other) = delete;
+		SGProfiler& operator=(const SGProfiler& other) = delete;
+
+		static void Count(SGCounter counter, unsigned long long amount = 1);
+
+		// Only called by the render thread
+		void BeginFrame();
+		void BeginRecording();
+		SGFrameProfile& CurrentFrame();
+		void EndFrame();
+
+		bool GetLatestFrame(SGFrameProfile& profile) const;
+		SGProfileStatistics GetCounterStatistics(SGCounter counter, size_t nrOfFrames) const;
+		SGProfileStatistics GetFrameTimeStatistics(size_t nrOfFrames) const;
+		SGProfileStatistics GetRecordingTimeStatistics(size_t nrOfFrames) const;
+
+	private:
+		struct FrameSlot
+		{
+			std::atomic<unsigned long long> sequence = 0; // Odd while the slot is written
+			SGFrameProfile profile;
+		};
+
+		FrameSlot history[HISTORY];
+		std::atomic<unsigned long long> nrOfFrames = 0;
+		SGFrameProfile current;
+		unsigned long long counterTotals[static_cast<size_t>(SGCounter::NR_OF_COUNTERS)] = {};
+		std::chrono::steady_clock::time_point frameStart;
+
+		static std::atomic<unsigned long long>* ThreadCounters();
+		bool ReadFrame(size_t slot, SGFrameProfile& profile) const;
+
+		template<typename Selector>
+		SGProfileStatistics GetStatistics(size_t nrOfFrames, Selector selector) const;
+	};
+
+	inline void SGProfiler::Count(SGCounter counter, unsigned long long amount)
+	{
+		if constexpr (PROFILING_VERSION)
+		{
+			// Only the owning thread writes, so a plain load and store is enough
+			std::atomic<unsigned long long>& value = ThreadCounters()[static_cast<size_t>(counter)];
+			value.store(value.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+		}
+	}
+}
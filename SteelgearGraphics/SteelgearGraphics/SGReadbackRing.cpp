@@ -0,0 +1,145 @@
+#include "SGReadbackRing.h"
+
+#include <cstring>
+
+SG::SGReadbackRing::SGReadbackRing(SGReadbackDevice * device, size_t nrOfSlots) : device(device), slots(nrOfSlots)
+{
+	// Taken from the back, so the first slot is used first
+	for (size_t i = nrOfSlots; i-- > 0;)
+		freeSlots.push_back(i);
+}
+
+SG::SGReadbackID SG::SGReadbackRing::Request(const SGReadbackSource & source, const SGReadbackCallback & callback)
+{
+	requestMutex.lock();
+	SGReadbackID id = nextID++;
+	queued.push_back({ id, source, callback });
+	results[id].status = SGReadbackStatus::QUEUED;
+	requestMutex.unlock();
+
+	return id;
+}
+
+SG::SGReadbackStatus SG::SGReadbackRing::GetStatus(SGReadbackID id)
+{
+	requestMutex.lock();
+	auto result = results.find(id);
+	SGReadbackStatus toReturn = result != results.end() ? result->second.status : SGReadbackStatus::UNKNOWN;
+	requestMutex.unlock();
+
+	return toReturn;
+}
+
+bool SG::SGReadbackRing::TakeData(SGReadbackID id, std::vector<unsigned char>& data, SGReadbackData & layout)
+{
+	requestMutex.lock();
+	auto result = results.find(id);
+	bool ready = result != results.end() && result->second.status == SGReadbackStatus::READY;
+
+	if (ready)
+	{
+		data = std::move(result->second.bytes);
+		layout = result->second.layout;
+		layout.bytes = data.data();
+	}
+
+	// A failed readback is only reported once as well
+	if (result != results.end() && (ready || result->second.status == SGReadbackStatus::FAILED))
+		results.erase(result);
+
+	requestMutex.unlock();
+
+	return ready;
+}
+
+void SG::SGReadbackRing::Update()
+{
+	// Fences pass in the order the copies were made, so the first slot that is not ready ends the search
+	while (!inFlight.empty() && device->IsSlotReady(inFlight.front()))
+	{
+		size_t slot = inFlight.front();
+		inFlight.pop_front();
+
+		SGReadbackData data;
+		bool mapped = device->MapSlot(slot, data);
+		Deliver(slots[slot], data, mapped ? SGReadbackStatus::READY : SGReadbackStatus::FAILED);
+
+		if (mapped)
+			device->UnmapSlot(slot);
+
+		slots[slot].callback = nullptr;
+		freeSlots.push_back(slot);
+	}
+
+	// Copies are made without holding the lock, since a callback of a failed readback may request another one
+	while (freeSlots.size() != 0)
+	{
+		requestMutex.lock();
+
+		if (queued.empty())
+		{
+			requestMutex.unlock();
+			break;
+		}
+
+		Readback readback = std::move(queued.front());
+		queued.pop_front();
+		requestMutex.unlock();
+
+		size_t slot = freeSlots.back();
+
+		if (!device->CopyToSlot(slot, readback.source))
+		{
+			Deliver(readback, SGReadbackData(), SGReadbackStatus::FAILED);
+			continue;
+		}
+
+		requestMutex.lock();
+		results[readback.id].status = SGReadbackStatus::IN_FLIGHT;
+		requestMutex.unlock();
+
+		freeSlots.pop_back();
+		slots[slot] = std::move(readback);
+		inFlight.push_back(slot);
+	}
+}
+
+void SG::SGReadbackRing::Deliver(const Readback & readback, const SGReadbackData & data, SGReadbackStatus status)
+{
+	if (readback.callback)
+	{
+		requestMutex.lock();
+		results.erase(readback.id);
+		requestMutex.unlock();
+
+		readback.callback(readback.id, status == SGReadbackStatus::READY ? data : SGReadbackData());
+		return;
+	}
+
+	// Copied out of the mapped memory with the padding between rows and slices removed
+	Result result;
+	result.status = status;
+
+	if (status == SGReadbackStatus::READY)
+	{
+		result.layout = data;
+		result.layout.bytes = nullptr;
+		result.layout.rowPitch = data.rowSize;
+		result.layout.depthPitch = data.rowSize * data.nrOfRows;
+		result.bytes.resize(result.layout.depthPitch * data.depth);
+		unsigned char* destination = result.bytes.data();
+
+		for (size_t z = 0; z < data.depth; ++z)
+		{
+			for (size_t y = 0; y < data.nrOfRows; ++y)
+			{
+				memcpy(destination, data.bytes + z * data.depthPitch + y * data.rowPitch, data.rowSize);
+				destination += data.rowSize;
+			}
+		}
+	}
+
+	requestMutex.lock();
+	results[readback.id] = std::move(result);
+	requestMutex.unlock();
+}
@@ -0,0 +1,107 @@
+#pragma once
+
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "SGGuid.h"
+
+namespace SG
+{
+	using SGReadbackID = unsigned long long;
+
+	enum class SGReadbackStatus
+	{
+		QUEUED, // Waiting for a slot of the ring to be free
+		IN_FLIGHT, // Copied on the GPU, waiting for the fence after the copy
+		READY, // Can be taken with TakeData
+		FAILED, // The source could not be read
+		UNKNOWN // Never requested, handed to a callback or already taken
+	};
+
+	// A range of a buffer or a region of a texture subresource, right, bottom and back are one past the region
+	struct SGReadbackSource
+	{
+		SGGuid guid;
+		bool texture = false;
+		size_t offset = 0; // Bytes into a buffer
+		size_t size = 0; // Bytes of a buffer, 0 reads to its end
+		unsigned int subresource = 0;
+		bool wholeSubresource = true; // The region is ignored when set
+		unsigned int left = 0;
+		unsigned int top = 0;
+		unsigned int front = 0;
+		unsigned int right = 0;
+		unsigned int bottom = 0;
+		unsigned int back = 0;
+	};
+
+	// nrOfRows rows of rowSize bytes for each of depth slices, a buffer is a single row
+	struct SGReadbackData
+	{
+		const unsigned char* bytes = nullptr; // nullptr when the readback failed
+		size_t rowSize = 0;
+		size_t nrOfRows = 0;
+		size_t depth = 0;
+		size_t rowPitch = 0;
+		size_t depthPitch = 0;
+	};
+
+	using SGReadbackCallback = std::function<void(SGReadbackID id, const SGReadbackData& data)>; // Called on the render thread, bytes are only valid during the call
+
+	/** The graphics API side of a readback ring, every slot has a staging resource and a fence of its own.
+	Kept apart from the ring so the bookkeeping can run against a fake device */
+	class SGReadbackDevice
+	{
+	public:
+		virtual ~SGReadbackDevice() = default;
+
+		virtual bool CopyToSlot(size_t slot, const SGReadbackSource& source) = 0; // Signals the fence of the slot after the copy, false if the source can not be read
+		virtual bool IsSlotReady(size_t slot) = 0; // Must not wait for the GPU
+		virtual bool MapSlot(size_t slot, SGReadbackData& data) = 0;
+		virtual void UnmapSlot(size_t slot) = 0;
+	};
+
+	/** Readbacks are copied into a fixed number of staging slots and delivered once the fence after their copy has passed.
+	Fences are only checked when the ring is updated once per frame, so a readback arrives a few frames after it is requested and nothing waits
+	for the GPU. Requests wait in order while every slot is in flight. The data goes to the callback of the request, or is kept until taken */
+	class SGReadbackRing
+	{
+	public:
+		SGReadbackRing(SGReadbackDevice* device, size_t nrOfSlots);
+		~SGReadbackRing() = default;
+
+		SGReadbackID Request(const SGReadbackSource& source, const SGReadbackCallback& callback = nullptr);
+		SGReadbackStatus GetStatus(SGReadbackID id);
+		bool TakeData(SGReadbackID id, std::vector<unsigned char>& data, SGReadbackData& layout); // Rows and slices tightly packed, false unless ready
+		void Update(); // On the render thread after the work of the frame is submitted
+
+	private:
+		struct Readback
+		{
+			SGReadbackID id;
+			SGReadbackSource source;
+			SGReadbackCallback callback;
+		};
+
+		struct Result
+		{
+			SGReadbackStatus status = SGReadbackStatus::QUEUED;
+			std::vector<unsigned char> bytes;
+			SGReadbackData layout;
+		};
+
+		SGReadbackDevice* device;
+		std::mutex requestMutex;
+		SGReadbackID nextID = 1;
+		std::deque<Readback> queued;
+		std::unordered_map<SGReadbackID, Result> results; // Requests without a callback until they are taken, and those still waiting with one
+		std::vector<Readback> slots;
+		std::vector<size_t> freeSlots;
+		std::deque<size_t> inFlight; // Slots in the order they were copied to, which is the order their fences pass
+
+		void Deliver(const Readback& readback, const SGReadbackData& data, SGReadbackStatus status);
+	};
+}
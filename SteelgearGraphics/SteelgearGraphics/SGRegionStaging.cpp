@@ -0,0 +1,228 @@
+#include "SGRegionStaging.h"
+
+#include <algorithm>
+#include <cstring>
+#include <initializer_list>
+
+namespace
+{
+	// True if second continues first along one axis while the two other axes match
+	bool Continues(const SG::SGUpdateRegion& first, const SG::SGUpdateRegion& second)
+	{
+		if (first.subresource != second.subresource)
+			return false;
+
+		bool sameX = first.left == second.left && first.right == second.right;
+		bool sameY = first.top == second.top && first.bottom == second.bottom;
+		bool sameZ = first.front == second.front && first.back == second.back;
+
+		return (first.right == second.left && sameY && sameZ) || (first.bottom == second.top && sameX && sameZ) ||
+			(first.back == second.front && sameX && sameY);
+	}
+
+	bool Overlaps(const SG::SGUpdateRegion& first, const SG::SGUpdateRegion& second)
+	{
+		return first.subresource == second.subresource && first.left < second.right && second.left < first.right &&
+			first.top < second.bottom && second.top < first.bottom && first.front < second.back && second.front < first.back;
+	}
+
+	bool Covers(const SG::SGUpdateRegion& outer, const SG::SGUpdateRegion& inner)
+	{
+		return outer.subresource == inner.subresource && outer.left <= inner.left && outer.right >= inner.right &&
+			outer.top <= inner.top && outer.bottom >= inner.bottom && outer.front <= inner.front && outer.back >= inner.back;
+	}
+}
+
+size_t SG::SGStagedRegion::GetSize() const
+{
+	return rowSize * nrOfRows * (region.back - region.front);
+}
+
+void SG::SGRegionStaging::AddRegion(const SGUpdateRegion & region, const void * data, size_t rowSize, size_t nrOfRows, size_t rowPitch, size_t depthPitch)
+{
+	// Regions the new one covers would only be overwritten
+	regions.erase(std::remove_if(regions.begin() + nextRegion, regions.end(), [&region](const SGStagedRegion& staged)
+	{
+		return Covers(region, staged.region);
+	}), regions.end());
+
+	if (regions.size() == nextRegion)
+		Clear();
+
+	SGStagedRegion staged;
+	staged.region = region;
+	staged.offset = bytes.size();
+	staged.rowSize = rowSize;
+	staged.nrOfRows = nrOfRows;
+	bytes.resize(bytes.size() + staged.GetSize());
+
+	const unsigned char* source = static_cast<const unsigned char*>(data);
+	unsigned char* destination = bytes.data() + staged.offset;
+
+	for (unsigned int z = region.front; z < region.back; ++z)
+	{
+		for (size_t y = 0; y < nrOfRows; ++y)
+		{
+			memcpy(destination, source + (z - region.front) * depthPitch + y * rowPitch, rowSize);
+			destination += rowSize;
+		}
+	}
+
+	regions.push_back(staged);
+
+	while (MergeLastRegion())
+	{
+		// The merged region can line up with another one
+	}
+}
+
+void SG::SGRegionStaging::TakePending(SGRegionStaging & older)
+{
+	if (older.Pending())
+	{
+		std::vector<unsigned char> combinedBytes;
+		std::vector<SGStagedRegion> combinedRegions;
+
+		for (SGRegionStaging* staging : { &older, this })
+		{
+			for (size_t i = staging->nextRegion; i < staging->regions.size(); ++i)
+			{
+				SGStagedRegion staged = staging->regions[i];
+				const unsigned char* data = staging->GetData(staged);
+				staged.offset = combinedBytes.size();
+				combinedBytes.insert(combinedBytes.end(), data, data + staged.GetSize());
+				combinedRegions.push_back(staged);
+			}
+		}
+
+		bytes.swap(combinedBytes);
+		regions.swap(combinedRegions);
+		nextRegion = 0;
+	}
+
+	older.Clear();
+}
+
+void SG::SGRegionStaging::Clear()
+{
+	bytes.clear();
+	regions.clear();
+	nextRegion = 0;
+}
+
+bool SG::SGRegionStaging::Empty() const
+{
+	return regions.empty();
+}
+
+bool SG::SGRegionStaging::Pending() const
+{
+	return nextRegion < regions.size();
+}
+
+const SG::SGStagedRegion & SG::SGRegionStaging::NextRegion() const
+{
+	return regions[nextRegion];
+}
+
+const unsigned char * SG::SGRegionStaging::GetData(const SGStagedRegion & staged) const
+{
+	return bytes.data() + staged.offset;
+}
+
+void SG::SGRegionStaging::PopRegion()
+{
+	++nextRegion;
+}
+
+bool SG::SGRegionStaging::MergeLastRegion()
+{
+	const SGStagedRegion& last = regions.back();
+
+	for (size_t i = regions.size() - 1; i-- > nextRegion;)
+	{
+		const SGStagedRegion& candidate = regions[i];
+		bool candidateFirst = Continues(candidate.region, last.region);
+
+		if (!candidateFirst && !Continues(last.region, candidate.region))
+			continue;
+
+		// The candidate is uploaded later once merged, which is only safe if no region staged after it writes to the same texels
+		bool overwritten = false;
+
+		for (size_t j = i + 1; j + 1 < regions.size() && !overwritten; ++j)
+			overwritten = Overlaps(regions[j].region, candidate.region);
+
+		if (overwritten)
+			continue;
+
+		SGStagedRegion merged = candidateFirst ? MergeRegions(candidate, last) : MergeRegions(last, candidate);
+		regions.back() = merged;
+		regions.erase(regions.begin() + i);
+		return true;
+	}
+
+	return false;
+}
+
+SG::SGStagedRegion SG::SGRegionStaging::MergeRegions(const SGStagedRegion & first, const SGStagedRegion & second)
+{
+	bool alongX = first.region.right != second.region.right;
+	bool alongY = first.region.bottom != second.region.bottom;
+	bool alongZ = first.region.back != second.region.back;
+
+	SGStagedRegion merged;
+	merged.region = first.region;
+	merged.region.right = second.region.right;
+	merged.region.bottom = second.region.bottom;
+	merged.region.back = second.region.back;
+	merged.rowSize = alongX ? first.rowSize + second.rowSize : first.rowSize;
+	merged.nrOfRows = alongY ? first.nrOfRows + second.nrOfRows : first.nrOfRows;
+
+	// Along z, or along y for a single slice, the merged region is the two regions after each other, which needs no copy if they already are
+	size_t depth = first.region.back - first.region.front;
+	bool consecutive = alongZ || (alongY && depth == 1);
+
+	if (consecutive && first.offset + first.GetSize() == second.offset)
+	{
+		merged.offset = first.offset;
+		return merged;
+	}
+
+	merged.offset = bytes.size();
+	bytes.resize(bytes.size() + merged.GetSize());
+
+	unsigned char* destination = bytes.data() + merged.offset;
+	const unsigned char* firstData = bytes.data() + first.offset;
+	const unsigned char* secondData = bytes.data() + second.offset;
+
+	if (alongZ)
+	{
+		memcpy(destination, firstData, first.GetSize());
+		memcpy(destination + first.GetSize(), secondData, second.GetSize());
+		return merged;
+	}
+
+	size_t firstSliceSize = first.rowSize * first.nrOfRows;
+	size_t secondSliceSize = second.rowSize * second.nrOfRows;
+
+	for (size_t z = 0; z < depth; ++z)
+	{
+		if (alongY)
+		{
+			memcpy(destination, firstData + z * firstSliceSize, firstSliceSize);
+			memcpy(destination + firstSliceSize, secondData + z * secondSliceSize, secondSliceSize);
+			destination += firstSliceSize + secondSliceSize;
+			continue;
+		}
+
+		for (size_t y = 0; y < merged.nrOfRows; ++y)
+		{
+			memcpy(destination, firstData + z * firstSliceSize + y * first.rowSize, first.rowSize);
+			memcpy(destination + first.rowSize, secondData + z * secondSliceSize + y * second.rowSize, second.rowSize);
+			destination += merged.rowSize;
+		}
+	}
+
+	return merged;
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+namespace SG
+{
+	// right, bottom and back are one past the last texel, like the box of a texture update
+	struct SGUpdateRegion
+	{
+		unsigned int subresource = 0;
+		unsigned int left = 0;
+		unsigned int top = 0;
+		unsigned int front = 0;
+		unsigned int right = 0;
+		unsigned int bottom = 0;
+		unsigned int back = 0;
+	};
+
+	// nrOfRows rows of rowSize bytes for every slice of the region, tightly packed from offset
+	struct SGStagedRegion
+	{
+		SGUpdateRegion region;
+		size_t offset = 0;
+		size_t rowSize = 0;
+		size_t nrOfRows = 0;
+
+		size_t GetSize() const;
+	};
+
+	/** Region updates of a resource copied into memory of their own, so only the bytes of the touched regions are staged.
+	A region that lines up with an earlier one of the same subresource is merged with it, and earlier regions a new one covers are dropped,
+	which leaves fewer and larger copies to make. Regions are handed out in the order they were staged, Clear keeps the memory for reuse */
+	class SGRegionStaging
+	{
+	public:
+		void AddRegion(const SGUpdateRegion& region, const void* data, size_t rowSize, size_t nrOfRows, size_t rowPitch, size_t depthPitch);
+		void TakePending(SGRegionStaging& older); // The regions older has not handed out are put before these ones, older is cleared
+		void Clear();
+
+		bool Empty() const;
+		bool Pending() const; // True while there are regions left to hand out
+		const SGStagedRegion& NextRegion() const;
+		const unsigned char* GetData(const SGStagedRegion& staged) const;
+		void PopRegion();
+
+	private:
+		std::vector<unsigned char> bytes;
+		std::vector<SGStagedRegion> regions;
+		size_t nextRegion = 0;
+
+		bool MergeLastRegion();
+		SGStagedRegion MergeRegions(const SGStagedRegion& first, const SGStagedRegion& second); // first comes before second along the axis they meet on
+	};
+}
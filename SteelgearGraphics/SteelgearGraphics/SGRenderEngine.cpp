@@ -1,10 +1,14 @@
 #include "SGRenderEngine.h"
+#include "SGCapture.h"
 
 #include <utility>
+#include <algorithm>
 
-SG::SGRenderEngine::SGRenderEngine(const SGRenderSettings& settings)
+SG::SGRenderEngine::SGRenderEngine(const SGRenderSettings& settings) : occlusionCuller(settings.occluderSettings),
+	cullingThreadPool(settings.nrOfContexts >= 1 ? settings.nrOfContexts - 1 : 0), loadQueue(settings.nrOfLoaderThreads, settings.uploadBudgetPerFrame)
 {
 	this->threadedRenderLoop = settings.threadedRenderLoop;
+	this->minimumEntitiesPerChunk = settings.minimumEntitiesPerChunk >= 1 ? settings.minimumEntitiesPerChunk : 1;
 	threadPool = new SGThreadPool(settings.nrOfContexts >= 1 ? settings.nrOfContexts - 1 : 0);
 
 	if (threadedRenderLoop)
@@ -16,41 +20,304 @@ SG::SGRenderEngine::SGRenderEngine(const SGRenderSettings& settings)
 
 void SG::SGRenderEngine::Render(const std::vector<SGGraphicsJob>& jobs)
 {
+	// Before the capture scope, so calls made by the load callbacks are captured on their own
+	loadQueue.FinishFrame();
+	SGCaptureScope capture(SGCaptureCall::RENDER, jobs);
+	SGTraceScope scope("SGRenderEngine::Render");
+
+	// Filtered before the data index is locked, so the render thread can move on to the previous frame while this one is culled
+	preparedJobs = jobs;
+	bool occludersRendered = false;
+
+	for (auto& job : preparedJobs)
+	{
+		if (job.cullingFrustums.size() != 0)
+		{
+			cullingBuffer.clear();
+			CullEntities(entityBounds, job.cullingFrustums, job.entitiesToRender, cullingBuffer, &cullingThreadPool);
+			job.entitiesToRender.swap(cullingBuffer);
+		}
+
+		if (job.occlusionCulling)
+		{
+			// The occluders are only rendered once per frame no matter how many jobs use them
+			if (!occludersRendered)
+			{
+				occlusionCuller.RenderOccluders(&cullingThreadPool);
+				occludersRendered = true;
+			}
+
+			cullingBuffer.clear();
+			occlusionCuller.CullEntities(entityBounds, job.entitiesToRender, cullingBuffer);
+			job.entitiesToRender.swap(cullingBuffer);
+		}
+
+		if (job.lodSelection)
+			SelectLODs(job);
+
+		if (job.streamedTextureBinds.size() != 0)
+			RequestTextureMips(job);
+	}
+
+	// Swapped rather than copied, the jobs of an earlier frame are left to be reused next frame
 	dataIndexMutex.lock();
-	pipelineJobs[toUpdate] = jobs;
+	pipelineJobs[toUpdate].swap(preparedJobs);
 	std::swap(toUpdate, toUseNext);
+	FinishEntityFrame();
 	FinishFrame();
 	dataIndexMutex.unlock();
 
 	if (!threadedRenderLoop)
 	{
 		std::swap(toWorkWith, toUseNext);
+		profiler.BeginFrame();
+		SwapEntityFrame();
 		SwapFrame();
+		profiler.BeginRecording();
 		ExecuteJobs(pipelineJobs[toWorkWith]);
+		profiler.EndFrame();
 	}
 }
 
 SG::SGGraphicalEntityID SG::SGRenderEngine::CreateEntity()
 {
+	SGCaptureScope capture(SGCaptureCall::CREATE_ENTITY);
 	SGGraphicalEntityID toReturn;
 	entityMutex.lock();
 	toReturn = graphicalEntities.size();
 	graphicalEntities.push_back(SGGraphicalEntity());
 	entityMutex.unlock();
+
+	// Not locked, the bounds are only used by the thread calling Render
+	entityBounds.AddEntity();
 	return toReturn;
 }
 
 void SG::SGRenderEngine::SetEntityToGroup(const SGGraphicalEntityID & entity, const SGGuid & groupGuid)
 {
+	SGCaptureScope capture(SGCaptureCall::SET_ENTITY_TO_GROUP, entity, groupGuid);
 	if constexpr (DEBUG_VERSION)
 		if (entity >= graphicalEntities.size())
 			throw std::runtime_error("Error setting entity to group, entity does not exist");
 
-	graphicalEntities[entity].groupGuid = groupGuid;
+	ChangeEntityGroup(entity, groupGuid);
+}
+
+void SG::SGRenderEngine::SetEntityBoundingSphere(const SGGraphicalEntityID & entity, float centerX, float centerY, float centerZ, float radius)
+{
+	SGCaptureScope capture(SGCaptureCall::SET_ENTITY_BOUNDING_SPHERE, entity, centerX, centerY, centerZ, radius);
+	if constexpr (DEBUG_VERSION)
+		if (entity >= entityBounds.Size())
+			throw std::runtime_error("Error setting entity bounds, entity does not exist");
+
+	entityBounds.SetSphere(entity, centerX, centerY, centerZ, radius);
+}
+
+void SG::SGRenderEngine::SetEntityBoundingBox(const SGGraphicalEntityID & entity, const float center[3], const float extents[3])
+{
+	SGCaptureScope capture(SGCaptureCall::SET_ENTITY_BOUNDING_BOX, entity, SGCaptureBytes{ center, sizeof(float) * 3 }, SGCaptureBytes{ extents, sizeof(float) * 3 });
+	if constexpr (DEBUG_VERSION)
+		if (entity >= entityBounds.Size())
+			throw std::runtime_error("Error setting entity bounds, entity does not exist");
+
+	entityBounds.SetBox(entity, center, extents);
+}
+
+SG::SGOcclusionCuller * SG::SGRenderEngine::OcclusionCuller()
+{
+	return &occlusionCuller;
+}
+
+const SG::SGProfiler * SG::SGRenderEngine::Profiler() const
+{
+	return &profiler;
+}
+
+SG::SGLoadQueue * SG::SGRenderEngine::LoadQueue()
+{
+	return &loadQueue;
+}
+
+void SG::SGRenderEngine::SetLODCamera(const SGLODCamera & camera)
+{
+	SGCaptureScope capture(SGCaptureCall::SET_LOD_CAMERA, camera);
+	lodMutex.lock();
+	lodCamera = camera;
+	lodMutex.unlock();
+}
+
+SG::SGResult SG::SGRenderEngine::SetEntityLODSet(const SGGraphicalEntityID & entity, const SGGuid & lodSetGuid)
+{
+	SGCaptureScope capture(SGCaptureCall::SET_ENTITY_LOD_SET, entity, lodSetGuid);
+	if constexpr (DEBUG_VERSION)
+		if (entity >= graphicalEntities.size())
+			throw std::runtime_error("Error setting entity LOD set, entity does not exist");
+
+	lodMutex.lock();
+	bool exists = lodSets.find(lodSetGuid) != lodSets.end();
+	lodMutex.unlock();
+
+	if (!exists)
+		return SGResult::GUID_MISSING;
+
+	// Read by the LOD selection under the same lock
+	lodMutex.lock();
+	graphicalEntities[entity].lodSetGuid = lodSetGuid;
+	graphicalEntities[entity].lodLevel = ~0u;
+	lodMutex.unlock();
+
+	return SGResult::OK;
+}
+
+void SG::SGRenderEngine::RegisterLODSet(const SGGuid & lodSetGuid, const SGLODThresholds & thresholds, bool groupedLevels)
+{
+	lodMutex.lock();
+	lodSets[lodSetGuid] = { thresholds, groupedLevels };
+	lodMutex.unlock();
+}
+
+void SG::SGRenderEngine::SelectLODs(SGGraphicsJob & job)
+{
+	std::vector<SGGraphicalEntityID>& entities = job.entitiesToRender;
+	screenSizeBuffer.resize(entities.size());
+	lodChanges.clear();
+
+	lodMutex.lock();
+	ComputeScreenSizes(entityBounds, lodCamera, entities.data(), entities.size(), screenSizeBuffer.data());
+
+	SGGuid noLODSet;
+	SGGuid lastGuid;
+	const LODSetSelection* lodSet = nullptr;
+
+	for (size_t i = 0; i < entities.size(); ++i)
+	{
+		SGGraphicalEntity& entity = graphicalEntities[entities[i]];
+
+		if (entity.lodSetGuid == noLODSet)
+			continue;
+
+		// Entities sharing a LOD set are usually next to each other, so the lookup is only redone when the set changes
+		if (lodSet == nullptr || lastGuid != entity.lodSetGuid)
+		{
+			auto found = lodSets.find(entity.lodSetGuid);
+			lodSet = found != lodSets.end() ? &found->second : nullptr;
+			lastGuid = entity.lodSetGuid;
+		}
+
+		if (lodSet == nullptr)
+			continue;
+
+		unsigned int level = SelectLODLevel(lodSet->thresholds, entity.lodLevel, screenSizeBuffer[i]);
+
+		// Rebinding is only paid for when the level actually changes
+		if (level != entity.lodLevel)
+		{
+			entity.lodLevel = level;
+			lodChanges.push_back({ i, entity.lodSetGuid, level, lodSet->groupedLevels });
+		}
+	}
+
+	lodMutex.unlock();
+
+	// Applied without holding the LOD lock, since rebinding takes the locks of the handlers
+	bool groupsChanged = false;
+
+	for (auto& change : lodChanges)
+	{
+		ApplyLODLevel(entities[change.position], change.lodSetGuid, change.level);
+		groupsChanged |= change.groupedLevels;
+	}
+
+	if (groupsChanged)
+		RegroupChangedEntities(entities);
+}
+
+void SG::SGRenderEngine::RegroupChangedEntities(std::vector<SGGraphicalEntityID>& entities)
+{
+	// An entity that moved to another level group is put right after the last entity of that group that did not move, so the group is
+	// still instanced together. Every other entity keeps its place, which keeps the order the caller gave, like back to front for transparency
+	std::unordered_map<SGGuid, std::vector<SGGraphicalEntityID>> moved;
+	std::unordered_map<SGGuid, size_t> insertAt;
+	std::vector<bool> hasMoved(entities.size(), false);
+
+	for (auto& change : lodChanges)
+	{
+		if (!change.groupedLevels)
+			continue;
+
+		SGGraphicalEntityID entity = entities[change.position];
+		hasMoved[change.position] = true;
+		moved[graphicalEntities[entity].updatedGroupGuid].push_back(entity);
+	}
+
+	for (size_t i = 0; i < entities.size(); ++i)
+	{
+		const SGGuid& groupGuid = graphicalEntities[entities[i]].updatedGroupGuid;
+
+		if (!hasMoved[i] && moved.find(groupGuid) != moved.end())
+			insertAt[groupGuid] = i;
+	}
+
+	// A group none of the unmoved entities are part of is put where the first of its entities was
+	for (auto& change : lodChanges)
+		if (change.groupedLevels)
+			insertAt.emplace(graphicalEntities[entities[change.position]].updatedGroupGuid, change.position);
+
+	regroupBuffer.clear();
+
+	for (size_t i = 0; i < entities.size(); ++i)
+	{
+		const SGGuid& groupGuid = graphicalEntities[entities[i]].updatedGroupGuid;
+
+		if (!hasMoved[i])
+			regroupBuffer.push_back(entities[i]);
+
+		auto position = insertAt.find(groupGuid);
+
+		if (position != insertAt.end() && position->second == i)
+		{
+			std::vector<SGGraphicalEntityID>& groupEntities = moved[groupGuid];
+			regroupBuffer.insert(regroupBuffer.end(), groupEntities.begin(), groupEntities.end());
+		}
+	}
+
+	entities.swap(regroupBuffer);
+}
+
+void SG::SGRenderEngine::ChangeEntityGroup(const SGGraphicalEntityID & entity, const SGGuid & groupGuid)
+{
+	// The render thread may still be recording an earlier frame with the old group, so the change waits for the frame it was made in
+	frameBufferGroupMutex.lock();
+	graphicalEntities[entity].updatedGroupGuid = groupGuid;
+	updatedGroupsFrameBuffer.push_back(std::make_pair(entity, groupGuid));
+	frameBufferGroupMutex.unlock();
+}
+
+void SG::SGRenderEngine::FinishEntityFrame()
+{
+	// Called with the data index locked, like FinishFrame
+	frameBufferGroupMutex.lock();
+	updatedGroupsTotalBuffer.insert(updatedGroupsTotalBuffer.end(), updatedGroupsFrameBuffer.begin(), updatedGroupsFrameBuffer.end());
+	updatedGroupsFrameBuffer.clear();
+	frameBufferGroupMutex.unlock();
+}
+
+void SG::SGRenderEngine::SwapEntityFrame()
+{
+	// Called with the data index locked, like SwapFrame. Frames that were never rendered are applied in order, so the latest group wins
+	entityMutex.lock();
+
+	for (auto& pair : updatedGroupsTotalBuffer)
+		graphicalEntities[pair.first].groupGuid = pair.second;
+
+	entityMutex.unlock();
+	updatedGroupsTotalBuffer.clear();
 }
 
 void SG::SGRenderEngine::RenderThreadFunction()
 {
+	SetTraceThreadName("Render thread");
+	SGCaptureScope internalWork;
 	renderthreadActive = true;
 	int lastIndex = toUseNext;
 
@@ -62,10 +329,14 @@ void SG::SGRenderEngine::RenderThreadFunction()
 		dataIndexMutex.lock();
 		lastIndex = toWorkWith;
 		std::swap(toWorkWith, toUseNext);
+		profiler.BeginFrame();
+		SwapEntityFrame();
 		SwapFrame();
 		dataIndexMutex.unlock();
 
+		profiler.BeginRecording();
 		ExecuteJobs(pipelineJobs[toWorkWith]);
+		profiler.EndFrame();
 	}
 
 	renderthreadActive = false;
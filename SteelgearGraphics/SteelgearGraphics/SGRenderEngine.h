@@ -6,10 +6,17 @@
 #include <vector>
 #include <mutex>
 #include <atomic>
+#include <unordered_map>
 
 #include "SGGraphicalEntity.h"
+#include "SGCulling.h"
+#include "SGOcclusionCuller.h"
+#include "SGLODSelection.h"
+#include "SGProfiler.h"
+#include "SGTrace.h"
 #include "SGGuid.h"
 #include "SGThreadPool.h"
+#include "SGLoadQueue.h"
 #include "SGResult.h"
 #include "LockableUnorderedMap.h"
 
@@ -27,8 +34,6 @@ constexpr bool TREADEDSAFE_VERSION = false;
 
 namespace SG
 {
-	typedef std::vector<SGGraphicalEntity>::size_type SGGraphicalEntityID;
-
 	struct SGBackBufferSettings
 	{
 		DXGI_USAGE usage = DXGI_USAGE_RENDER_TARGET_OUTPUT;
@@ -49,14 +54,27 @@ namespace SG
 		IDXGIAdapter* adapter = nullptr;
 		HWND windowHandle;
 		int nrOfContexts = 1;
+		unsigned int minimumEntitiesPerChunk = 512; // Jobs with fewer entities than this are never split between contexts
 		bool threadedRenderLoop = true;
+		unsigned int nrOfLoaderThreads = 1;
+		size_t uploadBudgetPerFrame = 16 * 1024 * 1024; // Bytes of initial data the loader threads may start creating each frame
+		size_t textureStreamingBudget = 256 * 1024 * 1024; // Bytes the resident mips of streamed textures may use
+		size_t textureUpdateBudgetPerFrame = 8 * 1024 * 1024; // Bytes of texture updates uploaded each frame, the rest waits for the next frame
+		unsigned int readbackSlots = 8; // Readbacks in flight at once, later requests wait for a slot to be free
+		bool headless = false; // Null device without a swap chain, everything but the GPU work runs so the submission path can be measured
+		bool specializedDrawLoops = true; // Without, every render job is recorded with the loop that checks every stage, only useful for comparing
 		SGBackBufferSettings backBufferSettings;
+		SGOccluderSettings occluderSettings;
 	};
 
 	struct SGGraphicsJob
 	{
 		SGGuid pipelineGuid;
 		std::vector<SGGraphicalEntityID> entitiesToRender;
+		std::vector<SGFrustum> cullingFrustums; // If not empty, entities outside of all the frustums are removed before rendering
+		bool occlusionCulling = false; // Entities hidden behind the occluders of the engine are removed before rendering
+		bool lodSelection = false; // Entities with a LOD set get their level picked from the LOD camera before rendering
+		std::vector<SGGuid> streamedTextureBinds; // Streamed textures bound to the entities with these bind guids get mips requested from the LOD camera
 	};
 
 	class SGRenderEngine
@@ -67,24 +85,74 @@ namespace SG
 
 		void Render(const std::vector<SGGraphicsJob>& jobs);
 
+		// The entity bounds belong to the thread that calls Render, which culls and selects LODs from them without a lock. Entities are
+		// created and given bounds from that thread only, since creating an entity grows the bounds
 		SGGraphicalEntityID CreateEntity();
 		void SetEntityToGroup(const SGGraphicalEntityID& entity, const SGGuid& groupGuid);
+		void SetEntityBoundingSphere(const SGGraphicalEntityID& entity, float centerX, float centerY, float centerZ, float radius);
+		void SetEntityBoundingBox(const SGGraphicalEntityID& entity, const float center[3], const float extents[3]);
+
+		SGOcclusionCuller* OcclusionCuller();
+		const SGProfiler* Profiler() const;
+		SGLoadQueue* LoadQueue();
+
+		void SetLODCamera(const SGLODCamera& camera);
+		SGResult SetEntityLODSet(const SGGraphicalEntityID& entity, const SGGuid& lodSetGuid);
 
 	protected:
+		struct LODSetSelection
+		{
+			SGLODThresholds thresholds;
+			bool groupedLevels;
+		};
+
+		struct LODChange
+		{
+			size_t position; // In the entity list of the job
+			SGGuid lodSetGuid;
+			unsigned int level;
+			bool groupedLevels;
+		};
 
 		void RenderThreadFunction();
 		virtual void FinishFrame() = 0;
 		virtual void SwapFrame() = 0;
 		virtual void ExecuteJobs(const std::vector<SGGraphicsJob>& jobs) = 0;
+		virtual void ApplyLODLevel(const SGGraphicalEntityID& entity, const SGGuid& lodSetGuid, unsigned int level) = 0;
+		virtual void RequestTextureMips(const SGGraphicsJob& job) = 0;
+
+		void RegisterLODSet(const SGGuid& lodSetGuid, const SGLODThresholds& thresholds, bool groupedLevels);
+		void SelectLODs(SGGraphicsJob& job);
+		void RegroupChangedEntities(std::vector<SGGraphicalEntityID>& entities);
+		void ChangeEntityGroup(const SGGraphicalEntityID& entity, const SGGuid& groupGuid);
+		void FinishEntityFrame();
+		void SwapEntityFrame();
 
 		std::mutex entityMutex;
 		std::vector<SGGraphicalEntity> graphicalEntities;
+		std::mutex frameBufferGroupMutex;
+		std::vector<std::pair<SGGraphicalEntityID, SGGuid>> updatedGroupsFrameBuffer;
+		std::vector<std::pair<SGGraphicalEntityID, SGGuid>> updatedGroupsTotalBuffer; // Finished frames the render thread has not swapped to yet
+		SGEntityBounds entityBounds;
+		std::vector<SGGraphicalEntityID> cullingBuffer;
+		std::vector<SGGraphicsJob> preparedJobs; // Culled before they are handed to the render thread
+		SGOcclusionCuller occlusionCuller;
+		SGThreadPool cullingThreadPool; // Used by Render, so culling never queues ahead of the recording of the render thread
+		SGProfiler profiler;
+		SGLoadQueue loadQueue;
+		std::mutex lodMutex;
+		std::unordered_map<SGGuid, LODSetSelection> lodSets;
+		SGLODCamera lodCamera;
+		std::vector<float> screenSizeBuffer;
+		std::vector<LODChange> lodChanges;
+		std::vector<SGGraphicalEntityID> regroupBuffer;
 		std::vector<SGGraphicsJob> pipelineJobs[3];
 		std::mutex dataIndexMutex;
 		int toWorkWith = 0;
 		int toUseNext = 1;
 		int toUpdate = 2;
 		bool threadedRenderLoop;
+		unsigned int minimumEntitiesPerChunk;
 		SGThreadPool* threadPool;
 		std::atomic<bool> engineActive = true;
 		std::atomic<bool> renderthreadActive = false;
@@ -0,0 +1,154 @@
+#include "SGRenderGraph.h"
+
+#include <algorithm>
+#include <unordered_map>
+
+namespace
+{
+	struct Dependency
+	{
+		size_t node;
+		bool keepsAlive; // Write after read only decides the order, the reader is not needed by the writer
+	};
+
+	struct ResourceState
+	{
+		size_t lastWriter;
+		std::vector<size_t> readers; // Readers since the last write
+	};
+}
+
+SG::SGCompiledRenderGraph SG::CompileRenderGraph(const std::vector<SGRenderGraphNode>& nodes, const std::vector<size_t>& outputs)
+{
+	const size_t none = static_cast<size_t>(-1);
+	std::vector<std::vector<Dependency>> dependencies(nodes.size());
+	std::unordered_map<size_t, ResourceState> resources;
+	std::vector<size_t> sinceBarrier;
+	std::vector<size_t> unknownReaders;
+	size_t lastBarrier = none;
+
+	for (size_t i = 0; i < nodes.size(); ++i)
+	{
+		const SGRenderGraphNode& node = nodes[i];
+		std::vector<Dependency>& nodeDependencies = dependencies[i];
+
+		if (lastBarrier != none)
+			nodeDependencies.push_back({ lastBarrier, true });
+
+		if (node.barrier)
+		{
+			for (size_t earlier : sinceBarrier)
+				nodeDependencies.push_back({ earlier, true });
+
+			lastBarrier = i;
+			sinceBarrier.clear();
+			unknownReaders.clear();
+		}
+		else
+		{
+			sinceBarrier.push_back(i);
+		}
+
+		if (node.readsUnknown && !node.barrier)
+		{
+			for (auto& resource : resources)
+				if (resource.second.lastWriter != none)
+					nodeDependencies.push_back({ resource.second.lastWriter, true });
+
+			unknownReaders.push_back(i);
+		}
+
+		for (size_t resource : node.reads)
+		{
+			auto inserted = resources.insert({ resource, { none, {} } });
+			size_t writer = inserted.first->second.lastWriter;
+
+			if (writer != none)
+				nodeDependencies.push_back({ writer, true });
+		}
+
+		if (node.writes.size() != 0)
+		{
+			for (size_t reader : unknownReaders)
+				if (reader != i)
+					nodeDependencies.push_back({ reader, false });
+		}
+
+		for (size_t resource : node.writes)
+		{
+			ResourceState& state = resources.insert({ resource, { none, {} } }).first->second;
+
+			if (state.lastWriter != none && state.lastWriter != i)
+				nodeDependencies.push_back({ state.lastWriter, true });
+
+			for (size_t reader : state.readers)
+				if (reader != i)
+					nodeDependencies.push_back({ reader, false });
+
+			state.lastWriter = i;
+			state.readers.clear();
+		}
+
+		for (size_t resource : node.reads)
+		{
+			ResourceState& state = resources[resource];
+
+			if (state.lastWriter != i)
+				state.readers.push_back(i);
+		}
+	}
+
+	std::vector<bool> alive(nodes.size(), outputs.size() == 0);
+
+	for (size_t i = 0; i < nodes.size(); ++i)
+		if (nodes[i].hasSideEffects || nodes[i].barrier)
+			alive[i] = true;
+
+	for (size_t output : outputs)
+	{
+		auto state = resources.find(output);
+
+		if (state != resources.end() && state->second.lastWriter != none)
+			alive[state->second.lastWriter] = true;
+	}
+
+	// Dependencies always point to earlier nodes, so one pass from the back reaches everything that is needed
+	for (size_t i = nodes.size(); i-- > 0;)
+	{
+		if (!alive[i])
+			continue;
+
+		for (auto& dependency : dependencies[i])
+			if (dependency.keepsAlive)
+				alive[dependency.node] = true;
+	}
+
+	SGCompiledRenderGraph toReturn;
+	std::vector<size_t> levels(nodes.size(), 0);
+
+	for (size_t i = 0; i < nodes.size(); ++i)
+	{
+		if (!alive[i])
+		{
+			++toReturn.nrOfCulled;
+			continue;
+		}
+
+		for (auto& dependency : dependencies[i])
+			if (alive[dependency.node] && levels[dependency.node] + 1 > levels[i])
+				levels[i] = levels[dependency.node] + 1;
+
+		toReturn.order.push_back(i);
+	}
+
+	// Every dependency is on a lower level, so sorting by level keeps the order valid while moving independent nodes next to each other
+	std::stable_sort(toReturn.order.begin(), toReturn.order.end(), [&levels](size_t first, size_t second)
+	{
+		return levels[first] < levels[second];
+	});
+
+	for (size_t node : toReturn.order)
+		toReturn.levels.push_back(levels[node]);
+
+	return toReturn;
+}
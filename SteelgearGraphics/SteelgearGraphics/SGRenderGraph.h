@@ -0,0 +1,28 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+namespace SG
+{
+	// Resources are identified by any unique number, for example the id of the guid of a texture or buffer
+	struct SGRenderGraphNode
+	{
+		std::vector<size_t> reads;
+		std::vector<size_t> writes;
+		bool hasSideEffects = false; // Never culled
+		bool readsUnknown = false; // Reads resources that could not be resolved, ordered after every earlier write
+		bool barrier = false; // Writes resources that could not be resolved, ordered against every other node and never culled
+	};
+
+	struct SGCompiledRenderGraph
+	{
+		std::vector<size_t> order; // Indices of the nodes that survived culling, in execution order
+		std::vector<size_t> levels; // Dependency depth of each node in order, nodes on the same level are independent of each other
+		size_t nrOfCulled = 0;
+	};
+
+	/** Nodes are given in submission order, which decides the order of conflicting accesses to the same resource.
+	Nodes that do not contribute to any of the outputs are culled, if outputs is empty no node is culled */
+	SGCompiledRenderGraph CompileRenderGraph(const std::vector<SGRenderGraphNode>& nodes, const std::vector<size_t>& outputs);
+}
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <cstddef>
+#include <emmintrin.h>
+
+namespace SG
+{
+	/** Finds the first and last element that differ between two arrays of plain data, returns false if the arrays are equal.
+	Elements are compared bytewise 16 bytes at a time, so they should not contain padding */
+	template<typename T>
+	bool FindChangedRange(const T* current, const T* wanted, unsigned int count, unsigned int& first, unsigned int& last)
+	{
+		const unsigned char* currentBytes = reinterpret_cast<const unsigned char*>(current);
+		const unsigned char* wantedBytes = reinterpret_cast<const unsigned char*>(wanted);
+		const size_t size = sizeof(T) * count;
+		const size_t nrOfBlocks = size / 16;
+		size_t firstByte = size;
+		size_t lastByte = size;
+
+		for (size_t block = 0; block < nrOfBlocks; ++block)
+		{
+			__m128i currentBlock = _mm_loadu_si128(reinterpret_cast<const __m128i*>(currentBytes + block * 16));
+			__m128i wantedBlock = _mm_loadu_si128(reinterpret_cast<const __m128i*>(wantedBytes + block * 16));
+
+			if (_mm_movemask_epi8(_mm_cmpeq_epi8(currentBlock, wantedBlock)) != 0xFFFF)
+			{
+				firstByte = block * 16;
+
+				while (currentBytes[firstByte] == wantedBytes[firstByte])
+					++firstByte;
+
+				break;
+			}
+		}
+
+		if (firstByte == size)
+		{
+			for (size_t i = nrOfBlocks * 16; i < size; ++i)
+			{
+				if (currentBytes[i] != wantedBytes[i])
+				{
+					firstByte = i;
+					break;
+				}
+			}
+
+			if (firstByte == size)
+				return false;
+		}
+
+		// Searched from the back the same way, the first difference found bounds the search
+		for (size_t i = size; i > nrOfBlocks * 16 && lastByte == size; --i)
+			if (currentBytes[i - 1] != wantedBytes[i - 1])
+				lastByte = i - 1;
+
+		for (size_t block = nrOfBlocks; block > 0 && lastByte == size; --block)
+		{
+			__m128i currentBlock = _mm_loadu_si128(reinterpret_cast<const __m128i*>(currentBytes + (block - 1) * 16));
+			__m128i wantedBlock = _mm_loadu_si128(reinterpret_cast<const __m128i*>(wantedBytes + (block - 1) * 16));
+
+			if (_mm_movemask_epi8(_mm_cmpeq_epi8(currentBlock, wantedBlock)) != 0xFFFF)
+			{
+				lastByte = block * 16 - 1;
+
+				while (currentBytes[lastByte] == wantedBytes[lastByte])
+					--lastByte;
+			}
+		}
+
+		first = static_cast<unsigned int>(firstByte / sizeof(T));
+		last = static_cast<unsigned int>(lastByte / sizeof(T));
+		return true;
+	}
+}
@@ -0,0 +1,242 @@
+#include "SGTextureResidency.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <tuple>
+
+SG::SGTextureResidency::SGTextureResidency(size_t budget)
+{
+	this->budget = budget;
+}
+
+void SG::SGTextureResidency::AddTexture(const SGGuid & guid, const std::vector<size_t>& mipSizes, unsigned int minimumResidentMips)
+{
+	if (mipSizes.empty())
+		return;
+
+	std::lock_guard<std::mutex> lock(residencyMutex);
+	Texture toAdd;
+	toAdd.mipSizes = mipSizes;
+	unsigned int nrOfMips = static_cast<unsigned int>(mipSizes.size());
+	toAdd.coarsestMip = nrOfMips - std::clamp(minimumResidentMips, 1u, nrOfMips);
+	toAdd.residentMip = toAdd.coarsestMip;
+
+	auto existing = textures.find(guid);
+
+	if (existing != textures.end())
+		residentBytes -= ResidentSize(existing->second, existing->second.residentMip);
+
+	// The minimum mips are always resident, even when they do not fit the budget
+	residentBytes += ResidentSize(toAdd, toAdd.residentMip);
+	textures[guid] = std::move(toAdd);
+}
+
+void SG::SGTextureResidency::RemoveTexture(const SGGuid & guid)
+{
+	std::lock_guard<std::mutex> lock(residencyMutex);
+	auto texture = textures.find(guid);
+
+	if (texture == textures.end())
+		return;
+
+	residentBytes -= ResidentSize(texture->second, texture->second.residentMip);
+	textures.erase(texture);
+}
+
+void SG::SGTextureResidency::RequestMip(const SGGuid & guid, unsigned int mip, float priority)
+{
+	std::lock_guard<std::mutex> lock(residencyMutex);
+	auto found = textures.find(guid);
+
+	if (found == textures.end())
+		return;
+
+	Texture& texture = found->second;
+	mip = std::min(mip, static_cast<unsigned int>(texture.mipSizes.size()) - 1);
+
+	if (texture.lastRequested != frame)
+	{
+		texture.requestedMip = mip;
+		texture.priority = priority;
+		texture.lastRequested = frame;
+	}
+	else
+	{
+		texture.requestedMip = std::min(texture.requestedMip, mip);
+		texture.priority = std::max(texture.priority, priority);
+	}
+}
+
+void SG::SGTextureResidency::SetLocked(const SGGuid & guid, bool locked)
+{
+	std::lock_guard<std::mutex> lock(residencyMutex);
+	auto texture = textures.find(guid);
+
+	if (texture != textures.end())
+		texture->second.locked = locked;
+}
+
+void SG::SGTextureResidency::SetResidentMip(const SGGuid & guid, unsigned int residentMip)
+{
+	std::lock_guard<std::mutex> lock(residencyMutex);
+	auto found = textures.find(guid);
+
+	if (found == textures.end())
+		return;
+
+	Texture& texture = found->second;
+	residentMip = std::min(residentMip, texture.coarsestMip);
+	residentBytes -= ResidentSize(texture, texture.residentMip);
+	texture.residentMip = residentMip;
+	residentBytes += ResidentSize(texture, texture.residentMip);
+}
+
+void SG::SGTextureResidency::SetBudget(size_t budget)
+{
+	std::lock_guard<std::mutex> lock(residencyMutex);
+	this->budget = budget;
+}
+
+size_t SG::SGTextureResidency::GetBudget()
+{
+	std::lock_guard<std::mutex> lock(residencyMutex);
+	return budget;
+}
+
+size_t SG::SGTextureResidency::GetResidentBytes()
+{
+	std::lock_guard<std::mutex> lock(residencyMutex);
+	return residentBytes;
+}
+
+unsigned int SG::SGTextureResidency::GetResidentMip(const SGGuid & guid)
+{
+	std::lock_guard<std::mutex> lock(residencyMutex);
+	auto texture = textures.find(guid);
+	return texture != textures.end() ? texture->second.residentMip : 0;
+}
+
+void SG::SGTextureResidency::Update(std::vector<SGResidencyChange>& changes)
+{
+	std::lock_guard<std::mutex> lock(residencyMutex);
+	std::vector<std::tuple<const SGGuid*, Texture*, unsigned int>> before;
+	std::vector<Texture*> toLoad;
+	std::vector<Texture*> victims;
+	before.reserve(textures.size());
+
+	for (auto& texture : textures)
+	{
+		Texture& data = texture.second;
+		before.emplace_back(&texture.first, &data, data.residentMip);
+
+		if (data.locked)
+			continue;
+
+		bool requestedNow = data.lastRequested == frame;
+
+		if (requestedNow && data.requestedMip < data.residentMip)
+			toLoad.push_back(&data);
+		else if (!requestedNow || data.residentMip < data.requestedMip)
+			victims.push_back(&data);
+	}
+
+	// Highest priority first, the largest jump in detail breaks ties
+	std::sort(toLoad.begin(), toLoad.end(), [](const Texture* lhs, const Texture* rhs)
+	{
+		if (lhs->priority != rhs->priority)
+			return lhs->priority > rhs->priority;
+
+		return lhs->residentMip - lhs->requestedMip > rhs->residentMip - rhs->requestedMip;
+	});
+
+	// Textures not requested this frame go first, least recently requested first, then the unneeded mips of requested textures
+	std::sort(victims.begin(), victims.end(), [this](const Texture* lhs, const Texture* rhs)
+	{
+		bool lhsRequested = lhs->lastRequested == frame;
+		bool rhsRequested = rhs->lastRequested == frame;
+
+		if (lhsRequested != rhsRequested)
+			return !lhsRequested;
+
+		if (lhs->lastRequested != rhs->lastRequested)
+			return lhs->lastRequested < rhs->lastRequested;
+
+		return lhs->priority < rhs->priority;
+	});
+
+	size_t nextVictim = 0;
+
+	// A lowered budget is honoured before anything new is loaded
+	while (residentBytes > budget && EvictOne(victims, nextVictim))
+	{
+	}
+
+	for (Texture* texture : toLoad)
+	{
+		while (texture->residentMip > texture->requestedMip)
+		{
+			size_t needed = texture->mipSizes[texture->residentMip - 1];
+
+			while (residentBytes + needed > budget && EvictOne(victims, nextVictim))
+			{
+			}
+
+			if (residentBytes + needed > budget)
+				break;
+
+			--texture->residentMip;
+			residentBytes += needed;
+		}
+	}
+
+	for (auto& [guid, texture, residentMip] : before)
+	{
+		if (texture->residentMip != residentMip)
+			changes.push_back({ *guid, texture->residentMip, residentMip });
+	}
+
+	++frame;
+}
+
+unsigned int SG::SGTextureResidency::MipForScreenSize(unsigned int width, unsigned int height, float pixels)
+{
+	float largestSide = static_cast<float>(std::max(width, height));
+
+	if (!(pixels > 0.0f))
+		return std::numeric_limits<unsigned int>::max();
+
+	if (pixels >= largestSide)
+		return 0;
+
+	return static_cast<unsigned int>(std::floor(std::log2(largestSide / pixels)));
+}
+
+size_t SG::SGTextureResidency::ResidentSize(const Texture & texture, unsigned int residentMip) const
+{
+	size_t toReturn = 0;
+
+	for (size_t i = residentMip; i < texture.mipSizes.size(); ++i)
+		toReturn += texture.mipSizes[i];
+
+	return toReturn;
+}
+
+bool SG::SGTextureResidency::EvictOne(std::vector<Texture*>& victims, size_t & nextVictim)
+{
+	// Drops the most detailed resident mip of the first victim that still has one to spare
+	for (; nextVictim < victims.size(); ++nextVictim)
+	{
+		Texture* victim = victims[nextVictim];
+		unsigned int floor = victim->lastRequested == frame ? std::min(victim->requestedMip, victim->coarsestMip) : victim->coarsestMip;
+
+		if (victim->residentMip < floor)
+		{
+			residentBytes -= victim->mipSizes[victim->residentMip];
+			++victim->residentMip;
+			return true;
+		}
+	}
+
+	return false;
+}
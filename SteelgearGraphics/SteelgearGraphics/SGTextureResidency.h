@@ -0,0 +1,66 @@
+#pragma once
+
+#include <cstddef>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "SGGuid.h"
+
+namespace SG
+{
+	struct SGResidencyChange
+	{
+		SGGuid guid;
+		unsigned int residentMip; // Most detailed mip that should be resident
+		unsigned int previousResidentMip;
+	};
+
+	/** Decides which mips of the streamed textures are resident within a byte budget, without knowing anything about the device.
+	Mips are loaded in order of request priority and evicted from the least recently requested textures first, then from the
+	mips that textures requested this frame no longer need. Every texture keeps its minimum mips so something can always be sampled.
+	Requests can be made from any thread, Update is called once per frame */
+	class SGTextureResidency
+	{
+	public:
+		SGTextureResidency(size_t budget);
+		~SGTextureResidency() = default;
+
+		void AddTexture(const SGGuid& guid, const std::vector<size_t>& mipSizes, unsigned int minimumResidentMips); // Sizes of mip 0 and up
+		void RemoveTexture(const SGGuid& guid);
+		void RequestMip(const SGGuid& guid, unsigned int mip, float priority = 1.0f); // The most detailed request of a frame wins
+		void SetLocked(const SGGuid& guid, bool locked); // Locked textures are neither loaded nor evicted, used while a change is in flight
+		void SetResidentMip(const SGGuid& guid, unsigned int residentMip); // Corrects the residency when a change could not be applied
+
+		void SetBudget(size_t budget);
+		size_t GetBudget();
+		size_t GetResidentBytes();
+		unsigned int GetResidentMip(const SGGuid& guid);
+
+		void Update(std::vector<SGResidencyChange>& changes); // Appends one change per texture whose residency changed, then starts a new frame
+
+		/** Mip that gives about one texel per pixel when the largest side of the texture covers the given number of pixels */
+		static unsigned int MipForScreenSize(unsigned int width, unsigned int height, float pixels);
+
+	private:
+		struct Texture
+		{
+			std::vector<size_t> mipSizes;
+			unsigned int residentMip;
+			unsigned int coarsestMip; // Least detailed mip that can be the most detailed resident one
+			unsigned int requestedMip = 0;
+			float priority = 0.0f;
+			unsigned long long lastRequested = 0;
+			bool locked = false;
+		};
+
+		std::mutex residencyMutex;
+		std::unordered_map<SGGuid, Texture> textures;
+		size_t budget;
+		size_t residentBytes = 0;
+		unsigned long long frame = 1;
+
+		size_t ResidentSize(const Texture& texture, unsigned int residentMip) const;
+		bool EvictOne(std::vector<Texture*>& victims, size_t& nextVictim);
+	};
+}
@@ -1,8 +1,10 @@
 #include "SGThreadPool.h"
+#include "SGTrace.h"
 #include <thread>
 
 void SG::SGThreadPool::ThreadFunction(int threadID)
 {
+	SetTraceThreadName("SGThreadPool worker");
 	std::mutex cvMutex;
 	std::unique_lock<std::mutex>* cvLock = new std::unique_lock<std::mutex>(cvMutex);
 
@@ -13,17 +15,20 @@ void SG::SGThreadPool::ThreadFunction(int threadID)
 		if (functionsToExecute.size())
 		{
 			std::function<void(void)> toExecute = functionsToExecute.front().function;
-			FunctionStatus* statusPtr = functionsToExecute.front().statusPtr;
+			std::atomic<FunctionStatus>* statusPtr = functionsToExecute.front().statusPtr;
 			functionsToExecute.pop();
 			functionMutex.unlock();
 
 			if (statusPtr)
-				*statusPtr = FunctionStatus::PROCESSING;
+				statusPtr->store(FunctionStatus::PROCESSING, std::memory_order_relaxed);
 
-			toExecute();
+			{
+				SGTraceScope scope("SGThreadPool task");
+				toExecute();
+			}
 
 			if (statusPtr)
-				*statusPtr = FunctionStatus::FINISHED;
+				statusPtr->store(FunctionStatus::FINISHED, std::memory_order_release);
 		}
 		else
 		{
@@ -37,19 +42,24 @@ void SG::SGThreadPool::ThreadFunction(int threadID)
 	return;
 }
 
-void SG::SGThreadPool::EnqueFunction(FunctionStatus* statusPtr, const std::function<void(void)>& function)
+void SG::SGThreadPool::EnqueFunction(std::atomic<FunctionStatus>* statusPtr, const std::function<void(void)>& function)
 {
 	functionMutex.lock();
 	functionsToExecute.push({ function, statusPtr });
 
 	if (statusPtr)
-		*statusPtr = FunctionStatus::ENQUEUED;
+		statusPtr->store(FunctionStatus::ENQUEUED, std::memory_order_relaxed); // The worker takes the function under the same lock
 
 	functionMutex.unlock();
 
 	cv.notify_one();
 }
 
+size_t SG::SGThreadPool::GetNrOfThreads() const
+{
+	return threadStatus.size();
+}
+
 SG::SGThreadPool::SGThreadPool(int nrOfThreadsInPool)
 {
 	threadStatus.resize(nrOfThreadsInPool, true);
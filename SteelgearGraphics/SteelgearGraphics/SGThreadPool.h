@@ -1,5 +1,6 @@
 #pragma once
 
+#include <atomic>
 #include <mutex>
 #include <functional>
 #include <vector>
@@ -8,6 +9,7 @@
 
 namespace SG
 {
+	// Set to FINISHED with release order once the function has run, wait for it with acquire so its writes are visible
 	enum class FunctionStatus
 	{
 		ENQUEUED,
@@ -22,7 +24,7 @@ namespace SG
 		struct StoredFunction
 		{
 			std::function<void(void)> function;
-			FunctionStatus* statusPtr = nullptr;
+			std::atomic<FunctionStatus>* statusPtr = nullptr;
 		};
 
 		std::vector<bool> threadStatus;
@@ -37,28 +39,64 @@ namespace SG
 		SGThreadPool(int nrOfThreadsInPool);
 		~SGThreadPool();
 
-		void EnqueFunction(FunctionStatus* statusPtr, const std::function<void(void)>& function);
+		void EnqueFunction(std::atomic<FunctionStatus>* statusPtr, const std::function<void(void)>& function);
+		size_t GetNrOfThreads() const;
 
 		template<class returnType, class... argTypes>
-		void EnqueFunction(FunctionStatus* statusPtr, const std::function<returnType(argTypes...)>& function, argTypes&&... arguments);
+		void EnqueFunction(std::atomic<FunctionStatus>* statusPtr, const std::function<returnType(argTypes...)>& function, argTypes&&... arguments);
 
 		template<class returnType, class... argTypes>
-		void EnqueFunction(FunctionStatus* statusPtr, returnType(*function)(argTypes...), argTypes&&... arguments);
+		void EnqueFunction(std::atomic<FunctionStatus>* statusPtr, returnType(*function)(argTypes...), argTypes&&... arguments);
 	};
 
-
-
-
+	/** Calls function(start, end) for ranges of at most countPerTask covering [0, count), the first range on the calling thread.
+	Returns when every range is done, threadPool can be nullptr */
+	template<class Function>
+	void RunTasks(SGThreadPool* threadPool, size_t count, size_t countPerTask, const Function& function);
 }
 
 template<class returnType, class ...argTypes>
-inline void SG::SGThreadPool::EnqueFunction(FunctionStatus* statusPtr, const std::function<returnType(argTypes...)>& function, argTypes&&... arguments)
+inline void SG::SGThreadPool::EnqueFunction(std::atomic<FunctionStatus>* statusPtr, const std::function<returnType(argTypes...)>& function, argTypes&&... arguments)
 {
 	EnqueFunction(statusPtr, std::bind(function, arguments...));
 }
 
 template<class returnType, class ...argTypes>
-inline void SG::SGThreadPool::EnqueFunction(FunctionStatus* statusPtr, returnType(*function)(argTypes...), argTypes && ...arguments)
+inline void SG::SGThreadPool::EnqueFunction(std::atomic<FunctionStatus>* statusPtr, returnType(*function)(argTypes...), argTypes && ...arguments)
 {
 	EnqueFunction(statusPtr, std::bind(function, arguments...));
 }
+
+template<class Function>
+inline void SG::RunTasks(SGThreadPool* threadPool, size_t count, size_t countPerTask, const Function& function)
+{
+	size_t nrOfTasks = (count + countPerTask - 1) / countPerTask;
+
+	if (threadPool == nullptr || threadPool->GetNrOfThreads() == 0 || nrOfTasks <= 1)
+	{
+		function(0, count);
+		return;
+	}
+
+	std::vector<std::atomic<FunctionStatus>> statuses(nrOfTasks - 1);
+
+	for (size_t i = 1; i < nrOfTasks; ++i)
+	{
+		size_t start = i * countPerTask;
+		size_t end = count - start < countPerTask ? count : start + countPerTask;
+		threadPool->EnqueFunction(&statuses[i - 1], [&function, start, end]()
+		{
+			function(start, end);
+		});
+	}
+
+	function(0, countPerTask);
+
+	for (auto& status : statuses)
+	{
+		while (status.load(std::memory_order_acquire) != FunctionStatus::FINISHED)
+		{
+			// Spinwait
+		}
+	}
+}
@@ -0,0 +1,288 @@
+#include "SGTrace.h"
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace
+{
+	const size_t SPANS_PER_THREAD = 1 << 14;
+
+	// The fields are atomic only so that a span overwritten while a trace is written is not a data race
+	struct TraceSpan
+	{
+		std::atomic<const char*> name = nullptr;
+		std::atomic<long long> start = 0;
+		std::atomic<long long> end = 0;
+	};
+
+	struct ThreadTrace
+	{
+		unsigned int id = 0;
+		std::atomic<const char*> name = nullptr;
+		std::atomic<unsigned long long> nrOfWritten = 0;
+		TraceSpan spans[SPANS_PER_THREAD];
+	};
+
+	struct SpanCopy
+	{
+		const char* name;
+		long long start;
+		long long end;
+	};
+
+	// Traces are never freed, so the spans of threads that have exited can still be written
+	std::mutex registryMutex;
+	std::vector<std::unique_ptr<ThreadTrace>> registry;
+	thread_local ThreadTrace* threadTrace = nullptr;
+
+	ThreadTrace* GetThreadTrace()
+	{
+		if (threadTrace == nullptr)
+		{
+			registryMutex.lock();
+			registry.push_back(std::make_unique<ThreadTrace>());
+			threadTrace = registry.back().get();
+			threadTrace->id = static_cast<unsigned int>(registry.size());
+			registryMutex.unlock();
+		}
+
+		return threadTrace;
+	}
+
+	// Copies the spans still in the ring sorted by start, enclosing spans before the spans they enclose
+	void CopySpans(const ThreadTrace& trace, std::vector<SpanCopy>& spans)
+	{
+		unsigned long long written = trace.nrOfWritten.load(std::memory_order_acquire);
+		unsigned long long first = written > SPANS_PER_THREAD ? written - SPANS_PER_THREAD : 0;
+
+		for (unsigned long long i = first; i < written; ++i)
+		{
+			const TraceSpan& span = trace.spans[i % SPANS_PER_THREAD];
+			spans.push_back({ span.name.load(std::memory_order_relaxed), span.start.load(std::memory_order_relaxed),
+				span.end.load(std::memory_order_relaxed) });
+		}
+
+		// Spans the owning thread wrote over during the copy are dropped
+		unsigned long long writtenAfter = trace.nrOfWritten.load(std::memory_order_acquire);
+		unsigned long long firstValid = writtenAfter > SPANS_PER_THREAD ? writtenAfter - SPANS_PER_THREAD : 0;
+
+		if (firstValid > first)
+			spans.erase(spans.begin(), spans.begin() + static_cast<size_t>(std::min(firstValid - first, written - first)));
+
+		std::sort(spans.begin(), spans.end(), [](const SpanCopy& lhs, const SpanCopy& rhs)
+		{
+			return lhs.start != rhs.start ? lhs.start < rhs.start : lhs.end > rhs.end;
+		});
+	}
+
+	std::string ThreadName(const ThreadTrace& trace)
+	{
+		const char* name = trace.name.load(std::memory_order_relaxed);
+		return name != nullptr ? std::string(name) : "Thread " + std::to_string(trace.id);
+	}
+
+	void WriteJSONString(std::ostream& stream, const char* text)
+	{
+		stream << '"';
+
+		for (; *text != '\0'; ++text)
+		{
+			if (*text == '"' || *text == '\\')
+				stream << '\\';
+
+			stream << *text;
+		}
+
+		stream << '"';
+	}
+
+	void AppendVarint(std::string& buffer, unsigned long long value)
+	{
+		while (value >= 0x80)
+		{
+			buffer.push_back(static_cast<char>((value & 0x7F) | 0x80));
+			value >>= 7;
+		}
+
+		buffer.push_back(static_cast<char>(value));
+	}
+
+	void AppendVarintField(std::string& buffer, unsigned int field, unsigned long long value)
+	{
+		AppendVarint(buffer, field << 3);
+		AppendVarint(buffer, value);
+	}
+
+	void AppendBytesField(std::string& buffer, unsigned int field, const std::string& bytes)
+	{
+		AppendVarint(buffer, (field << 3) | 2);
+		AppendVarint(buffer, bytes.size());
+		buffer.append(bytes);
+	}
+
+	// Field numbers from perfetto/trace/trace_packet.proto and track_event/*.proto
+	const unsigned int TRACE_PACKET = 1;
+	const unsigned int PACKET_TIMESTAMP = 8;
+	const unsigned int PACKET_SEQUENCE_ID = 10;
+	const unsigned int PACKET_TRACK_EVENT = 11;
+	const unsigned int PACKET_SEQUENCE_FLAGS = 13;
+	const unsigned int PACKET_TRACK_DESCRIPTOR = 60;
+	const unsigned int EVENT_TYPE = 9;
+	const unsigned int EVENT_TRACK_UUID = 11;
+	const unsigned int EVENT_NAME = 23;
+	const unsigned int EVENT_SLICE_BEGIN = 1;
+	const unsigned int EVENT_SLICE_END = 2;
+	const unsigned int DESCRIPTOR_UUID = 1;
+	const unsigned int DESCRIPTOR_THREAD = 4;
+	const unsigned int THREAD_PID = 1;
+	const unsigned int THREAD_TID = 2;
+	const unsigned int THREAD_NAME = 5;
+	const unsigned int SEQUENCE_INCREMENTAL_STATE_CLEARED = 1;
+
+	void AppendTrackEvent(std::string& trace, unsigned int threadID, long long timestamp, unsigned int type, const char* name)
+	{
+		std::string event;
+		AppendVarintField(event, EVENT_TYPE, type);
+		AppendVarintField(event, EVENT_TRACK_UUID, threadID);
+
+		if (name != nullptr)
+			AppendBytesField(event, EVENT_NAME, name);
+
+		std::string packet;
+		AppendVarintField(packet, PACKET_TIMESTAMP, static_cast<unsigned long long>(timestamp));
+		AppendVarintField(packet, PACKET_SEQUENCE_ID, threadID);
+		AppendBytesField(packet, PACKET_TRACK_EVENT, event);
+		AppendBytesField(trace, TRACE_PACKET, packet);
+	}
+}
+
+void SG::SetTraceThreadName(const char * name)
+{
+	if constexpr (TRACING_VERSION)
+		GetThreadTrace()->name.store(name, std::memory_order_relaxed);
+}
+
+void SG::RecordTraceSpan(const char * name, long long start, long long end)
+{
+	ThreadTrace* trace = GetThreadTrace();
+	unsigned long long index = trace->nrOfWritten.load(std::memory_order_relaxed);
+	TraceSpan& span = trace->spans[index % SPANS_PER_THREAD];
+	span.name.store(name, std::memory_order_relaxed);
+	span.start.store(start, std::memory_order_relaxed);
+	span.end.store(end, std::memory_order_relaxed);
+	trace->nrOfWritten.store(index + 1, std::memory_order_release);
+}
+
+void SG::WriteChromeTrace(std::ostream & stream)
+{
+	stream << "{\"traceEvents\":[";
+
+	if constexpr (TRACING_VERSION)
+	{
+		registryMutex.lock();
+		std::vector<ThreadTrace*> traces;
+
+		for (auto& trace : registry)
+			traces.push_back(trace.get());
+
+		registryMutex.unlock();
+
+		std::vector<SpanCopy> spans;
+		bool firstEvent = true;
+		auto precision = stream.precision(3);
+		auto flags = stream.setf(std::ios::fixed, std::ios::floatfield);
+
+		for (ThreadTrace* trace : traces)
+		{
+			stream << (firstEvent ? "" : ",") << "\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << trace->id << ",\"args\":{\"name\":";
+			WriteJSONString(stream, ThreadName(*trace).c_str());
+			stream << "}}";
+			firstEvent = false;
+
+			spans.clear();
+			CopySpans(*trace, spans);
+
+			// Timestamps are in microseconds
+			for (auto& span : spans)
+			{
+				stream << ",\n{\"name\":";
+				WriteJSONString(stream, span.name);
+				stream << ",\"ph\":\"X\",\"pid\":1,\"tid\":" << trace->id << ",\"ts\":" << span.start / 1000.0
+					<< ",\"dur\":" << (span.end - span.start) / 1000.0 << "}";
+			}
+		}
+
+		stream.precision(precision);
+		stream.flags(flags);
+	}
+
+	stream << "\n],\"displayTimeUnit\":\"ms\"}\n";
+}
+
+void SG::WritePerfettoTrace(std::ostream & stream)
+{
+	if constexpr (TRACING_VERSION)
+	{
+		registryMutex.lock();
+		std::vector<ThreadTrace*> traces;
+
+		for (auto& trace : registry)
+			traces.push_back(trace.get());
+
+		registryMutex.unlock();
+
+		std::vector<SpanCopy> spans;
+		std::vector<const SpanCopy*> open;
+		std::string buffer;
+
+		// Every thread gets its own packet sequence and track, both identified by the id of the thread
+		for (ThreadTrace* trace : traces)
+		{
+			std::string thread;
+			AppendVarintField(thread, THREAD_PID, 1);
+			AppendVarintField(thread, THREAD_TID, trace->id);
+			AppendBytesField(thread, THREAD_NAME, ThreadName(*trace));
+			std::string descriptor;
+			AppendVarintField(descriptor, DESCRIPTOR_UUID, trace->id);
+			AppendBytesField(descriptor, DESCRIPTOR_THREAD, thread);
+			std::string packet;
+			AppendVarintField(packet, PACKET_SEQUENCE_ID, trace->id);
+			AppendVarintField(packet, PACKET_SEQUENCE_FLAGS, SEQUENCE_INCREMENTAL_STATE_CLEARED);
+			AppendBytesField(packet, PACKET_TRACK_DESCRIPTOR, descriptor);
+			AppendBytesField(buffer, TRACE_PACKET, packet);
+
+			spans.clear();
+			CopySpans(*trace, spans);
+
+			// Slices on a track have to nest, so a slice is ended before any slice that starts after it
+			for (auto& span : spans)
+			{
+				while (!open.empty() && open.back()->end <= span.start)
+				{
+					AppendTrackEvent(buffer, trace->id, open.back()->end, EVENT_SLICE_END, nullptr);
+					open.pop_back();
+				}
+
+				AppendTrackEvent(buffer, trace->id, span.start, EVENT_SLICE_BEGIN, span.name);
+				open.push_back(&span);
+			}
+
+			while (!open.empty())
+			{
+				AppendTrackEvent(buffer, trace->id, open.back()->end, EVENT_SLICE_END, nullptr);
+				open.pop_back();
+			}
+
+			stream.write(buffer.data(), buffer.size());
+			buffer.clear();
+		}
+	}
+	else
+	{
+		(void)stream;
+	}
+}
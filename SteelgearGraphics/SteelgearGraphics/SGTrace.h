@@ -0,0 +1,55 @@
+#pragma once
+
+#include <chrono>
+#include <ostream>
+
+#ifdef _SGG_TRACING
+constexpr bool TRACING_VERSION = true;
+#else
+constexpr bool TRACING_VERSION = false;
+#endif
+
+namespace SG
+{
+	/** Records the time from construction to destruction as a span on the timeline of the calling thread.
+	The name is stored as a pointer and must outlive the trace, use string literals */
+	class SGTraceScope
+	{
+	public:
+		SGTraceScope(const char* name);
+		~SGTraceScope();
+
+		SGTraceScope(const SGTraceScope& other) = delete;
+		SGTraceScope& operator=(const SGTraceScope& other) = delete;
+
+	private:
+		const char* name;
+		long long start;
+	};
+
+	/** Spans are written to a ring per thread without locks, so only the latest spans of each thread are kept.
+	Writing a trace can be done from any thread while the others keep recording, spans overwritten during the write are left out.
+	Everything compiles to nothing unless _SGG_TRACING is defined */
+	void SetTraceThreadName(const char* name);
+	void WriteChromeTrace(std::ostream& stream); // Trace event JSON, opens in chrome://tracing and Perfetto
+	void WritePerfettoTrace(std::ostream& stream); // Perfetto protobuf with one track per thread
+
+	inline long long TraceTimestamp()
+	{
+		return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+	}
+
+	void RecordTraceSpan(const char* name, long long start, long long end);
+
+	inline SGTraceScope::SGTraceScope(const char* name) : name(name), start(0)
+	{
+		if constexpr (TRACING_VERSION)
+			start = TraceTimestamp();
+	}
+
+	inline SGTraceScope::~SGTraceScope()
+	{
+		if constexpr (TRACING_VERSION)
+			RecordTraceSpan(name, start, TraceTimestamp());
+	}
+}
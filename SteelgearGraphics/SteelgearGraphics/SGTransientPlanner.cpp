@@ -0,0 +1,60 @@
+#include "SGTransientPlanner.h"
+
+#include <algorithm>
+#include <numeric>
+#include <unordered_map>
+
+size_t SG::SGTransientPlan::BytesSaved() const
+{
+	return requestedBytes - allocatedBytes;
+}
+
+SG::SGTransientPlan SG::PlanTransientResources(const std::vector<SGTransientResource>& resources)
+{
+	SGTransientPlan toReturn;
+	toReturn.assignments.resize(resources.size());
+
+	std::vector<size_t> byStart(resources.size());
+	std::iota(byStart.begin(), byStart.end(), 0);
+	std::stable_sort(byStart.begin(), byStart.end(), [&resources](size_t first, size_t second)
+	{
+		return resources[first].firstUse < resources[second].firstUse;
+	});
+
+	// Free time of every allocation per descriptor. Taking intervals by start and reusing any allocation that is free
+	// is optimal for interval graphs, so every descriptor ends up with as many allocations as its peak of live resources
+	struct Allocation
+	{
+		size_t index;
+		size_t lastUse;
+	};
+
+	std::unordered_map<size_t, std::vector<Allocation>> allocations;
+
+	for (size_t resourceIndex : byStart)
+	{
+		const SGTransientResource& resource = resources[resourceIndex];
+		std::vector<Allocation>& candidates = allocations[resource.descriptorKey];
+		toReturn.requestedBytes += resource.sizeInBytes;
+
+		auto freeAllocation = std::find_if(candidates.begin(), candidates.end(), [&resource](const Allocation& allocation)
+		{
+			return allocation.lastUse < resource.firstUse;
+		});
+
+		if (freeAllocation == candidates.end())
+		{
+			candidates.push_back({ toReturn.allocationKeys.size(), resource.lastUse });
+			toReturn.assignments[resourceIndex] = toReturn.allocationKeys.size();
+			toReturn.allocationKeys.push_back(resource.descriptorKey);
+			toReturn.allocatedBytes += resource.sizeInBytes;
+		}
+		else
+		{
+			freeAllocation->lastUse = resource.lastUse;
+			toReturn.assignments[resourceIndex] = freeAllocation->index;
+		}
+	}
+
+	return toReturn;
+}
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+namespace SG
+{
+	// Resources can only share a backing allocation if their descriptor keys are equal
+	struct SGTransientResource
+	{
+		size_t descriptorKey;
+		size_t sizeInBytes;
+		size_t firstUse;
+		size_t lastUse; // Inclusive
+	};
+
+	struct SGTransientPlan
+	{
+		std::vector<size_t> assignments; // Backing allocation of every resource
+		std::vector<size_t> allocationKeys; // Descriptor key of every backing allocation
+		size_t requestedBytes = 0;
+		size_t allocatedBytes = 0;
+
+		size_t BytesSaved() const;
+	};
+
+	/** Assigns resources with overlapping lifetimes to different backing allocations, using as few allocations as possible */
+	SGTransientPlan PlanTransientResources(const std::vector<SGTransientResource>& resources);
+}
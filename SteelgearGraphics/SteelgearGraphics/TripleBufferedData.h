@@ -28,6 +28,7 @@ public:
 	void MarkAsUpdated();
 	T& GetActive();
 	T& GetToUpdate();
+	T& GetLastUpdated(); // The same as the active data once the last update has been switched to
 	void UpdateData(const T& data);
 	void UpdateData(T&& data);
 	void SwitchActiveBuffer();
@@ -124,6 +125,12 @@ inline T & TripleBufferedData<T>::GetToUpdate()
 	return storedData[nextToUpdate];
 }
 
+template<class T>
+inline T & TripleBufferedData<T>::GetLastUpdated()
+{
+	return storedData[lastUpdated];
+}
+
 template<class T>
 inline void TripleBufferedData<T>::UpdateData(const T & data)
 {
@@ -0,0 +1,327 @@
+#include "SGBenchmark.h"
+#include "D3D11RenderEngine.h"
+
+#include <d3dcompiler.h>
+
+#include <atomic>
+#include <new>
+#include <stdexcept>
+#include <string>
+
+namespace
+{
+	std::atomic<size_t> nrOfAllocations = 0;
+}
+
+// Every allocation of the process is counted, the ones made by the engine included
+void* operator new(size_t size)
+{
+	++nrOfAllocations;
+
+	if (void* memory = std::malloc(size != 0 ? size : 1))
+		return memory;
+
+	throw std::bad_alloc();
+}
+
+void operator delete(void* memory) noexcept
+{
+	std::free(memory);
+}
+
+namespace
+{
+	const UINT CONSTANT_BUFFER_SIZE = 16;
+	const size_t MAXIMUM_BINDINGS = D3D11_COMMONSHADER_CONSTANT_BUFFER_API_SLOT_COUNT;
+
+	struct SceneSettings
+	{
+		size_t nrOfEntities = 10000;
+		size_t nrOfPipelines = 4;
+		size_t nrOfGroups = 64;
+		size_t bindingsPerEntity = 4; // Constant buffers of the vertex shader
+		size_t entityBoundPercent = 50; // Share of the bindings that are bound to the entity, the rest are bound to its group
+		size_t updatePercent = 10; // Share of the entity bound constant buffers updated every frame
+		size_t nrOfFrames = 200;
+		bool specializedDrawLoops = true;
+	};
+
+	struct SceneResult
+	{
+		double draws = 0.0; // Everything is the median over the measured frames
+		double recordingMicroseconds = 0.0;
+		double swapMicroseconds = 0.0;
+		double renderMicroseconds = 0.0; // Wall time of Render, including the frame swap and the recording
+		double allocations = 0.0; // Made by the updates and Render
+		double constantBufferChanges = 0.0;
+	};
+
+	double Median(std::vector<double>& values)
+	{
+		std::sort(values.begin(), values.end());
+		return values[values.size() / 2];
+	}
+
+	std::vector<unsigned char> CompileShader(const std::string& source, const char* target)
+	{
+		ID3DBlob* code = nullptr;
+		ID3DBlob* errors = nullptr;
+
+		if (FAILED(D3DCompile(source.data(), source.size(), nullptr, nullptr, nullptr, "main", target, 0, 0, &code, &errors)))
+		{
+			std::string message = errors != nullptr ? static_cast<const char*>(errors->GetBufferPointer()) : "Error compiling shader";
+			SG::ReleaseCOM(errors);
+			throw std::runtime_error(message);
+		}
+
+		const unsigned char* bytes = static_cast<const unsigned char*>(code->GetBufferPointer());
+		std::vector<unsigned char> toReturn(bytes, bytes + code->GetBufferSize());
+		SG::ReleaseCOM(code);
+		SG::ReleaseCOM(errors);
+
+		return toReturn;
+	}
+
+	// Every binding is a constant buffer the vertex shader reads, so none of them can be left out by the compiler
+	std::string GetVertexShaderSource(size_t nrOfBindings)
+	{
+		std::string source;
+		std::string position = "float4(position, 1.0f)";
+
+		for (size_t i = 0; i < nrOfBindings; ++i)
+		{
+			std::string index = std::to_string(i);
+			source += "cbuffer Binding" + index + " : register(b" + index + ") { float4 value" + index + "; };\n";
+			position += " + value" + index;
+		}
+
+		return source + "float4 main(float3 position : POSITION) : SV_POSITION { return " + position + "; }\n";
+	}
+
+	void CheckResult(SG::SGResult result, const char* call)
+	{
+		if (result != SG::SGResult::OK)
+			throw std::runtime_error(std::string("Error creating the scene in ") + call);
+	}
+
+	/** Creates the resources, entities and jobs of the scene. Bindings before entityBoundBindings get a buffer per entity, the
+	rest a buffer per group. The entity bound buffers are returned so they can be updated */
+	std::vector<SG::SGGuid> CreateScene(SG::D3D11RenderEngine& engine, const SceneSettings& settings, size_t entityBoundBindings,
+		std::vector<SG::SGGraphicsJob>& jobs)
+	{
+		using namespace SG;
+
+		std::vector<unsigned char> vertexShader = CompileShader(GetVertexShaderSource(settings.bindingsPerEntity), "vs_5_0");
+		std::vector<unsigned char> pixelShader = CompileShader("float4 main() : SV_TARGET { return float4(1.0f, 1.0f, 1.0f, 1.0f); }", "ps_5_0");
+		CheckResult(engine.ShaderManager()->CreateVertexShader(SGGuid("SubmissionVS"), vertexShader.data(), vertexShader.size()), "CreateVertexShader");
+		CheckResult(engine.ShaderManager()->CreatePixelShader(SGGuid("SubmissionPS"), pixelShader.data(), pixelShader.size()), "CreatePixelShader");
+		CheckResult(engine.ShaderManager()->CreateInputLayout(SGGuid("SubmissionLayout"), { { "POSITION", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, 0, false, 0 } },
+			vertexShader.data(), static_cast<UINT>(vertexShader.size())), "CreateInputLayout");
+
+		const float vertices[] = { -1.0f, -1.0f, 0.0f, 0.0f, 1.0f, 0.0f, 1.0f, -1.0f, 0.0f };
+		const UINT indices[] = { 0, 1, 2 };
+		D3D11BufferHandler* bufferHandler = engine.BufferHandler();
+		CheckResult(bufferHandler->CreateVertexBuffer(SGGuid("SubmissionVertices"), static_cast<UINT>(sizeof(vertices)), 3, false, false, vertices), "CreateVertexBuffer");
+		CheckResult(bufferHandler->CreateIndexBuffer(SGGuid("SubmissionIndices"), static_cast<UINT>(sizeof(indices)), 3, false, indices), "CreateIndexBuffer");
+		CheckResult(bufferHandler->CreateBufferStride(SGGuid("SubmissionStride"), static_cast<UINT>(3 * sizeof(float))), "CreateBufferStride");
+		CheckResult(bufferHandler->CreateBufferOffset(SGGuid("SubmissionOffset"), 0), "CreateBufferOffset");
+		CheckResult(engine.TextureHandler()->CreateRTV(SGGuid("SubmissionRTV"), SGGuid("SG_BACKBUFFER_0")), "CreateRTV");
+		CheckResult(engine.StateHandler()->CreateViewport(SGGuid("SubmissionViewport"), 0.0f, 0.0f, 1280.0f, 720.0f, 0.0f, 1.0f), "CreateViewport");
+		CheckResult(engine.DrawCallHandler()->CreateDrawIndexedCall(SGGuid("SubmissionDraw"), 3), "CreateDrawIndexedCall");
+
+		std::vector<SGGuid> bindGuids;
+		const float initialData[CONSTANT_BUFFER_SIZE / sizeof(float)] = {};
+
+		for (size_t i = 0; i < settings.bindingsPerEntity; ++i)
+			bindGuids.push_back(SGGuid("SubmissionBinding" + std::to_string(i)));
+
+		std::vector<SGGuid> groupGuids;
+
+		for (size_t group = 0; group < settings.nrOfGroups; ++group)
+		{
+			groupGuids.push_back(SGGuid("SubmissionGroup" + std::to_string(group)));
+
+			for (size_t i = entityBoundBindings; i < settings.bindingsPerEntity; ++i)
+			{
+				SGGuid bufferGuid("SubmissionGroup" + std::to_string(group) + "Buffer" + std::to_string(i));
+				CheckResult(bufferHandler->CreateConstantBuffer(bufferGuid, CONSTANT_BUFFER_SIZE, true, true, initialData), "CreateConstantBuffer");
+				CheckResult(bufferHandler->BindBufferToGroup(groupGuids.back(), bufferGuid, bindGuids[i]), "BindBufferToGroup");
+			}
+		}
+
+		std::vector<SGGuid> entityBuffers;
+		std::vector<SGGraphicalEntityID> entities;
+
+		for (size_t entity = 0; entity < settings.nrOfEntities; ++entity)
+		{
+			entities.push_back(engine.CreateEntity());
+			engine.SetEntityToGroup(entities.back(), groupGuids[entity * settings.nrOfGroups / settings.nrOfEntities]);
+
+			for (size_t i = 0; i < entityBoundBindings; ++i)
+			{
+				entityBuffers.push_back(SGGuid("SubmissionEntity" + std::to_string(entity) + "Buffer" + std::to_string(i)));
+				CheckResult(bufferHandler->CreateConstantBuffer(entityBuffers.back(), CONSTANT_BUFFER_SIZE, true, true, initialData), "CreateConstantBuffer");
+				CheckResult(bufferHandler->BindBufferToEntity(entities.back(), entityBuffers.back(), bindGuids[i]), "BindBufferToEntity");
+			}
+		}
+
+		SGRenderJob renderJob = {};
+		renderJob.association = Association::ENTITY;
+		renderJob.topology = SGTopology::TRIANGLELIST;
+		renderJob.inputAssembly = SGGuid("SubmissionLayout");
+		renderJob.vertexBuffers = { { { Association::GLOBAL, SGGuid("SubmissionVertices") }, { Association::GLOBAL, SGGuid("SubmissionStride") },
+			{ Association::GLOBAL, SGGuid("SubmissionOffset") } } };
+		renderJob.indexBuffer.buffer = { Association::GLOBAL, SGGuid("SubmissionIndices") };
+		renderJob.vertexShader.shader = SGGuid("SubmissionVS");
+		renderJob.pixelShader.shader = SGGuid("SubmissionPS");
+		renderJob.rtvs = { { ResourceView::ResourceType::TEXTURE, { Association::GLOBAL, SGGuid("SubmissionRTV") } } };
+		renderJob.viewports = { { Association::GLOBAL, SGGuid("SubmissionViewport") } };
+		renderJob.drawCall = { Association::GLOBAL, SGGuid("SubmissionDraw") };
+
+		for (size_t i = 0; i < settings.bindingsPerEntity; ++i)
+			renderJob.vertexShader.constantBuffers.push_back({ { i < entityBoundBindings ? Association::ENTITY : Association::GROUP, bindGuids[i] } });
+
+		// Every pipeline has a job of its own and draws an equal part of the entities
+		for (size_t pipeline = 0; pipeline < settings.nrOfPipelines; ++pipeline)
+		{
+			SGGuid jobGuid("SubmissionJob" + std::to_string(pipeline));
+			SGGuid pipelineGuid("SubmissionPipeline" + std::to_string(pipeline));
+			CheckResult(engine.PipelineManager()->CreateRenderJob(jobGuid, renderJob), "CreateRenderJob");
+			CheckResult(engine.PipelineManager()->CreatePipeline(pipelineGuid, { { { PipelineJobType::RENDER, jobGuid } }, {}, {} }), "CreatePipeline");
+
+			SGGraphicsJob job;
+			job.pipelineGuid = pipelineGuid;
+			job.entitiesToRender.assign(entities.begin() + pipeline * entities.size() / settings.nrOfPipelines,
+				entities.begin() + (pipeline + 1) * entities.size() / settings.nrOfPipelines);
+			jobs.push_back(job);
+		}
+
+		return entityBuffers;
+	}
+
+	SceneResult RunScene(const SceneSettings& settings, size_t entityBoundBindings, size_t updatePercent)
+	{
+		SG::SGRenderSettings renderSettings;
+		renderSettings.windowHandle = nullptr;
+		renderSettings.headless = true;
+		renderSettings.threadedRenderLoop = false; // Render does the whole frame, so it can be timed from here
+		renderSettings.specializedDrawLoops = settings.specializedDrawLoops;
+
+		SG::D3D11RenderEngine engine(renderSettings);
+		std::vector<SG::SGGraphicsJob> jobs;
+		std::vector<SG::SGGuid> entityBuffers = CreateScene(engine, settings, entityBoundBindings, jobs);
+		size_t updatesPerFrame = entityBuffers.size() * updatePercent / 100;
+		size_t nextUpdate = 0;
+		float updateData[CONSTANT_BUFFER_SIZE / sizeof(float)] = {};
+
+		// The first frames make the created resources active and grow the buffers of the engine
+		for (int frame = 0; frame < 4; ++frame)
+			engine.Render(jobs);
+
+		std::vector<double> draws, recording, swap, render, allocations, constantBufferChanges;
+
+		for (size_t frame = 0; frame < settings.nrOfFrames; ++frame)
+		{
+			size_t allocationsBefore = nrOfAllocations;
+			updateData[0] = static_cast<float>(frame);
+
+			for (size_t i = 0; i < updatesPerFrame; ++i)
+			{
+				engine.BufferHandler()->UpdateBuffer(entityBuffers[nextUpdate], SG::UpdateStrategy::DISCARD, updateData);
+				nextUpdate = (nextUpdate + 1) % entityBuffers.size();
+			}
+
+			auto start = std::chrono::steady_clock::now();
+			engine.Render(jobs);
+			render.push_back(std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count());
+			allocations.push_back(static_cast<double>(nrOfAllocations - allocationsBefore));
+
+			SG::SGFrameProfile profile;
+			engine.Profiler()->GetLatestFrame(profile);
+			draws.push_back(static_cast<double>(profile.counters[static_cast<size_t>(SG::SGCounter::DRAWS)]));
+			constantBufferChanges.push_back(static_cast<double>(profile.counters[static_cast<size_t>(SG::SGCounter::CONSTANT_BUFFER_CHANGES)]));
+			recording.push_back(profile.recordingTime);
+			swap.push_back(profile.swapTime);
+		}
+
+		SceneResult result;
+		result.draws = Median(draws);
+		result.recordingMicroseconds = Median(recording);
+		result.swapMicroseconds = Median(swap);
+		result.renderMicroseconds = Median(render);
+		result.allocations = Median(allocations);
+		result.constantBufferChanges = Median(constantBufferChanges);
+
+		return result;
+	}
+
+	double GetNanosecondsPerDraw(const SceneResult& result)
+	{
+		return result.draws > 0.0 ? result.recordingMicroseconds * 1000.0 / result.draws : 0.0;
+	}
+
+	void Report(const char* scene, const SceneResult& result)
+	{
+		std::printf("%-20s %10.0f %12.1f %12.1f %12.1f %14.1f %10.0f %12.0f\n", scene, result.draws, GetNanosecondsPerDraw(result),
+			result.recordingMicroseconds, result.swapMicroseconds, result.renderMicroseconds, result.allocations, result.constantBufferChanges);
+	}
+}
+
+static_assert(PROFILING_VERSION, "The benchmark reads its times and counters from the profiler, build it with _SGG_PROFILING defined");
+
+int main(int argc, char** argv)
+{
+	SceneSettings settings;
+	settings.nrOfEntities = std::max<size_t>(SG::GetArgument(argc, argv, 1, settings.nrOfEntities), 1);
+	settings.nrOfPipelines = std::clamp<size_t>(SG::GetArgument(argc, argv, 2, settings.nrOfPipelines), 1, settings.nrOfEntities);
+	settings.bindingsPerEntity = std::min(SG::GetArgument(argc, argv, 3, settings.bindingsPerEntity), MAXIMUM_BINDINGS);
+	settings.entityBoundPercent = std::min<size_t>(SG::GetArgument(argc, argv, 4, settings.entityBoundPercent), 100);
+	settings.updatePercent = std::min<size_t>(SG::GetArgument(argc, argv, 5, settings.updatePercent), 100);
+	settings.nrOfFrames = std::max<size_t>(SG::GetArgument(argc, argv, 6, settings.nrOfFrames), 1);
+	settings.nrOfGroups = std::clamp<size_t>(settings.nrOfGroups, 1, settings.nrOfEntities);
+	size_t entityBoundBindings = (settings.bindingsPerEntity * settings.entityBoundPercent + 50) / 100;
+
+	std::printf("%zu entities in %zu pipelines and %zu groups, %zu bindings per entity of which %zu entity bound, %zu%% updated per frame\n",
+		settings.nrOfEntities, settings.nrOfPipelines, settings.nrOfGroups, settings.bindingsPerEntity, entityBoundBindings, settings.updatePercent);
+	std::printf("Headless device, one context, medians over %zu frames, times in microseconds unless noted\n", settings.nrOfFrames);
+	std::printf("%-20s %10s %12s %12s %12s %14s %10s %12s\n", "scene", "draws", "ns/draw", "recording", "SwapFrame", "Render", "allocs", "CB changes");
+
+	try
+	{
+		SceneResult scene = RunScene(settings, entityBoundBindings, settings.updatePercent);
+		Report("configured", scene);
+
+		// The binding cost is what the bindings add to a draw, measured without updates since those are mapped while recording
+		SceneResult withoutUpdates = RunScene(settings, entityBoundBindings, 0);
+		SceneSettings unbound = settings;
+		unbound.bindingsPerEntity = 0;
+		SceneResult withoutBindings = RunScene(unbound, 0, 0);
+		Report("no updates", withoutUpdates);
+		Report("no bindings", withoutBindings);
+
+		if (settings.bindingsPerEntity != 0)
+		{
+			std::printf("ns per binding resolve: %.1f\n", (GetNanosecondsPerDraw(withoutUpdates) - GetNanosecondsPerDraw(withoutBindings)) /
+				static_cast<double>(settings.bindingsPerEntity));
+		}
+
+		// The common case of a vertex and pixel shader with one constant buffer per entity, recorded with the draw loop made
+		// for its shape and with the all-stages loop. That loop is one of the specialized loops, the unspecialized binding code
+		// that resolved and set every component per entity is gone and is not measured here
+		SceneSettings common = settings;
+		common.bindingsPerEntity = 1;
+		SceneResult specialized = RunScene(common, 1, 0);
+		common.specializedDrawLoops = false;
+		SceneResult generic = RunScene(common, 1, 0);
+		Report("1 CB specialized", specialized);
+		Report("1 CB every stage", generic);
+		std::printf("\"every stage\" is the specialized loop for all stages with per draw bindings, not the old per-entity Set* path\n");
+	}
+	catch (const std::exception& exception)
+	{
+		std::printf("%s\n", exception.what());
+		return 1;
+	}
+
+	return 0;
+}
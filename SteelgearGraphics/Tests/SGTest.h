@@ -0,0 +1,64 @@
+#pragma once
+
+#include <cstdio>
+#include <vector>
+
+// Every test file is an executable of its own that registers its tests with SG_TEST and runs them from main with RunTests
+namespace SG
+{
+	struct SGTestCase
+	{
+		const char* name;
+		void(*function)();
+	};
+
+	inline std::vector<SGTestCase>& GetTestCases()
+	{
+		static std::vector<SGTestCase> testCases;
+		return testCases;
+	}
+
+	inline unsigned int& GetNrOfFailedChecks()
+	{
+		static unsigned int nrOfFailedChecks = 0;
+		return nrOfFailedChecks;
+	}
+
+	struct SGTestRegistrar
+	{
+		SGTestRegistrar(const char* name, void(*function)())
+		{
+			GetTestCases().push_back({ name, function });
+		}
+	};
+
+	inline void Check(bool passed, const char* condition, const char* file, int line)
+	{
+		if (passed)
+			return;
+
+		std::printf("%s(%d): check failed: %s\n", file, line, condition);
+		++GetNrOfFailedChecks();
+	}
+
+	// Returns the exit code of the test executable, tests keep running after a failed check
+	inline int RunTests()
+	{
+		unsigned int nrOfFailedTests = 0;
+
+		for (auto& testCase : GetTestCases())
+		{
+			unsigned int failedBefore = GetNrOfFailedChecks();
+			testCase.function();
+			bool passed = GetNrOfFailedChecks() == failedBefore;
+			nrOfFailedTests += passed ? 0 : 1;
+			std::printf("%s %s\n", passed ? "passed" : "FAILED", testCase.name);
+		}
+
+		std::printf("%zu tests, %u failed\n", GetTestCases().size(), nrOfFailedTests);
+		return nrOfFailedTests == 0 ? 0 : 1;
+	}
+}
+
+#define SG_TEST(name) static void name(); static SG::SGTestRegistrar name##Registrar(#name, name); static void name()
+#define SG_CHECK(condition) SG::Check(static_cast<bool>(condition), #condition, __FILE__, __LINE__)
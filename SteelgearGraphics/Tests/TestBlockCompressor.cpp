@@ -0,0 +1,163 @@
+#include "SGTest.h"
+#include "SGBlockCompressor.h"
+
+#include <cmath>
+#include <vector>
+
+namespace
+{
+	// Smooth gradients and a wave with hard edged squares on top, without noise so the PSNR only measures the compression
+	SG::SGMipImage CreateImage(unsigned int width, unsigned int height, bool opaque)
+	{
+		SG::SGMipImage image;
+		image.width = width;
+		image.height = height;
+
+		for (unsigned int y = 0; y < height; ++y)
+		{
+			for (unsigned int x = 0; x < width; ++x)
+			{
+				float u = static_cast<float>(x) / width;
+				float v = static_cast<float>(y) / height;
+				float values[4] =
+				{
+					255.0f * u,
+					127.5f + 127.5f * std::sin(v * 9.0f + u * 3.0f),
+					(x / 16 + y / 16) % 3 == 0 ? 220.0f : 40.0f + 120.0f * v,
+					opaque ? 255.0f : 255.0f * v
+				};
+
+				for (float value : values)
+					image.texels.push_back(static_cast<unsigned char>(value + 0.5f));
+			}
+		}
+
+		return image;
+	}
+
+	/** Over the channels the format stores, BC1 is measured on colour and BC5 on red and green */
+	double GetPSNR(const SG::SGMipImage& image, const SG::SGMipImage& decoded, SG::SGBlockFormat format)
+	{
+		int nrOfChannels = format == SG::SGBlockFormat::BC1 ? 3 : (format == SG::SGBlockFormat::BC5 ? 2 : 4);
+		double squaredError = 0.0;
+		size_t nrOfValues = 0;
+
+		for (size_t i = 0; i < image.texels.size(); i += 4)
+		{
+			for (int c = 0; c < nrOfChannels; ++c)
+			{
+				double difference = static_cast<double>(image.texels[i + c]) - decoded.texels[i + c];
+				squaredError += difference * difference;
+				++nrOfValues;
+			}
+		}
+
+		double meanSquaredError = squaredError / nrOfValues;
+		return meanSquaredError > 0.0 ? 10.0 * std::log10(255.0 * 255.0 / meanSquaredError) : 99.0;
+	}
+
+	double RoundTrip(const SG::SGMipImage& image, SG::SGBlockFormat format, SG::SGCompressionQuality quality)
+	{
+		SG::SGCompressionSettings settings;
+		settings.format = format;
+		settings.quality = quality;
+		SG::SGCompressedImage compressed;
+		SG::SGMipImage decoded;
+
+		if (SG::CompressImage(image, settings, compressed, nullptr) != SG::SGResult::OK ||
+			SG::DecompressImage(compressed, decoded) != SG::SGResult::OK ||
+			decoded.width != image.width || decoded.height != image.height || decoded.texels.size() != image.texels.size())
+			return 0.0;
+
+		return GetPSNR(image, decoded, format);
+	}
+}
+
+SG_TEST(RoundTripsKeepTheirQuality)
+{
+	struct Expected
+	{
+		SG::SGBlockFormat format;
+		double minimumPSNR[3]; // Per quality from fast to high
+	};
+
+	// About a decibel under what the compressor reached when this was written, the height is not a multiple of the block size
+	const Expected expected[] =
+	{
+		{ SG::SGBlockFormat::BC1, { 34.5, 35.0, 35.0 } },
+		{ SG::SGBlockFormat::BC3, { 35.5, 36.0, 36.0 } },
+		{ SG::SGBlockFormat::BC5, { 42.5, 43.0, 43.0 } },
+		{ SG::SGBlockFormat::BC7, { 39.5, 39.5, 39.5 } }
+	};
+	const SG::SGCompressionQuality qualities[3] = { SG::SGCompressionQuality::FAST, SG::SGCompressionQuality::NORMAL, SG::SGCompressionQuality::HIGH };
+
+	for (auto& format : expected)
+	{
+		// BC1 turns texels with little alpha transparent, so it is measured on an opaque image
+		SG::SGMipImage image = CreateImage(64, 50, format.format == SG::SGBlockFormat::BC1);
+		double previous = 0.0;
+
+		for (int quality = 0; quality < 3; ++quality)
+		{
+			double psnr = RoundTrip(image, format.format, qualities[quality]);
+			SG_CHECK(psnr >= format.minimumPSNR[quality]);
+			SG_CHECK(psnr >= previous);
+			previous = psnr;
+		}
+	}
+}
+
+SG_TEST(SmallImagesArePaddedAndCropped)
+{
+	for (auto format : { SG::SGBlockFormat::BC1, SG::SGBlockFormat::BC3, SG::SGBlockFormat::BC5, SG::SGBlockFormat::BC7 })
+	{
+		SG::SGMipImage image = CreateImage(13, 7, format == SG::SGBlockFormat::BC1);
+		SG::SGCompressionSettings settings;
+		settings.format = format;
+		SG::SGCompressedImage compressed;
+		SG_CHECK(SG::CompressImage(image, settings, compressed, nullptr) == SG::SGResult::OK);
+		SG_CHECK(compressed.rowPitch == 4 * SG::GetBytesPerBlock(format) && compressed.slicePitch == 2 * compressed.rowPitch);
+		SG_CHECK(RoundTrip(image, format, SG::SGCompressionQuality::NORMAL) >= 20.0);
+	}
+}
+
+SG_TEST(TransparentTexelsSurviveBC1)
+{
+	SG::SGMipImage image = CreateImage(16, 8, true);
+
+	for (size_t i = 0; i < image.texels.size(); i += 4)
+		image.texels[i + 3] = (i / 4) % 16 < 8 ? 0 : 255;
+
+	SG::SGCompressionSettings settings;
+	settings.format = SG::SGBlockFormat::BC1;
+	SG::SGCompressedImage compressed;
+	SG::SGMipImage decoded;
+	SG_CHECK(SG::CompressImage(image, settings, compressed, nullptr) == SG::SGResult::OK);
+	SG_CHECK(SG::DecompressImage(compressed, decoded) == SG::SGResult::OK);
+
+	for (size_t i = 3; i < image.texels.size(); i += 4)
+		SG_CHECK(decoded.texels[i] == image.texels[i]);
+}
+
+SG_TEST(UnknownBlocksFailToDecode)
+{
+	// Only mode 6 is written for BC7, a block of zeros has no mode at all
+	SG::SGCompressedImage compressed;
+	compressed.format = SG::SGBlockFormat::BC7;
+	compressed.width = 4;
+	compressed.height = 4;
+	compressed.rowPitch = 16;
+	compressed.slicePitch = 16;
+	compressed.blocks.assign(16, 0);
+
+	SG::SGMipImage decoded;
+	SG_CHECK(SG::DecompressImage(compressed, decoded) == SG::SGResult::FAIL);
+
+	compressed.blocks.resize(8);
+	SG_CHECK(SG::DecompressImage(compressed, decoded) == SG::SGResult::FAIL);
+}
+
+int main()
+{
+	return SG::RunTests();
+}
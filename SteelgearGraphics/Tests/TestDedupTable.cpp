@@ -0,0 +1,179 @@
+#include "SGTest.h"
+#include "SGDedupTable.h"
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <thread>
+
+namespace
+{
+	// Stands in for a device object, every copy holds a reference like an AddRef
+	struct FakeObject
+	{
+		std::shared_ptr<int> object;
+
+		FakeObject Share()
+		{
+			return *this;
+		}
+	};
+
+	FakeObject Create(int value)
+	{
+		return { std::make_shared<int>(value) };
+	}
+}
+
+SG_TEST(HashIsFNV1a)
+{
+	SG_CHECK(SG::HashContent("", 0) == 14695981039346656037ull);
+	SG_CHECK(SG::HashContent("a", 1) == 0xaf63dc4c8601ec8cull);
+	SG_CHECK(SG::HashContent("foobar", 6) == 0x85944171f73967e8ull);
+}
+
+SG_TEST(IdenticalContentSharesOneObject)
+{
+	SG::SGDedupTable<FakeObject> table;
+	const char content[] = "rasterizer desc";
+	FakeObject first;
+	FakeObject second;
+
+	SG_CHECK(!table.Acquire(SG::SGGuid("DedupFirst"), content, sizeof(content), first));
+	table.Insert(SG::SGGuid("DedupFirst"), content, sizeof(content), Create(1), first);
+	SG_CHECK(table.Acquire(SG::SGGuid("DedupSecond"), content, sizeof(content), second));
+
+	SG_CHECK(first.object == second.object);
+	SG_CHECK(table.Size() == 1);
+}
+
+SG_TEST(DifferentContentIsNeverShared)
+{
+	SG::SGDedupTable<FakeObject> table;
+	const char content[] = "blend desc 1";
+	const char other[] = "blend desc 2";
+	FakeObject shared;
+
+	table.Insert(SG::SGGuid("DedupBlend"), content, sizeof(content), Create(1), shared);
+
+	SG_CHECK(!table.Contains(other, sizeof(other)));
+	SG_CHECK(!table.Contains(content, sizeof(content) - 1));
+	SG_CHECK(table.Contains(content, sizeof(content)));
+}
+
+SG_TEST(ObjectIsDestroyedWithItsLastGuid)
+{
+	SG::SGDedupTable<FakeObject> table;
+	const char content[] = "sampler desc";
+	std::weak_ptr<int> object;
+
+	{
+		FakeObject shared;
+		table.Insert(SG::SGGuid("DedupOwnerA"), content, sizeof(content), Create(1), shared);
+		table.Acquire(SG::SGGuid("DedupOwnerB"), content, sizeof(content), shared);
+		object = shared.object;
+	}
+
+	table.Release(SG::SGGuid("DedupOwnerA"));
+	SG_CHECK(table.Size() == 1);
+	SG_CHECK(!object.expired());
+
+	// Releasing twice does not take a reference of another guid
+	table.Release(SG::SGGuid("DedupOwnerA"));
+	SG_CHECK(table.Size() == 1);
+
+	table.Release(SG::SGGuid("DedupOwnerB"));
+	SG_CHECK(table.Size() == 0);
+	SG_CHECK(object.expired());
+}
+
+SG_TEST(RecreatedGuidDropsWhatItReferencedBefore)
+{
+	SG::SGDedupTable<FakeObject> table;
+	const char before[] = "shader 1";
+	const char after[] = "shader 2";
+	FakeObject shared;
+	SG::SGGuid guid("DedupRecreated");
+
+	table.Insert(guid, before, sizeof(before), Create(1), shared);
+	table.Insert(guid, after, sizeof(after), Create(2), shared);
+	SG_CHECK(table.Size() == 1);
+	SG_CHECK(*shared.object == 2);
+
+	// Creating it again from the same content keeps the single reference
+	table.Acquire(guid, after, sizeof(after), shared);
+	table.Release(guid);
+	SG_CHECK(table.Size() == 0);
+}
+
+SG_TEST(ObjectsWithoutGuidStayUntilTrimmed)
+{
+	SG::SGDedupTable<FakeObject> table;
+	const char content[] = "prewarmed";
+	FakeObject shared;
+
+	table.Insert(SG::SGGuid(), content, sizeof(content), Create(1), shared);
+	SG_CHECK(table.Size() == 1);
+
+	table.Trim();
+	SG_CHECK(table.Size() == 0);
+}
+
+SG_TEST(ConcurrentInsertKeepsTheFirstObject)
+{
+	SG::SGDedupTable<FakeObject> table;
+	const char content[] = "raced";
+	FakeObject first;
+	FakeObject second;
+
+	// Both callers missed in Acquire and created their own object, the second one is dropped
+	table.Insert(SG::SGGuid("DedupRaceA"), content, sizeof(content), Create(1), first);
+	table.Insert(SG::SGGuid("DedupRaceB"), content, sizeof(content), Create(2), second);
+
+	SG_CHECK(second.object == first.object);
+	SG_CHECK(*second.object == 1);
+}
+
+SG_TEST(ManyThreadsShareFourObjects)
+{
+	SG::SGDedupTable<FakeObject> table;
+	std::vector<std::thread> threads;
+	std::atomic<int> nrOfWrong = 0;
+	const int nrOfThreads = 8;
+	const int nrOfContents = 4;
+
+	for (int t = 0; t < nrOfThreads; ++t)
+	{
+		threads.emplace_back([&table, &nrOfWrong, t]()
+		{
+			for (int i = 0; i < 200; ++i)
+			{
+				int content = i % nrOfContents;
+				SG::SGGuid guid("DedupThread" + std::to_string(t) + "_" + std::to_string(i));
+				FakeObject shared;
+
+				if (!table.Acquire(guid, &content, sizeof(content), shared))
+					table.Insert(guid, &content, sizeof(content), Create(content), shared);
+
+				nrOfWrong += *shared.object == content ? 0 : 1;
+			}
+		});
+	}
+
+	for (auto& thread : threads)
+		thread.join();
+
+	SG_CHECK(nrOfWrong == 0);
+	SG_CHECK(table.Size() == nrOfContents);
+
+	for (int t = 0; t < nrOfThreads; ++t)
+		for (int i = 0; i < 200; ++i)
+			table.Release(SG::SGGuid("DedupThread" + std::to_string(t) + "_" + std::to_string(i)));
+
+	SG_CHECK(table.Size() == 0);
+}
+
+int main()
+{
+	return SG::RunTests();
+}
@@ -0,0 +1,121 @@
+#include "SGTest.h"
+#include "D3D11FormatInfo.h"
+#include "SGMipGenerator.h"
+
+#include <algorithm>
+
+namespace
+{
+	struct ExpectedLayout
+	{
+		unsigned int blockWidth;
+		unsigned int blockHeight;
+		size_t bytesPerBlock;
+	};
+
+	// Walks every subresource of a texture the way the initial data is laid out, slice by slice and mip by mip within each slice
+	size_t WalkSubresources(DXGI_FORMAT format, const ExpectedLayout& layout, unsigned int width, unsigned int height, unsigned int depth,
+		unsigned int arraySize)
+	{
+		unsigned int mipLevels = SG::GetNrOfMipLevels(width, height, depth);
+		size_t totalBytes = 0;
+
+		for (unsigned int slice = 0; slice < arraySize; ++slice)
+		{
+			for (unsigned int mip = 0; mip < mipLevels; ++mip)
+			{
+				unsigned int mipWidth = std::max(width >> mip, 1u);
+				unsigned int mipHeight = std::max(height >> mip, 1u);
+				unsigned int mipDepth = std::max(depth >> mip, 1u);
+				size_t rowPitch = (mipWidth + layout.blockWidth - 1) / layout.blockWidth * layout.bytesPerBlock;
+				unsigned int nrOfRows = (mipHeight + layout.blockHeight - 1) / layout.blockHeight;
+
+				SG::SGSubresourcePitch pitch = SG::GetSubresourcePitch(format, width, height, depth, mipLevels, slice * mipLevels + mip);
+
+				SG_CHECK(pitch.rowPitch == rowPitch);
+				SG_CHECK(pitch.nrOfRows == nrOfRows);
+				SG_CHECK(pitch.slicePitch == rowPitch * nrOfRows);
+				SG_CHECK(pitch.depth == mipDepth);
+				SG_CHECK(SG::GetSlicePitch(format, mipWidth, mipHeight) == pitch.slicePitch);
+
+				totalBytes += pitch.slicePitch * pitch.depth;
+			}
+		}
+
+		return totalBytes;
+	}
+}
+
+SG_TEST(LinearArrayWalksEveryMipOfEverySlice)
+{
+	size_t total = WalkSubresources(DXGI_FORMAT_R8G8B8A8_UNORM, { 1, 1, 4 }, 300, 200, 1, 3);
+
+	// 300x200, 150x100, 75x50, 37x25, 18x12, 9x6, 4x3, 2x1, 1x1
+	size_t perSlice = 4 * (300 * 200 + 150 * 100 + 75 * 50 + 37 * 25 + 18 * 12 + 9 * 6 + 4 * 3 + 2 * 1 + 1 * 1);
+	SG_CHECK(total == 3 * perSlice);
+}
+
+SG_TEST(BlockCompressedChainPadsTheMipTail)
+{
+	size_t total = WalkSubresources(DXGI_FORMAT_BC1_UNORM, { 4, 4, 8 }, 256, 64, 1, 1);
+
+	// Blocks per mip: 64x16, 32x8, 16x4, 8x2, 4x1, 2x1 and then single blocks for 4x1, 2x1 and 1x1
+	SG_CHECK(total == 8 * (64 * 16 + 32 * 8 + 16 * 4 + 8 * 2 + 4 * 1 + 2 * 1 + 1 + 1 + 1));
+
+	for (unsigned int mip = 6; mip < 9; ++mip)
+		SG_CHECK(SG::GetSubresourcePitch(DXGI_FORMAT_BC1_UNORM, 256, 64, 1, 9, mip).slicePitch == 8);
+}
+
+SG_TEST(CubeFacesStartAtMipZeroAgain)
+{
+	WalkSubresources(DXGI_FORMAT_BC7_UNORM_SRGB, { 4, 4, 16 }, 128, 128, 1, 6);
+
+	for (unsigned int face = 0; face < 6; ++face)
+	{
+		SG_CHECK(SG::GetSubresourcePitch(DXGI_FORMAT_BC7_UNORM_SRGB, 128, 128, 1, 8, face * 8).rowPitch == 32 * 16);
+		SG_CHECK(SG::GetSubresourcePitch(DXGI_FORMAT_BC7_UNORM_SRGB, 128, 128, 1, 8, face * 8 + 7).slicePitch == 16);
+	}
+}
+
+SG_TEST(VolumeMipsShrinkInDepth)
+{
+	size_t total = WalkSubresources(DXGI_FORMAT_R16_FLOAT, { 1, 1, 2 }, 64, 32, 16, 1);
+
+	SG_CHECK(total == 2 * (64 * 32 * 16 + 32 * 16 * 8 + 16 * 8 * 4 + 8 * 4 * 2 + 4 * 2 * 1 + 2 * 1 * 1 + 1));
+}
+
+SG_TEST(PackedFormatsWalkWholeBlocks)
+{
+	WalkSubresources(DXGI_FORMAT_R1_UNORM, { 8, 1, 1 }, 100, 10, 1, 2);
+	WalkSubresources(DXGI_FORMAT_YUY2, { 2, 1, 4 }, 33, 17, 1, 2);
+	WalkSubresources(DXGI_FORMAT_R32G32B32_FLOAT, { 1, 1, 12 }, 7, 5, 1, 4);
+}
+
+SG_TEST(PlanarFormatsCountTheChromaRows)
+{
+	SG_CHECK(SG::GetNrOfRows(DXGI_FORMAT_NV12, 720) == 1080);
+	SG_CHECK(SG::GetNrOfRows(DXGI_FORMAT_NV12, 5) == 8);
+	SG_CHECK(SG::GetSlicePitch(DXGI_FORMAT_NV12, 1280, 720) == 1280 * 1080);
+	SG_CHECK(SG::GetSlicePitch(DXGI_FORMAT_P010, 64, 32) == 128 * 48);
+	SG_CHECK(SG::GetNrOfRows(DXGI_FORMAT_NV11, 7) == 14);
+	SG_CHECK(SG::IsPlanar(DXGI_FORMAT_NV12) && !SG::IsPlanar(DXGI_FORMAT_YUY2));
+}
+
+SG_TEST(WithoutMipLevelsEverySubresourceIsMipZero)
+{
+	SG::SGSubresourcePitch pitch = SG::GetSubresourcePitch(DXGI_FORMAT_R8G8B8A8_UNORM, 64, 64, 1, 0, 5);
+
+	SG_CHECK(pitch.rowPitch == 256 && pitch.nrOfRows == 64);
+}
+
+SG_TEST(FormatsWithoutSizeGiveNoPitch)
+{
+	SG_CHECK(SG::GetRowPitch(DXGI_FORMAT_UNKNOWN, 64) == 0);
+	SG_CHECK(SG::GetRowPitch(static_cast<DXGI_FORMAT>(SG::SGFormatTable::SIZE + 10), 64) == 0);
+	SG_CHECK(!SG::IsBlockCompressed(DXGI_FORMAT_R8G8B8A8_UNORM) && SG::IsBlockCompressed(DXGI_FORMAT_BC5_SNORM));
+}
+
+int main()
+{
+	return SG::RunTests();
+}
@@ -0,0 +1,139 @@
+#include "SGTest.h"
+#include "SGHazardTracker.h"
+
+#include <algorithm>
+
+namespace
+{
+	const SG::SGBindPoint renderTarget0 = { SG::SGBindStage::OUTPUT_MERGER, SG::SGBindType::RENDER_TARGET, 0 };
+	const SG::SGBindPoint renderTarget1 = { SG::SGBindStage::OUTPUT_MERGER, SG::SGBindType::RENDER_TARGET, 1 };
+	const SG::SGBindPoint depthStencil = { SG::SGBindStage::OUTPUT_MERGER, SG::SGBindType::DEPTH_STENCIL, 0 };
+	const SG::SGBindPoint outputUAV1 = { SG::SGBindStage::OUTPUT_MERGER, SG::SGBindType::UNORDERED_ACCESS, 1 };
+	const SG::SGBindPoint pixelSRV0 = { SG::SGBindStage::PIXEL_SHADER, SG::SGBindType::SHADER_RESOURCE, 0 };
+	const SG::SGBindPoint vertexSRV1 = { SG::SGBindStage::VERTEX_SHADER, SG::SGBindType::SHADER_RESOURCE, 1 };
+	const SG::SGBindPoint computeSRV0 = { SG::SGBindStage::COMPUTE_SHADER, SG::SGBindType::SHADER_RESOURCE, 0 };
+	const SG::SGBindPoint computeUAV0 = { SG::SGBindStage::COMPUTE_SHADER, SG::SGBindType::UNORDERED_ACCESS, 0 };
+	const SG::SGBindPoint vertexBuffer0 = { SG::SGBindStage::INPUT_ASSEMBLER, SG::SGBindType::VERTEX_BUFFER, 0 };
+
+	bool Contains(const std::vector<SG::SGBindPoint>& hazards, const SG::SGBindPoint& bindPoint)
+	{
+		return std::find(hazards.begin(), hazards.end(), bindPoint) != hazards.end();
+	}
+}
+
+SG_TEST(InputsDoNotConflict)
+{
+	SG::SGHazardTracker tracker;
+	std::vector<SG::SGBindPoint> hazards;
+
+	tracker.Bind(pixelSRV0, 1, hazards);
+	tracker.Bind(vertexSRV1, 1, hazards);
+	tracker.Bind(computeSRV0, 1, hazards);
+	tracker.Bind(vertexBuffer0, 1, hazards);
+
+	SG_CHECK(hazards.empty());
+}
+
+SG_TEST(InputOfABoundOutputIsAHazard)
+{
+	SG::SGHazardTracker tracker;
+	std::vector<SG::SGBindPoint> hazards;
+
+	tracker.Bind(renderTarget0, 1, hazards);
+	tracker.Bind(pixelSRV0, 1, hazards);
+
+	SG_CHECK(hazards.size() == 1 && hazards[0] == renderTarget0);
+
+	// The render target was forgotten, so binding the input again finds nothing
+	hazards.clear();
+	tracker.Bind(vertexSRV1, 1, hazards);
+	SG_CHECK(hazards.empty());
+}
+
+SG_TEST(OutputOfBoundInputsIsAHazardForEveryInput)
+{
+	SG::SGHazardTracker tracker;
+	std::vector<SG::SGBindPoint> hazards;
+
+	tracker.Bind(pixelSRV0, 1, hazards);
+	tracker.Bind(vertexSRV1, 1, hazards);
+	tracker.Bind(vertexBuffer0, 1, hazards);
+	tracker.Bind(renderTarget0, 1, hazards);
+
+	SG_CHECK(hazards.size() == 3);
+	SG_CHECK(Contains(hazards, pixelSRV0) && Contains(hazards, vertexSRV1) && Contains(hazards, vertexBuffer0));
+}
+
+SG_TEST(OutputsOfTheSameStageDoNotConflict)
+{
+	SG::SGHazardTracker tracker;
+	std::vector<SG::SGBindPoint> hazards;
+
+	tracker.Bind(renderTarget0, 1, hazards);
+	tracker.Bind(depthStencil, 1, hazards);
+	tracker.Bind(outputUAV1, 1, hazards);
+	tracker.Bind(renderTarget1, 1, hazards);
+
+	SG_CHECK(hazards.empty());
+}
+
+SG_TEST(OutputMergerAndComputeOutputsExcludeEachOther)
+{
+	SG::SGHazardTracker tracker;
+	std::vector<SG::SGBindPoint> hazards;
+
+	tracker.Bind(renderTarget0, 1, hazards);
+	tracker.Bind(outputUAV1, 1, hazards);
+	tracker.Bind(computeUAV0, 1, hazards);
+
+	SG_CHECK(hazards.size() == 2 && Contains(hazards, renderTarget0) && Contains(hazards, outputUAV1));
+
+	hazards.clear();
+	tracker.Bind(renderTarget0, 1, hazards);
+	SG_CHECK(hazards.size() == 1 && hazards[0] == computeUAV0);
+}
+
+SG_TEST(RebindingTheSameResourceIsNoHazard)
+{
+	SG::SGHazardTracker tracker;
+	std::vector<SG::SGBindPoint> hazards;
+
+	tracker.Bind(renderTarget0, 1, hazards);
+	tracker.Bind(renderTarget0, 1, hazards);
+
+	SG_CHECK(hazards.empty());
+}
+
+SG_TEST(ReplacedAndUnboundResourcesAreForgotten)
+{
+	SG::SGHazardTracker tracker;
+	std::vector<SG::SGBindPoint> hazards;
+
+	tracker.Bind(renderTarget0, 1, hazards);
+	tracker.Bind(renderTarget0, 2, hazards);
+	tracker.Bind(pixelSRV0, 1, hazards);
+	SG_CHECK(hazards.empty());
+
+	tracker.Bind(renderTarget0, 0, hazards);
+	tracker.Bind(pixelSRV0, 2, hazards);
+	SG_CHECK(hazards.empty());
+}
+
+SG_TEST(ResetForgetsEverything)
+{
+	SG::SGHazardTracker tracker;
+	std::vector<SG::SGBindPoint> hazards;
+
+	tracker.Bind(renderTarget0, 1, hazards);
+	tracker.Bind(computeUAV0, 2, hazards);
+	tracker.Reset();
+	tracker.Bind(pixelSRV0, 1, hazards);
+	tracker.Bind(computeSRV0, 2, hazards);
+
+	SG_CHECK(hazards.empty());
+}
+
+int main()
+{
+	return SG::RunTests();
+}
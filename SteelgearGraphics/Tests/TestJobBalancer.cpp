@@ -0,0 +1,65 @@
+#include "SGTest.h"
+#include "SGJobBalancer.h"
+
+SG_TEST(SegmentsCoverEveryChunkInOrder)
+{
+	SG::SGJobBalancer balancer;
+	std::vector<double> times = { 1.0, 1.0, 8.0, 1.0, 1.0, 1.0, 1.0, 2.0 };
+	balancer.CreateSegments(times, 4);
+
+	const std::vector<SG::SGChunkSegment>& segments = balancer.GetSegments();
+	SG_CHECK(segments.size() <= 4 && !segments.empty());
+	SG_CHECK(segments.front().chunkStart == 0 && segments.back().chunkEnd == times.size());
+
+	for (size_t i = 1; i < segments.size(); ++i)
+		SG_CHECK(segments[i].chunkStart == segments[i - 1].chunkEnd && segments[i].chunkEnd > segments[i].chunkStart);
+}
+
+SG_TEST(LongestSegmentsAreTakenFirst)
+{
+	SG::SGJobBalancer balancer;
+	balancer.CreateSegments({ 2.0, 2.0, 2.0, 2.0, 8.0, 6.0 }, 4);
+	const std::vector<SG::SGChunkSegment>& segments = balancer.GetSegments();
+	std::vector<size_t> taken;
+	size_t next = 0;
+
+	while (balancer.TakeSegment(next))
+		taken.push_back(next);
+
+	// Chunks are added to a segment until it reaches a quarter of the total, equal predictions keep the chunk order
+	SG_CHECK(segments.size() == 3);
+	SG_CHECK((taken == std::vector<size_t>{ 1, 0, 2 }));
+	SG_CHECK(!balancer.TakeSegment(next));
+
+	balancer.CreateSegments({ 1.0 }, 4);
+	SG_CHECK(balancer.GetSegments().size() == 1);
+	SG_CHECK(balancer.TakeSegment(next) && next == 0);
+
+	balancer.CreateSegments({}, 4);
+	SG_CHECK(balancer.GetSegments().empty() && !balancer.TakeSegment(next));
+}
+
+SG_TEST(PredictionsFollowRecordedTimes)
+{
+	SG::SGJobBalancer balancer;
+	SG::SGGuid job("BalancedJob");
+
+	SG_CHECK(balancer.PredictTime(job, 10) == SG::SGJobBalancer::DEFAULT_TIME_PER_ENTITY * 10);
+	SG_CHECK(balancer.PredictTime(job, 0) == SG::SGJobBalancer::DEFAULT_TIME_PER_ENTITY);
+
+	balancer.AddRecordedTime(job, 10, 100.0);
+	SG_CHECK(balancer.PredictTime(job, 10) == 100.0);
+
+	// Later frames move the average part of the way
+	balancer.AddRecordedTime(job, 20, 400.0);
+	double expected = 10.0 + SG::SGJobBalancer::SMOOTHING * (20.0 - 10.0);
+	SG_CHECK(balancer.PredictTime(job, 1) == expected);
+
+	balancer.AddRecordedTime(job, 0, 1000.0);
+	SG_CHECK(balancer.PredictTime(job, 1) == expected);
+}
+
+int main()
+{
+	return SG::RunTests();
+}
@@ -0,0 +1,124 @@
+#include "SGTest.h"
+#include "SGLODSelection.h"
+
+#include <cmath>
+#include <vector>
+
+namespace
+{
+	SG::SGLODThresholds CreateThresholds()
+	{
+		SG::SGLODThresholds thresholds;
+		thresholds.screenSizes = { 0.5f, 0.25f, 0.1f };
+		thresholds.hysteresis = 0.1f;
+		return thresholds;
+	}
+}
+
+SG_TEST(FirstSelectionUsesTheThresholds)
+{
+	SG::SGLODThresholds thresholds = CreateThresholds();
+
+	// Without a current level there is nothing to keep, so the hysteresis is not applied
+	for (unsigned int unset : { 3u, ~0u })
+	{
+		SG_CHECK(SG::SelectLODLevel(thresholds, unset, 0.5f) == 0);
+		SG_CHECK(SG::SelectLODLevel(thresholds, unset, 0.49f) == 1);
+		SG_CHECK(SG::SelectLODLevel(thresholds, unset, 0.25f) == 1);
+		SG_CHECK(SG::SelectLODLevel(thresholds, unset, 0.24f) == 2);
+		SG_CHECK(SG::SelectLODLevel(thresholds, unset, 0.0f) == 2);
+	}
+
+	SG::SGLODThresholds noLevels;
+	SG_CHECK(SG::SelectLODLevel(noLevels, 0, 1.0f) == 0);
+}
+
+SG_TEST(HysteresisHoldsBothEdges)
+{
+	SG::SGLODThresholds thresholds = CreateThresholds();
+
+	// Moving to a higher detail level needs 10 percent more than the threshold above
+	SG_CHECK(SG::SelectLODLevel(thresholds, 1, 0.54f) == 1);
+	SG_CHECK(SG::SelectLODLevel(thresholds, 1, 0.56f) == 0);
+
+	// Moving to a lower detail level needs 10 percent less than the threshold of the current level
+	SG_CHECK(SG::SelectLODLevel(thresholds, 1, 0.23f) == 1);
+	SG_CHECK(SG::SelectLODLevel(thresholds, 1, 0.22f) == 2);
+	SG_CHECK(SG::SelectLODLevel(thresholds, 0, 0.46f) == 0);
+	SG_CHECK(SG::SelectLODLevel(thresholds, 0, 0.44f) == 1);
+	SG_CHECK(SG::SelectLODLevel(thresholds, 2, 0.26f) == 2);
+	SG_CHECK(SG::SelectLODLevel(thresholds, 2, 0.28f) == 1);
+
+	// Large changes move past several levels at once and stay within the levels
+	SG_CHECK(SG::SelectLODLevel(thresholds, 0, 0.01f) == 2);
+	SG_CHECK(SG::SelectLODLevel(thresholds, 2, 2.0f) == 0);
+}
+
+SG_TEST(VectorPathMatchesTheRemainder)
+{
+	SG::SGEntityBounds bounds;
+	std::vector<SG::SGGraphicalEntityID> entities;
+
+	for (unsigned int i = 0; i < 11; ++i)
+	{
+		bounds.AddEntity();
+		bounds.SetSphere(i, i * 3.0f - 10.0f, i * 0.5f, i * 7.0f + 2.0f, 0.5f + i * 0.25f);
+		entities.push_back(10 - i);
+	}
+
+	SG::SGLODCamera camera;
+	camera.position[0] = 1.0f;
+	camera.position[2] = -4.0f;
+	camera.projectionScale = 1.7f;
+
+	// Eight entities go through the vector path and three through the scalar remainder, one at a time everything is scalar
+	std::vector<float> sizes(entities.size());
+	SG::ComputeScreenSizes(bounds, camera, entities.data(), entities.size(), sizes.data());
+
+	for (size_t i = 0; i < entities.size(); ++i)
+	{
+		float size = 0.0f;
+		SG::ComputeScreenSizes(bounds, camera, &entities[i], 1, &size);
+		SG_CHECK(std::fabs(sizes[i] - size) <= size * 1e-6f);
+
+		SG::SGGraphicalEntityID entity = entities[i];
+		float deltaX = bounds.centerX[entity] - camera.position[0];
+		float deltaY = bounds.centerY[entity] - camera.position[1];
+		float deltaZ = bounds.centerZ[entity] - camera.position[2];
+		float expected = bounds.radius[entity] * camera.projectionScale / std::sqrt(deltaX * deltaX + deltaY * deltaY + deltaZ * deltaZ);
+		SG_CHECK(std::fabs(size - expected) <= expected * 1e-5f);
+	}
+}
+
+SG_TEST(EntitiesWithoutBoundsStayAtTheHighestDetail)
+{
+	SG::SGLODThresholds thresholds = CreateThresholds();
+	thresholds.screenSizes[0] = 0.9f;
+	SG::SGEntityBounds bounds;
+	std::vector<SG::SGGraphicalEntityID> entities;
+
+	for (unsigned int i = 0; i < 6; ++i)
+	{
+		bounds.AddEntity();
+		entities.push_back(i);
+	}
+
+	// A wide field of view makes the projection scale smaller than the first threshold
+	SG::SGLODCamera camera;
+	camera.position[0] = 1000.0f;
+	camera.projectionScale = 0.5f;
+
+	std::vector<float> sizes(entities.size());
+	SG::ComputeScreenSizes(bounds, camera, entities.data(), entities.size(), sizes.data());
+
+	for (float size : sizes)
+	{
+		SG_CHECK(SG::SelectLODLevel(thresholds, 3, size) == 0);
+		SG_CHECK(SG::SelectLODLevel(thresholds, 2, size) == 0);
+	}
+}
+
+int main()
+{
+	return SG::RunTests();
+}
@@ -0,0 +1,179 @@
+#include "SGTest.h"
+#include "SGLoadQueue.h"
+#include "FrameMap.h"
+
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <thread>
+
+namespace
+{
+	// Waits for a condition set by the loader threads, a correct queue never runs into the timeout
+	template<typename Condition>
+	bool WaitFor(Condition condition)
+	{
+		auto timeout = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+
+		while (!condition())
+		{
+			if (std::chrono::steady_clock::now() > timeout)
+				return false;
+
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		}
+
+		return true;
+	}
+}
+
+SG_TEST(CallbackArrivesOneFrameAfterTheLoadFinished)
+{
+	SG::SGLoadQueue queue(1, 1000);
+	SG::SGGuid guid("LoadQueueTexture");
+	SG::SGResult result = SG::SGResult::FAIL;
+	int nrOfCallbacks = 0;
+
+	queue.Enqueue(guid, 10, []() { return SG::SGResult::OK; }, [&](const SG::SGGuid& loaded, SG::SGResult loadResult)
+	{
+		SG_CHECK(loaded == guid);
+		result = loadResult;
+		++nrOfCallbacks;
+	});
+
+	SG_CHECK(queue.IsPending(guid));
+	queue.Flush();
+	queue.FinishFrame();
+	SG_CHECK(nrOfCallbacks == 0);
+	SG_CHECK(queue.IsPending(guid));
+
+	queue.FinishFrame();
+	SG_CHECK(nrOfCallbacks == 1);
+	SG_CHECK(result == SG::SGResult::OK);
+	SG_CHECK(!queue.IsPending(guid));
+	SG_CHECK(queue.GetNrOfPending() == 0);
+}
+
+SG_TEST(FailedLoadsReportTheirResult)
+{
+	SG::SGLoadQueue queue(1, 1000);
+	SG::SGResult result = SG::SGResult::OK;
+
+	queue.Enqueue(SG::SGGuid(), 10, []() { return SG::SGResult::FAIL; }, [&](const SG::SGGuid&, SG::SGResult loadResult) { result = loadResult; });
+	queue.Flush();
+	queue.FinishFrame();
+	queue.FinishFrame();
+
+	SG_CHECK(result == SG::SGResult::FAIL);
+}
+
+SG_TEST(LoadsStartWithinTheBudgetOfAFrame)
+{
+	SG::SGLoadQueue queue(4, 100);
+	std::atomic<int> nrOfStarted = 0;
+
+	for (int i = 0; i < 3; ++i)
+		queue.Enqueue(SG::SGGuid(), 60, [&]() { ++nrOfStarted; return SG::SGResult::OK; });
+
+	SG_CHECK(WaitFor([&]() { return nrOfStarted == 1; }));
+	std::this_thread::sleep_for(std::chrono::milliseconds(50));
+	SG_CHECK(nrOfStarted == 1);
+
+	queue.FinishFrame();
+	SG_CHECK(WaitFor([&]() { return nrOfStarted == 2; }));
+	std::this_thread::sleep_for(std::chrono::milliseconds(50));
+	SG_CHECK(nrOfStarted == 2);
+
+	queue.FinishFrame();
+	SG_CHECK(WaitFor([&]() { return nrOfStarted == 3; }));
+}
+
+SG_TEST(LoadLargerThanTheBudgetStartsAlone)
+{
+	SG::SGLoadQueue queue(2, 100);
+	std::atomic<int> nrOfStarted = 0;
+
+	queue.Enqueue(SG::SGGuid(), 500, [&]() { ++nrOfStarted; return SG::SGResult::OK; });
+	queue.Enqueue(SG::SGGuid(), 1, [&]() { ++nrOfStarted; return SG::SGResult::OK; });
+
+	SG_CHECK(WaitFor([&]() { return nrOfStarted == 1; }));
+	std::this_thread::sleep_for(std::chrono::milliseconds(50));
+	SG_CHECK(nrOfStarted == 1);
+
+	queue.FinishFrame();
+	SG_CHECK(WaitFor([&]() { return nrOfStarted == 2; }));
+}
+
+SG_TEST(FlushIgnoresTheBudget)
+{
+	SG::SGLoadQueue queue(2, 100);
+	std::atomic<int> nrOfFinished = 0;
+
+	for (int i = 0; i < 8; ++i)
+		queue.Enqueue(SG::SGGuid(), 60, [&]() { ++nrOfFinished; return SG::SGResult::OK; });
+
+	queue.Flush();
+	SG_CHECK(nrOfFinished == 8);
+}
+
+SG_TEST(StopDropsLoadsNotYetStarted)
+{
+	std::atomic<int> nrOfStarted = 0;
+	int nrOfCallbacks = 0;
+
+	{
+		SG::SGLoadQueue queue(1, 100);
+
+		for (int i = 0; i < 4; ++i)
+			queue.Enqueue(SG::SGGuid(), 100, [&]() { ++nrOfStarted; return SG::SGResult::OK; }, [&](const SG::SGGuid&, SG::SGResult) { ++nrOfCallbacks; });
+
+		SG_CHECK(WaitFor([&]() { return nrOfStarted == 1; }));
+		queue.Stop();
+	}
+
+	SG_CHECK(nrOfStarted == 1);
+	SG_CHECK(nrOfCallbacks == 0);
+}
+
+/** The loads create their resources in a frame map from the loader threads, like the Create*Async paths of the handlers.
+Frames are finished and swapped in the order of the render engine, so every resource is active when its callback arrives */
+SG_TEST(ResourcesAreActiveWhenTheirCallbackArrives)
+{
+	const int nrOfLoads = 400;
+	SG::FrameMap<SG::SGGuid, int> fakeDevice;
+	SG::SGLoadQueue queue(4, 64);
+	int nrOfCallbacks = 0;
+	int nrOfMissing = 0;
+
+	for (int i = 0; i < nrOfLoads; ++i)
+	{
+		SG::SGGuid guid("LoadQueueResource" + std::to_string(i));
+		queue.Enqueue(guid, 4, [&fakeDevice, guid, i]()
+		{
+			fakeDevice.AddElement(guid, i);
+			return SG::SGResult::OK;
+		}, [&](const SG::SGGuid& loaded, SG::SGResult)
+		{
+			++nrOfCallbacks;
+			nrOfMissing += fakeDevice.HasElement(loaded) ? 0 : 1;
+		});
+	}
+
+	auto timeout = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+
+	while (nrOfCallbacks < nrOfLoads && std::chrono::steady_clock::now() < timeout)
+	{
+		queue.FinishFrame();
+		fakeDevice.FinishFrame();
+		fakeDevice.UpdateActive();
+	}
+
+	SG_CHECK(nrOfCallbacks == nrOfLoads);
+	SG_CHECK(nrOfMissing == 0);
+	SG_CHECK(fakeDevice.Elements().size() == static_cast<size_t>(nrOfLoads));
+}
+
+int main()
+{
+	return SG::RunTests();
+}
@@ -0,0 +1,147 @@
+#include "SGTest.h"
+#include "SGMipGenerator.h"
+
+#include <cmath>
+#include <random>
+#include <vector>
+
+namespace
+{
+	SG::SGMipImage CreateImage(unsigned int width, unsigned int height, const std::vector<unsigned char>& texel)
+	{
+		SG::SGMipImage image;
+		image.width = width;
+		image.height = height;
+
+		for (unsigned int i = 0; i < width * height; ++i)
+			image.texels.insert(image.texels.end(), texel.begin(), texel.end());
+
+		return image;
+	}
+
+	float GetCoverage(const SG::SGMipImage& image, float reference)
+	{
+		size_t covered = 0;
+
+		for (size_t i = 3; i < image.texels.size(); i += 4)
+		{
+			if (image.texels[i] / 255.0f > reference)
+				++covered;
+		}
+
+		return static_cast<float>(covered) / (image.texels.size() / 4);
+	}
+}
+
+SG_TEST(ConstantImagesStayConstant)
+{
+	const std::vector<unsigned char> texel = { 37, 200, 90, 131 };
+	SG::SGMipImage source = CreateImage(16, 8, texel);
+	SG::SGThreadPool threadPool(2);
+
+	for (SG::SGMipFilter filter : { SG::SGMipFilter::BOX, SG::SGMipFilter::KAISER, SG::SGMipFilter::LANCZOS })
+	{
+		for (bool srgb : { false, true })
+		{
+			SG::SGMipSettings settings;
+			settings.filter = filter;
+			settings.srgb = srgb;
+			std::vector<SG::SGMipImage> mips;
+			SG_CHECK(SG::GenerateMips(source, settings, mips, &threadPool) == SG::SGResult::OK);
+			SG_CHECK(mips.size() == 5);
+
+			for (auto& mip : mips)
+				SG_CHECK(mip.texels == CreateImage(mip.width, mip.height, texel).texels);
+		}
+	}
+}
+
+SG_TEST(BlackAndWhiteAverageToGreyInLinearSpace)
+{
+	SG::SGMipImage source;
+	source.width = 2;
+	source.height = 2;
+	source.texels = { 0, 0, 0, 255, 255, 255, 255, 255, 255, 255, 255, 255, 0, 0, 0, 255 };
+
+	SG::SGMipSettings settings;
+	std::vector<SG::SGMipImage> mips;
+	SG_CHECK(SG::GenerateMips(source, settings, mips, nullptr) == SG::SGResult::OK);
+	SG_CHECK(mips.size() == 2 && mips[1].width == 1 && mips[1].height == 1);
+	SG_CHECK((mips[1].texels == std::vector<unsigned char>{ 128, 128, 128, 255 }));
+
+	// Half of the light is 188 once encoded as sRGB, averaging the encoded values would give 128
+	settings.srgb = true;
+	SG_CHECK(SG::GenerateMips(source, settings, mips, nullptr) == SG::SGResult::OK);
+	SG_CHECK((mips[1].texels == std::vector<unsigned char>{ 188, 188, 188, 255 }));
+}
+
+SG_TEST(AlphaCoverageIsKept)
+{
+	// Noisy alpha, filtering pulls it towards the average and most texels fall below the reference
+	std::mt19937 generator(47);
+	SG::SGMipImage source = CreateImage(64, 64, { 255, 255, 255, 0 });
+
+	for (size_t i = 3; i < source.texels.size(); i += 4)
+		source.texels[i] = static_cast<unsigned char>(generator() % 256);
+
+	SG::SGMipSettings settings;
+	settings.alphaReference = 0.7f;
+	std::vector<SG::SGMipImage> kept;
+	std::vector<SG::SGMipImage> filtered;
+	SG_CHECK(SG::GenerateMips(source, settings, kept, nullptr) == SG::SGResult::OK);
+
+	settings.alphaReference = -1.0f;
+	SG_CHECK(SG::GenerateMips(source, settings, filtered, nullptr) == SG::SGResult::OK);
+
+	float coverage = GetCoverage(source, 0.7f);
+	SG_CHECK(coverage > 0.25f && coverage < 0.35f);
+	SG_CHECK(GetCoverage(filtered[2], 0.7f) < coverage * 0.5f);
+
+	// Down to 8x8 there are enough texels to get close to the coverage of mip 0
+	for (size_t mip = 1; mip <= 3; ++mip)
+		SG_CHECK(std::abs(GetCoverage(kept[mip], 0.7f) - coverage) < 0.05f);
+}
+
+SG_TEST(OddAndNonSquareSizesAreHalvedPerAxis)
+{
+	SG::SGMipImage source = CreateImage(7, 5, { 10, 20, 30, 40 });
+	SG::SGMipSettings settings;
+	std::vector<SG::SGMipImage> mips;
+
+	SG_CHECK(SG::GetNrOfMipLevels(7, 5) == 3);
+	SG_CHECK(SG::GenerateMips(source, settings, mips, nullptr) == SG::SGResult::OK);
+	SG_CHECK(mips.size() == 3);
+	SG_CHECK(mips[1].width == 3 && mips[1].height == 2 && mips[1].texels.size() == 3 * 2 * 4);
+	SG_CHECK(mips[2].width == 1 && mips[2].height == 1 && mips[2].texels.size() == 4);
+	SG_CHECK((mips[2].texels == std::vector<unsigned char>{ 10, 20, 30, 40 }));
+
+	// Three texels into one weighs them equally
+	source = CreateImage(3, 1, { 0, 0, 0, 0 });
+	source.texels[8] = 255;
+	SG_CHECK(SG::GenerateMips(source, settings, mips, nullptr) == SG::SGResult::OK);
+	SG_CHECK(mips.size() == 2 && mips[1].texels[0] == 85 && mips[1].texels[1] == 0);
+}
+
+SG_TEST(TooManyMipLevelsFail)
+{
+	SG::SGMipImage source = CreateImage(8, 8, { 1, 2, 3, 4 });
+	SG::SGMipSettings settings;
+	std::vector<SG::SGMipImage> mips;
+
+	settings.mipLevels = 5;
+	SG_CHECK(SG::GenerateMips(source, settings, mips, nullptr) == SG::SGResult::FAIL);
+
+	settings.mipLevels = 4;
+	SG_CHECK(SG::GenerateMips(source, settings, mips, nullptr) == SG::SGResult::OK && mips.size() == 4);
+
+	settings.mipLevels = 2;
+	SG_CHECK(SG::GenerateMips(source, settings, mips, nullptr) == SG::SGResult::OK && mips.size() == 2);
+
+	SG::SGMipImage empty;
+	SG_CHECK(SG::GenerateMips(empty, SG::SGMipSettings(), mips, nullptr) == SG::SGResult::FAIL);
+}
+
+int main()
+{
+	return SG::RunTests();
+}
@@ -0,0 +1,120 @@
+#include "SGTest.h"
+#include "SGOcclusionCuller.h"
+
+#include <vector>
+
+namespace
+{
+	// The view projection is the identity moved by an offset, so world x and y are the normalized device coordinates and z is the depth
+	void SetView(SG::SGOcclusionCuller& culler, float offsetX, float offsetZ)
+	{
+		float viewProjection[16] = { 1.0f, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, offsetX, 0.0f, offsetZ, 1.0f };
+		culler.SetViewProjection(viewProjection);
+	}
+
+	/** A quad of two triangles facing the camera, leftZ and rightZ are the depths of its left and right edge */
+	void AddWall(SG::SGOcclusionCuller& culler, const SG::SGGuid& guid, float minX, float maxX, float leftZ, float rightZ)
+	{
+		std::vector<float> positions = { minX, -0.5f, leftZ, maxX, -0.5f, rightZ, maxX, 0.5f, rightZ, minX, 0.5f, leftZ };
+		culler.AddOccluder(guid, positions, { 0, 1, 2, 0, 2, 3 });
+	}
+
+	bool IsVisible(const SG::SGOcclusionCuller& culler, float x, float z)
+	{
+		SG::SGEntityBounds bounds;
+		bounds.AddEntity();
+		bounds.SetSphere(0, x, 0.0f, z, 0.05f);
+
+		std::vector<SG::SGGraphicalEntityID> visibleEntities;
+		culler.CullEntities(bounds, { 0 }, visibleEntities);
+		return visibleEntities.size() == 1;
+	}
+
+	SG::SGOccluderSettings CreateSettings(size_t maxTrianglesPerFrame)
+	{
+		SG::SGOccluderSettings settings;
+		settings.width = 64;
+		settings.height = 64;
+		settings.maxTrianglesPerFrame = maxTrianglesPerFrame;
+		return settings;
+	}
+}
+
+SG_TEST(EntitiesBehindAWallAreCulled)
+{
+	SG::SGOcclusionCuller culler(CreateSettings(0));
+	AddWall(culler, SG::SGGuid("CullingWall"), -0.5f, 0.5f, 0.5f, 0.5f);
+	SetView(culler, 0.0f, 0.0f);
+	culler.RenderOccluders(nullptr);
+
+	SG_CHECK(!IsVisible(culler, 0.0f, 0.8f));
+	SG_CHECK(IsVisible(culler, 0.0f, 0.2f));
+	SG_CHECK(IsVisible(culler, 0.8f, 0.8f));
+
+	// Entities without bounds are never culled
+	SG::SGEntityBounds bounds;
+	bounds.AddEntity();
+	std::vector<SG::SGGraphicalEntityID> visibleEntities;
+	culler.CullEntities(bounds, { 0 }, visibleEntities);
+	SG_CHECK(visibleEntities.size() == 1);
+}
+
+SG_TEST(RemovedOccludersLeaveNoHistory)
+{
+	SG::SGOcclusionCuller culler(CreateSettings(0));
+	SG::SGGuid wall("RemovedWall");
+	AddWall(culler, wall, -0.5f, 0.5f, 0.5f, 0.5f);
+	SetView(culler, 0.0f, 0.0f);
+	culler.RenderOccluders(nullptr);
+	SG_CHECK(!IsVisible(culler, 0.0f, 0.8f));
+
+	culler.RemoveOccluder(wall);
+	culler.RenderOccluders(nullptr);
+	SG_CHECK(IsVisible(culler, 0.0f, 0.8f));
+}
+
+SG_TEST(SkippedOccludersAreReprojected)
+{
+	// Only one wall fits in the budget, the first frame renders the left one and the second frame the right one
+	SG::SGOcclusionCuller culler(CreateSettings(2));
+	AddWall(culler, SG::SGGuid("ReprojectedLeftWall"), -0.8f, -0.4f, 0.5f, 0.5f);
+	AddWall(culler, SG::SGGuid("ReprojectedRightWall"), 0.4f, 0.8f, 0.5f, 0.5f);
+	SetView(culler, 0.0f, 0.0f);
+	culler.RenderOccluders(nullptr);
+	SG_CHECK(!IsVisible(culler, -0.6f, 0.8f));
+	SG_CHECK(IsVisible(culler, 0.6f, 0.8f));
+
+	// The camera moves, the left wall has to follow it to the right on the screen
+	SetView(culler, 0.4f, 0.0f);
+	culler.RenderOccluders(nullptr);
+	SG_CHECK(!IsVisible(culler, -0.6f, 0.8f));
+	SG_CHECK(!IsVisible(culler, 0.6f, 0.8f));
+	SG_CHECK(IsVisible(culler, -1.0f, 0.8f));
+}
+
+SG_TEST(ReprojectedDepthExpires)
+{
+	// The left edge of the left wall is close to the near plane, once the camera moves forward its triangles are skipped
+	SG::SGOcclusionCuller culler(CreateSettings(2));
+	AddWall(culler, SG::SGGuid("ExpiringLeftWall"), -0.8f, -0.2f, 0.05f, 0.5f);
+	AddWall(culler, SG::SGGuid("ExpiringRightWall"), 0.4f, 0.8f, 0.5f, 0.5f);
+	SetView(culler, 0.0f, 0.0f);
+	culler.RenderOccluders(nullptr);
+	culler.RenderOccluders(nullptr);
+	SG_CHECK(!IsVisible(culler, -0.3f, 0.8f));
+
+	// It is the turn of the left wall, but only its reprojected depth is left
+	SetView(culler, 0.0f, -0.1f);
+	culler.RenderOccluders(nullptr);
+	SG_CHECK(!IsVisible(culler, -0.3f, 0.8f));
+
+	// Every occluder had a frame to be rendered since, the depth of the left wall is dropped
+	culler.RenderOccluders(nullptr);
+	SG_CHECK(IsVisible(culler, -0.3f, 0.8f));
+	SG_CHECK(!IsVisible(culler, 0.6f, 0.8f));
+}
+
+int main()
+{
+	return SG::RunTests();
+}
@@ -0,0 +1,295 @@
+#include "SGTest.h"
+#include "SGReadbackRing.h"
+
+#include <vector>
+
+namespace
+{
+	unsigned char Texel(const SG::SGReadbackSource& source, size_t x, size_t y, size_t z)
+	{
+		return static_cast<unsigned char>(source.guid.GetID() * 31 + source.offset + z * 17 + y * 5 + x);
+	}
+
+	/** Copies are finished when the test signals them, like a GPU that is a number of frames behind.
+	Mapped memory has padding after every row and slice */
+	class FakeReadbackDevice : public SG::SGReadbackDevice
+	{
+	public:
+		std::vector<SG::SGReadbackSource> slotSources;
+		std::vector<bool> signaled;
+		std::vector<std::vector<unsigned char>> mappedMemory;
+		SG::SGGuid missing = SG::SGGuid("ReadbackMissing");
+		bool failMaps = false;
+		int nrOfCopies = 0;
+		int nrOfMapped = 0;
+		int nrOfUnmapped = 0;
+
+		FakeReadbackDevice(size_t nrOfSlots) : slotSources(nrOfSlots), signaled(nrOfSlots, false), mappedMemory(nrOfSlots)
+		{
+		}
+
+		void Signal()
+		{
+			signaled.assign(signaled.size(), true);
+		}
+
+		bool CopyToSlot(size_t slot, const SG::SGReadbackSource& source) override
+		{
+			if (source.guid == missing)
+				return false;
+
+			slotSources[slot] = source;
+			signaled[slot] = false;
+			++nrOfCopies;
+			return true;
+		}
+
+		bool IsSlotReady(size_t slot) override
+		{
+			return signaled[slot];
+		}
+
+		bool MapSlot(size_t slot, SG::SGReadbackData& data) override
+		{
+			if (failMaps)
+				return false;
+
+			const SG::SGReadbackSource& source = slotSources[slot];
+			data.rowSize = source.texture ? (source.right - source.left) * 4 : source.size;
+			data.nrOfRows = source.texture ? source.bottom - source.top : 1;
+			data.depth = source.texture ? source.back - source.front : 1;
+			data.rowPitch = data.rowSize + 12;
+			data.depthPitch = data.rowPitch * data.nrOfRows + 7;
+
+			std::vector<unsigned char>& memory = mappedMemory[slot];
+			memory.assign(data.depthPitch * data.depth, 0xCD);
+
+			for (size_t z = 0; z < data.depth; ++z)
+				for (size_t y = 0; y < data.nrOfRows; ++y)
+					for (size_t x = 0; x < data.rowSize; ++x)
+						memory[z * data.depthPitch + y * data.rowPitch + x] = Texel(source, x, y, z);
+
+			data.bytes = memory.data();
+			++nrOfMapped;
+			return true;
+		}
+
+		void UnmapSlot(size_t) override
+		{
+			++nrOfUnmapped;
+		}
+	};
+
+	SG::SGReadbackSource Buffer(const SG::SGGuid& guid, size_t offset, size_t size)
+	{
+		SG::SGReadbackSource source;
+		source.guid = guid;
+		source.offset = offset;
+		source.size = size;
+		return source;
+	}
+
+	SG::SGReadbackSource TextureRegion(const SG::SGGuid& guid, unsigned int right, unsigned int bottom, unsigned int back)
+	{
+		SG::SGReadbackSource source;
+		source.guid = guid;
+		source.texture = true;
+		source.wholeSubresource = false;
+		source.right = right;
+		source.bottom = bottom;
+		source.back = back;
+		return source;
+	}
+
+	bool IsTightlyPacked(const SG::SGReadbackSource& source, const std::vector<unsigned char>& data, const SG::SGReadbackData& layout)
+	{
+		if (layout.rowPitch != layout.rowSize || layout.depthPitch != layout.rowSize * layout.nrOfRows ||
+			data.size() != layout.depthPitch * layout.depth || layout.bytes != data.data())
+			return false;
+
+		size_t i = 0;
+
+		for (size_t z = 0; z < layout.depth; ++z)
+			for (size_t y = 0; y < layout.nrOfRows; ++y)
+				for (size_t x = 0; x < layout.rowSize; ++x)
+					if (data[i++] != Texel(source, x, y, z))
+						return false;
+
+		return true;
+	}
+}
+
+SG_TEST(DataArrivesOnlyAfterTheFencePassed)
+{
+	FakeReadbackDevice device(3);
+	SG::SGReadbackRing ring(&device, 3);
+	SG::SGReadbackSource source = TextureRegion(SG::SGGuid("ReadbackTexture"), 5, 3, 2);
+	std::vector<unsigned char> data;
+	SG::SGReadbackData layout;
+
+	SG::SGReadbackID id = ring.Request(source);
+	SG_CHECK(ring.GetStatus(id) == SG::SGReadbackStatus::QUEUED);
+
+	ring.Update();
+	SG_CHECK(ring.GetStatus(id) == SG::SGReadbackStatus::IN_FLIGHT);
+	ring.Update();
+	SG_CHECK(ring.GetStatus(id) == SG::SGReadbackStatus::IN_FLIGHT);
+	SG_CHECK(!ring.TakeData(id, data, layout));
+	SG_CHECK(device.nrOfMapped == 0);
+
+	device.Signal();
+	ring.Update();
+	SG_CHECK(ring.GetStatus(id) == SG::SGReadbackStatus::READY);
+	SG_CHECK(device.nrOfMapped == 1 && device.nrOfUnmapped == 1);
+
+	SG_CHECK(ring.TakeData(id, data, layout));
+	SG_CHECK(IsTightlyPacked(source, data, layout));
+	SG_CHECK(ring.GetStatus(id) == SG::SGReadbackStatus::UNKNOWN);
+	SG_CHECK(!ring.TakeData(id, data, layout));
+}
+
+SG_TEST(CallbacksGetTheMappedData)
+{
+	FakeReadbackDevice device(2);
+	SG::SGReadbackRing ring(&device, 2);
+	SG::SGReadbackSource source = Buffer(SG::SGGuid("ReadbackBuffer"), 16, 40);
+	SG::SGReadbackID delivered = 0;
+	bool correct = false;
+
+	SG::SGReadbackID id = ring.Request(source, [&](SG::SGReadbackID readback, const SG::SGReadbackData& data)
+	{
+		delivered = readback;
+		correct = data.bytes != nullptr && data.rowSize == 40 && data.bytes[39] == Texel(source, 39, 0, 0);
+	});
+
+	ring.Update();
+	device.Signal();
+	ring.Update();
+
+	SG_CHECK(delivered == id);
+	SG_CHECK(correct);
+	SG_CHECK(ring.GetStatus(id) == SG::SGReadbackStatus::UNKNOWN);
+}
+
+SG_TEST(RequestsWaitInOrderWhileEverySlotIsInFlight)
+{
+	FakeReadbackDevice device(2);
+	SG::SGReadbackRing ring(&device, 2);
+	std::vector<SG::SGReadbackID> delivered;
+	std::vector<SG::SGReadbackID> ids;
+
+	for (size_t i = 0; i < 5; ++i)
+		ids.push_back(ring.Request(Buffer(SG::SGGuid("ReadbackQueued"), i, 4), [&](SG::SGReadbackID id, const SG::SGReadbackData&)
+		{
+			delivered.push_back(id);
+		}));
+
+	ring.Update();
+	SG_CHECK(device.nrOfCopies == 2);
+	SG_CHECK(ring.GetStatus(ids[1]) == SG::SGReadbackStatus::IN_FLIGHT);
+	SG_CHECK(ring.GetStatus(ids[2]) == SG::SGReadbackStatus::QUEUED);
+
+	for (int frame = 0; frame < 3; ++frame)
+	{
+		device.Signal();
+		ring.Update();
+	}
+
+	SG_CHECK(delivered == ids);
+	SG_CHECK(device.nrOfCopies == 5);
+}
+
+SG_TEST(FencesArePolledInCopyOrder)
+{
+	FakeReadbackDevice device(2);
+	SG::SGReadbackRing ring(&device, 2);
+	SG::SGReadbackID first = ring.Request(Buffer(SG::SGGuid("ReadbackFirst"), 0, 4));
+	SG::SGReadbackID second = ring.Request(Buffer(SG::SGGuid("ReadbackSecond"), 0, 4));
+
+	ring.Update();
+
+	// The first slot is used first, a later fence passing alone delivers nothing
+	device.signaled[1] = true;
+	ring.Update();
+	SG_CHECK(ring.GetStatus(first) == SG::SGReadbackStatus::IN_FLIGHT);
+	SG_CHECK(ring.GetStatus(second) == SG::SGReadbackStatus::IN_FLIGHT);
+
+	device.signaled[0] = true;
+	ring.Update();
+	SG_CHECK(ring.GetStatus(first) == SG::SGReadbackStatus::READY);
+	SG_CHECK(ring.GetStatus(second) == SG::SGReadbackStatus::READY);
+}
+
+SG_TEST(FailedCopiesAndMapsAreReportedOnce)
+{
+	FakeReadbackDevice device(2);
+	SG::SGReadbackRing ring(&device, 2);
+	std::vector<unsigned char> data;
+	SG::SGReadbackData layout;
+
+	SG::SGReadbackID missing = ring.Request(Buffer(device.missing, 0, 4));
+	ring.Update();
+	SG_CHECK(ring.GetStatus(missing) == SG::SGReadbackStatus::FAILED);
+	SG_CHECK(!ring.TakeData(missing, data, layout));
+	SG_CHECK(ring.GetStatus(missing) == SG::SGReadbackStatus::UNKNOWN);
+
+	device.failMaps = true;
+	SG::SGReadbackID unmappable = ring.Request(Buffer(SG::SGGuid("ReadbackUnmappable"), 0, 4));
+	ring.Update();
+	device.Signal();
+	ring.Update();
+	SG_CHECK(ring.GetStatus(unmappable) == SG::SGReadbackStatus::FAILED);
+	SG_CHECK(device.nrOfUnmapped == 0);
+}
+
+SG_TEST(FailedCallbackCanRequestAgain)
+{
+	FakeReadbackDevice device(1);
+	SG::SGReadbackRing ring(&device, 1);
+	SG::SGReadbackID retried = 0;
+	bool failedData = false;
+
+	ring.Request(Buffer(device.missing, 0, 4), [&](SG::SGReadbackID, const SG::SGReadbackData& data)
+	{
+		failedData = data.bytes == nullptr;
+		retried = ring.Request(Buffer(SG::SGGuid("ReadbackRetried"), 0, 4));
+	});
+
+	ring.Update();
+	SG_CHECK(failedData);
+	SG_CHECK(ring.GetStatus(retried) == SG::SGReadbackStatus::IN_FLIGHT);
+
+	device.Signal();
+	ring.Update();
+	SG_CHECK(ring.GetStatus(retried) == SG::SGReadbackStatus::READY);
+}
+
+SG_TEST(SlotsAreReused)
+{
+	FakeReadbackDevice device(3);
+	SG::SGReadbackRing ring(&device, 3);
+	int nrOfDelivered = 0;
+
+	for (int frame = 0; frame < 100; ++frame)
+	{
+		ring.Request(TextureRegion(SG::SGGuid("ReadbackReused"), 2, 2, 1), [&](SG::SGReadbackID, const SG::SGReadbackData&) { ++nrOfDelivered; });
+		ring.Update();
+
+		// The GPU is two frames behind
+		if (frame % 2 == 1)
+			device.Signal();
+	}
+
+	device.Signal();
+	ring.Update();
+	device.Signal();
+	ring.Update();
+
+	SG_CHECK(nrOfDelivered == 100);
+	SG_CHECK(device.nrOfMapped == device.nrOfUnmapped);
+}
+
+int main()
+{
+	return SG::RunTests();
+}
@@ -0,0 +1,252 @@
+#include "SGTest.h"
+#include "SGRegionStaging.h"
+
+#include <vector>
+
+namespace
+{
+	const unsigned int WIDTH = 16;
+	const unsigned int HEIGHT = 16;
+	const unsigned int DEPTH = 4;
+	const unsigned int NR_OF_SUBRESOURCES = 2;
+
+	// One byte per texel, so a row of a region is as many bytes as the region is wide
+	struct FakeTexture
+	{
+		std::vector<unsigned char> texels = std::vector<unsigned char>(NR_OF_SUBRESOURCES * WIDTH * HEIGHT * DEPTH, 0);
+
+		unsigned char& At(unsigned int subresource, unsigned int x, unsigned int y, unsigned int z)
+		{
+			return texels[((subresource * DEPTH + z) * HEIGHT + y) * WIDTH + x];
+		}
+	};
+
+	// Source data with padded rows and slices, like mapped memory
+	struct Source
+	{
+		size_t rowPitch;
+		size_t depthPitch;
+		std::vector<unsigned char> bytes;
+	};
+
+	Source CreateSource(const SG::SGUpdateRegion& region, unsigned char seed)
+	{
+		Source source;
+		source.rowPitch = region.right - region.left + 3;
+		source.depthPitch = source.rowPitch * (region.bottom - region.top) + 5;
+		source.bytes.resize(source.depthPitch * (region.back - region.front));
+
+		for (size_t i = 0; i < source.bytes.size(); ++i)
+			source.bytes[i] = static_cast<unsigned char>(seed + i * 7);
+
+		return source;
+	}
+
+	void Stage(SG::SGRegionStaging& staging, FakeTexture& reference, const SG::SGUpdateRegion& region, unsigned char seed)
+	{
+		Source source = CreateSource(region, seed);
+		staging.AddRegion(region, source.bytes.data(), region.right - region.left, region.bottom - region.top, source.rowPitch, source.depthPitch);
+
+		for (unsigned int z = region.front; z < region.back; ++z)
+			for (unsigned int y = region.top; y < region.bottom; ++y)
+				for (unsigned int x = region.left; x < region.right; ++x)
+					reference.At(region.subresource, x, y, z) = source.bytes[(z - region.front) * source.depthPitch +
+						(y - region.top) * source.rowPitch + (x - region.left)];
+	}
+
+	// Copies the staged regions into the texture in the order they are handed out, like the uploads of the texture handler
+	void Upload(SG::SGRegionStaging& staging, FakeTexture& texture, size_t maxRegions = static_cast<size_t>(-1))
+	{
+		for (size_t i = 0; i < maxRegions && staging.Pending(); ++i)
+		{
+			const SG::SGStagedRegion& staged = staging.NextRegion();
+			const unsigned char* data = staging.GetData(staged);
+			const SG::SGUpdateRegion& region = staged.region;
+
+			for (unsigned int z = region.front; z < region.back; ++z)
+			{
+				for (size_t y = 0; y < staged.nrOfRows; ++y)
+				{
+					for (size_t x = 0; x < staged.rowSize; ++x)
+						texture.At(region.subresource, region.left + static_cast<unsigned int>(x), region.top + static_cast<unsigned int>(y), z) = *data++;
+				}
+			}
+
+			staging.PopRegion();
+		}
+	}
+
+	size_t CountPending(const SG::SGRegionStaging& staging)
+	{
+		SG::SGRegionStaging copy = staging;
+		size_t count = 0;
+
+		while (copy.Pending())
+		{
+			copy.PopRegion();
+			++count;
+		}
+
+		return count;
+	}
+
+	SG::SGUpdateRegion Region(unsigned int subresource, unsigned int left, unsigned int top, unsigned int front,
+		unsigned int right, unsigned int bottom, unsigned int back)
+	{
+		return { subresource, left, top, front, right, bottom, back };
+	}
+}
+
+SG_TEST(NeighboursAlongEveryAxisMergeIntoOneRegion)
+{
+	for (int axis = 0; axis < 3; ++axis)
+	{
+		SG::SGRegionStaging staging;
+		FakeTexture reference;
+		FakeTexture texture;
+
+		SG::SGUpdateRegion first = Region(0, 2, 2, 1, 6, 6, 2);
+		SG::SGUpdateRegion second = first;
+		(axis == 0 ? second.left : axis == 1 ? second.top : second.front) = (axis == 0 ? first.right : axis == 1 ? first.bottom : first.back);
+		(axis == 0 ? second.right : axis == 1 ? second.bottom : second.back) += axis == 2 ? 2 : 5;
+
+		Stage(staging, reference, first, 1);
+		Stage(staging, reference, second, 2);
+
+		SG_CHECK(CountPending(staging) == 1);
+		Upload(staging, texture);
+		SG_CHECK(texture.texels == reference.texels);
+	}
+}
+
+SG_TEST(ChainOfRowsMergesWithoutGaps)
+{
+	SG::SGRegionStaging staging;
+	FakeTexture reference;
+	FakeTexture texture;
+
+	for (unsigned int y = 0; y < HEIGHT; ++y)
+		Stage(staging, reference, Region(1, 0, y, 0, WIDTH, y + 1, 1), static_cast<unsigned char>(y));
+
+	SG_CHECK(CountPending(staging) == 1);
+	SG_CHECK(staging.NextRegion().GetSize() == WIDTH * HEIGHT);
+	Upload(staging, texture);
+	SG_CHECK(texture.texels == reference.texels);
+}
+
+SG_TEST(CoveredRegionsAreDropped)
+{
+	SG::SGRegionStaging staging;
+	FakeTexture reference;
+	FakeTexture texture;
+
+	Stage(staging, reference, Region(0, 1, 1, 0, 3, 3, 1), 1);
+	Stage(staging, reference, Region(0, 8, 8, 2, 9, 9, 3), 2);
+	Stage(staging, reference, Region(0, 0, 0, 0, 10, 10, 4), 3);
+
+	SG_CHECK(CountPending(staging) == 1);
+	Upload(staging, texture);
+	SG_CHECK(texture.texels == reference.texels);
+}
+
+SG_TEST(OverwrittenRegionsAreNotMovedPastTheirOverwrite)
+{
+	SG::SGRegionStaging staging;
+	FakeTexture reference;
+	FakeTexture texture;
+
+	// Merging the first and last would upload the first after the overlapping second
+	Stage(staging, reference, Region(0, 0, 0, 0, 4, 4, 1), 1);
+	Stage(staging, reference, Region(0, 2, 2, 0, 6, 6, 1), 2);
+	Stage(staging, reference, Region(0, 4, 0, 0, 8, 4, 1), 3);
+
+	SG_CHECK(CountPending(staging) == 3);
+	Upload(staging, texture);
+	SG_CHECK(texture.texels == reference.texels);
+}
+
+SG_TEST(SubresourcesNeverMerge)
+{
+	SG::SGRegionStaging staging;
+	FakeTexture reference;
+	FakeTexture texture;
+
+	Stage(staging, reference, Region(0, 0, 0, 0, 4, 4, 1), 1);
+	Stage(staging, reference, Region(1, 4, 0, 0, 8, 4, 1), 2);
+
+	SG_CHECK(CountPending(staging) == 2);
+}
+
+SG_TEST(TakePendingKeepsTheOlderRegionsFirst)
+{
+	SG::SGRegionStaging older;
+	SG::SGRegionStaging newer;
+	FakeTexture reference;
+	FakeTexture texture;
+
+	Stage(older, reference, Region(0, 0, 0, 0, 8, 8, 1), 1);
+	Stage(older, reference, Region(1, 0, 0, 0, 8, 8, 1), 2);
+	Upload(older, texture, 1);
+
+	Stage(newer, reference, Region(1, 4, 4, 0, 12, 12, 1), 3);
+	newer.TakePending(older);
+
+	SG_CHECK(older.Empty());
+	SG_CHECK(CountPending(newer) == 2);
+	SG_CHECK(newer.NextRegion().region.subresource == 1 && newer.NextRegion().region.left == 0);
+	Upload(newer, texture);
+	SG_CHECK(texture.texels == reference.texels);
+}
+
+SG_TEST(RandomUpdatesMatchUpdatingDirectly)
+{
+	unsigned int seed = 777;
+	auto next = [&seed](unsigned int range)
+	{
+		seed = seed * 1664525u + 1013904223u;
+		return (seed >> 8) % range;
+	};
+
+	for (int round = 0; round < 200; ++round)
+	{
+		SG::SGRegionStaging staging[2];
+		FakeTexture reference;
+		FakeTexture texture;
+		size_t current = 0;
+
+		for (int update = 0; update < 40; ++update)
+		{
+			// Neighbouring regions on a coarse grid, so that merges happen often
+			unsigned int left = next(4) * 4;
+			unsigned int top = next(4) * 4;
+			unsigned int front = next(DEPTH);
+			SG::SGUpdateRegion region = Region(next(NR_OF_SUBRESOURCES), left, top, front,
+				left + 4 * (1 + next((WIDTH - left) / 4)), top + 4 * (1 + next((HEIGHT - top) / 4)), front + 1 + next(DEPTH - front));
+
+			Stage(staging[current], reference, region, static_cast<unsigned char>(update));
+
+			// Sometimes part of the regions are uploaded, or the frame is swapped and the next staging takes what is left
+			switch (next(4))
+			{
+			case 0:
+				Upload(staging[current], texture, next(3));
+				break;
+			case 1:
+				staging[1 - current].TakePending(staging[current]);
+				current = 1 - current;
+				break;
+			default:
+				break;
+			}
+		}
+
+		Upload(staging[current], texture);
+		SG_CHECK(!staging[1 - current].Pending());
+		SG_CHECK(texture.texels == reference.texels);
+	}
+}
+
+int main()
+{
+	return SG::RunTests();
+}
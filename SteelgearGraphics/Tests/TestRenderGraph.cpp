@@ -0,0 +1,106 @@
+#include "SGTest.h"
+#include "SGRenderGraph.h"
+
+namespace
+{
+	SG::SGRenderGraphNode Node(const std::vector<size_t>& reads, const std::vector<size_t>& writes)
+	{
+		SG::SGRenderGraphNode node;
+		node.reads = reads;
+		node.writes = writes;
+		return node;
+	}
+
+	// Clears and draws into two targets, the second reads the first, one draw nobody reads and a final pass into the output
+	std::vector<SG::SGRenderGraphNode> CreateFrame()
+	{
+		return { Node({}, { 1 }), Node({ 10 }, { 1 }), Node({}, { 2 }), Node({ 1 }, { 2 }), Node({ 1 }, { 3 }), Node({ 2 }, { 99 }) };
+	}
+}
+
+SG_TEST(CullsNodesThatDoNotReachAnOutput)
+{
+	SG::SGCompiledRenderGraph graph = SG::CompileRenderGraph(CreateFrame(), { 99 });
+
+	SG_CHECK(graph.nrOfCulled == 1);
+	SG_CHECK(graph.order == std::vector<size_t>({ 0, 2, 1, 3, 5 }));
+	SG_CHECK(graph.levels == std::vector<size_t>({ 0, 0, 1, 2, 3 }));
+}
+
+SG_TEST(KeepsEveryNodeWithoutOutputs)
+{
+	SG::SGCompiledRenderGraph graph = SG::CompileRenderGraph(CreateFrame(), {});
+
+	SG_CHECK(graph.nrOfCulled == 0);
+	SG_CHECK(graph.order == std::vector<size_t>({ 0, 2, 1, 3, 4, 5 }));
+}
+
+SG_TEST(WriteAfterReadOrdersWithoutKeepingAlive)
+{
+	std::vector<SG::SGRenderGraphNode> nodes = { Node({ 1 }, { 5 }), Node({}, { 1 }) };
+
+	SG::SGCompiledRenderGraph onlyWriter = SG::CompileRenderGraph(nodes, { 1 });
+	SG_CHECK(onlyWriter.order == std::vector<size_t>({ 1 }));
+	SG_CHECK(onlyWriter.nrOfCulled == 1);
+
+	SG::SGCompiledRenderGraph both = SG::CompileRenderGraph(nodes, { 1, 5 });
+	SG_CHECK(both.order == std::vector<size_t>({ 0, 1 }));
+	SG_CHECK(both.levels == std::vector<size_t>({ 0, 1 }));
+}
+
+SG_TEST(SideEffectsAndBarriersAreNeverCulled)
+{
+	std::vector<SG::SGRenderGraphNode> nodes = { Node({}, { 1 }), Node({}, { 2 }), Node({}, { 3 }) };
+	nodes[0].hasSideEffects = true;
+	nodes[1].barrier = true;
+
+	SG::SGCompiledRenderGraph graph = SG::CompileRenderGraph(nodes, { 3 });
+
+	SG_CHECK(graph.nrOfCulled == 0);
+	SG_CHECK(graph.order == std::vector<size_t>({ 0, 1, 2 }));
+	SG_CHECK(graph.levels == std::vector<size_t>({ 0, 1, 2 }));
+}
+
+SG_TEST(BarrierOrdersAgainstIndependentNodes)
+{
+	std::vector<SG::SGRenderGraphNode> nodes = CreateFrame();
+	nodes[2].barrier = true;
+
+	SG::SGCompiledRenderGraph graph = SG::CompileRenderGraph(nodes, { 99 });
+
+	// Nothing before the barrier can move after it and nothing after it can move before it
+	size_t barrierPosition = 0;
+
+	for (size_t i = 0; i < graph.order.size(); ++i)
+		if (graph.order[i] == 2)
+			barrierPosition = i;
+
+	for (size_t i = 0; i < graph.order.size(); ++i)
+		SG_CHECK((graph.order[i] < 2) == (i < barrierPosition) || graph.order[i] == 2);
+}
+
+SG_TEST(UnknownReadsFollowEarlierWrites)
+{
+	std::vector<SG::SGRenderGraphNode> nodes = { Node({}, { 1 }), Node({}, {}), Node({}, { 1 }) };
+	nodes[1].readsUnknown = true;
+
+	SG::SGCompiledRenderGraph graph = SG::CompileRenderGraph(nodes, {});
+
+	SG_CHECK(graph.order == std::vector<size_t>({ 0, 1, 2 }));
+	SG_CHECK(graph.levels == std::vector<size_t>({ 0, 1, 2 }));
+}
+
+SG_TEST(IndependentNodesShareALevel)
+{
+	std::vector<SG::SGRenderGraphNode> nodes = { Node({}, { 1 }), Node({ 1 }, { 3 }), Node({}, { 2 }), Node({ 2 }, { 4 }) };
+
+	SG::SGCompiledRenderGraph graph = SG::CompileRenderGraph(nodes, { 3, 4 });
+
+	SG_CHECK(graph.order == std::vector<size_t>({ 0, 2, 1, 3 }));
+	SG_CHECK(graph.levels == std::vector<size_t>({ 0, 0, 1, 1 }));
+}
+
+int main()
+{
+	return SG::RunTests();
+}
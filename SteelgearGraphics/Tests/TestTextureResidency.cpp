@@ -0,0 +1,183 @@
+#include "SGTest.h"
+#include "SGTextureResidency.h"
+
+#include <limits>
+
+namespace
+{
+	const std::vector<size_t> mipSizes = { 64, 16, 4, 1 };
+
+	unsigned int Update(SG::SGTextureResidency& residency)
+	{
+		std::vector<SG::SGResidencyChange> changes;
+		residency.Update(changes);
+		return static_cast<unsigned int>(changes.size());
+	}
+}
+
+SG_TEST(MinimumMipsAreResidentFromTheStart)
+{
+	SG::SGTextureResidency residency(0);
+	SG::SGGuid guid("ResidencyMinimum");
+
+	residency.AddTexture(guid, mipSizes, 2);
+
+	SG_CHECK(residency.GetResidentMip(guid) == 2);
+	SG_CHECK(residency.GetResidentBytes() == 5);
+
+	residency.RemoveTexture(guid);
+	SG_CHECK(residency.GetResidentBytes() == 0);
+}
+
+SG_TEST(RequestedMipsAreLoadedAndReported)
+{
+	SG::SGTextureResidency residency(1000);
+	SG::SGGuid guid("ResidencyRequested");
+	std::vector<SG::SGResidencyChange> changes;
+
+	residency.AddTexture(guid, mipSizes, 1);
+	residency.RequestMip(guid, 0);
+	residency.Update(changes);
+
+	SG_CHECK(changes.size() == 1);
+	SG_CHECK(changes.size() == 1 && changes[0].guid == guid && changes[0].residentMip == 0 && changes[0].previousResidentMip == 3);
+	SG_CHECK(residency.GetResidentBytes() == 85);
+
+	// Nothing changes while the same mip is requested
+	residency.RequestMip(guid, 0);
+	SG_CHECK(Update(residency) == 0);
+}
+
+SG_TEST(MostDetailedRequestOfAFrameWins)
+{
+	SG::SGTextureResidency residency(1000);
+	SG::SGGuid guid("ResidencyMostDetailed");
+
+	residency.AddTexture(guid, mipSizes, 1);
+	residency.RequestMip(guid, 2);
+	residency.RequestMip(guid, 1);
+	residency.RequestMip(guid, 3);
+	Update(residency);
+
+	SG_CHECK(residency.GetResidentMip(guid) == 1);
+}
+
+SG_TEST(LoadingStopsAtTheBudget)
+{
+	SG::SGTextureResidency residency(30);
+	SG::SGGuid guid("ResidencyBudget");
+
+	residency.AddTexture(guid, mipSizes, 1);
+	residency.RequestMip(guid, 0);
+	Update(residency);
+
+	SG_CHECK(residency.GetResidentMip(guid) == 1);
+	SG_CHECK(residency.GetResidentBytes() == 21);
+}
+
+SG_TEST(UnrequestedTexturesAreEvictedFirst)
+{
+	SG::SGTextureResidency residency(100);
+	SG::SGGuid first("ResidencyFirst");
+	SG::SGGuid second("ResidencySecond");
+
+	residency.AddTexture(first, mipSizes, 1);
+	residency.AddTexture(second, mipSizes, 1);
+	residency.RequestMip(first, 0);
+	Update(residency);
+	SG_CHECK(residency.GetResidentMip(first) == 0);
+
+	residency.RequestMip(second, 0);
+	Update(residency);
+
+	SG_CHECK(residency.GetResidentMip(second) == 0);
+	SG_CHECK(residency.GetResidentMip(first) == 2);
+	SG_CHECK(residency.GetResidentBytes() == 90);
+	SG_CHECK(residency.GetResidentBytes() <= residency.GetBudget());
+}
+
+SG_TEST(HigherPriorityIsLoadedFirst)
+{
+	SG::SGTextureResidency residency(90);
+	SG::SGGuid low("ResidencyLow");
+	SG::SGGuid high("ResidencyHigh");
+
+	residency.AddTexture(low, mipSizes, 1);
+	residency.AddTexture(high, mipSizes, 1);
+	residency.RequestMip(low, 0, 1.0f);
+	residency.RequestMip(high, 0, 2.0f);
+	Update(residency);
+
+	SG_CHECK(residency.GetResidentMip(high) == 0);
+	SG_CHECK(residency.GetResidentMip(low) == 2);
+}
+
+SG_TEST(LockedTexturesAreNeitherLoadedNorEvicted)
+{
+	SG::SGTextureResidency residency(1000);
+	SG::SGGuid guid("ResidencyLocked");
+
+	residency.AddTexture(guid, mipSizes, 1);
+	residency.SetLocked(guid, true);
+	residency.RequestMip(guid, 0);
+	SG_CHECK(Update(residency) == 0);
+	SG_CHECK(residency.GetResidentMip(guid) == 3);
+
+	residency.SetLocked(guid, false);
+	residency.RequestMip(guid, 0);
+	Update(residency);
+	residency.SetLocked(guid, true);
+	residency.SetBudget(0);
+	SG_CHECK(Update(residency) == 0);
+	SG_CHECK(residency.GetResidentMip(guid) == 0);
+}
+
+SG_TEST(LoweredBudgetEvictsDownToTheMinimumMips)
+{
+	SG::SGTextureResidency residency(1000);
+	SG::SGGuid guid("ResidencyLowered");
+
+	residency.AddTexture(guid, mipSizes, 2);
+	residency.RequestMip(guid, 0);
+	Update(residency);
+	SG_CHECK(residency.GetResidentBytes() == 85);
+
+	// Mips a texture requested this frame still needs are kept
+	residency.SetBudget(0);
+	residency.RequestMip(guid, 1);
+	Update(residency);
+	SG_CHECK(residency.GetResidentMip(guid) == 1);
+
+	Update(residency);
+	SG_CHECK(residency.GetResidentMip(guid) == 2);
+	SG_CHECK(residency.GetResidentBytes() == 5);
+}
+
+SG_TEST(SetResidentMipCorrectsTheBytes)
+{
+	SG::SGTextureResidency residency(1000);
+	SG::SGGuid guid("ResidencyCorrected");
+
+	residency.AddTexture(guid, mipSizes, 1);
+	residency.SetResidentMip(guid, 1);
+	SG_CHECK(residency.GetResidentBytes() == 21);
+
+	// Never less detailed than the minimum mips
+	residency.SetResidentMip(guid, 10);
+	SG_CHECK(residency.GetResidentMip(guid) == 3);
+	SG_CHECK(residency.GetResidentBytes() == 1);
+}
+
+SG_TEST(MipForScreenSize)
+{
+	SG_CHECK(SG::SGTextureResidency::MipForScreenSize(1024, 512, 2048.0f) == 0);
+	SG_CHECK(SG::SGTextureResidency::MipForScreenSize(1024, 512, 1024.0f) == 0);
+	SG_CHECK(SG::SGTextureResidency::MipForScreenSize(1024, 512, 256.0f) == 2);
+	SG_CHECK(SG::SGTextureResidency::MipForScreenSize(512, 1024, 300.0f) == 1);
+	SG_CHECK(SG::SGTextureResidency::MipForScreenSize(1024, 1024, 0.0f) == std::numeric_limits<unsigned int>::max());
+}
+
+int main()
+{
+	return SG::RunTests();
+}
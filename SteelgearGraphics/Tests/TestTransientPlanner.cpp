@@ -0,0 +1,100 @@
+#include "SGTest.h"
+#include "SGTransientPlanner.h"
+
+#include <algorithm>
+
+SG_TEST(DisjointLifetimesShareAnAllocation)
+{
+	SG::SGTransientPlan plan = SG::PlanTransientResources({ { 7, 100, 0, 1 }, { 7, 100, 2, 3 } });
+
+	SG_CHECK(plan.allocationKeys == std::vector<size_t>({ 7 }));
+	SG_CHECK(plan.assignments[0] == plan.assignments[1]);
+	SG_CHECK(plan.requestedBytes == 200);
+	SG_CHECK(plan.allocatedBytes == 100);
+	SG_CHECK(plan.BytesSaved() == 100);
+}
+
+SG_TEST(LastUseIsInclusive)
+{
+	SG::SGTransientPlan plan = SG::PlanTransientResources({ { 7, 100, 0, 2 }, { 7, 100, 2, 3 } });
+
+	SG_CHECK(plan.allocationKeys.size() == 2);
+	SG_CHECK(plan.assignments[0] != plan.assignments[1]);
+	SG_CHECK(plan.BytesSaved() == 0);
+}
+
+SG_TEST(DifferentDescriptorsNeverShare)
+{
+	SG::SGTransientPlan plan = SG::PlanTransientResources({ { 1, 100, 0, 0 }, { 2, 100, 1, 1 }, { 1, 100, 2, 2 } });
+
+	SG_CHECK(plan.allocationKeys.size() == 2);
+	SG_CHECK(plan.assignments[0] == plan.assignments[2]);
+	SG_CHECK(plan.assignments[0] != plan.assignments[1]);
+	SG_CHECK(plan.allocationKeys[plan.assignments[1]] == 2);
+}
+
+SG_TEST(EmptyInputGivesAnEmptyPlan)
+{
+	SG::SGTransientPlan plan = SG::PlanTransientResources({});
+
+	SG_CHECK(plan.assignments.empty());
+	SG_CHECK(plan.allocationKeys.empty());
+	SG_CHECK(plan.requestedBytes == 0 && plan.allocatedBytes == 0);
+}
+
+SG_TEST(RandomLifetimesUseThePeakOfLiveResources)
+{
+	unsigned int seed = 12345;
+	auto next = [&seed](unsigned int range)
+	{
+		seed = seed * 1664525u + 1013904223u;
+		return (seed >> 8) % range;
+	};
+
+	for (int round = 0; round < 50; ++round)
+	{
+		std::vector<SG::SGTransientResource> resources;
+
+		for (int i = 0; i < 40; ++i)
+		{
+			size_t firstUse = next(30);
+			resources.push_back({ next(3), 64, firstUse, firstUse + next(8) });
+		}
+
+		SG::SGTransientPlan plan = SG::PlanTransientResources(resources);
+
+		// Resources that are alive at the same time never share
+		for (size_t i = 0; i < resources.size(); ++i)
+		{
+			SG_CHECK(plan.allocationKeys[plan.assignments[i]] == resources[i].descriptorKey);
+
+			for (size_t j = i + 1; j < resources.size(); ++j)
+			{
+				bool overlap = resources[i].firstUse <= resources[j].lastUse && resources[j].firstUse <= resources[i].lastUse;
+				SG_CHECK(!overlap || plan.assignments[i] != plan.assignments[j]);
+			}
+		}
+
+		for (size_t key = 0; key < 3; ++key)
+		{
+			size_t peak = 0;
+
+			for (size_t position = 0; position < 40; ++position)
+			{
+				size_t live = std::count_if(resources.begin(), resources.end(), [&](const SG::SGTransientResource& resource)
+				{
+					return resource.descriptorKey == key && resource.firstUse <= position && position <= resource.lastUse;
+				});
+
+				peak = std::max(peak, live);
+			}
+
+			SG_CHECK(static_cast<size_t>(std::count(plan.allocationKeys.begin(), plan.allocationKeys.end(), key)) == peak);
+		}
+	}
+}
+
+int main()
+{
+	return SG::RunTests();
+}